@@ -0,0 +1,60 @@
+#include <cppsim/circuit.hpp>
+#include <cppsim/state.hpp>
+#include <cppsim/type.hpp>
+#include <cppsim/utility.hpp>
+#include <iomanip>
+#include <iostream>
+
+// Compare QuantumCircuit::update_quantum_state with and without gate fusion
+// and cache-blocked execution. "passes" is the number of kernels applied, i.e.
+// the number of sweeps over the state vector.
+static QuantumCircuit* build_layered_circuit(UINT n, UINT depth) {
+    Random random;
+    random.set_seed(0);
+    QuantumCircuit* circuit = new QuantumCircuit(n);
+    for (UINT d = 0; d < depth; ++d) {
+        for (UINT i = 0; i < n; ++i) {
+            circuit->add_RX_gate(i, random.uniform());
+            circuit->add_RZ_gate(i, random.uniform());
+        }
+        for (UINT i = d % 2; i + 1 < n; i += 2) {
+            circuit->add_CNOT_gate(i, i + 1);
+        }
+    }
+    return circuit;
+}
+
+int main() {
+    const UINT min_qubit_count = 10;
+    const UINT max_qubit_count = 24;
+    const UINT depth = 10;
+    const UINT max_block_size = 5;
+    const UINT cache_blocking_qubit_count = 14;
+
+    std::cout << std::setw(6) << "qubit" << std::setw(8) << "block"
+              << std::setw(8) << "cache" << std::setw(8) << "passes"
+              << std::setw(14) << "time[s]" << std::endl;
+    for (UINT n = min_qubit_count; n <= max_qubit_count; n += 2) {
+        QuantumCircuit* circuit = build_layered_circuit(n, depth);
+        QuantumState state(n);
+        for (UINT cache : {0u, cache_blocking_qubit_count}) {
+            circuit->set_cache_blocking_qubit_count(cache);
+            for (UINT block_size = 0; block_size <= max_block_size;
+                 ++block_size) {
+                if (block_size == 1) continue;
+                circuit->set_fusion_max_block_size(block_size);
+                UINT passes = circuit->get_fused_gate_count();
+                state.set_zero_state();
+                Timer timer;
+                timer.reset();
+                circuit->update_quantum_state(&state);
+                double elapsed = timer.elapsed();
+                std::cout << std::setw(6) << n << std::setw(8) << block_size
+                          << std::setw(8) << cache << std::setw(8) << passes
+                          << std::setw(14) << elapsed << std::endl;
+            }
+        }
+        delete circuit;
+    }
+    return 0;
+}
@@ -20,9 +20,12 @@ __all__ = [
     "DensityMatrix",
     "GeneralQuantumOperator",
     "GradCalculator",
+    "MatrixProductState",
     "NoiseSimulator",
     "Observable",
+    "PackedDensityMatrix",
     "ParametricQuantumCircuit",
+    "PauliFrameSimulator",
     "PauliOperator",
     "QuantumCircuit",
     "QuantumCircuitSimulator",
@@ -36,9 +39,13 @@ __all__ = [
     "QuantumGate_Probabilistic",
     "QuantumGate_SingleParameter",
     "QuantumState",
+    "QuantumStateF32",
     "QuantumStateBase",
     "SimulationResult",
+    "StabilizerState",
     "StateVector",
+    "TrajectoryEnsemble",
+    "TrajectoryEnsembleResult",
     "circuit",
     "gate",
     "observable",
@@ -65,6 +72,10 @@ class CausalConeSimulator():
         """
         Return coef_list
         """
+    def get_cone_count(self) -> int: 
+        """
+        Return the number of distinct cones
+        """
     def get_expectation_value(self) -> complex: 
         """
         Return expectation_value
@@ -73,6 +84,10 @@ class CausalConeSimulator():
         """
         Return pauli_operator_list
         """
+    def set_parameter(self, index: int, value: float) -> None: 
+        """
+        Set parameter value without building the cones again
+        """
     pass
 class QuantumGateBase():
     def __str__(self) -> str: ...
@@ -263,6 +278,13 @@ class GeneralQuantumOperator():
 class GradCalculator():
     def __init__(self) -> None: ...
     @typing.overload
+    def calculate_energy_and_grad(self, parametric_circuit: ParametricQuantumCircuit, observable: Observable) -> typing.Tuple[float, typing.List[float]]: 
+        """
+        Calculate energy and grad by adjoint method
+        """
+    @typing.overload
+    def calculate_energy_and_grad(self, parametric_circuit: ParametricQuantumCircuit, observable: Observable, angles_of_gates: typing.List[float]) -> typing.Tuple[float, typing.List[float]]: ...
+    @typing.overload
     def calculate_grad(self, parametric_circuit: ParametricQuantumCircuit, observable: Observable) -> typing.List[complex]: 
         """
         Calculate Grad
@@ -283,6 +305,22 @@ class NoiseSimulator():
         """
         Simulate & Return ressult [array of (state, frequency)]
         """
+    def execute_parallel(self, sample_count: int) -> typing.List[int]: 
+        """
+        Sampling with trajectories in parallel & Return result [array]
+        """
+    def execute_streaming(self, sample_count: int, process_samples: typing.Callable[[typing.List[int]], None]) -> None: 
+        """
+        Sampling & Pass result of each trajectory to callback [array]
+        """
+    def get_checkpoint_memory_budget(self) -> int: 
+        """
+        Get memory budget in bytes of states kept to reuse shared noise histories
+        """
+    def set_checkpoint_memory_budget(self, budget_bytes: int) -> None: 
+        """
+        Set memory budget in bytes of states kept to reuse shared noise histories
+        """
     pass
 class Observable(GeneralQuantumOperator):
     def __init__(self, qubit_count: int) -> None: 
@@ -542,6 +580,18 @@ class QuantumCircuit():
         """
         Create copied instance
         """
+    def get_cache_blocking_qubit_count(self) -> int: 
+        """
+        Get qubit count of cache-blocked execution
+        """
+    def get_fused_gate_count(self) -> int: 
+        """
+        Get gate count after gate fusion
+        """
+    def get_fusion_max_block_size(self) -> int: 
+        """
+        Get maximum qubit count of fused gates
+        """
     def get_gate(self, position: int) -> QuantumGateBase: 
         """
         Get gate instance
@@ -563,6 +613,14 @@ class QuantumCircuit():
         """
         Remove gate
         """
+    def set_cache_blocking_qubit_count(self, block_qubit_count: int) -> None: 
+        """
+        Set qubit count of cache-blocked execution (0 disables it)
+        """
+    def set_fusion_max_block_size(self, max_block_size: int) -> None: 
+        """
+        Set maximum qubit count of fused gates (0 disables gate fusion)
+        """
     def to_json(self) -> str: ...
     def to_string(self) -> str: 
         """
@@ -576,6 +634,28 @@ class QuantumCircuit():
     @typing.overload
     def update_quantum_state(self, state: QuantumStateBase, start: int, end: int) -> None: ...
     pass
+class PauliFrameSimulator():
+    @typing.overload
+    def __init__(self, circuit: QuantumCircuit) -> None: 
+        """
+        Constructor
+        """
+    @typing.overload
+    def __init__(self, circuit: QuantumCircuit, initial_state: QuantumState) -> None: ...
+    def execute(self, sample_count: int) -> typing.List[int]: 
+        """
+        Sampling & Return result [array]
+        """
+    @staticmethod
+    def is_supported(circuit: QuantumCircuit) -> bool: 
+        """
+        Check if circuit consists of Clifford gates and Pauli noises
+        """
+    def set_seed(self, seed: int) -> None: 
+        """
+        Set random seed
+        """
+    pass
 class PauliOperator():
     def __IMUL__(self, arg0: complex) -> PauliOperator: ...
     def __imul__(self, arg0: PauliOperator) -> PauliOperator: ...
@@ -684,6 +764,10 @@ class ParametricQuantumCircuit(QuantumCircuit):
         """
         Create copied instance
         """
+    def evaluate_batch(self, theta_matrix: numpy.ndarray[numpy.float64, _Shape[m, n]], observable: GeneralQuantumOperator) -> numpy.ndarray[numpy.float64, _Shape[m, 1]]: 
+        """
+        Evaluate expectation values for rows of parameters in parallel
+        """
     def get_parameter(self, index: int) -> float: 
         """
         Get parameter
@@ -861,6 +945,10 @@ class QuantumState(QuantumStateBase):
         """
         Get entropy
         """
+    def get_marginal_distribution(self, target_qubit_index_list: typing.List[int]) -> typing.List[float]: 
+        """
+        Get marginal probability distribution of target qubits
+        """
     def get_marginal_probability(self, measured_values: typing.List[int]) -> float: 
         """
         Get merginal probability for measured values
@@ -908,12 +996,23 @@ class QuantumState(QuantumStateBase):
     @typing.overload
     def sampling(self, sampling_count: int, random_seed: int) -> typing.List[int]: ...
     @typing.overload
+    def sampling(self, sampling_count: int, target_qubit_index_list: typing.List[int]) -> typing.List[int]: 
+        """
+        Sampling measurement results of target qubits
+        """
+    @typing.overload
+    def sampling(self, sampling_count: int, target_qubit_index_list: typing.List[int], random_seed: int) -> typing.List[int]: ...
+    @typing.overload
     def set_Haar_random_state(self) -> None: 
         """
         Set Haar random state
         """
     @typing.overload
     def set_Haar_random_state(self, seed: int) -> None: ...
+    def set_alias_sampling(self, use_alias_table: bool) -> None: 
+        """
+        Use Walker alias table cached on the state for sampling
+        """
     def set_classical_value(self, index: int, value: int) -> None: 
         """
         Set classical value
@@ -935,6 +1034,101 @@ class QuantumState(QuantumStateBase):
         to string
         """
     pass
+class QuantumStateF32(QuantumStateBase):
+    def __init__(self, qubit_count: int) -> None: 
+        """
+        Constructor
+        """
+    def __str__(self) -> str: 
+        """
+        to string
+        """
+    def add_state(self, state: QuantumStateBase) -> None: 
+        """
+        Add state vector to this state
+        """
+    def apply_gate(self, gate: QuantumGateBase) -> None: 
+        """
+        Apply quantum gate
+        """
+    def copy(self) -> QuantumStateF32: 
+        """
+        Create copied instance
+        """
+    def get_device_name(self) -> str: 
+        """
+        Get allocated device name
+        """
+    def get_entropy(self) -> float: 
+        """
+        Get entropy
+        """
+    def get_marginal_probability(self, measured_values: typing.List[int]) -> float: 
+        """
+        Get merginal probability for measured values
+        """
+    def get_qubit_count(self) -> int: 
+        """
+        Get qubit count
+        """
+    def get_squared_norm(self) -> float: 
+        """
+        Get squared norm
+        """
+    def get_vector(self) -> numpy.ndarray[numpy.complex128, _Shape[m, 1]]: 
+        """
+        Get state vector converted to double precision
+        """
+    def get_zero_probability(self, index: int) -> float: 
+        """
+        Get probability with which we obtain 0 when we measure a qubit
+        """
+    @typing.overload
+    def load(self, state: QuantumStateBase) -> None: 
+        """
+        Load quantum state vector
+        """
+    @typing.overload
+    def load(self, state: typing.List[complex]) -> None: ...
+    def multiply_coef(self, coef: complex) -> None: 
+        """
+        Multiply coefficient to this state
+        """
+    def normalize(self, squared_norm: float) -> None: 
+        """
+        Normalize quantum state
+        """
+    @typing.overload
+    def sampling(self, sampling_count: int) -> typing.List[int]: 
+        """
+        Sampling measurement results
+        """
+    @typing.overload
+    def sampling(self, sampling_count: int, random_seed: int) -> typing.List[int]: ...
+    @typing.overload
+    def set_Haar_random_state(self) -> None: 
+        """
+        Set Haar random state
+        """
+    @typing.overload
+    def set_Haar_random_state(self, seed: int) -> None: ...
+    def set_computational_basis(self, comp_basis: int) -> None: 
+        """
+        Set state to computational basis
+        """
+    def set_zero_state(self) -> None: 
+        """
+        Set state to |0>
+        """
+    def to_double_precision(self) -> QuantumState: 
+        """
+        Convert to double-precision state
+        """
+    def to_string(self) -> str: 
+        """
+        to string
+        """
+    pass
 class DensityMatrix(QuantumStateBase):
     def __getstate__(self) -> str: ...
     def __init__(self, qubit_count: int) -> None: 
@@ -970,6 +1164,10 @@ class DensityMatrix(QuantumStateBase):
         """
         Get entropy
         """
+    def get_marginal_distribution(self, target_qubit_index_list: typing.List[int]) -> typing.List[float]: 
+        """
+        Get marginal probability distribution of target qubits
+        """
     def get_marginal_probability(self, measured_values: typing.List[int]) -> float: 
         """
         Get merginal probability for measured values
@@ -1015,6 +1213,222 @@ class DensityMatrix(QuantumStateBase):
     @typing.overload
     def sampling(self, sampling_count: int, random_seed: int) -> typing.List[int]: ...
     @typing.overload
+    def sampling(self, sampling_count: int, target_qubit_index_list: typing.List[int]) -> typing.List[int]: 
+        """
+        Sampling measurement results of target qubits
+        """
+    @typing.overload
+    def sampling(self, sampling_count: int, target_qubit_index_list: typing.List[int], random_seed: int) -> typing.List[int]: ...
+    @typing.overload
+    def set_Haar_random_state(self) -> None: 
+        """
+        Set Haar random state
+        """
+    @typing.overload
+    def set_Haar_random_state(self, seed: int) -> None: ...
+    def set_classical_value(self, index: int, value: int) -> None: 
+        """
+        Set classical value
+        """
+    def set_computational_basis(self, comp_basis: int) -> None: 
+        """
+        Set state to computational basis
+        """
+    def set_zero_state(self) -> None: 
+        """
+        Set state to |0>
+        """
+    def to_json(self) -> str: 
+        """
+        to json string
+        """
+    def to_string(self) -> str: 
+        """
+        to string
+        """
+    pass
+class MatrixProductState(QuantumStateBase):
+    def __init__(self, qubit_count: int, max_bond_dimension: int = 64, truncation_threshold: float = 1e-12) -> None: 
+        """
+        Constructor
+        """
+    def __str__(self) -> str: 
+        """
+        to string
+        """
+    def apply_gate(self, gate: QuantumGateBase) -> None: 
+        """
+        Apply quantum gate
+        """
+    def copy(self) -> MatrixProductState: 
+        """
+        Create copied instance
+        """
+    def get_Pauli_expectation_value(self, target_qubit_index_list: typing.List[int], pauli_id_list: typing.List[int]) -> float: 
+        """
+        Get expectation value of Pauli operator
+        """
+    def get_bond_dimension_list(self) -> typing.List[int]: 
+        """
+        Get bond dimensions between adjacent qubits
+        """
+    def get_device_name(self) -> str: 
+        """
+        Get allocated device name
+        """
+    def get_marginal_probability(self, measured_values: typing.List[int]) -> float: 
+        """
+        Get merginal probability for measured values
+        """
+    def get_max_bond_dimension(self) -> int: 
+        """
+        Get max bond dimension
+        """
+    def get_qubit_count(self) -> int: 
+        """
+        Get qubit count
+        """
+    def get_squared_norm(self) -> float: 
+        """
+        Get squared norm
+        """
+    def get_truncation_error(self) -> float: 
+        """
+        Get total discarded weight of singular values
+        """
+    def get_truncation_threshold(self) -> float: 
+        """
+        Get threshold of discarded weight of singular values
+        """
+    def get_vector(self) -> numpy.ndarray[numpy.complex128, _Shape[m, 1]]: 
+        """
+        Get state vector by contracting the tensors
+        """
+    def get_zero_probability(self, index: int) -> float: 
+        """
+        Get probability with which we obtain 0 when we measure a qubit
+        """
+    @typing.overload
+    def load(self, state: QuantumStateBase) -> None: 
+        """
+        Load quantum state
+        """
+    @typing.overload
+    def load(self, state: typing.List[complex]) -> None: ...
+    def multiply_coef(self, coef: complex) -> None: 
+        """
+        Multiply coefficient to this state
+        """
+    def normalize(self, squared_norm: float) -> None: 
+        """
+        Normalize quantum state
+        """
+    @typing.overload
+    def sampling(self, sampling_count: int) -> typing.List[int]: 
+        """
+        Sampling measurement results
+        """
+    @typing.overload
+    def sampling(self, sampling_count: int, random_seed: int) -> typing.List[int]: ...
+    def set_computational_basis(self, comp_basis: int) -> None: 
+        """
+        Set state to computational basis
+        """
+    def set_max_bond_dimension(self, max_bond_dimension: int) -> None: 
+        """
+        Set max bond dimension
+        """
+    def set_truncation_threshold(self, truncation_threshold: float) -> None: 
+        """
+        Set threshold of discarded weight of singular values
+        """
+    def set_zero_state(self) -> None: 
+        """
+        Set state to |0>
+        """
+    def to_string(self) -> str: 
+        """
+        to string
+        """
+    pass
+class PackedDensityMatrix(QuantumStateBase):
+    def __getstate__(self) -> str: ...
+    def __init__(self, qubit_count: int) -> None: 
+        """
+        Constructor
+        """
+    def __setstate__(self, arg0: str) -> None: ...
+    def __str__(self) -> str: 
+        """
+        to string
+        """
+    def add_state(self, state: QuantumStateBase) -> None: 
+        """
+        Add packed density matrix to this state
+        """
+    def allocate_buffer(self) -> PackedDensityMatrix: 
+        """
+        Allocate buffer with the same size
+        """
+    def copy(self) -> PackedDensityMatrix: 
+        """
+        Create copied insntace
+        """
+    def get_classical_value(self, index: int) -> int: 
+        """
+        Get classical value
+        """
+    def get_device_name(self) -> str: 
+        """
+        Get allocated device name
+        """
+    def get_entropy(self) -> float: 
+        """
+        Get entropy
+        """
+    def get_marginal_probability(self, measured_values: typing.List[int]) -> float: 
+        """
+        Get merginal probability for measured values
+        """
+    def get_matrix(self) -> numpy.ndarray[numpy.complex128, _Shape[m, n]]: 
+        """
+        Get density matrix
+        """
+    def get_qubit_count(self) -> int: 
+        """
+        Get qubit count
+        """
+    def get_squared_norm(self) -> float: 
+        """
+        Get squared norm
+        """
+    def get_zero_probability(self, index: int) -> float: 
+        """
+        Get probability with which we obtain 0 when we measure a qubit
+        """
+    @typing.overload
+    def load(self, state: QuantumStateBase) -> None: 
+        """
+        Load quantum state vector or density matrix
+        """
+    @typing.overload
+    def load(self, state: typing.List[complex]) -> None: ...
+    def multiply_coef(self, coef: complex) -> None: 
+        """
+        Multiply real coefficient to this state
+        """
+    def normalize(self, squared_norm: float) -> None: 
+        """
+        Normalize quantum state
+        """
+    @typing.overload
+    def sampling(self, sampling_count: int) -> typing.List[int]: 
+        """
+        Sampling measurement results
+        """
+    @typing.overload
+    def sampling(self, sampling_count: int, random_seed: int) -> typing.List[int]: ...
+    @typing.overload
     def set_Haar_random_state(self) -> None: 
         """
         Set Haar random state
@@ -1056,6 +1470,115 @@ class SimulationResult():
         get state
         """
     pass
+class StabilizerState(QuantumStateBase):
+    def __init__(self, qubit_count: int) -> None: 
+        """
+        Constructor
+        """
+    def __str__(self) -> str: 
+        """
+        to string
+        """
+    def apply_gate(self, gate: QuantumGateBase) -> None: 
+        """
+        Apply Clifford gate
+        """
+    def copy(self) -> StabilizerState: 
+        """
+        Create copied instance
+        """
+    def get_Pauli_expectation_value(self, target_qubit_index_list: typing.List[int], pauli_id_list: typing.List[int]) -> float: 
+        """
+        Get expectation value of Pauli operator
+        """
+    def get_device_name(self) -> str: 
+        """
+        Get allocated device name
+        """
+    def get_entropy(self) -> float: 
+        """
+        Get entropy
+        """
+    def get_marginal_probability(self, measured_values: typing.List[int]) -> float: 
+        """
+        Get merginal probability for measured values
+        """
+    def get_qubit_count(self) -> int: 
+        """
+        Get qubit count
+        """
+    def get_zero_probability(self, index: int) -> float: 
+        """
+        Get probability with which we obtain 0 when we measure a qubit
+        """
+    def load(self, state: QuantumStateBase) -> None: 
+        """
+        Load stabilizer state
+        """
+    def measure(self, index: int) -> int: 
+        """
+        Measure a qubit in Z basis and project the state
+        """
+    @typing.overload
+    def sampling(self, sampling_count: int) -> typing.List[int]: 
+        """
+        Sampling measurement results
+        """
+    @typing.overload
+    def sampling(self, sampling_count: int, random_seed: int) -> typing.List[int]: ...
+    def set_computational_basis(self, comp_basis: int) -> None: 
+        """
+        Set state to computational basis
+        """
+    def set_zero_state(self) -> None: 
+        """
+        Set state to |0>
+        """
+    def to_string(self) -> str: 
+        """
+        to string
+        """
+    pass
+class TrajectoryEnsemble():
+    @typing.overload
+    def __init__(self, circuit: QuantumCircuit) -> None: 
+        """
+        Constructor
+        """
+    @typing.overload
+    def __init__(self, circuit: QuantumCircuit, initial_state: QuantumState) -> None: ...
+    def estimate(self, observable: GeneralQuantumOperator, max_trajectory_count: int, target_standard_error: float = 0.0, batch_size: int = 100) -> TrajectoryEnsembleResult: 
+        """
+        Estimate expectation value by averaging trajectories in parallel
+        """
+    def set_seed(self, seed: int) -> None: 
+        """
+        Set random seed
+        """
+    pass
+class TrajectoryEnsembleResult():
+    @property
+    def mean(self) -> float:
+        """
+        Mean of expectation values over trajectories
+
+        :type: float
+        """
+    @property
+    def standard_error(self) -> float:
+        """
+        Standard error of the mean
+
+        :type: float
+        """
+    @property
+    def trajectory_count(self) -> int:
+        """
+        Number of simulated trajectories
+
+        :type: int
+        """
+    pass
 def StateVector(arg0: int) -> QuantumState:
     """
     StateVector
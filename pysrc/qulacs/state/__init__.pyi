@@ -41,6 +41,9 @@ def partial_trace(state: qulacs_core.DensityMatrix, target_traceout: typing.List
     Take partial trace
     """
 @typing.overload
+def partial_trace(state: qulacs_core.PackedDensityMatrix, target_traceout: typing.List[int]) -> qulacs_core.PackedDensityMatrix:
+    pass
+@typing.overload
 def partial_trace(state: qulacs_core.QuantumState, target_traceout: typing.List[int]) -> qulacs_core.DensityMatrix:
     pass
 @typing.overload
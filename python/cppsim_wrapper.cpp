@@ -16,10 +16,16 @@
 #include <cppsim/general_quantum_operator.hpp>
 #include <cppsim/noisesimulator.hpp>
 #include <cppsim/observable.hpp>
+#include <cppsim/pauli_frame_simulator.hpp>
 #include <cppsim/pauli_operator.hpp>
 #include <cppsim/simulator.hpp>
 #include <cppsim/state.hpp>
 #include <cppsim/state_dm.hpp>
+#include <cppsim/state_dm_packed.hpp>
+#include <cppsim/state_f32.hpp>
+#include <cppsim/state_mps.hpp>
+#include <cppsim/state_stabilizer.hpp>
+#include <cppsim/trajectory_ensemble.hpp>
 #include <cppsim/utility.hpp>
 #include <csim/memory_ops.hpp>
 #include <csim/stat_ops.hpp>
@@ -386,6 +392,23 @@ PYBIND11_MODULE(qulacs_core, m) {
             "Sampling measurement results", py::arg("sampling_count"))
         .def("sampling", py::overload_cast<UINT, UINT>(&QuantumState::sampling),
             py::arg("sampling_count"), py::arg("random_seed"))
+        .def("sampling",
+            py::overload_cast<UINT, const std::vector<UINT>&>(
+                &QuantumState::sampling),
+            "Sampling measurement results of target qubits",
+            py::arg("sampling_count"), py::arg("target_qubit_index_list"))
+        .def("sampling",
+            py::overload_cast<UINT, const std::vector<UINT>&, UINT>(
+                &QuantumState::sampling),
+            py::arg("sampling_count"), py::arg("target_qubit_index_list"),
+            py::arg("random_seed"))
+        .def("get_marginal_distribution",
+            &QuantumState::get_marginal_distribution,
+            "Get marginal probability distribution of target qubits",
+            py::arg("target_qubit_index_list"))
+        .def("set_alias_sampling", &QuantumState::set_alias_sampling,
+            "Use Walker alias table cached on the state for sampling",
+            py::arg("use_alias_table"))
         .def(
             "get_vector",
             [](const QuantumState& state) -> Eigen::VectorXcd {
@@ -433,6 +456,216 @@ PYBIND11_MODULE(qulacs_core, m) {
         },
         py::return_value_policy::take_ownership, "StateVector");
 
+    py::class_<QuantumStateCpuF32, QuantumStateBase>(m, "QuantumStateF32")
+        .def(py::init<UINT>(), "Constructor", py::arg("qubit_count"))
+        .def("set_zero_state", &QuantumStateCpuF32::set_zero_state,
+            "Set state to |0>")
+        .def("set_computational_basis",
+            &QuantumStateCpuF32::set_computational_basis,
+            "Set state to computational basis", py::arg("comp_basis"))
+        .def("set_Haar_random_state",
+            py::overload_cast<>(&QuantumStateCpuF32::set_Haar_random_state),
+            "Set Haar random state")
+        .def("set_Haar_random_state",
+            py::overload_cast<UINT>(
+                &QuantumStateCpuF32::set_Haar_random_state),
+            py::arg("seed"))
+        .def("get_zero_probability", &QuantumStateCpuF32::get_zero_probability,
+            "Get probability with which we obtain 0 when we measure a qubit",
+            py::arg("index"))
+        .def("get_marginal_probability",
+            &QuantumStateCpuF32::get_marginal_probability,
+            "Get merginal probability for measured values",
+            py::arg("measured_values"))
+        .def("get_entropy", &QuantumStateCpuF32::get_entropy, "Get entropy")
+        .def("get_squared_norm", &QuantumStateCpuF32::get_squared_norm,
+            "Get squared norm")
+        .def("normalize", &QuantumStateCpuF32::normalize,
+            "Normalize quantum state", py::arg("squared_norm"))
+        .def("copy", &QuantumStateCpuF32::copy,
+            py::return_value_policy::take_ownership, "Create copied instance")
+        .def("load",
+            py::overload_cast<const QuantumStateBase*>(
+                &QuantumStateCpuF32::load),
+            "Load quantum state vector", py::arg("state"))
+        .def("load",
+            py::overload_cast<const std::vector<CPPCTYPE>&>(
+                &QuantumStateCpuF32::load),
+            py::arg("state"))
+        .def("get_device_name", &QuantumStateCpuF32::get_device_name,
+            "Get allocated device name")
+        .def("add_state", &QuantumStateCpuF32::add_state,
+            "Add state vector to this state", py::arg("state"))
+        .def("multiply_coef", &QuantumStateCpuF32::multiply_coef,
+            "Multiply coefficient to this state", py::arg("coef"))
+        .def("sampling",
+            py::overload_cast<UINT>(&QuantumStateCpuF32::sampling),
+            "Sampling measurement results", py::arg("sampling_count"))
+        .def("sampling",
+            py::overload_cast<UINT, UINT>(&QuantumStateCpuF32::sampling),
+            py::arg("sampling_count"), py::arg("random_seed"))
+        .def(
+            "get_vector",
+            [](const QuantumStateCpuF32& state) -> Eigen::VectorXcd {
+                CPPCTYPE* data = state.duplicate_data_cpp();
+                Eigen::VectorXcd vec =
+                    Eigen::Map<Eigen::VectorXcd>(data, state.dim);
+                free(data);
+                return vec;
+            },
+            "Get state vector converted to double precision")
+        .def(
+            "get_qubit_count",
+            [](const QuantumStateCpuF32& state) -> UINT {
+                return state.qubit_count;
+            },
+            "Get qubit count")
+        .def("apply_gate", &QuantumStateCpuF32::apply_gate,
+            "Apply quantum gate", py::arg("gate"))
+        .def("to_double_precision", &QuantumStateCpuF32::to_double_precision,
+            py::return_value_policy::take_ownership,
+            "Convert to double-precision state")
+        .def("to_string", &QuantumStateCpuF32::to_string, "to string")
+        .def(
+            "__str__",
+            [](const QuantumStateCpuF32& p) { return p.to_string(); },
+            "to string");
+
+    py::class_<StabilizerState, QuantumStateBase>(m, "StabilizerState")
+        .def(py::init<UINT>(), "Constructor", py::arg("qubit_count"))
+        .def("set_zero_state", &StabilizerState::set_zero_state,
+            "Set state to |0>")
+        .def("set_computational_basis",
+            &StabilizerState::set_computational_basis,
+            "Set state to computational basis", py::arg("comp_basis"))
+        .def("get_zero_probability", &StabilizerState::get_zero_probability,
+            "Get probability with which we obtain 0 when we measure a qubit",
+            py::arg("index"))
+        .def("get_marginal_probability",
+            &StabilizerState::get_marginal_probability,
+            "Get merginal probability for measured values",
+            py::arg("measured_values"))
+        .def("get_entropy", &StabilizerState::get_entropy, "Get entropy")
+        .def("copy", &StabilizerState::copy,
+            py::return_value_policy::take_ownership, "Create copied instance")
+        .def("load",
+            py::overload_cast<const QuantumStateBase*>(&StabilizerState::load),
+            "Load stabilizer state", py::arg("state"))
+        .def("get_device_name", &StabilizerState::get_device_name,
+            "Get allocated device name")
+        .def("apply_gate", &StabilizerState::apply_gate,
+            "Apply Clifford gate", py::arg("gate"))
+        .def("measure", &StabilizerState::measure,
+            "Measure a qubit in Z basis and project the state",
+            py::arg("index"))
+        .def("get_Pauli_expectation_value",
+            &StabilizerState::get_Pauli_expectation_value,
+            "Get expectation value of Pauli operator",
+            py::arg("target_qubit_index_list"), py::arg("pauli_id_list"))
+        .def("sampling", py::overload_cast<UINT>(&StabilizerState::sampling),
+            "Sampling measurement results", py::arg("sampling_count"))
+        .def("sampling",
+            py::overload_cast<UINT, UINT>(&StabilizerState::sampling),
+            py::arg("sampling_count"), py::arg("random_seed"))
+        .def(
+            "get_qubit_count",
+            [](const StabilizerState& state) -> UINT {
+                return state.qubit_count;
+            },
+            "Get qubit count")
+        .def("to_string", &StabilizerState::to_string, "to string")
+        .def(
+            "__str__", [](const StabilizerState& p) { return p.to_string(); },
+            "to string");
+
+    py::class_<MatrixProductState, QuantumStateBase>(m, "MatrixProductState")
+        .def(py::init<UINT, UINT, double>(), "Constructor",
+            py::arg("qubit_count"), py::arg("max_bond_dimension") = 64,
+            py::arg("truncation_threshold") = 1e-12)
+        .def("set_zero_state", &MatrixProductState::set_zero_state,
+            "Set state to |0>")
+        .def("set_computational_basis",
+            &MatrixProductState::set_computational_basis,
+            "Set state to computational basis", py::arg("comp_basis"))
+        .def("get_zero_probability",
+            &MatrixProductState::get_zero_probability,
+            "Get probability with which we obtain 0 when we measure a qubit",
+            py::arg("index"))
+        .def("get_marginal_probability",
+            &MatrixProductState::get_marginal_probability,
+            "Get merginal probability for measured values",
+            py::arg("measured_values"))
+        .def("get_squared_norm", &MatrixProductState::get_squared_norm,
+            "Get squared norm")
+        .def("normalize", &MatrixProductState::normalize,
+            "Normalize quantum state", py::arg("squared_norm"))
+        .def("copy", &MatrixProductState::copy,
+            py::return_value_policy::take_ownership, "Create copied instance")
+        .def("load",
+            py::overload_cast<const QuantumStateBase*>(
+                &MatrixProductState::load),
+            "Load quantum state", py::arg("state"))
+        .def("load",
+            py::overload_cast<const std::vector<CPPCTYPE>&>(
+                &MatrixProductState::load),
+            py::arg("state"))
+        .def("get_device_name", &MatrixProductState::get_device_name,
+            "Get allocated device name")
+        .def("multiply_coef", &MatrixProductState::multiply_coef,
+            "Multiply coefficient to this state", py::arg("coef"))
+        .def("apply_gate", &MatrixProductState::apply_gate,
+            "Apply quantum gate", py::arg("gate"))
+        .def("get_Pauli_expectation_value",
+            &MatrixProductState::get_Pauli_expectation_value,
+            "Get expectation value of Pauli operator",
+            py::arg("target_qubit_index_list"), py::arg("pauli_id_list"))
+        .def("sampling",
+            py::overload_cast<UINT>(&MatrixProductState::sampling),
+            "Sampling measurement results", py::arg("sampling_count"))
+        .def("sampling",
+            py::overload_cast<UINT, UINT>(&MatrixProductState::sampling),
+            py::arg("sampling_count"), py::arg("random_seed"))
+        .def(
+            "get_vector",
+            [](const MatrixProductState& state) -> Eigen::VectorXcd {
+                CPPCTYPE* data = state.duplicate_data_cpp();
+                Eigen::VectorXcd vec =
+                    Eigen::Map<Eigen::VectorXcd>(data, state.dim);
+                free(data);
+                return vec;
+            },
+            "Get state vector by contracting the tensors")
+        .def(
+            "get_qubit_count",
+            [](const MatrixProductState& state) -> UINT {
+                return state.qubit_count;
+            },
+            "Get qubit count")
+        .def("set_max_bond_dimension",
+            &MatrixProductState::set_max_bond_dimension,
+            "Set max bond dimension", py::arg("max_bond_dimension"))
+        .def("get_max_bond_dimension",
+            &MatrixProductState::get_max_bond_dimension,
+            "Get max bond dimension")
+        .def("set_truncation_threshold",
+            &MatrixProductState::set_truncation_threshold,
+            "Set threshold of discarded weight of singular values",
+            py::arg("truncation_threshold"))
+        .def("get_truncation_threshold",
+            &MatrixProductState::get_truncation_threshold,
+            "Get threshold of discarded weight of singular values")
+        .def("get_truncation_error",
+            &MatrixProductState::get_truncation_error,
+            "Get total discarded weight of singular values")
+        .def("get_bond_dimension_list",
+            &MatrixProductState::get_bond_dimension_list,
+            "Get bond dimensions between adjacent qubits")
+        .def("to_string", &MatrixProductState::to_string, "to string")
+        .def(
+            "__str__",
+            [](const MatrixProductState& p) { return p.to_string(); },
+            "to string");
+
     py::class_<DensityMatrix, QuantumStateBase>(m, "DensityMatrix")
         .def(py::init<UINT>(), "Constructor", py::arg("qubit_count"))
         .def("set_zero_state", &DensityMatrix::set_zero_state,
@@ -488,6 +721,20 @@ PYBIND11_MODULE(qulacs_core, m) {
         .def("sampling",
             py::overload_cast<UINT, UINT>(&DensityMatrix::sampling),
             py::arg("sampling_count"), py::arg("random_seed"))
+        .def("sampling",
+            py::overload_cast<UINT, const std::vector<UINT>&>(
+                &DensityMatrix::sampling),
+            "Sampling measurement results of target qubits",
+            py::arg("sampling_count"), py::arg("target_qubit_index_list"))
+        .def("sampling",
+            py::overload_cast<UINT, const std::vector<UINT>&, UINT>(
+                &DensityMatrix::sampling),
+            py::arg("sampling_count"), py::arg("target_qubit_index_list"),
+            py::arg("random_seed"))
+        .def("get_marginal_distribution",
+            &DensityMatrix::get_marginal_distribution,
+            "Get marginal probability distribution of target qubits",
+            py::arg("target_qubit_index_list"))
         .def(
             "get_matrix",
             [](const DensityMatrix& state) -> Eigen::MatrixXcd {
@@ -526,6 +773,102 @@ PYBIND11_MODULE(qulacs_core, m) {
             }));
     ;
 
+    py::class_<PackedDensityMatrix, QuantumStateBase>(m, "PackedDensityMatrix")
+        .def(py::init<UINT>(), "Constructor", py::arg("qubit_count"))
+        .def("set_zero_state", &PackedDensityMatrix::set_zero_state,
+            "Set state to |0>")
+        .def("set_computational_basis",
+            &PackedDensityMatrix::set_computational_basis,
+            "Set state to computational basis", py::arg("comp_basis"))
+        .def("set_Haar_random_state",
+            py::overload_cast<>(&PackedDensityMatrix::set_Haar_random_state),
+            "Set Haar random state")
+        .def("set_Haar_random_state",
+            py::overload_cast<UINT>(
+                &PackedDensityMatrix::set_Haar_random_state),
+            py::arg("seed"))
+        .def("get_zero_probability",
+            &PackedDensityMatrix::get_zero_probability,
+            "Get probability with which we obtain 0 when we measure a qubit",
+            py::arg("index"))
+        .def("get_marginal_probability",
+            &PackedDensityMatrix::get_marginal_probability,
+            "Get merginal probability for measured values",
+            py::arg("measured_values"))
+        .def("get_entropy", &PackedDensityMatrix::get_entropy, "Get entropy")
+        .def("get_squared_norm", &PackedDensityMatrix::get_squared_norm,
+            "Get squared norm")
+        .def("normalize", &PackedDensityMatrix::normalize,
+            "Normalize quantum state", py::arg("squared_norm"))
+        .def("allocate_buffer", &PackedDensityMatrix::allocate_buffer,
+            py::return_value_policy::take_ownership,
+            "Allocate buffer with the same size")
+        .def("copy", &PackedDensityMatrix::copy,
+            py::return_value_policy::take_ownership, "Create copied insntace")
+        .def("load",
+            py::overload_cast<const QuantumStateBase*>(
+                &PackedDensityMatrix::load),
+            "Load quantum state vector or density matrix", py::arg("state"))
+        .def("load",
+            py::overload_cast<const std::vector<CPPCTYPE>&>(
+                &PackedDensityMatrix::load),
+            py::arg("state"))
+        .def("get_device_name", &PackedDensityMatrix::get_device_name,
+            "Get allocated device name")
+        .def("add_state", &PackedDensityMatrix::add_state,
+            "Add packed density matrix to this state", py::arg("state"))
+        .def("multiply_coef", &PackedDensityMatrix::multiply_coef,
+            "Multiply real coefficient to this state", py::arg("coef"))
+        .def("get_classical_value", &PackedDensityMatrix::get_classical_value,
+            "Get classical value", py::arg("index"))
+        .def("set_classical_value", &PackedDensityMatrix::set_classical_value,
+            "Set classical value", py::arg("index"), py::arg("value"))
+        .def("to_string", &PackedDensityMatrix::to_string, "to string")
+        .def("sampling",
+            py::overload_cast<UINT>(&PackedDensityMatrix::sampling),
+            "Sampling measurement results", py::arg("sampling_count"))
+        .def("sampling",
+            py::overload_cast<UINT, UINT>(&PackedDensityMatrix::sampling),
+            py::arg("sampling_count"), py::arg("random_seed"))
+        .def(
+            "get_matrix",
+            [](const PackedDensityMatrix& state) -> Eigen::MatrixXcd {
+                Eigen::MatrixXcd mat(state.dim, state.dim);
+                CTYPE* ptr = state.duplicate_data_c();
+                for (ITYPE y = 0; y < state.dim; ++y) {
+                    for (ITYPE x = 0; x < state.dim; ++x) {
+                        mat(y, x) = ptr[y * state.dim + x];
+                    }
+                }
+                free(ptr);
+                return mat;
+            },
+            "Get density matrix")
+        .def(
+            "get_qubit_count",
+            [](const PackedDensityMatrix& state) -> UINT {
+                return state.qubit_count;
+            },
+            "Get qubit count")
+        .def(
+            "__str__",
+            [](const PackedDensityMatrix& p) { return p.to_string(); },
+            "to string")
+        .def(
+            "to_json",
+            [](const PackedDensityMatrix& state) -> std::string {
+                return ptree::to_json(state.to_ptree());
+            },
+            "to json string")
+        .def(py::pickle(
+            [](const PackedDensityMatrix& state) -> std::string {
+                return ptree::to_json(state.to_ptree());
+            },
+            [](std::string json) -> PackedDensityMatrix* {
+                return static_cast<PackedDensityMatrix*>(
+                    state::from_ptree(ptree::from_json(json)));
+            }));
+
 #ifdef _USE_GPU
     py::class_<QuantumStateGpu, QuantumStateBase>(m, "QuantumStateGpu")
         .def(py::init<UINT>(), "Constructor", py::arg("qubit_count"))
@@ -657,6 +1000,11 @@ PYBIND11_MODULE(qulacs_core, m) {
             &state::partial_trace),
         py::return_value_policy::take_ownership, py::arg("state"),
         py::arg("target_traceout"));
+    mstate.def("partial_trace",
+        py::overload_cast<const PackedDensityMatrix*, std::vector<UINT>>(
+            &state::partial_trace),
+        py::return_value_policy::take_ownership, py::arg("state"),
+        py::arg("target_traceout"));
     mstate.def("make_superposition", &state::make_superposition,
         py::return_value_policy::take_ownership,
         "Create superposition of states", py::arg("coef1"), py::arg("state1"),
@@ -1146,6 +1494,22 @@ PYBIND11_MODULE(qulacs_core, m) {
             (void (QuantumCircuit::*)(QuantumStateBase*, UINT, UINT)) &
                 QuantumCircuit::update_quantum_state,
             py::arg("state"), py::arg("start"), py::arg("end"))
+        .def("set_fusion_max_block_size",
+            &QuantumCircuit::set_fusion_max_block_size,
+            "Set maximum qubit count of fused gates (0 disables gate fusion)",
+            py::arg("max_block_size"))
+        .def("get_fusion_max_block_size",
+            &QuantumCircuit::get_fusion_max_block_size,
+            "Get maximum qubit count of fused gates")
+        .def("get_fused_gate_count", &QuantumCircuit::get_fused_gate_count,
+            "Get gate count after gate fusion")
+        .def("set_cache_blocking_qubit_count",
+            &QuantumCircuit::set_cache_blocking_qubit_count,
+            "Set qubit count of cache-blocked execution (0 disables it)",
+            py::arg("block_qubit_count"))
+        .def("get_cache_blocking_qubit_count",
+            &QuantumCircuit::get_cache_blocking_qubit_count,
+            "Get qubit count of cache-blocked execution")
         .def("calculate_depth", &QuantumCircuit::calculate_depth,
             "Calculate depth of circuit")
         .def("to_string", &QuantumCircuit::to_string,
@@ -1331,6 +1695,28 @@ PYBIND11_MODULE(qulacs_core, m) {
         .def("backprop_inner_product",
             &ParametricQuantumCircuit::backprop_inner_product,
             "Do backprop with innder product", py::arg("state"))
+        .def(
+            "evaluate_batch",
+            [](ParametricQuantumCircuit& circuit,
+                const Eigen::Ref<const Eigen::Matrix<double, Eigen::Dynamic,
+                    Eigen::Dynamic, Eigen::RowMajor>>& theta_matrix,
+                const GeneralQuantumOperator& observable) {
+                std::vector<std::vector<double>> theta_list(
+                    theta_matrix.rows());
+                for (Eigen::Index i = 0; i < theta_matrix.rows(); ++i) {
+                    theta_list[i].assign(theta_matrix.row(i).data(),
+                        theta_matrix.row(i).data() + theta_matrix.cols());
+                }
+                std::vector<double> result;
+                {
+                    py::gil_scoped_release release;
+                    result = circuit.evaluate_batch(theta_list, observable);
+                }
+                return Eigen::VectorXd(
+                    Eigen::Map<Eigen::VectorXd>(result.data(), result.size()));
+            },
+            "Evaluate expectation values for rows of parameters in parallel",
+            py::arg("theta_matrix"), py::arg("observable"))
 
         .def(
             "__str__",
@@ -1356,6 +1742,17 @@ PYBIND11_MODULE(qulacs_core, m) {
             py::overload_cast<ParametricQuantumCircuit&, Observable&,
                 std::vector<double>>(&GradCalculator::calculate_grad),
             py::arg("parametric_circuit"), py::arg("observable"),
+            py::arg("angles_of_gates"))
+        .def("calculate_energy_and_grad",
+            py::overload_cast<ParametricQuantumCircuit&, Observable&>(
+                &GradCalculator::calculate_energy_and_grad),
+            "Calculate energy and grad by adjoint method",
+            py::arg("parametric_circuit"), py::arg("observable"))
+        .def("calculate_energy_and_grad",
+            py::overload_cast<ParametricQuantumCircuit&, Observable&,
+                std::vector<double>>(
+                &GradCalculator::calculate_energy_and_grad),
+            py::arg("parametric_circuit"), py::arg("observable"),
             py::arg("angles_of_gates"));
 
     auto mcircuit = m.def_submodule("circuit");
@@ -1424,7 +1821,12 @@ PYBIND11_MODULE(qulacs_core, m) {
             &CausalConeSimulator::get_pauli_operator_list,
             "Return pauli_operator_list")
         .def("get_coef_list", &CausalConeSimulator::get_coef_list,
-            "Return coef_list");
+            "Return coef_list")
+        .def("set_parameter", &CausalConeSimulator::set_parameter,
+            "Set parameter value without building the cones again",
+            py::arg("index"), py::arg("value"))
+        .def("get_cone_count", &CausalConeSimulator::get_cone_count,
+            "Return the number of distinct cones");
 
     py::class_<NoiseSimulator::Result>(m, "SimulationResult")
         .def(
@@ -1451,6 +1853,54 @@ PYBIND11_MODULE(qulacs_core, m) {
         .def("execute", &NoiseSimulator::execute,
             "Sampling & Return result [array]",
             py::return_value_policy::take_ownership)
+        .def("execute_streaming", &NoiseSimulator::execute_streaming,
+            "Sampling & Pass result of each trajectory to callback [array]",
+            py::arg("sample_count"), py::arg("process_samples"))
         .def("execute_and_get_result", &NoiseSimulator::execute_and_get_result,
-            "Simulate & Return ressult [array of (state, frequency)]");
+            "Simulate & Return ressult [array of (state, frequency)]")
+        .def("execute_parallel", &NoiseSimulator::execute_parallel,
+            "Sampling with trajectories in parallel & Return result [array]",
+            py::arg("sample_count"))
+        .def("get_checkpoint_memory_budget",
+            &NoiseSimulator::get_checkpoint_memory_budget,
+            "Get memory budget in bytes of states kept to reuse shared noise "
+            "histories")
+        .def("set_checkpoint_memory_budget",
+            &NoiseSimulator::set_checkpoint_memory_budget,
+            "Set memory budget in bytes of states kept to reuse shared noise "
+            "histories",
+            py::arg("budget_bytes"));
+
+    py::class_<PauliFrameSimulator>(m, "PauliFrameSimulator")
+        .def(py::init<QuantumCircuit*, QuantumState*>(), "Constructor",
+            py::arg("circuit"), py::arg("initial_state"))
+        .def(py::init<QuantumCircuit*>(), "Constructor", py::arg("circuit"))
+        .def("execute", &PauliFrameSimulator::execute,
+            "Sampling & Return result [array]", py::arg("sample_count"))
+        .def_static("is_supported", &PauliFrameSimulator::is_supported,
+            "Check if circuit consists of Clifford gates and Pauli noises",
+            py::arg("circuit"))
+        .def("set_seed", &PauliFrameSimulator::set_seed, "Set random seed",
+            py::arg("seed"));
+
+    py::class_<TrajectoryEnsemble::Result>(m, "TrajectoryEnsembleResult")
+        .def_readonly("mean", &TrajectoryEnsemble::Result::mean,
+            "Mean of expectation values over trajectories")
+        .def_readonly("standard_error",
+            &TrajectoryEnsemble::Result::standard_error,
+            "Standard error of the mean")
+        .def_readonly("trajectory_count",
+            &TrajectoryEnsemble::Result::trajectory_count,
+            "Number of simulated trajectories");
+
+    py::class_<TrajectoryEnsemble>(m, "TrajectoryEnsemble")
+        .def(py::init<QuantumCircuit*, QuantumState*>(), "Constructor",
+            py::arg("circuit"), py::arg("initial_state"))
+        .def(py::init<QuantumCircuit*>(), "Constructor", py::arg("circuit"))
+        .def("estimate", &TrajectoryEnsemble::estimate,
+            "Estimate expectation value by averaging trajectories in parallel",
+            py::arg("observable"), py::arg("max_trajectory_count"),
+            py::arg("target_standard_error") = 0., py::arg("batch_size") = 100)
+        .def("set_seed", &TrajectoryEnsemble::set_seed, "Set random seed",
+            py::arg("seed"));
 }
@@ -6,6 +6,8 @@
 
 #include <algorithm>
 #include <cassert>
+#include <csim/update_ops.hpp>
+#include <csim/update_ops_dm.hpp>
 #include <cstring>
 #include <sstream>
 #include <stdexcept>
@@ -14,12 +16,245 @@
 #include "gate.hpp"
 #include "gate_factory.hpp"
 #include "gate_matrix.hpp"
+#include "gate_matrix_diagonal.hpp"
+#include "gate_merge.hpp"
+#include "gate_named_one.hpp"
+#include "gate_named_pauli.hpp"
+#include "gate_named_two.hpp"
 #include "observable.hpp"
 #include "pauli_operator.hpp"
+#include "state.hpp"
 
 bool check_gate_index(
     const QuantumCircuit* circuit, const QuantumGateBase* gate);
 
+// Only gates with a deterministic, state-independent matrix are fused.
+// Parametric gates are excluded since their matrices change after fusion.
+bool QuantumCircuit::is_fusable_gate(const QuantumGateBase* gate) {
+    if (gate->is_parametric()) return false;
+    return dynamic_cast<const ClsOneQubitGate*>(gate) != nullptr ||
+           dynamic_cast<const ClsOneQubitRotationGate*>(gate) != nullptr ||
+           dynamic_cast<const ClsTwoQubitGate*>(gate) != nullptr ||
+           dynamic_cast<const ClsOneControlOneTargetGate*>(gate) != nullptr ||
+           dynamic_cast<const ClsPauliGate*>(gate) != nullptr ||
+           dynamic_cast<const ClsPauliRotationGate*>(gate) != nullptr ||
+           dynamic_cast<const QuantumGateMatrix*>(gate) != nullptr ||
+           dynamic_cast<const QuantumGateDiagonalMatrix*>(gate) != nullptr;
+}
+
+// Gate applying a run of low-qubit gates with
+// multi_gate_blocked_dense_matrix_gate. Only used inside of the fused gate
+// list of QuantumCircuit.
+class ClsBlockedGateBatch : public QuantumGateBase {
+private:
+    UINT _block_qubit_count;
+    std::vector<UINT> _control_qubit_index_count_list;
+    std::vector<UINT> _control_qubit_index_list;
+    std::vector<UINT> _control_value_list;
+    std::vector<UINT> _target_qubit_index_count_list;
+    std::vector<UINT> _target_qubit_index_list;
+    std::vector<CPPCTYPE> _matrix_list;
+
+public:
+    ClsBlockedGateBatch(const std::vector<QuantumGateBase*>& gate_list,
+        UINT block_qubit_count)
+        : _block_qubit_count(block_qubit_count) {
+        this->_name = "BlockedGateBatch";
+        std::vector<bool> is_used(block_qubit_count, false);
+        for (const auto& gate : gate_list) {
+            auto target_index_list = gate->get_target_index_list();
+            auto control_index_list = gate->get_control_index_list();
+            auto control_value_list = gate->get_control_value_list();
+            this->_target_qubit_index_count_list.push_back(
+                (UINT)target_index_list.size());
+            this->_target_qubit_index_list.insert(
+                this->_target_qubit_index_list.end(),
+                target_index_list.begin(), target_index_list.end());
+            this->_control_qubit_index_count_list.push_back(
+                (UINT)control_index_list.size());
+            this->_control_qubit_index_list.insert(
+                this->_control_qubit_index_list.end(),
+                control_index_list.begin(), control_index_list.end());
+            this->_control_value_list.insert(this->_control_value_list.end(),
+                control_value_list.begin(), control_value_list.end());
+            ComplexMatrix matrix;
+            gate->set_matrix(matrix);
+            this->_matrix_list.insert(this->_matrix_list.end(), matrix.data(),
+                matrix.data() + matrix.size());
+            for (auto index : target_index_list) is_used[index] = true;
+            for (auto index : control_index_list) is_used[index] = true;
+        }
+        for (UINT index = 0; index < block_qubit_count; ++index) {
+            if (is_used[index])
+                this->_target_qubit_list.push_back(TargetQubitInfo(index, 0));
+        }
+    }
+
+    virtual void update_quantum_state(QuantumStateBase* state) override {
+        multi_gate_blocked_dense_matrix_gate(
+            (UINT)this->_target_qubit_index_count_list.size(),
+            this->_control_qubit_index_count_list.data(),
+            this->_control_qubit_index_list.data(),
+            this->_control_value_list.data(),
+            this->_target_qubit_index_count_list.data(),
+            this->_target_qubit_index_list.data(),
+            reinterpret_cast<const CTYPE*>(this->_matrix_list.data()),
+            this->_block_qubit_count, state->data_c(), state->dim);
+    }
+
+    virtual ClsBlockedGateBatch* copy() const override {
+        return new ClsBlockedGateBatch(*this);
+    }
+
+    virtual void set_matrix(ComplexMatrix&) const override {
+        throw NotImplementedException(
+            "Error: ClsBlockedGateBatch::set_matrix(ComplexMatrix&): "
+            "gate matrix of blocked gate batch is not supported");
+    }
+};
+
+// Gate applying U rho U^dagger of a fusable gate to a density matrix with
+// dm_multi_qubit_control_multi_qubit_dense_matrix_gate_tiled. The matrix is
+// taken once when the gate is built. Only used inside of the density-matrix
+// gate list of QuantumCircuit.
+class ClsDensityMatrixTiledGate : public QuantumGateBase {
+private:
+    std::vector<UINT> _target_qubit_index_list;
+    std::vector<UINT> _control_qubit_index_list;
+    std::vector<UINT> _control_value_list;
+    std::vector<CPPCTYPE> _matrix;
+
+public:
+    explicit ClsDensityMatrixTiledGate(const QuantumGateBase* gate)
+        : _target_qubit_index_list(gate->get_target_index_list()),
+          _control_qubit_index_list(gate->get_control_index_list()),
+          _control_value_list(gate->get_control_value_list()) {
+        this->_name = "DensityMatrixTiledGate";
+        this->_target_qubit_list = gate->target_qubit_list;
+        this->_control_qubit_list = gate->control_qubit_list;
+        ComplexMatrix matrix;
+        gate->set_matrix(matrix);
+        this->_matrix.assign(matrix.data(), matrix.data() + matrix.size());
+    }
+
+    virtual void update_quantum_state(QuantumStateBase* state) override {
+        dm_multi_qubit_control_multi_qubit_dense_matrix_gate_tiled(
+            this->_control_qubit_index_list.data(),
+            this->_control_value_list.data(),
+            (UINT)this->_control_qubit_index_list.size(),
+            this->_target_qubit_index_list.data(),
+            (UINT)this->_target_qubit_index_list.size(),
+            reinterpret_cast<const CTYPE*>(this->_matrix.data()),
+            state->data_c(), state->dim);
+    }
+
+    virtual ClsDensityMatrixTiledGate* copy() const override {
+        return new ClsDensityMatrixTiledGate(*this);
+    }
+
+    virtual void set_matrix(ComplexMatrix& matrix) const override {
+        const Eigen::Index matrix_dim =
+            (Eigen::Index)1 << this->_target_qubit_index_list.size();
+        matrix = Eigen::Map<const ComplexMatrix>(
+            this->_matrix.data(), matrix_dim, matrix_dim);
+    }
+};
+
+// Pauli, Pauli-rotation and diagonal gates keep their own density-matrix
+// kernels, which are cheaper than a dense matrix applied from both sides,
+// and gates wider than the fusion block are not made dense either.
+static bool is_density_matrix_tiled_gate(
+    const QuantumGateBase* gate, UINT max_block_size) {
+    if (!QuantumCircuit::is_fusable_gate(gate)) return false;
+    if (dynamic_cast<const ClsPauliGate*>(gate) != nullptr ||
+        dynamic_cast<const ClsPauliRotationGate*>(gate) != nullptr ||
+        dynamic_cast<const QuantumGateDiagonalMatrix*>(gate) != nullptr) {
+        return false;
+    }
+    return gate->get_target_index_list().size() +
+               gate->get_control_index_list().size() <=
+           max_block_size;
+}
+
+// Greedily collect consecutive fusable gates while the union of their qubits
+// fits in max_block_size, and flush them as one gate. The gates created here
+// are also appended to owned_gate_list.
+static void fuse_gate_list(const std::vector<QuantumGateBase*>& gate_list,
+    UINT max_block_size, std::vector<QuantumGateBase*>& fused_gate_list,
+    std::vector<QuantumGateBase*>& owned_gate_list) {
+    std::vector<QuantumGateBase*> block;
+    std::vector<UINT> block_qubits;
+    auto flush_block = [&]() {
+        if (block.size() == 1) {
+            fused_gate_list.push_back(block[0]);
+        } else if (block.size() > 1) {
+            QuantumGateMatrix* merged_gate = gate::merge(block);
+            QuantumGateBase* fused_gate = merged_gate;
+            if (merged_gate->is_diagonal()) {
+                ComplexMatrix matrix;
+                merged_gate->set_matrix(matrix);
+                ComplexVector diagonal_element = matrix.diagonal();
+                fused_gate = new QuantumGateDiagonalMatrix(
+                    merged_gate->target_qubit_list, diagonal_element,
+                    merged_gate->control_qubit_list);
+                delete merged_gate;
+            }
+            fused_gate_list.push_back(fused_gate);
+            owned_gate_list.push_back(fused_gate);
+        }
+        block.clear();
+        block_qubits.clear();
+    };
+
+    for (const auto& gate : gate_list) {
+        if (!QuantumCircuit::is_fusable_gate(gate)) {
+            flush_block();
+            fused_gate_list.push_back(gate);
+            continue;
+        }
+        std::vector<UINT> merged_qubits = block_qubits;
+        for (auto index : gate->get_target_index_list())
+            merged_qubits.push_back(index);
+        for (auto index : gate->get_control_index_list())
+            merged_qubits.push_back(index);
+        std::sort(merged_qubits.begin(), merged_qubits.end());
+        merged_qubits.erase(
+            std::unique(merged_qubits.begin(), merged_qubits.end()),
+            merged_qubits.end());
+
+        if (merged_qubits.size() > max_block_size) {
+            flush_block();
+            merged_qubits = gate->get_target_index_list();
+            for (auto index : gate->get_control_index_list())
+                merged_qubits.push_back(index);
+            std::sort(merged_qubits.begin(), merged_qubits.end());
+            // a gate larger than the block size is applied as it is
+            if (merged_qubits.size() > max_block_size) {
+                fused_gate_list.push_back(gate);
+                continue;
+            }
+        }
+        block.push_back(gate);
+        block_qubits.swap(merged_qubits);
+    }
+    flush_block();
+}
+
+// States which apply the gates by themselves reject unsupported gates
+// before the state is modified.
+static void check_gates_applied_by_state(const QuantumStateBase* state,
+    const std::vector<QuantumGateBase*>& gate_list, UINT start, UINT end) {
+    for (UINT cursor = start; cursor < end; ++cursor) {
+        if (!state->is_supported_gate(gate_list[cursor])) {
+            throw NotImplementedException(
+                "Error: QuantumCircuit::update_quantum_state("
+                "QuantumStateBase*): " +
+                gate_list[cursor]->get_name() +
+                " gate cannot be applied to this state");
+        }
+    }
+}
+
 void QuantumCircuit::update_quantum_state(QuantumStateBase* state) {
     if (state->qubit_count != this->qubit_count) {
         throw InvalidQubitCountException(
@@ -28,6 +263,40 @@ void QuantumCircuit::update_quantum_state(QuantumStateBase* state) {
             "invalid qubit count");
     }
 
+    // single-precision, stabilizer, matrix product and packed states apply
+    // the gates by themselves
+    if (state->is_gate_applied_by_state()) {
+        check_gates_applied_by_state(
+            state, this->_gate_list, 0, (UINT)this->_gate_list.size());
+        for (const auto& gate : this->_gate_list) {
+            state->apply_gate(gate);
+        }
+        return;
+    }
+
+    // with fusion, density matrices on CPU apply the cached matrices of the
+    // fused gates from both sides in one sweep
+    if (this->_fusion_max_block_size >= 2 && !state->is_state_vector() &&
+        state->get_device_name() == "cpu") {
+        if (!this->_is_density_matrix_gate_list_valid) {
+            this->build_density_matrix_gate_list();
+        }
+        for (const auto& gate : this->_density_matrix_gate_list) {
+            gate->update_quantum_state(state);
+        }
+        return;
+    }
+
+    // fused diagonal gates are only supported by state vectors on CPU
+    if (this->is_fused_gate_list_enabled() && state->is_state_vector() &&
+        state->get_device_name() == "cpu") {
+        if (!this->_is_fused_gate_list_valid) this->build_fused_gate_list();
+        for (const auto& gate : this->_fused_gate_list) {
+            gate->update_quantum_state(state);
+        }
+        return;
+    }
+
     for (const auto& gate : this->_gate_list) {
         gate->update_quantum_state(state);
     }
@@ -53,6 +322,13 @@ void QuantumCircuit::update_quantum_state(
             "QuantumCircuit::update_quantum_state(QuantumStateBase,UINT,"
             "UINT) : end must be smaller than or equal to gate_count");
     }
+    if (state->is_gate_applied_by_state()) {
+        check_gates_applied_by_state(state, this->_gate_list, start, end);
+        for (UINT cursor = start; cursor < end; ++cursor) {
+            state->apply_gate(this->_gate_list[cursor]);
+        }
+        return;
+    }
     for (UINT cursor = start; cursor < end; ++cursor) {
         this->_gate_list[cursor]->update_quantum_state(state);
     }
@@ -65,6 +341,8 @@ QuantumCircuit::QuantumCircuit(const QuantumCircuit& obj)
     for (UINT i = 0; i < obj.gate_list.size(); ++i) {
         _gate_list.push_back(obj.gate_list[i]->copy());
     }
+    _fusion_max_block_size = obj._fusion_max_block_size;
+    _cache_blocking_qubit_count = obj._cache_blocking_qubit_count;
 };
 
 QuantumCircuit::QuantumCircuit(UINT qubit_count_)
@@ -77,9 +355,149 @@ QuantumCircuit* QuantumCircuit::copy() const {
     for (const auto& gate : this->_gate_list) {
         new_circuit->add_gate(gate->copy());
     }
+    new_circuit->_fusion_max_block_size = this->_fusion_max_block_size;
+    new_circuit->_cache_blocking_qubit_count =
+        this->_cache_blocking_qubit_count;
     return new_circuit;
 }
 
+bool QuantumCircuit::is_fused_gate_list_enabled() const {
+    return this->_fusion_max_block_size >= 2 ||
+           this->_cache_blocking_qubit_count > 0;
+}
+
+void QuantumCircuit::clear_fused_gate_list() {
+    for (auto& gate : this->_fused_gate_owned_list) {
+        delete gate;
+    }
+    this->_fused_gate_owned_list.clear();
+    this->_fused_gate_list.clear();
+    this->_is_fused_gate_list_valid = false;
+}
+
+void QuantumCircuit::clear_density_matrix_gate_list() {
+    for (auto& gate : this->_density_matrix_gate_owned_list) {
+        delete gate;
+    }
+    this->_density_matrix_gate_owned_list.clear();
+    this->_density_matrix_gate_list.clear();
+    this->_is_density_matrix_gate_list_valid = false;
+}
+
+void QuantumCircuit::build_fused_gate_list() {
+    this->clear_fused_gate_list();
+    fuse_gate_list(this->_gate_list, this->_fusion_max_block_size,
+        this->_fused_gate_list, this->_fused_gate_owned_list);
+
+    if (this->_cache_blocking_qubit_count > 0 &&
+        this->_qubit_count > this->_cache_blocking_qubit_count) {
+        this->build_blocked_gate_batch();
+    }
+    this->_is_fused_gate_list_valid = true;
+}
+
+void QuantumCircuit::build_density_matrix_gate_list() {
+    this->clear_density_matrix_gate_list();
+    std::vector<QuantumGateBase*> fused_gate_list, fused_gate_owned_list;
+    fuse_gate_list(this->_gate_list, this->_fusion_max_block_size,
+        fused_gate_list, fused_gate_owned_list);
+    for (const auto& gate : fused_gate_list) {
+        if (!is_density_matrix_tiled_gate(
+                gate, this->_fusion_max_block_size)) {
+            this->_density_matrix_gate_list.push_back(gate);
+            continue;
+        }
+        QuantumGateBase* tiled_gate = new ClsDensityMatrixTiledGate(gate);
+        this->_density_matrix_gate_list.push_back(tiled_gate);
+        this->_density_matrix_gate_owned_list.push_back(tiled_gate);
+    }
+    // fused gates which are applied as they are stay alive with the list
+    for (auto& gate : fused_gate_owned_list) {
+        if (std::find(this->_density_matrix_gate_list.begin(),
+                this->_density_matrix_gate_list.end(),
+                gate) == this->_density_matrix_gate_list.end()) {
+            delete gate;
+        } else {
+            this->_density_matrix_gate_owned_list.push_back(gate);
+        }
+    }
+    this->_is_density_matrix_gate_list_valid = true;
+}
+
+void QuantumCircuit::build_blocked_gate_batch() {
+    // Collect runs of gates acting only on qubits smaller than
+    // _cache_blocking_qubit_count, and replace each run with a single batch.
+    const UINT block_qubit_count = this->_cache_blocking_qubit_count;
+    auto is_low_qubit_gate = [block_qubit_count](const QuantumGateBase* gate) {
+        if (!is_fusable_gate(gate)) return false;
+        for (auto index : gate->get_target_index_list())
+            if (index >= block_qubit_count) return false;
+        for (auto index : gate->get_control_index_list())
+            if (index >= block_qubit_count) return false;
+        return true;
+    };
+
+    std::vector<QuantumGateBase*> new_gate_list;
+    std::vector<QuantumGateBase*> run;
+    auto flush_run = [&]() {
+        if (run.size() == 1) {
+            new_gate_list.push_back(run[0]);
+        } else if (run.size() > 1) {
+            QuantumGateBase* batch =
+                new ClsBlockedGateBatch(run, block_qubit_count);
+            new_gate_list.push_back(batch);
+            this->_fused_gate_owned_list.push_back(batch);
+            // matrices are copied to the batch, so owned gates are released
+            for (auto gate : run) {
+                auto ite = std::find(this->_fused_gate_owned_list.begin(),
+                    this->_fused_gate_owned_list.end(), gate);
+                if (ite != this->_fused_gate_owned_list.end()) {
+                    delete gate;
+                    this->_fused_gate_owned_list.erase(ite);
+                }
+            }
+        }
+        run.clear();
+    };
+    for (const auto& gate : this->_fused_gate_list) {
+        if (is_low_qubit_gate(gate)) {
+            run.push_back(gate);
+        } else {
+            flush_run();
+            new_gate_list.push_back(gate);
+        }
+    }
+    flush_run();
+    this->_fused_gate_list.swap(new_gate_list);
+}
+
+void QuantumCircuit::set_fusion_max_block_size(UINT max_block_size) {
+    this->clear_fused_gate_list();
+    this->clear_density_matrix_gate_list();
+    this->_fusion_max_block_size = (max_block_size >= 2) ? max_block_size : 0;
+}
+
+UINT QuantumCircuit::get_fusion_max_block_size() const {
+    return this->_fusion_max_block_size;
+}
+
+void QuantumCircuit::set_cache_blocking_qubit_count(UINT block_qubit_count) {
+    this->clear_fused_gate_list();
+    this->_cache_blocking_qubit_count = block_qubit_count;
+}
+
+UINT QuantumCircuit::get_cache_blocking_qubit_count() const {
+    return this->_cache_blocking_qubit_count;
+}
+
+UINT QuantumCircuit::get_fused_gate_count() {
+    if (!this->is_fused_gate_list_enabled()) {
+        return (UINT)this->_gate_list.size();
+    }
+    if (!this->_is_fused_gate_list_valid) this->build_fused_gate_list();
+    return (UINT)this->_fused_gate_list.size();
+}
+
 bool check_gate_index(
     const QuantumCircuit* circuit, const QuantumGateBase* gate) {
     auto vec1 = gate->get_target_index_list();
@@ -102,6 +520,8 @@ void QuantumCircuit::add_gate(QuantumGateBase* gate) {
             "applied to qubits of which the indices are smaller than "
             "qubit_count");
     }
+    this->clear_fused_gate_list();
+    this->clear_density_matrix_gate_list();
     this->_gate_list.push_back(gate);
 }
 
@@ -117,6 +537,8 @@ void QuantumCircuit::add_gate(QuantumGateBase* gate, UINT index) {
             "Error: QuantumCircuit::add_gate(QuantumGateBase*, UINT) : "
             "insert index must be smaller than or equal to gate_count");
     }
+    this->clear_fused_gate_list();
+    this->clear_density_matrix_gate_list();
     this->_gate_list.insert(this->_gate_list.begin() + index, gate);
 }
 
@@ -217,11 +639,15 @@ void QuantumCircuit::remove_gate(UINT index) {
             "Error: QuantumCircuit::remove_gate(UINT) : index must be "
             "smaller than gate_count");
     }
+    this->clear_fused_gate_list();
+    this->clear_density_matrix_gate_list();
     delete this->_gate_list[index];
     this->_gate_list.erase(this->_gate_list.begin() + index);
 }
 
 QuantumCircuit::~QuantumCircuit() {
+    this->clear_fused_gate_list();
+    this->clear_density_matrix_gate_list();
     for (auto& gate : this->_gate_list) {
         delete gate;
     }
@@ -31,6 +31,26 @@ protected:
     std::vector<QuantumGateBase*> _gate_list;
     UINT _qubit_count;
 
+    // gate fusion cache (see set_fusion_max_block_size and
+    // set_cache_blocking_qubit_count)
+    UINT _fusion_max_block_size = 0;
+    UINT _cache_blocking_qubit_count = 0;
+    bool _is_fused_gate_list_valid = false;
+    std::vector<QuantumGateBase*> _fused_gate_list;
+    std::vector<QuantumGateBase*> _fused_gate_owned_list;
+    // gates applied to density matrices on CPU with fusion, built in the same
+    // way as the fused gate list
+    bool _is_density_matrix_gate_list_valid = false;
+    std::vector<QuantumGateBase*> _density_matrix_gate_list;
+    std::vector<QuantumGateBase*> _density_matrix_gate_owned_list;
+
+    bool is_fused_gate_list_enabled() const;
+    void build_fused_gate_list();
+    void build_blocked_gate_batch();
+    void clear_fused_gate_list();
+    void build_density_matrix_gate_list();
+    void clear_density_matrix_gate_list();
+
     // prohibit shallow copy
     QuantumCircuit(const QuantumCircuit& obj);
     QuantumCircuit& operator=(const QuantumCircuit&) = delete;
@@ -55,6 +75,16 @@ public:
      */
     QuantumCircuit* copy() const;
 
+    /**
+     * \~japanese-en ゲートが融合の対象となるかを判定する
+     *
+     * 行列が状態によらず定まり、パラメータで変化しないゲートが対象となる。
+     * ノイズや測定などのランダムなゲートは対象とならない。
+     * @param[in] gate 判定するゲート
+     * @return 融合の対象であればtrue
+     */
+    static bool is_fusable_gate(const QuantumGateBase* gate);
+
     /**
      * \~japanese-en デストラクタ
      */
@@ -165,6 +195,63 @@ public:
     void update_quantum_state(
         QuantumStateBase* state, UINT start_index, UINT end_index);
 
+    /**
+     * \~japanese-en ゲート融合の最大ブロックサイズを設定する
+     *
+     * 2以上を設定すると、update_quantum_state(QuantumStateBase*)
+     * は連続するゲートのうち作用する量子ビットの合計がmax_block_size以下となるものを
+     * gate::merge で一つの密行列(全て対角であれば対角行列)ゲートに融合してから作用する。
+     * 状態ベクトルを走査する回数がゲート数から融合後のゲート数に減る。
+     * 融合結果は回路ごとにキャッシュされ、add_gate/remove_gate で破棄される。
+     * パラメトリックゲートやノイズ、測定などのゲートは融合されない。
+     * 融合はCPU上の状態ベクトルと密度行列に対して行われる。密度行列では
+     * 融合後のゲートの行列をキャッシュし、行のタイルごとに左右から掛けることで
+     * 密度行列を一度だけ走査する。パウリゲート、パウリ回転ゲート、対角行列ゲート
+     * およびmax_block_sizeより多くの量子ビットに作用するゲートは、
+     * それぞれのゲートの密度行列用の処理で作用する。
+     * gate_list を通してゲートを直接書き換えた場合はもう一度本関数を呼ぶこと。
+     * @param[in] max_block_size 融合後のゲートが作用する最大量子ビット数。0
+     * または1で融合を無効にする。
+     */
+    void set_fusion_max_block_size(UINT max_block_size);
+
+    /**
+     * \~japanese-en ゲート融合の最大ブロックサイズを取得する
+     *
+     * @return 最大ブロックサイズ。0の場合は融合が無効
+     */
+    UINT get_fusion_max_block_size() const;
+
+    /**
+     * \~japanese-en 融合後のゲート数を取得する
+     *
+     * update_quantum_state(QuantumStateBase*)
+     * が状態ベクトルを走査する回数に等しい。融合が無効な場合はゲート数を返す。
+     * @return 融合後のゲート数
+     */
+    UINT get_fused_gate_count();
+
+    /**
+     * \~japanese-en キャッシュブロッキングの量子ビット数を設定する
+     *
+     * 1以上を設定すると、update_quantum_state(QuantumStateBase*)
+     * は作用する量子ビットが全て block_qubit_count
+     * 未満である連続したゲート(融合後のゲート)をまとめ、状態ベクトルを
+     * 2^block_qubit_count
+     * 要素のブロックごとに全てのゲートを作用させる。ブロックがキャッシュに収まる大きさであれば、
+     * まとめたゲート全体で状態ベクトルをメモリから一度だけ読み込む。
+     * 量子ビット数が block_qubit_count 以下の回路では何もしない。
+     * @param[in] block_qubit_count ブロックの量子ビット数。0で無効にする。
+     */
+    void set_cache_blocking_qubit_count(UINT block_qubit_count);
+
+    /**
+     * \~japanese-en キャッシュブロッキングの量子ビット数を取得する
+     *
+     * @return ブロックの量子ビット数。0の場合は無効
+     */
+    UINT get_cache_blocking_qubit_count() const;
+
     /////////////////////////////// CHECK PROPERTY OF QUANTUM CIRCUIT
 
     /**
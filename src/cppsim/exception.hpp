@@ -318,6 +318,20 @@ public:
         : std::domain_error(message) {}
 };
 
+/**
+ * \~japanese-en 行列積状態の打ち切りの設定が不適切という例外
+ */
+class InvalidTruncationParameterException : public std::domain_error {
+public:
+    /**
+     * \~japanese-en コンストラクタ
+     *
+     * @param message エラーメッセージ
+     */
+    InvalidTruncationParameterException(const std::string& message)
+        : std::domain_error(message) {}
+};
+
 /**
  * \~japanese-en ファイルを開くのに失敗した例外
  */
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <csim/stat_ops.hpp>
+#include <csim/update_ops.hpp>
+
 #include "gate.hpp"
 #include "gate_merge.hpp"
 #include "state.hpp"
@@ -13,6 +16,29 @@
  * ただし、和が1のProbabilistic においてのみ、　Identityなしで求めている
  */
 
+namespace gate {
+/**
+ * \~japanese-en
+ * Kraus演算子のリストを target_index_list 上の行列のリストに展開する。
+ *
+ * 各行列は行優先で並べられ、基底の順序は target_index_list に従う。
+ * 行列が得られないゲートや制御qubitを持つゲートを含む場合、
+ * または対象のqubitが多い場合は空のリストを返す。
+ */
+inline std::vector<CPPCTYPE> get_expanded_Kraus_matrix_list(
+    const std::vector<QuantumGateBase*>& gate_list,
+    const std::vector<UINT>& target_index_list);
+
+/**
+ * \~japanese-en
+ * 展開されたKraus演算子のうちindex番目をscale倍して状態に作用させる。
+ */
+inline void apply_expanded_Kraus_matrix(
+    const std::vector<CPPCTYPE>& matrix_list, UINT index,
+    const std::vector<UINT>& target_index_list, double scale,
+    QuantumStateCpu* state);
+}  // namespace gate
+
 /**
  * \~japanese-en 確率的なユニタリ操作
  */
@@ -209,11 +235,15 @@ public:
 
     virtual void set_seed(int seed) override { random.set_seed(seed); };
 
-    virtual std::vector<double> get_cumulative_distribution() {
+    virtual std::vector<double> get_cumulative_distribution() const {
         return _cumulative_distribution;
     };
-    virtual std::vector<double> get_distribution() { return _distribution; };
-    virtual std::vector<QuantumGateBase*> get_gate_list() { return _gate_list; }
+    virtual std::vector<double> get_distribution() const {
+        return _distribution;
+    };
+    virtual std::vector<QuantumGateBase*> get_gate_list() const {
+        return _gate_list;
+    }
     virtual void optimize_ProbablisticGate() {
         int n = (int)_gate_list.size();
         std::vector<std::pair<double, int>> itr;
@@ -250,6 +280,44 @@ protected:
     std::vector<QuantumGateBase*> _gate_list;
     bool is_instrument;
     UINT _classical_register_address;
+    //! Kraus operators expanded on the target qubits. Empty if they are not
+    //! available.
+    std::vector<CPPCTYPE> _Kraus_matrix_list;
+
+    /**
+     * \~japanese-en
+     * 全ての分岐の確率を一度の走査で計算し、選ばれたKraus演算子のみを作用させる
+     */
+    void _update_state_vector_by_Kraus_matrix_list(
+        QuantumStateCpu* state, double r) {
+        const auto target_index_list = this->get_target_index_list();
+        const UINT gate_count = (UINT)_gate_list.size();
+        std::vector<double> probability_list(gate_count);
+        const double org_norm = Kraus_operator_probabilities(
+            target_index_list.data(), (UINT)target_index_list.size(),
+            (const CTYPE*)_Kraus_matrix_list.data(), gate_count,
+            probability_list.data(), state->data_c(), state->dim);
+
+        double sum = 0.;
+        UINT index = 0;
+        for (; index < gate_count; ++index) {
+            const double norm = probability_list[index] / org_norm;
+            sum += norm;
+            if (r < sum) {
+                gate::apply_expanded_Kraus_matrix(_Kraus_matrix_list, index,
+                    target_index_list, 1. / sqrt(norm), state);
+                break;
+            }
+        }
+        if (!(r < sum)) {
+            std::cerr << "* Warning : CPTP-map was not trace preserving. "
+                         "Identity-map is applied."
+                      << std::endl;
+        }
+        if (is_instrument) {
+            state->set_classical_value(this->_classical_register_address, index);
+        }
+    }
 
 public:
     explicit QuantumGate_CPTP(std::vector<QuantumGateBase*> gate_list) {
@@ -277,6 +345,10 @@ public:
                 return a.index() < b.index();
             });
         is_instrument = false;
+        if (this->_control_qubit_list.empty()) {
+            _Kraus_matrix_list = gate::get_expanded_Kraus_matrix_list(
+                _gate_list, this->get_target_index_list());
+        }
     };
 
     explicit QuantumGate_CPTP(std::vector<QuantumGateBase*> gate_list,
@@ -301,6 +373,12 @@ public:
         if (state->is_state_vector()) {
             double r = random.uniform();
 
+            auto state_cpu = dynamic_cast<QuantumStateCpu*>(state);
+            if (state_cpu != nullptr && !_Kraus_matrix_list.empty()) {
+                this->_update_state_vector_by_Kraus_matrix_list(state_cpu, r);
+                return;
+            }
+
             double sum = 0.;
             double org_norm = state->get_squared_norm();
 
@@ -396,7 +474,11 @@ public:
         }
         return pt;
     }
-    virtual std::vector<QuantumGateBase*> get_gate_list() { return _gate_list; }
+    virtual void set_seed(int seed) override { random.set_seed(seed); };
+
+    virtual std::vector<QuantumGateBase*> get_gate_list() const {
+        return _gate_list;
+    }
 };
 
 /**
@@ -409,6 +491,47 @@ protected:
     const bool _state_normalize;
     const bool _probability_normalize;
     const bool _assign_zero_if_not_matched;
+    //! Kraus operators expanded on the target qubits. Empty if they are not
+    //! available.
+    std::vector<CPPCTYPE> _Kraus_matrix_list;
+
+    /**
+     * \~japanese-en
+     * 全ての分岐の確率を一度の走査で計算し、選ばれたKraus演算子のみを作用させる
+     */
+    void _update_state_vector_by_Kraus_matrix_list(
+        QuantumStateCpu* state, double r) {
+        const auto target_index_list = this->get_target_index_list();
+        const UINT gate_count = (UINT)_gate_list.size();
+        std::vector<double> probability_list(gate_count);
+        const double org_norm = Kraus_operator_probabilities(
+            target_index_list.data(), (UINT)target_index_list.size(),
+            (const CTYPE*)_Kraus_matrix_list.data(), gate_count,
+            probability_list.data(), state->data_c(), state->dim);
+
+        double probability_sum = 1.;
+        if (_probability_normalize) {
+            probability_sum = 0.;
+            for (UINT index = 0; index < gate_count; ++index) {
+                probability_sum += probability_list[index] / org_norm;
+            }
+        }
+
+        double sum = 0.;
+        for (UINT index = 0; index < gate_count; ++index) {
+            const double norm = probability_list[index] / org_norm;
+            sum += norm;
+            if (r * probability_sum < sum) {
+                const double scale = _state_normalize ? 1. / sqrt(norm) : 1.;
+                gate::apply_expanded_Kraus_matrix(
+                    _Kraus_matrix_list, index, target_index_list, scale, state);
+                return;
+            }
+        }
+        if (_assign_zero_if_not_matched) {
+            state->multiply_coef(CPPCTYPE(0.));
+        }
+    }
 
 public:
     explicit QuantumGate_CP(std::vector<QuantumGateBase*> gate_list,
@@ -440,6 +563,10 @@ public:
             [](const ControlQubitInfo& a, const ControlQubitInfo& b) {
                 return a.index() < b.index();
             });
+        if (this->_control_qubit_list.empty()) {
+            _Kraus_matrix_list = gate::get_expanded_Kraus_matrix_list(
+                _gate_list, this->get_target_index_list());
+        }
     };
     virtual ~QuantumGate_CP() {
         for (unsigned int i = 0; i < _gate_list.size(); ++i) {
@@ -456,6 +583,12 @@ public:
         if (state->is_state_vector()) {
             double r = random.uniform();
 
+            auto state_cpu = dynamic_cast<QuantumStateCpu*>(state);
+            if (state_cpu != nullptr && !_Kraus_matrix_list.empty()) {
+                this->_update_state_vector_by_Kraus_matrix_list(state_cpu, r);
+                return;
+            }
+
             double sum = 0.;
             double org_norm = state->get_squared_norm();
 
@@ -555,7 +688,11 @@ public:
         pt.put("assign_zero_if_not_matched", _assign_zero_if_not_matched);
         return pt;
     }
-    virtual std::vector<QuantumGateBase*> get_gate_list() { return _gate_list; }
+    virtual void set_seed(int seed) override { random.set_seed(seed); };
+
+    virtual std::vector<QuantumGateBase*> get_gate_list() const {
+        return _gate_list;
+    }
 };
 
 /**
@@ -647,6 +784,9 @@ public:
             return new QuantumGate_Adaptive(_gate, _func_with_id, _id);
         }
     };
+
+    virtual void set_seed(int seed) override { _gate->set_seed(seed); };
+
     /**
      * \~japanese-en 自身のゲート行列をセットする
      *
@@ -661,6 +801,79 @@ public:
     }
 };
 
+inline std::vector<CPPCTYPE> gate::get_expanded_Kraus_matrix_list(
+    const std::vector<QuantumGateBase*>& gate_list,
+    const std::vector<UINT>& target_index_list) {
+    // larger operators are applied faster by the gates themselves
+    const UINT max_target_count = 4;
+    const UINT target_count = (UINT)target_index_list.size();
+    if (target_count == 0 || target_count > max_target_count) return {};
+    const ITYPE matrix_dim = 1ULL << target_count;
+
+    std::vector<CPPCTYPE> matrix_list;
+    matrix_list.reserve(gate_list.size() * matrix_dim * matrix_dim);
+    for (auto gate : gate_list) {
+        // the maps in this file do not have their matrices
+        if (dynamic_cast<const QuantumGate_Probabilistic*>(gate) != nullptr ||
+            dynamic_cast<const QuantumGate_CPTP*>(gate) != nullptr ||
+            dynamic_cast<const QuantumGate_CP*>(gate) != nullptr ||
+            dynamic_cast<const QuantumGate_Adaptive*>(gate) != nullptr ||
+            !gate->get_control_index_list().empty()) {
+            return {};
+        }
+        ComplexMatrix matrix;
+        try {
+            gate->set_matrix(matrix);
+        } catch (const NotImplementedException&) {
+            return {};
+        }
+        // position in target_index_list of each target of the gate
+        const auto gate_target_list = gate->get_target_index_list();
+        std::vector<UINT> position_list;
+        ITYPE gate_mask = 0;
+        for (UINT target : gate_target_list) {
+            auto ite = std::find(
+                target_index_list.begin(), target_index_list.end(), target);
+            if (ite == target_index_list.end()) return {};
+            position_list.push_back((UINT)(ite - target_index_list.begin()));
+            gate_mask |= 1ULL << position_list.back();
+        }
+        if ((ITYPE)matrix.rows() != (1ULL << gate_target_list.size())) {
+            return {};
+        }
+
+        for (ITYPE y = 0; y < matrix_dim; ++y) {
+            for (ITYPE x = 0; x < matrix_dim; ++x) {
+                // identity on the qubits which the gate does not act on
+                if ((y ^ x) & ~gate_mask) {
+                    matrix_list.push_back(0.);
+                    continue;
+                }
+                ITYPE gate_y = 0, gate_x = 0;
+                for (UINT i = 0; i < position_list.size(); ++i) {
+                    gate_y |= ((y >> position_list[i]) & 1ULL) << i;
+                    gate_x |= ((x >> position_list[i]) & 1ULL) << i;
+                }
+                matrix_list.push_back(matrix(gate_y, gate_x));
+            }
+        }
+    }
+    return matrix_list;
+}
+
+inline void gate::apply_expanded_Kraus_matrix(
+    const std::vector<CPPCTYPE>& matrix_list, UINT index,
+    const std::vector<UINT>& target_index_list, double scale,
+    QuantumStateCpu* state) {
+    const ITYPE matrix_size = 1ULL << (2 * target_index_list.size());
+    std::vector<CPPCTYPE> matrix(matrix_list.begin() + index * matrix_size,
+        matrix_list.begin() + (index + 1) * matrix_size);
+    for (auto& value : matrix) value *= scale;
+    multi_qubit_dense_matrix_gate(target_index_list.data(),
+        (UINT)target_index_list.size(), (const CTYPE*)matrix.data(),
+        state->data_c(), state->dim);
+}
+
 /**
  * This type alias is kept for backward compatibility.
  * Do not edit this!
@@ -189,6 +189,13 @@ public:
         return new ClsPauliRotationGate(_angle, _pauli->copy());
     };
 
+    /**
+     * \~japanese-en 回転角を取得する
+     *
+     * @return 回転角
+     */
+    virtual double get_angle() const { return _angle; }
+
     /**
      * \~japanese-en 自身のゲート行列をセットする
      *
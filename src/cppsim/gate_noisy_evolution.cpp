@@ -239,11 +239,12 @@ void ClsNoisyEvolution::update_quantum_state(QuantumStateBase* state) {
     double r = _random.uniform();
     std::vector<double> cumulative_dist(_c_ops.size());
     double prob_sum = 0;
-    auto k1 = state->copy();  // vector for Runge-Kutta k
-    auto k2 = state->copy();  // vector for Runge-Kutta k
-    auto k3 = state->copy();  // vector for Runge-Kutta k
-    auto k4 = state->copy();  // vector for Runge-Kutta k
-    auto buffer = state->copy();
+    // k1..k4 and buffer are overwritten before they are read
+    auto k1 = state->allocate_buffer();  // vector for Runge-Kutta k
+    auto k2 = state->allocate_buffer();  // vector for Runge-Kutta k
+    auto k3 = state->allocate_buffer();  // vector for Runge-Kutta k
+    auto k4 = state->allocate_buffer();  // vector for Runge-Kutta k
+    auto buffer = state->allocate_buffer();
     double t = 0;
 
     while (
@@ -7,6 +7,7 @@
 #include <csim/utility.hpp>
 #include <cstring>
 #include <fstream>
+#include <map>
 #include <numeric>
 
 #include "exception.hpp"
@@ -57,6 +58,7 @@ void GeneralQuantumOperator::add_operator_move(PauliOperator* mpt) {
         this->_is_hermitian = false;
     }
     this->_operator_list.push_back(mpt);
+    this->_clear_term_group_list();
 }
 
 void GeneralQuantumOperator::add_operator(
@@ -111,6 +113,11 @@ CPPCTYPE GeneralQuantumOperator::get_expectation_value(
         return sum;
     }
 
+    auto state_cpu = dynamic_cast<const QuantumStateCpu*>(state);
+    if (state_cpu != nullptr) {
+        return this->_get_expectation_value_by_term_group(state_cpu, true);
+    }
+
     double sum_real = 0.;
     double sum_imag = 0.;
     CPPCTYPE tmp(0., 0.);
@@ -140,6 +147,10 @@ CPPCTYPE GeneralQuantumOperator::get_expectation_value_single_thread(
             << std::endl;
         return 0.;
     }
+    auto state_cpu = dynamic_cast<const QuantumStateCpu*>(state);
+    if (state_cpu != nullptr) {
+        return this->_get_expectation_value_by_term_group(state_cpu, false);
+    }
     auto sum = std::accumulate(this->_operator_list.cbegin(),
         this->_operator_list.cend(), (CPPCTYPE)0.0,
         [&](CPPCTYPE acc, PauliOperator* pauli) {
@@ -148,6 +159,114 @@ CPPCTYPE GeneralQuantumOperator::get_expectation_value_single_thread(
     return sum;
 }
 
+std::shared_ptr<const std::vector<GeneralQuantumOperator::PauliTermGroup>>
+GeneralQuantumOperator::_get_term_group_list() const {
+    auto term_group_list = std::atomic_load(&this->_term_group_list);
+    if (term_group_list) return term_group_list;
+
+    auto new_term_group_list = std::make_shared<std::vector<PauliTermGroup>>();
+    std::map<ITYPE, size_t> group_index_map;
+    for (UINT term_index = 0; term_index < _operator_list.size();
+         ++term_index) {
+        ITYPE bit_flip_mask, phase_flip_mask;
+        UINT global_phase_90rot_count, pivot_qubit_index;
+        if (!_operator_list[term_index]->get_Pauli_masks(&bit_flip_mask,
+                &phase_flip_mask, &global_phase_90rot_count,
+                &pivot_qubit_index)) {
+            // a term with an index of 64 or above is evaluated by itself
+            PauliTermGroup group;
+            group.has_Pauli_masks = false;
+            group.bit_flip_mask = 0;
+            group.pivot_qubit_index = 0;
+            group.term_index_list.push_back(term_index);
+            new_term_group_list->push_back(group);
+            continue;
+        }
+
+        auto ite = group_index_map.find(bit_flip_mask);
+        if (ite == group_index_map.end()) {
+            ite = group_index_map
+                      .emplace(bit_flip_mask, new_term_group_list->size())
+                      .first;
+            PauliTermGroup group;
+            group.has_Pauli_masks = true;
+            group.bit_flip_mask = bit_flip_mask;
+            group.pivot_qubit_index = pivot_qubit_index;
+            new_term_group_list->push_back(group);
+        }
+        auto& group = (*new_term_group_list)[ite->second];
+        group.term_index_list.push_back(term_index);
+        group.phase_flip_mask_list.push_back(phase_flip_mask);
+        group.global_phase_90rot_count_list.push_back(
+            global_phase_90rot_count);
+    }
+    term_group_list = new_term_group_list;
+    std::atomic_store(&this->_term_group_list, term_group_list);
+    return term_group_list;
+}
+
+void GeneralQuantumOperator::_clear_term_group_list() const {
+    std::atomic_store(&this->_term_group_list,
+        std::shared_ptr<const std::vector<PauliTermGroup>>());
+}
+
+CPPCTYPE GeneralQuantumOperator::_get_expectation_value_by_term_group(
+    const QuantumStateCpu* state_cpu, bool use_multi_thread) const {
+    const CTYPE* state = state_cpu->data_c();
+    const ITYPE dim = state_cpu->dim;
+    const auto term_group_list = this->_get_term_group_list();
+    const int group_count = (int)term_group_list->size();
+    // A small state is not processed in parallel by the kernels, so the
+    // groups are distributed over the threads instead.
+    const bool is_parallel_over_groups =
+        use_multi_thread && dim < (1ULL << 10);
+
+    double sum_real = 0.;
+    double sum_imag = 0.;
+#ifdef _OPENMP
+    if (is_parallel_over_groups) {
+        OMPutil::get_inst().set_qulacs_num_threads(group_count, 0);
+    }
+#pragma omp parallel for reduction(+ : sum_real, sum_imag) if (is_parallel_over_groups)
+#endif
+    for (int group_index = 0; group_index < group_count; ++group_index) {
+        const auto& group = (*term_group_list)[group_index];
+        if (!group.has_Pauli_masks) {
+            const CPPCTYPE term_value =
+                _operator_list[group.term_index_list[0]]
+                    ->get_expectation_value_single_thread(state_cpu);
+            sum_real += term_value.real();
+            sum_imag += term_value.imag();
+            continue;
+        }
+        const UINT term_count = (UINT)group.term_index_list.size();
+        // coefficients are read every time since they may be changed
+        std::vector<CTYPE> coef_list(term_count);
+        for (UINT i = 0; i < term_count; ++i) {
+            coef_list[i] = _operator_list[group.term_index_list[i]]->get_coef();
+        }
+        CTYPE value;
+        if (use_multi_thread && !is_parallel_over_groups) {
+            value = expectation_value_Pauli_operator_group(group.bit_flip_mask,
+                group.pivot_qubit_index, group.phase_flip_mask_list.data(),
+                group.global_phase_90rot_count_list.data(), coef_list.data(),
+                term_count, state, dim);
+        } else {
+            value = expectation_value_Pauli_operator_group_single_thread(
+                group.bit_flip_mask, group.pivot_qubit_index,
+                group.phase_flip_mask_list.data(),
+                group.global_phase_90rot_count_list.data(), coef_list.data(),
+                term_count, state, dim);
+        }
+        sum_real += _creal(value);
+        sum_imag += _cimag(value);
+    }
+#ifdef _OPENMP
+    if (is_parallel_over_groups) OMPutil::get_inst().reset_qulacs_num_threads();
+#endif
+    return CPPCTYPE(sum_real, sum_imag);
+}
+
 CPPCTYPE GeneralQuantumOperator::get_transition_amplitude(
     const QuantumStateBase* state_bra,
     const QuantumStateBase* state_ket) const {
@@ -683,6 +802,7 @@ GeneralQuantumOperator& GeneralQuantumOperator::operator*=(
         delete term;
     }
     _operator_list.clear();
+    this->_clear_term_group_list();
 
     ITYPE i, j;
     // #pragma omp parallel for
@@ -709,6 +829,7 @@ GeneralQuantumOperator& GeneralQuantumOperator::operator*=(
         delete term;
     }
     _operator_list.clear();
+    this->_clear_term_group_list();
 
     // #pragma omp parallel for
     for (i = 0; i < terms.size(); i++) {
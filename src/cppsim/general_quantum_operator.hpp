@@ -2,6 +2,7 @@
 
 #include <cstdio>
 #include <iostream>
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
@@ -12,6 +13,7 @@
 class SinglePauliOperator;
 class PauliOperator;
 class QuantumStateBase;
+class QuantumStateCpu;
 
 class DllExport GeneralQuantumOperator {
 private:
@@ -22,6 +24,27 @@ private:
     bool _is_hermitian;
     Random random;
 
+    //! terms which share the bit-flip mask
+    struct PauliTermGroup {
+        //! false for a single term whose masks cannot be built
+        bool has_Pauli_masks;
+        ITYPE bit_flip_mask;
+        UINT pivot_qubit_index;
+        std::vector<UINT> term_index_list;
+        std::vector<ITYPE> phase_flip_mask_list;
+        std::vector<UINT> global_phase_90rot_count_list;
+    };
+    //! groups of the terms for get_expectation_value. Built on the first
+    //! evaluation and discarded when the terms are added or removed.
+    mutable std::shared_ptr<const std::vector<PauliTermGroup>>
+        _term_group_list;
+
+    std::shared_ptr<const std::vector<PauliTermGroup>> _get_term_group_list()
+        const;
+    void _clear_term_group_list() const;
+    CPPCTYPE _get_expectation_value_by_term_group(
+        const QuantumStateCpu* state, bool use_multi_thread) const;
+
 protected:
     /**
      * \~japanese-en
@@ -159,6 +182,8 @@ public:
      * @return GeneralQuantumOperatorが持つPauliOperatorのリスト
      */
     virtual std::vector<PauliOperator*> get_terms() const {
+        // the returned terms may be modified by the caller
+        this->_clear_term_group_list();
         return _operator_list;
     }
 
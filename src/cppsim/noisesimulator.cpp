@@ -5,7 +5,12 @@
 #include "noisesimulator.hpp"
 
 #include <algorithm>
+#include <csim/utility.hpp>
+#include <memory>
 #include <numeric>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 #include "circuit.hpp"
 #include "gate_factory.hpp"
@@ -26,6 +31,8 @@ NoiseSimulator::NoiseSimulator(
         initial_state = init_state->copy();
     }
     circuit = init_circuit->copy();
+    // one checkpoint and the buffer, as many states as before the trie
+    checkpoint_memory_budget = 0;
     for (UINT i = 0; i < circuit->gate_list.size(); ++i) {
         auto gate = circuit->gate_list[i];
         if (!gate->is_noise()) continue;
@@ -64,12 +71,26 @@ std::vector<ITYPE> NoiseSimulator::Result::sampling() const {
 }
 
 std::vector<ITYPE> NoiseSimulator::execute(const UINT execution_count) {
-    Result* result = execute_and_get_result(execution_count);
-    std::vector<ITYPE> ret = result->sampling();
-    delete result;
+    std::vector<ITYPE> ret;
+    ret.reserve(execution_count);
+    execute_streaming(execution_count, [&](const std::vector<ITYPE>& samples) {
+        ret.insert(ret.end(), samples.begin(), samples.end());
+    });
     return ret;
 }
 
+void NoiseSimulator::execute_streaming(const UINT sample_count,
+    const std::function<void(const std::vector<ITYPE>&)>& process_samples) {
+    const std::vector<SamplingRequest> sampling_requests =
+        generate_sampling_request(sample_count);
+    simulate_sampling_requests(circuit, sampling_requests, 0,
+        (UINT)sampling_requests.size(), checkpoint_memory_budget,
+        [&](UINT i, QuantumState* state) {
+            process_samples(
+                state->sampling(sampling_requests[i].num_of_sampling));
+        });
+}
+
 NoiseSimulator::Result* NoiseSimulator::execute_and_get_result(
     const UINT sample_count) {
     std::vector<SamplingRequest> sampling_required =
@@ -83,6 +104,86 @@ NoiseSimulator::Result* NoiseSimulator::execute_and_get_result(
     return result;
 }
 
+std::vector<ITYPE> NoiseSimulator::execute_parallel(const UINT sample_count) {
+    std::vector<SamplingRequest> sampling_requests =
+        generate_sampling_request(sample_count);
+    // the requests are sorted by gate_pos, so each worker takes a subtree
+    const UINT request_count = (UINT)sampling_requests.size();
+    const UINT qubit_count = initial_state->qubit_count;
+
+    // the samples of each request are written from its offset, and their
+    // seeds are drawn here to be independent of the thread count. Random
+    // gates other than the noises still use the engines of the circuit
+    // copies, so their outcomes depend on the thread count.
+    std::vector<UINT> offset_list(request_count + 1, 0);
+    std::vector<UINT> seed_list(request_count);
+    for (UINT i = 0; i < request_count; ++i) {
+        offset_list[i + 1] =
+            offset_list[i] + sampling_requests[i].num_of_sampling;
+        seed_list[i] = (UINT)random.int32();
+    }
+    std::vector<ITYPE> sampling_result(offset_list[request_count]);
+
+    // Trajectories are the coarsest independent work, so each thread takes
+    // its own trajectories up to this size. Larger states give more threads
+    // to each trajectory for the amplitudes.
+    const UINT trajectory_parallel_qubit_count = 20;
+    UINT thread_per_trajectory = 1;
+    UINT worker_count = 1;
+#ifdef _OPENMP
+    const UINT thread_count = (UINT)omp_get_max_threads();
+    if (qubit_count > trajectory_parallel_qubit_count) {
+        const UINT shift =
+            std::min(qubit_count - trajectory_parallel_qubit_count, 31U);
+        thread_per_trajectory = std::min(thread_count, 1U << shift);
+    }
+    worker_count = std::max(
+        1U, std::min(thread_count / thread_per_trajectory, request_count));
+    const int max_active_levels = omp_get_max_active_levels();
+    if (worker_count > 1 && thread_per_trajectory > 1) {
+        omp_set_max_active_levels(2);
+    }
+#endif
+
+    // each worker owns its states and its copy of the circuit, since the
+    // gates may keep random engines of their own
+    std::vector<std::unique_ptr<QuantumCircuit>> circuit_list;
+    for (UINT worker = 0; worker < worker_count; ++worker) {
+        circuit_list.emplace_back(circuit->copy());
+    }
+    const size_t worker_checkpoint_budget =
+        checkpoint_memory_budget / worker_count;
+
+#ifdef _OPENMP
+#pragma omp parallel num_threads(worker_count) if (worker_count > 1)
+#endif
+    {
+#ifdef _OPENMP
+        const UINT worker = (UINT)omp_get_thread_num();
+        OMPutil::get_inst().set_qulacs_num_thread_limit(thread_per_trajectory);
+#else
+        const UINT worker = 0;
+#endif
+        const UINT begin = request_count * worker / worker_count;
+        const UINT end = request_count * (worker + 1) / worker_count;
+        simulate_sampling_requests(circuit_list[worker].get(),
+            sampling_requests, begin, end, worker_checkpoint_budget,
+            [&](UINT i, QuantumState* state) {
+                const std::vector<ITYPE> samples = state->sampling(
+                    sampling_requests[i].num_of_sampling, seed_list[i]);
+                std::copy(samples.begin(), samples.end(),
+                    sampling_result.begin() + offset_list[i]);
+            });
+#ifdef _OPENMP
+        OMPutil::get_inst().set_qulacs_num_thread_limit(0);
+#endif
+    }
+#ifdef _OPENMP
+    omp_set_max_active_levels(max_active_levels);
+#endif
+    return sampling_result;
+}
+
 std::vector<NoiseSimulator::SamplingRequest>
 NoiseSimulator::generate_sampling_request(const UINT sample_count) {
     std::vector<std::vector<UINT>> selected_gate_pos(
@@ -128,37 +229,12 @@ std::vector<std::pair<QuantumState*, UINT>> NoiseSimulator::simulate(
         });
 
     std::vector<std::pair<QuantumState*, UINT>> simulation_result;
-
-    QuantumState common_state(initial_state->qubit_count);
-    QuantumState buffer(initial_state->qubit_count);
-
-    common_state.load(initial_state);
-    UINT done_itr = 0;  // for gates i such that i < done_itr, gate i is already
-                        // applied to common_state.
-
-    for (UINT i = 0; i < sampling_requests.size(); ++i) {
-        // if gate[done_itr] will always choice 0-th gate to apply to state, we
-        // can apply 0-th gate of gate[done_itr] to common_state.
-
-        std::vector<UINT> current_gate_pos = sampling_requests[i].gate_pos;
-        while (done_itr < current_gate_pos.size() &&
-               current_gate_pos[done_itr] == 0) {
-            auto gate = circuit->gate_list[done_itr];
-            if (!gate->is_noise()) {
-                gate->update_quantum_state(&common_state);
-            } else {
-                dynamic_cast<QuantumGate_Probabilistic*>(gate)
-                    ->get_gate_list()[current_gate_pos[done_itr]]
-                    ->update_quantum_state(&common_state);
-            }
-            done_itr++;
-        }
-
-        buffer.load(&common_state);
-        apply_gates(current_gate_pos, &buffer, done_itr);
-        simulation_result.emplace_back(
-            buffer.copy(), sampling_requests[i].num_of_sampling);
-    }
+    simulate_sampling_requests(circuit, sampling_requests, 0,
+        (UINT)sampling_requests.size(), checkpoint_memory_budget,
+        [&](UINT i, QuantumState* state) {
+            simulation_result.emplace_back(
+                state->copy(), sampling_requests[i].num_of_sampling);
+        });
     return simulation_result;
 }
 
@@ -182,11 +258,98 @@ UINT NoiseSimulator::randomly_select_which_gate_pos_to_apply(
     return gate_pos;
 };
 
+// the length of the common prefix of two gate_pos
+static UINT common_prefix_length(
+    const std::vector<UINT>& l, const std::vector<UINT>& r) {
+    const UINT size = (UINT)std::min(l.size(), r.size());
+    UINT length = 0;
+    while (length < size && l[length] == r[length]) ++length;
+    return length;
+}
+
+void NoiseSimulator::simulate_sampling_requests(
+    const QuantumCircuit* target_circuit,
+    const std::vector<SamplingRequest>& sampling_requests, UINT begin,
+    UINT end, size_t checkpoint_budget,
+    const std::function<void(UINT, QuantumState*)>& process_state) {
+    if (begin >= end) return;
+    const UINT qubit_count = initial_state->qubit_count;
+    const UINT gate_size = (UINT)target_circuit->gate_list.size();
+    const size_t state_bytes = sizeof(CPPCTYPE) << qubit_count;
+    const size_t max_checkpoint_count =
+        std::max((size_t)1, checkpoint_budget / state_bytes);
+
+    // branch_depth_list[i] is the depth at which the (i+1)-th request leaves
+    // the path of the i-th request in the trie of gate_pos
+    std::vector<UINT> branch_depth_list(end - begin, 0);
+    for (UINT i = begin; i + 1 < end; ++i) {
+        branch_depth_list[i - begin] = common_prefix_length(
+            sampling_requests[i].gate_pos, sampling_requests[i + 1].gate_pos);
+    }
+
+    // states after the first depth gates of the current path, in ascending
+    // order of depth
+    std::vector<std::pair<UINT, std::unique_ptr<QuantumState>>>
+        checkpoint_list;
+    std::vector<UINT> save_depth_list;
+    QuantumState buffer(qubit_count);
+    for (UINT i = begin; i < end; ++i) {
+        const std::vector<UINT>& gate_pos = sampling_requests[i].gate_pos;
+        // drop the checkpoints which are not on the path of this request
+        const UINT shared_depth =
+            (i == begin) ? 0 : branch_depth_list[i - 1 - begin];
+        while (!checkpoint_list.empty() &&
+               checkpoint_list.back().first > shared_depth) {
+            checkpoint_list.pop_back();
+        }
+        UINT depth = 0;
+        if (checkpoint_list.empty()) {
+            buffer.load(initial_state);
+        } else {
+            depth = checkpoint_list.back().first;
+            buffer.load(checkpoint_list.back().second.get());
+        }
+
+        // the branch points of the following requests on this path deeper
+        // than the current state, which are the running minimums of the
+        // branch depths
+        save_depth_list.clear();
+        UINT min_depth = gate_size;
+        for (UINT j = i; j + 1 < end; ++j) {
+            const UINT branch_depth = branch_depth_list[j - begin];
+            if (branch_depth <= depth) break;
+            if (branch_depth < min_depth) {
+                min_depth = branch_depth;
+                save_depth_list.push_back(min_depth);
+            }
+        }
+        for (auto it = save_depth_list.rbegin();
+             it != save_depth_list.rend() &&
+             checkpoint_list.size() < max_checkpoint_count;
+             ++it) {
+            apply_gates(target_circuit, gate_pos, &buffer, depth, *it);
+            depth = *it;
+            std::unique_ptr<QuantumState> checkpoint(
+                new QuantumState(qubit_count));
+            checkpoint->load(&buffer);
+            checkpoint_list.emplace_back(depth, std::move(checkpoint));
+        }
+        apply_gates(target_circuit, gate_pos, &buffer, depth, gate_size);
+        process_state(i, &buffer);
+    }
+}
+
 void NoiseSimulator::apply_gates(const std::vector<UINT>& chosen_gate,
     QuantumState* sampling_state, const int StartPos) {
-    const UINT gate_size = (UINT)circuit->gate_list.size();
-    for (UINT q = StartPos; q < gate_size; ++q) {
-        auto gate = circuit->gate_list[q];
+    apply_gates(circuit, chosen_gate, sampling_state, StartPos,
+        (UINT)circuit->gate_list.size());
+}
+
+void NoiseSimulator::apply_gates(const QuantumCircuit* target_circuit,
+    const std::vector<UINT>& chosen_gate, QuantumState* sampling_state,
+    const UINT begin_pos, const UINT end_pos) {
+    for (UINT q = begin_pos; q < end_pos; ++q) {
+        auto gate = target_circuit->gate_list[q];
         if (!gate->is_noise()) {
             gate->update_quantum_state(sampling_state);
         } else {
@@ -196,3 +359,11 @@ void NoiseSimulator::apply_gates(const std::vector<UINT>& chosen_gate,
         }
     }
 }
+
+void NoiseSimulator::set_checkpoint_memory_budget(size_t budget_bytes) {
+    checkpoint_memory_budget = budget_bytes;
+}
+
+size_t NoiseSimulator::get_checkpoint_memory_budget() const {
+    return checkpoint_memory_budget;
+}
@@ -2,6 +2,8 @@
 #define _CRT_SECURE_NO_WARNINGS
 #endif
 
+#include <functional>
+
 #include "circuit.hpp"
 #include "gate_factory.hpp"
 #include "gate_merge.hpp"
@@ -16,6 +18,7 @@ private:
     Random random;
     QuantumCircuit* circuit;
     QuantumStateBase* initial_state;
+    size_t checkpoint_memory_budget;
 
     /**
      * \~japanese-en
@@ -41,6 +44,31 @@ private:
 
     void apply_gates(const std::vector<UINT>& chosen_gate,
         QuantumState* sampling_state, const int StartPos);
+    void apply_gates(const QuantumCircuit* target_circuit,
+        const std::vector<UINT>& chosen_gate, QuantumState* sampling_state,
+        const UINT begin_pos, const UINT end_pos);
+
+    /**
+     * \~japanese-en
+     *
+     * ソートされたSamplingRequestのうち[begin, end)番目の量子状態を順に計算し、
+     * process_stateに渡す。
+     *
+     * ソートされたgate_posの列はトライ木の深さ優先の順に並んでいるため、
+     * 以降のリクエストと分岐する位置の量子状態をチェックポイントとして保存し、
+     * 共通の接頭辞は一度だけ計算する。
+     * @param[in] target_circuit 適用するゲートを持つ量子回路
+     * @param[in] sampling_requests gate_posでソートされたSamplingRequestのvector
+     * @param[in] begin 計算する最初のリクエストの番号
+     * @param[in] end 計算する最後のリクエストの次の番号
+     * @param[in] checkpoint_budget
+     * チェックポイントに使うメモリのバイト数。少なくとも1つは保存される。
+     * @param[in] process_state リクエストの番号と量子状態を受け取る関数
+     */
+    void simulate_sampling_requests(const QuantumCircuit* target_circuit,
+        const std::vector<SamplingRequest>& sampling_requests, UINT begin,
+        UINT end, size_t checkpoint_budget,
+        const std::function<void(UINT, QuantumState*)>& process_state);
 
     /**
      * \~japanese-en
@@ -108,6 +136,21 @@ public:
      */
     virtual std::vector<ITYPE> execute(const UINT sample_count);
 
+    /**
+     * \~japanese-en
+     *
+     * サンプリングを行い、結果をトラジェクトリごとにprocess_samplesに渡す。
+     *
+     * 各トラジェクトリの量子状態は計算されるとすぐにサンプリングされ、
+     * バッファは次のトラジェクトリに再利用される。
+     * そのため、サンプリングの回数によらず少数の量子状態しか保持しない。
+     * @param[in] sample_count 行うsamplingの回数
+     * @param[in] process_samples
+     * 1つのトラジェクトリから得られたサンプリング結果を受け取る関数
+     */
+    virtual void execute_streaming(const UINT sample_count,
+        const std::function<void(const std::vector<ITYPE>&)>& process_samples);
+
     /**
      * \~japanese-en
      *
@@ -117,4 +160,38 @@ public:
      * 量子状態の列。Resultクラスに入れられる。
      */
     virtual Result* execute_and_get_result(const UINT execution_count);
+
+    /**
+     * \~japanese-en
+     *
+     * 独立なトラジェクトリを並列に実行してサンプリングを行い、結果を配列で返す。
+     *
+     * 各スレッドは自身の量子状態と量子回路の複製を持ち、割り当てられたトラジェクトリを
+     * 計算してすぐにサンプリングするため、量子状態は保持されない。
+     * 量子ビット数が大きい場合は、各トラジェクトリに複数のスレッドを割り当てて
+     * 振幅の計算も並列化する。
+     * ノイズの選択とサンプリングの乱数は事前に生成されるが、測定やCPTPなど
+     * ノイズ以外の乱数を使うゲートは各スレッドの回路の複製が持つ乱数で
+     * 計算される。そのようなゲートを含む回路では、結果はスレッド数に依存する。
+     * @param[in] sample_count 行うsamplingの回数
+     * @return サンプリング結果の配列
+     */
+    virtual std::vector<ITYPE> execute_parallel(const UINT sample_count);
+    /**
+     * \~japanese-en
+     *
+     * ノイズの履歴の共通部分を再利用するために保存する量子状態のメモリの上限を設定する。
+     *
+     * 既定値は0。上限によらず、少なくとも1つの量子状態は保存される。
+     * 上限を大きくすると、より多くの分岐点の量子状態が再利用される。
+     * @param[in] budget_bytes メモリの上限のバイト数
+     */
+    virtual void set_checkpoint_memory_budget(size_t budget_bytes);
+
+    /**
+     * \~japanese-en
+     *
+     * @return ノイズの履歴の共通部分を再利用するために保存する量子状態のメモリの上限
+     */
+    virtual size_t get_checkpoint_memory_budget() const;
 };
@@ -0,0 +1,264 @@
+#include "pauli_frame_simulator.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include "exception.hpp"
+#include "gate_general.hpp"
+
+// the largest number of qubits of a Clifford gate or a Pauli noise branch
+static const UINT max_frame_gate_qubit_count = 3;
+
+// Find the Pauli operator X^x Z^z proportional to the unitary matrix, whose
+// basis order follows the qubit order of the gate.
+static bool find_Pauli_of_matrix(
+    const ComplexMatrix& matrix, UINT* x_mask, UINT* z_mask) {
+    const UINT dim = (UINT)matrix.rows();
+    for (UINT x = 0; x < dim; ++x) {
+        for (UINT z = 0; z < dim; ++z) {
+            CPPCTYPE overlap = 0.;
+            for (UINT basis = 0; basis < dim; ++basis) {
+                const double sign =
+                    (count_population_cpp(basis & z) % 2) ? -1. : 1.;
+                overlap += sign * matrix(basis ^ x, basis);
+            }
+            if (std::abs(std::abs(overlap) / dim - 1.) < 1e-8) {
+                *x_mask = x;
+                *z_mask = z;
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+static ComplexMatrix get_Pauli_matrix(UINT x_mask, UINT z_mask, UINT dim) {
+    ComplexMatrix matrix = ComplexMatrix::Zero(dim, dim);
+    for (UINT basis = 0; basis < dim; ++basis) {
+        matrix(basis ^ x_mask, basis) =
+            (count_population_cpp(basis & z_mask) % 2) ? -1. : 1.;
+    }
+    return matrix;
+}
+
+// matrix of the gate on its target qubits followed by its control qubits
+static ComplexMatrix get_controlled_matrix(const QuantumGateBase* gate) {
+    ComplexMatrix target_matrix;
+    gate->set_matrix(target_matrix);
+    const UINT target_count = (UINT)gate->get_target_index_list().size();
+    const std::vector<UINT> control_value_list = gate->get_control_value_list();
+    const UINT qubit_count = target_count + (UINT)control_value_list.size();
+    const UINT dim = 1U << qubit_count;
+    const UINT target_dim = 1U << target_count;
+    UINT control_offset = 0;
+    for (UINT i = 0; i < control_value_list.size(); ++i) {
+        control_offset |= control_value_list[i] << (target_count + i);
+    }
+    ComplexMatrix matrix = ComplexMatrix::Identity(dim, dim);
+    matrix.block(control_offset, control_offset, target_dim, target_dim) =
+        target_matrix;
+    return matrix;
+}
+
+bool PauliFrameSimulator::create_frame_gate(
+    QuantumGateBase* gate, FrameGate* frame_gate) {
+    frame_gate->is_noise = gate->is_noise();
+    frame_gate->error_probability = 0.;
+    if (!gate->is_noise()) {
+        // Pauli gates only change the sign of the frame
+        if (gate->is_Pauli() && gate->get_control_index_list().empty()) {
+            return true;
+        }
+        if (!gate->is_Clifford()) return false;
+        std::vector<UINT> qubit_index_list = gate->get_target_index_list();
+        for (UINT index : gate->get_control_index_list()) {
+            qubit_index_list.push_back(index);
+        }
+        const UINT qubit_count = (UINT)qubit_index_list.size();
+        if (qubit_count > max_frame_gate_qubit_count) return false;
+        const ComplexMatrix matrix = get_controlled_matrix(gate);
+        const UINT dim = 1U << qubit_count;
+        frame_gate->qubit_index_list = qubit_index_list;
+        frame_gate->x_image_x_mask_list.resize(qubit_count);
+        frame_gate->x_image_z_mask_list.resize(qubit_count);
+        frame_gate->z_image_x_mask_list.resize(qubit_count);
+        frame_gate->z_image_z_mask_list.resize(qubit_count);
+        for (UINT j = 0; j < qubit_count; ++j) {
+            const ComplexMatrix x_image = matrix *
+                                          get_Pauli_matrix(1U << j, 0, dim) *
+                                          matrix.adjoint();
+            const ComplexMatrix z_image = matrix *
+                                          get_Pauli_matrix(0, 1U << j, dim) *
+                                          matrix.adjoint();
+            if (!find_Pauli_of_matrix(x_image,
+                    &frame_gate->x_image_x_mask_list[j],
+                    &frame_gate->x_image_z_mask_list[j]) ||
+                !find_Pauli_of_matrix(z_image,
+                    &frame_gate->z_image_x_mask_list[j],
+                    &frame_gate->z_image_z_mask_list[j])) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    auto noise = dynamic_cast<QuantumGate_Probabilistic*>(gate);
+    if (noise == NULL) return false;
+    const std::vector<double> distribution = noise->get_distribution();
+    const std::vector<QuantumGateBase*> branch_list = noise->get_gate_list();
+    std::vector<double> error_distribution;
+    for (UINT i = 0; i < branch_list.size(); ++i) {
+        const QuantumGateBase* branch = branch_list[i];
+        const std::vector<UINT> target_list = branch->get_target_index_list();
+        if (!branch->get_control_index_list().empty() ||
+            target_list.size() > max_frame_gate_qubit_count) {
+            return false;
+        }
+        ComplexMatrix matrix;
+        branch->set_matrix(matrix);
+        UINT x_mask, z_mask;
+        if (!find_Pauli_of_matrix(matrix, &x_mask, &z_mask)) return false;
+        if (x_mask == 0 && z_mask == 0) continue;
+        ITYPE x_global_mask = 0, z_global_mask = 0;
+        for (UINT j = 0; j < target_list.size(); ++j) {
+            if ((x_mask >> j) & 1) x_global_mask |= 1ULL << target_list[j];
+            if ((z_mask >> j) & 1) z_global_mask |= 1ULL << target_list[j];
+        }
+        error_distribution.push_back(distribution[i]);
+        frame_gate->error_x_mask_list.push_back(x_global_mask);
+        frame_gate->error_z_mask_list.push_back(z_global_mask);
+    }
+    double sum = 0.;
+    for (double prob : error_distribution) {
+        sum += prob;
+        frame_gate->error_cumulative_distribution.push_back(sum);
+    }
+    if (sum > 0.) {
+        for (double& prob : frame_gate->error_cumulative_distribution) {
+            prob /= sum;
+        }
+    }
+    frame_gate->error_probability = sum;
+    return true;
+}
+
+PauliFrameSimulator::PauliFrameSimulator(
+    const QuantumCircuit* init_circuit, const QuantumState* init_state) {
+    qubit_count = init_circuit->qubit_count;
+    for (QuantumGateBase* gate : init_circuit->gate_list) {
+        FrameGate frame_gate;
+        if (!create_frame_gate(gate, &frame_gate)) {
+            throw NotImplementedException(
+                "Error: PauliFrameSimulator::PauliFrameSimulator("
+                "const QuantumCircuit*, const QuantumState*): gate " +
+                gate->get_name() +
+                " is neither a Clifford gate nor a Pauli noise.");
+        }
+        if (frame_gate.is_noise || !frame_gate.qubit_index_list.empty()) {
+            frame_gate_list.push_back(frame_gate);
+        }
+    }
+
+    // the noiseless state is simulated once
+    noiseless_state = new QuantumState(qubit_count);
+    if (init_state == NULL) {
+        noiseless_state->set_zero_state();
+    } else {
+        noiseless_state->load(init_state);
+    }
+    for (QuantumGateBase* gate : init_circuit->gate_list) {
+        if (!gate->is_noise()) gate->update_quantum_state(noiseless_state);
+    }
+}
+
+PauliFrameSimulator::~PauliFrameSimulator() { delete noiseless_state; }
+
+bool PauliFrameSimulator::is_supported(const QuantumCircuit* circuit) {
+    return std::all_of(circuit->gate_list.cbegin(), circuit->gate_list.cend(),
+        [](QuantumGateBase* gate) {
+            FrameGate frame_gate;
+            return create_frame_gate(gate, &frame_gate);
+        });
+}
+
+void PauliFrameSimulator::propagate_frame(
+    std::vector<uint64_t>& x_frame, std::vector<uint64_t>& z_frame) {
+    std::fill(x_frame.begin(), x_frame.end(), 0);
+    std::fill(z_frame.begin(), z_frame.end(), 0);
+    uint64_t new_x[max_frame_gate_qubit_count];
+    uint64_t new_z[max_frame_gate_qubit_count];
+    for (const FrameGate& gate : frame_gate_list) {
+        if (gate.is_noise) {
+            const double prob = gate.error_probability;
+            if (prob <= 0.) continue;
+            // skip the shots without errors with geometric distribution
+            const double log_no_error = std::log(1. - std::min(prob, 1.));
+            UINT shot = 0;
+            while (true) {
+                if (prob < 1.) {
+                    const double skip =
+                        std::log(1. - random.uniform()) / log_no_error;
+                    if (skip >= 64. - shot) break;
+                    shot += (UINT)skip;
+                }
+                const double r = random.uniform();
+                const UINT error_count =
+                    (UINT)gate.error_cumulative_distribution.size();
+                const UINT error_index = std::min(
+                    (UINT)(std::upper_bound(
+                               gate.error_cumulative_distribution.begin(),
+                               gate.error_cumulative_distribution.end(), r) -
+                           gate.error_cumulative_distribution.begin()),
+                    error_count - 1);
+                const uint64_t shot_bit = 1ULL << shot;
+                ITYPE x_mask = gate.error_x_mask_list[error_index];
+                ITYPE z_mask = gate.error_z_mask_list[error_index];
+                for (UINT q = 0; x_mask; ++q, x_mask >>= 1) {
+                    if (x_mask & 1) x_frame[q] ^= shot_bit;
+                }
+                for (UINT q = 0; z_mask; ++q, z_mask >>= 1) {
+                    if (z_mask & 1) z_frame[q] ^= shot_bit;
+                }
+                if (++shot >= 64) break;
+            }
+        } else {
+            const UINT count = (UINT)gate.qubit_index_list.size();
+            for (UINT a = 0; a < count; ++a) new_x[a] = new_z[a] = 0;
+            for (UINT j = 0; j < count; ++j) {
+                const uint64_t x = x_frame[gate.qubit_index_list[j]];
+                const uint64_t z = z_frame[gate.qubit_index_list[j]];
+                for (UINT a = 0; a < count; ++a) {
+                    if ((gate.x_image_x_mask_list[j] >> a) & 1) new_x[a] ^= x;
+                    if ((gate.x_image_z_mask_list[j] >> a) & 1) new_z[a] ^= x;
+                    if ((gate.z_image_x_mask_list[j] >> a) & 1) new_x[a] ^= z;
+                    if ((gate.z_image_z_mask_list[j] >> a) & 1) new_z[a] ^= z;
+                }
+            }
+            for (UINT a = 0; a < count; ++a) {
+                x_frame[gate.qubit_index_list[a]] = new_x[a];
+                z_frame[gate.qubit_index_list[a]] = new_z[a];
+            }
+        }
+    }
+}
+
+std::vector<ITYPE> PauliFrameSimulator::execute(const UINT sample_count) {
+    std::vector<ITYPE> result =
+        noiseless_state->sampling(sample_count, (UINT)random.int32());
+    std::vector<uint64_t> x_frame(qubit_count), z_frame(qubit_count);
+    for (UINT offset = 0; offset < sample_count; offset += 64) {
+        propagate_frame(x_frame, z_frame);
+        // only the bit flips of the final frame change the readout
+        const UINT shot_count = std::min(64U, sample_count - offset);
+        for (UINT q = 0; q < qubit_count; ++q) {
+            uint64_t word = x_frame[q];
+            for (UINT shot = 0; word && shot < shot_count;
+                 ++shot, word >>= 1) {
+                if (word & 1) result[offset + shot] ^= 1ULL << q;
+            }
+        }
+    }
+    return result;
+}
+
+void PauliFrameSimulator::set_seed(UINT seed) { random.set_seed(seed); }
@@ -0,0 +1,118 @@
+#pragma once
+
+#include "circuit.hpp"
+#include "state.hpp"
+#include "type.hpp"
+#include "utility.hpp"
+
+/**
+ * \~japanese-en
+ * クリフォードゲートとパウリノイズからなる回路を、パウリフレームの伝播によって
+ * サンプリングするクラス
+ *
+ * ノイズのない量子状態は一度だけ計算され、各サンプルではパウリノイズを
+ * X、Zのビットマスクとしてクリフォードゲートに沿って伝播させる。
+ * ビットマスクは64サンプルを1ワードにまとめて処理され、読み出しの際に
+ * ノイズのない量子状態からのサンプリング結果に最終的なXの成分が適用される。
+ * そのため、1サンプルあたりのコストはゲート数に比例し、量子ビット数に依存しない。
+ */
+class DllExport PauliFrameSimulator {
+private:
+    /**
+     * \~japanese-en
+     *
+     * フレームに作用するゲートの構造体。
+     * クリフォードゲートは対象の量子ビット上の各X、Zの像を、パウリノイズは
+     * 各分岐のパウリ演算子を保持する。
+     */
+    struct FrameGate {
+        bool is_noise;
+        std::vector<UINT> qubit_index_list;
+        // images of X_j and Z_j of the j-th qubit of the clifford gate, as
+        // bit masks over qubit_index_list
+        std::vector<UINT> x_image_x_mask_list;
+        std::vector<UINT> x_image_z_mask_list;
+        std::vector<UINT> z_image_x_mask_list;
+        std::vector<UINT> z_image_z_mask_list;
+        // probability that the noise applies a non-identity Pauli
+        double error_probability;
+        // cumulative distribution of the non-identity Paulis conditioned on
+        // an error, and their masks over the whole qubits
+        std::vector<double> error_cumulative_distribution;
+        std::vector<ITYPE> error_x_mask_list;
+        std::vector<ITYPE> error_z_mask_list;
+    };
+
+    Random random;
+    UINT qubit_count;
+    QuantumState* noiseless_state;
+    std::vector<FrameGate> frame_gate_list;
+
+    /**
+     * \~japanese-en
+     *
+     * ゲートをフレームに作用するゲートに変換する。
+     * @param[in] gate 変換するゲート
+     * @param[out] frame_gate 変換されたゲート
+     * @return true 変換できた
+     * @return false クリフォードゲートでもパウリノイズでもないため変換できない
+     */
+    static bool create_frame_gate(QuantumGateBase* gate, FrameGate* frame_gate);
+
+    /**
+     * \~japanese-en
+     *
+     * 64サンプル分のフレームを生成して回路に沿って伝播させる。
+     * @param[out] x_frame 各量子ビットのXの成分
+     * @param[out] z_frame 各量子ビットのZの成分
+     */
+    void propagate_frame(
+        std::vector<uint64_t>& x_frame, std::vector<uint64_t>& z_frame);
+
+public:
+    /**
+     * \~japanese-en
+     * コンストラクタ。
+     *
+     * 回路の各ゲートはノイズでない場合はクリフォードゲート、ノイズの場合は
+     * 各分岐がパウリ演算子である必要がある。
+     * @param[in] init_circuit  シミュレータに使用する量子回路。
+     * @param[in] init_state
+     * 最初の状態。指定されなかった場合は|00...0>で初期化される。
+     * @return PauliFrameSimulatorのインスタンス
+     */
+    explicit PauliFrameSimulator(const QuantumCircuit* init_circuit,
+        const QuantumState* init_state = NULL);
+    /**
+     * \~japanese-en
+     * デストラクタ。
+     */
+    virtual ~PauliFrameSimulator();
+
+    /**
+     * \~japanese-en
+     *
+     * 回路がPauliFrameSimulatorでシミュレートできるかを判定する。
+     * @param[in] circuit 判定する量子回路
+     * @return true シミュレートできる
+     * @return false シミュレートできない
+     */
+    static bool is_supported(const QuantumCircuit* circuit);
+
+    /**
+     * \~japanese-en
+     *
+     * サンプリングを行い、結果を配列で返す。
+     * @param[in] sample_count 行うsamplingの回数
+     * @return サンプリング結果の配列
+     */
+    virtual std::vector<ITYPE> execute(const UINT sample_count);
+
+    /**
+     * \~japanese-en
+     *
+     * 乱数のシードを設定する。
+     * @param[in] seed シード値
+     */
+    virtual void set_seed(UINT seed);
+};
@@ -138,6 +138,32 @@ void PauliOperator::add_single_Pauli(UINT qubit_index, UINT pauli_type) {
     } else if (pauli_type == 3) {
         _z.set(qubit_index);
     }
+
+    if (qubit_index >= sizeof(ITYPE) * 8) {
+        _has_Pauli_masks = false;
+        return;
+    }
+    const ITYPE qubit_mask = 1ULL << qubit_index;
+    if (pauli_type == 1 || pauli_type == 2) {
+        _bit_flip_mask ^= qubit_mask;
+        _pivot_qubit_index = qubit_index;
+    }
+    if (pauli_type == 2 || pauli_type == 3) {
+        _phase_flip_mask ^= qubit_mask;
+    }
+    if (pauli_type == 2) {
+        ++_global_phase_90rot_count;
+    }
+}
+
+bool PauliOperator::get_Pauli_masks(ITYPE* bit_flip_mask,
+    ITYPE* phase_flip_mask, UINT* global_phase_90rot_count,
+    UINT* pivot_qubit_index) const {
+    (*bit_flip_mask) = _bit_flip_mask;
+    (*phase_flip_mask) = _phase_flip_mask;
+    (*global_phase_90rot_count) = _global_phase_90rot_count;
+    (*pivot_qubit_index) = _pivot_qubit_index;
+    return _has_Pauli_masks;
 }
 
 CPPCTYPE PauliOperator::get_expectation_value(
@@ -151,6 +177,10 @@ CPPCTYPE PauliOperator::get_expectation_value(
             std::to_string(this->get_qubit_count()) +
             " QuantumState: " + std::to_string(state->qubit_count));
     }
+    if (state->is_Pauli_expectation_computed_by_state()) {
+        return _coef * state->get_Pauli_expectation_value(
+                           this->get_index_list(), this->get_pauli_id_list());
+    }
     if (state->is_state_vector()) {
 #ifdef _USE_GPU
         if (state->get_device_name() == "gpu") {
@@ -161,23 +191,27 @@ CPPCTYPE PauliOperator::get_expectation_value(
                        (UINT)this->get_index_list().size(), state->data(),
                        state->dim, state->get_cuda_stream(),
                        state->device_number);
-        } else {
-            return _coef *
-                   expectation_value_multi_qubit_Pauli_operator_partial_list(
-                       this->get_index_list().data(),
-                       this->get_pauli_id_list().data(),
-                       (UINT)this->get_index_list().size(), state->data_c(),
-                       state->dim);
         }
-#else
+#endif
+        if (_has_Pauli_masks) {
+            return _coef * expectation_value_Pauli_operator_masks(
+                               _bit_flip_mask, _phase_flip_mask,
+                               _global_phase_90rot_count, _pivot_qubit_index,
+                               state->data_c(), state->dim);
+        }
         return _coef *
                expectation_value_multi_qubit_Pauli_operator_partial_list(
                    this->get_index_list().data(),
                    this->get_pauli_id_list().data(),
                    (UINT)this->get_index_list().size(), state->data_c(),
                    state->dim);
-#endif
     } else {
+        if (_has_Pauli_masks) {
+            return _coef * dm_expectation_value_Pauli_operator_masks(
+                               _bit_flip_mask, _phase_flip_mask,
+                               _global_phase_90rot_count, state->data_c(),
+                               state->dim);
+        }
         return _coef *
                dm_expectation_value_multi_qubit_Pauli_operator_partial_list(
                    this->get_index_list().data(),
@@ -189,6 +223,10 @@ CPPCTYPE PauliOperator::get_expectation_value(
 
 CPPCTYPE PauliOperator::get_expectation_value_single_thread(
     const QuantumStateBase* state) const {
+    if (state->is_Pauli_expectation_computed_by_state()) {
+        return _coef * state->get_Pauli_expectation_value_single_thread(
+                           this->get_index_list(), this->get_pauli_id_list());
+    }
     if (state->is_state_vector()) {
 #ifdef _USE_GPU
         if (state->get_device_name() == "gpu") {
@@ -203,6 +241,12 @@ CPPCTYPE PauliOperator::get_expectation_value_single_thread(
                        state->device_number);
         }
 #endif
+        if (_has_Pauli_masks) {
+            return _coef * expectation_value_Pauli_operator_masks_single_thread(
+                               _bit_flip_mask, _phase_flip_mask,
+                               _global_phase_90rot_count, _pivot_qubit_index,
+                               state->data_c(), state->dim);
+        }
         return _coef *
                expectation_value_multi_qubit_Pauli_operator_partial_list_single_thread(
                    this->get_index_list().data(),
@@ -210,6 +254,12 @@ CPPCTYPE PauliOperator::get_expectation_value_single_thread(
                    (UINT)this->get_index_list().size(), state->data_c(),
                    state->dim);
     } else {
+        if (_has_Pauli_masks) {
+            return _coef * dm_expectation_value_Pauli_operator_masks(
+                               _bit_flip_mask, _phase_flip_mask,
+                               _global_phase_90rot_count, state->data_c(),
+                               state->dim);
+        }
         // TODO: implement single_thread version of
         // dm_expectation_value_multi_qubit_Pauli_operator_partial_list
         return _coef *
@@ -239,16 +289,15 @@ CPPCTYPE PauliOperator::get_transition_amplitude(
                        (UINT)this->get_index_list().size(), state_bra->data(),
                        state_ket->data(), state_bra->dim,
                        state_ket->get_cuda_stream(), state_ket->device_number);
-    } else {
-        return _coef *
-               (CPPCTYPE)
-                   transition_amplitude_multi_qubit_Pauli_operator_partial_list(
-                       this->get_index_list().data(),
-                       this->get_pauli_id_list().data(),
-                       (UINT)this->get_index_list().size(), state_bra->data_c(),
-                       state_ket->data_c(), state_bra->dim);
     }
-#else
+#endif
+    if (_has_Pauli_masks) {
+        return _coef * (CPPCTYPE)transition_amplitude_Pauli_operator_masks(
+                           _bit_flip_mask, _phase_flip_mask,
+                           _global_phase_90rot_count, _pivot_qubit_index,
+                           state_bra->data_c(), state_ket->data_c(),
+                           state_bra->dim);
+    }
     return _coef *
            (CPPCTYPE)
                transition_amplitude_multi_qubit_Pauli_operator_partial_list(
@@ -256,7 +305,6 @@ CPPCTYPE PauliOperator::get_transition_amplitude(
                    this->get_pauli_id_list().data(),
                    (UINT)this->get_index_list().size(), state_bra->data_c(),
                    state_ket->data_c(), state_bra->dim);
-#endif
 }
 
 PauliOperator* PauliOperator::copy() const {
@@ -390,6 +438,11 @@ PauliOperator& PauliOperator::operator*=(const PauliOperator& target) {
     _x.clear();
     _z.clear();
     _pauli_list.clear();
+    _bit_flip_mask = 0;
+    _phase_flip_mask = 0;
+    _global_phase_90rot_count = 0;
+    _pivot_qubit_index = 0;
+    _has_Pauli_masks = true;
     _x.resize(max_size);
     _z.resize(max_size);
     for (i = 0; i < x_bit.size(); i++) {
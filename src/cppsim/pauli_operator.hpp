@@ -93,6 +93,15 @@ private:
     CPPCTYPE _coef;
     boost::dynamic_bitset<> _z;
     boost::dynamic_bitset<> _x;
+    //! masks of get_Pauli_masks_partial_list updated with _pauli_list. They
+    //! are valid while all the indices fit in ITYPE. Larger indices only
+    //! appear with states computing the value by themselves (e.g.
+    //! StabilizerState), since a state vector has at most 63 qubits.
+    ITYPE _bit_flip_mask = 0;
+    ITYPE _phase_flip_mask = 0;
+    UINT _global_phase_90rot_count = 0;
+    UINT _pivot_qubit_index = 0;
+    bool _has_Pauli_masks = true;
 
 public:
     /**
@@ -243,6 +252,21 @@ public:
      */
     virtual boost::dynamic_bitset<> get_z_bits() const { return _z; }
 
+    /**
+     * \~japanese-en
+     * 自身のパウリ演算子のビット反転と位相反転のマスクを返す
+     *
+     * マスクは演算子の追加のたびに更新されて保持されるため、期待値の計算ごとに作り直す必要がない。
+     *
+     * @param[out] bit_flip_mask XまたはYが作用するqubitのマスク
+     * @param[out] phase_flip_mask YまたはZが作用するqubitのマスク
+     * @param[out] global_phase_90rot_count Yの個数
+     * @param[out] pivot_qubit_index XまたはYが作用するqubitの添字
+     * @return 64以上の添字を含みマスクで表せない場合はfalse
+     */
+    virtual bool get_Pauli_masks(ITYPE* bit_flip_mask, ITYPE* phase_flip_mask,
+        UINT* global_phase_90rot_count, UINT* pivot_qubit_index) const;
+
     virtual ~PauliOperator(){};
 
     /**
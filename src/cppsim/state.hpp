@@ -1,16 +1,20 @@
 ﻿#pragma once
 
+#include <algorithm>
 #include <csim/init_ops.hpp>
 #include <csim/memory_ops.hpp>
 #include <csim/stat_ops.hpp>
 #include <csim/update_ops.hpp>
 #include <iostream>
+#include <memory>
 #include <vector>
 
 #include "exception.hpp"
 #include "type.hpp"
 #include "utility.hpp"
 
+class QuantumGateBase;
+
 /**
  * \~japanese-en 量子状態の基底クラス
  */
@@ -23,6 +27,68 @@ protected:
     UINT _device_number;
     void* _cuda_stream;
 
+    /**
+     * \~japanese-en 確率分布の表からサンプリングを行う
+     *
+     * 表は小さいことを想定し、累積分布を二分探索する。
+     * @param[in] distribution 確率分布。正規化されていなくてもよい。
+     * @param[in] sampling_count サンプリングを行う回数
+     * @param[in] random 乱数生成器
+     * @return サンプルされた表の添え字のリスト
+     */
+    static std::vector<ITYPE> _sampling_from_distribution(
+        const std::vector<double>& distribution, UINT sampling_count,
+        Random& random) {
+        std::vector<double> cumulative(distribution.size());
+        double sum = 0.;
+        for (ITYPE i = 0; i < distribution.size(); ++i) {
+            sum += distribution[i];
+            cumulative[i] = sum;
+        }
+        std::vector<ITYPE> result(sampling_count);
+        for (UINT count = 0; count < sampling_count; ++count) {
+            const double r = random.uniform() * sum;
+            ITYPE index = std::distance(cumulative.begin(),
+                std::upper_bound(cumulative.begin(), cumulative.end(), r));
+            if (index >= cumulative.size()) index = cumulative.size() - 1;
+            result[count] = index;
+        }
+        return result;
+    }
+
+    /**
+     * \~japanese-en 整列した一様乱数を用いて計算基底のサンプリングを行う
+     *
+     * 乱数を整列して sample_sorted に渡し、結果を元の順に戻す。
+     * sample_sorted は state_sampling_sorted
+     * のように、整列した乱数に状態ベクトルの1回の走査で基底を割り当てる。
+     * @param[in] sampling_count サンプリングを行う回数
+     * @param[in] random 乱数生成器
+     * @param[in] sample_sorted 整列した乱数、その個数、結果の配列を受け取る関数
+     * @return サンプルされた値のリスト
+     */
+    template <typename SampleSortedFunc>
+    static std::vector<ITYPE> _sampling_sorted(UINT sampling_count,
+        Random& random, SampleSortedFunc sample_sorted) {
+        std::vector<std::pair<double, UINT>> random_list(sampling_count);
+        for (UINT count = 0; count < sampling_count; ++count) {
+            random_list[count] = std::make_pair(random.uniform(), count);
+        }
+        std::sort(random_list.begin(), random_list.end());
+        std::vector<double> sorted_random_list(sampling_count);
+        for (UINT count = 0; count < sampling_count; ++count) {
+            sorted_random_list[count] = random_list[count].first;
+        }
+        std::vector<ITYPE> sorted_result(sampling_count);
+        sample_sorted(
+            sorted_random_list.data(), sampling_count, sorted_result.data());
+        std::vector<ITYPE> result(sampling_count);
+        for (UINT count = 0; count < sampling_count; ++count) {
+            result[random_list[count].second] = sorted_result[count];
+        }
+        return result;
+    }
+
 public:
     const UINT& qubit_count; /**< \~japanese-en 量子ビット数 */
     const ITYPE& dim;        /**< \~japanese-en 量子状態の次元 */
@@ -40,7 +106,8 @@ public:
           classical_register(_classical_register),
           device_number(_device_number) {
         this->_qubit_count = qubit_count_;
-        this->_dim = 1ULL << qubit_count_;
+        // states which do not hold amplitudes may have more than 63 qubits
+        this->_dim = (qubit_count_ < 64) ? 1ULL << qubit_count_ : 0;
         this->_is_state_vector = is_state_vector;
         this->_device_number = 0;
     }
@@ -51,7 +118,8 @@ public:
           classical_register(_classical_register),
           device_number(_device_number) {
         this->_qubit_count = qubit_count_;
-        this->_dim = 1ULL << qubit_count_;
+        // states which do not hold amplitudes may have more than 63 qubits
+        this->_dim = (qubit_count_ < 64) ? 1ULL << qubit_count_ : 0;
         this->_is_state_vector = is_state_vector;
         this->_device_number = device_number_;
     }
@@ -65,6 +133,76 @@ public:
      */
     virtual bool is_state_vector() const { return this->_is_state_vector; }
 
+    /**
+     * \~japanese-en 量子ゲートを量子状態自身が作用させるかを判定する
+     *
+     * 倍精度の状態ベクトルや密度行列を data_c() で公開しない量子状態は true
+     * を返す。QuantumCircuit::update_quantum_state
+     * は、このような量子状態には各ゲートの update_quantum_state の代わりに
+     * apply_gate を呼ぶ。
+     */
+    virtual bool is_gate_applied_by_state() const { return false; }
+
+    /**
+     * \~japanese-en 量子ゲートを apply_gate で作用させられるかを判定する
+     *
+     * @param gate 判定する量子ゲート
+     */
+    virtual bool is_supported_gate(const QuantumGateBase*) const {
+        return true;
+    }
+
+    /**
+     * \~japanese-en 量子ゲートを量子状態自身の表現で作用させる
+     *
+     * @param gate 作用させる量子ゲート
+     */
+    virtual void apply_gate(const QuantumGateBase*) {
+        throw NotImplementedException(
+            "Error: QuantumStateBase::apply_gate(const QuantumGateBase*): "
+            "this state is updated by the update_quantum_state of gates");
+    }
+
+    /**
+     * \~japanese-en パウリ演算子の期待値を量子状態自身が計算するかを判定する
+     *
+     * true を返す量子状態には、PauliOperator::get_expectation_value は
+     * data_c() を参照する代わりに get_Pauli_expectation_value を呼ぶ。
+     */
+    virtual bool is_Pauli_expectation_computed_by_state() const {
+        return false;
+    }
+
+    /**
+     * \~japanese-en パウリ演算子の期待値を量子状態自身の表現で計算する
+     *
+     * @param target_qubit_index_list 作用する量子ビットの添え字のリスト
+     * @param pauli_id_list パウリ演算子のリスト。(I,X,Y,Z)が(0,1,2,3)に対応する。
+     * @return 期待値
+     */
+    virtual double get_Pauli_expectation_value(const std::vector<UINT>&,
+        const std::vector<UINT>&) const {
+        throw NotImplementedException(
+            "Error: QuantumStateBase::get_Pauli_expectation_value(const "
+            "vector<UINT>&, const vector<UINT>&): the expectation value of "
+            "this state is computed by PauliOperator");
+    }
+
+    /**
+     * \~japanese-en get_Pauli_expectation_value のシングルスレッド版
+     *
+     * 並列領域の内部から呼び出せる。
+     * @param target_qubit_index_list 作用する量子ビットの添え字のリスト
+     * @param pauli_id_list パウリ演算子のリスト。(I,X,Y,Z)が(0,1,2,3)に対応する。
+     * @return 期待値
+     */
+    virtual double get_Pauli_expectation_value_single_thread(
+        const std::vector<UINT>& target_qubit_index_list,
+        const std::vector<UINT>& pauli_id_list) const {
+        return this->get_Pauli_expectation_value(
+            target_qubit_index_list, pauli_id_list);
+    }
+
     /**
      * \~japanese-en 量子状態を計算基底の0状態に初期化する
      */
@@ -343,6 +481,35 @@ class QuantumStateCpu : public QuantumStateBase {
 private:
     CPPCTYPE* _state_vector;
     Random random;
+    // Walker alias table for sampling. It is cleared whenever the state
+    // vector is handed out, since the state may be modified through it. The
+    // const accessors clear it from several threads when a shared state is
+    // loaded in parallel, so it is swapped atomically.
+    struct AliasTable {
+        std::vector<double> threshold_list;
+        std::vector<ITYPE> index_list;
+    };
+    bool _use_alias_table = false;
+    mutable std::shared_ptr<const AliasTable> _alias_table;
+
+    void clear_alias_table() const {
+        std::atomic_store(
+            &this->_alias_table, std::shared_ptr<const AliasTable>());
+    }
+
+    std::shared_ptr<const AliasTable> get_alias_table() const {
+        auto alias_table = std::atomic_load(&this->_alias_table);
+        if (alias_table) return alias_table;
+        auto new_alias_table = std::make_shared<AliasTable>();
+        new_alias_table->threshold_list.resize(_dim);
+        new_alias_table->index_list.resize(_dim);
+        state_sampling_alias_table(new_alias_table->threshold_list.data(),
+            new_alias_table->index_list.data(),
+            reinterpret_cast<const CTYPE*>(this->_state_vector), _dim);
+        alias_table = new_alias_table;
+        std::atomic_store(&this->_alias_table, alias_table);
+        return alias_table;
+    }
 
 public:
     /**
@@ -539,7 +706,7 @@ public:
         }
 
         this->_classical_register = _state->classical_register;
-        if (_state->get_device_name() == "gpu") {
+        if (_state->get_device_name() != "cpu") {
             auto ptr = _state->duplicate_data_cpp();
             memcpy(this->data_cpp(), ptr, (size_t)(sizeof(CPPCTYPE) * _dim));
             free(ptr);
@@ -578,6 +745,7 @@ public:
      * \~japanese-en 量子状態のポインタをvoid*型として返す
      */
     virtual void* data() const override {
+        this->clear_alias_table();
         return reinterpret_cast<void*>(this->_state_vector);
     }
     /**
@@ -586,13 +754,17 @@ public:
      *
      * @return 複素ベクトルのポインタ
      */
-    virtual CPPCTYPE* data_cpp() const override { return this->_state_vector; }
+    virtual CPPCTYPE* data_cpp() const override {
+        this->clear_alias_table();
+        return this->_state_vector;
+    }
     /**
      * \~japanese-en 量子状態をcsimのComplex型の配列として取得する
      *
      * @return 複素ベクトルのポインタ
      */
     virtual CTYPE* data_c() const override {
+        this->clear_alias_table();
         return reinterpret_cast<CTYPE*>(this->_state_vector);
     }
 
@@ -679,29 +851,48 @@ public:
         }
     }
 
+    /**
+     * \~japanese-en サンプリングに Walker のエイリアス法を用いるかを設定する
+     *
+     * 有効にすると、sampling
+     * は初回にエイリアス表を構築して状態に保持し、以降は1回あたり定数時間でサンプリングする。
+     * エイリアス表は状態ベクトルが data_c()
+     * などで取り出されるまで再利用されるため、同じ状態から繰り返しサンプリングする場合に有効である。
+     * エイリアス表は状態ベクトルと同じ大きさのメモリを使う。
+     * @param[in] use_alias_table エイリアス法を用いるかどうか
+     */
+    virtual void set_alias_sampling(bool use_alias_table) {
+        this->_use_alias_table = use_alias_table;
+        if (!use_alias_table) this->clear_alias_table();
+    }
+
     /**
      * \~japanese-en 量子状態を測定した際の計算基底のサンプリングを行う
      *
+     * 一様乱数を整列し、確率の累積と乱数の割り当てを状態ベクトルの1回の走査で並列に行う。
+     * set_alias_sampling
+     * で有効にした場合はエイリアス表を用いる。
      * @param[in] sampling_count サンプリングを行う回数
      * @return サンプルされた値のリスト
      */
     virtual std::vector<ITYPE> sampling(UINT sampling_count) override {
-        std::vector<double> stacked_prob;
-        std::vector<ITYPE> result;
-        double sum = 0.;
-        auto ptr = this->data_cpp();
-        stacked_prob.push_back(0.);
-        for (UINT i = 0; i < this->dim; ++i) {
-            sum += norm(ptr[i]);
-            stacked_prob.push_back(sum);
+        if (!this->_use_alias_table) {
+            return _sampling_sorted(sampling_count, random,
+                [this](const double* sorted_random_list, UINT count,
+                    ITYPE* sorted_result) {
+                    state_sampling_sorted(sorted_random_list, count,
+                        sorted_result, this->data_c(), _dim);
+                });
         }
-
+        std::vector<ITYPE> result(sampling_count);
+        const auto alias_table = this->get_alias_table();
         for (UINT count = 0; count < sampling_count; ++count) {
-            double r = random.uniform();
-            auto ite =
-                std::lower_bound(stacked_prob.begin(), stacked_prob.end(), r);
-            auto index = std::distance(stacked_prob.begin(), ite) - 1;
-            result.push_back(index);
+            ITYPE index = (ITYPE)(random.uniform() * this->dim);
+            if (index >= this->dim) index = this->dim - 1;
+            if (random.uniform() >= alias_table->threshold_list[index]) {
+                index = alias_table->index_list[index];
+            }
+            result[count] = index;
         }
         return result;
     }
@@ -710,6 +901,60 @@ public:
         random.set_seed(random_seed);
         return this->sampling(sampling_count);
     }
+
+    /**
+     * \~japanese-en 指定した量子ビットの周辺確率分布を計算する
+     *
+     * 全ての測定結果の周辺確率を状態ベクトルの1回の走査で求める。
+     * @param[in] target_qubit_index_list 測定する量子ビットの添え字のリスト
+     * @return 周辺確率分布。添え字の j ビット目は
+     * target_qubit_index_list[j] の測定結果を表す。
+     */
+    virtual std::vector<double> get_marginal_distribution(
+        const std::vector<UINT>& target_qubit_index_list) const {
+        std::vector<bool> is_used(this->_qubit_count, false);
+        for (auto index : target_qubit_index_list) {
+            if (index >= this->_qubit_count) {
+                throw QubitIndexOutOfRangeException(
+                    "Error: QuantumStateCpu::get_marginal_distribution("
+                    "vector<UINT>): index of target qubit must be smaller "
+                    "than qubit_count");
+            }
+            if (is_used[index]) {
+                throw DuplicatedQubitIndexException(
+                    "Error: QuantumStateCpu::get_marginal_distribution("
+                    "vector<UINT>): target qubits must be distinct");
+            }
+            is_used[index] = true;
+        }
+        std::vector<double> distribution(
+            1ULL << target_qubit_index_list.size());
+        marginal_distribution(target_qubit_index_list.data(),
+            (UINT)target_qubit_index_list.size(), distribution.data(),
+            this->data_c(), _dim);
+        return distribution;
+    }
+
+    /**
+     * \~japanese-en 一部の量子ビットを測定した際の測定結果のサンプリングを行う
+     *
+     * 周辺確率分布を計算し、その小さな表からサンプリングする。
+     * @param[in] sampling_count サンプリングを行う回数
+     * @param[in] target_qubit_index_list 測定する量子ビットの添え字のリスト
+     * @return サンプルされた値のリスト。値の j ビット目は
+     * target_qubit_index_list[j] の測定結果を表す。
+     */
+    virtual std::vector<ITYPE> sampling(UINT sampling_count,
+        const std::vector<UINT>& target_qubit_index_list) {
+        return _sampling_from_distribution(
+            this->get_marginal_distribution(target_qubit_index_list),
+            sampling_count, random);
+    }
+    virtual std::vector<ITYPE> sampling(UINT sampling_count,
+        const std::vector<UINT>& target_qubit_index_list, UINT random_seed) {
+        random.set_seed(random_seed);
+        return this->sampling(sampling_count, target_qubit_index_list);
+    }
     virtual boost::property_tree::ptree to_ptree() const override {
         boost::property_tree::ptree pt;
         pt.put("name", "QuantumState");
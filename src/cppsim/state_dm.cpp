@@ -2,9 +2,13 @@
 
 #include "state_dm.hpp"
 
+#include <algorithm>
 #include <csim/stat_ops_dm.hpp>
 #include <iostream>
 
+#include "state_dm_packed.hpp"
+#include "state_f32.hpp"
+
 namespace state {
 DensityMatrixCpu* tensor_product(
     const DensityMatrixCpu* state_left, const DensityMatrixCpu* state_right) {
@@ -89,6 +93,18 @@ DllExport QuantumStateBase* from_ptree(const boost::property_tree::ptree& pt) {
         }
         qs->load(state_vector);
         return qs;
+    } else if (name == "QuantumStateF32") {
+        UINT qubit_count = pt.get<UINT>("qubit_count");
+        std::vector<UINT> classical_register =
+            ptree::uint_array_from_ptree(pt.get_child("classical_register"));
+        std::vector<CPPCTYPE> state_vector =
+            ptree::complex_array_from_ptree(pt.get_child("state_vector"));
+        QuantumStateCpuF32* qs = new QuantumStateCpuF32(qubit_count);
+        for (UINT i = 0; i < classical_register.size(); i++) {
+            qs->set_classical_value(i, classical_register[i]);
+        }
+        qs->load(state_vector);
+        return qs;
     } else if (name == "DensityMatrix") {
         UINT qubit_count = pt.get<UINT>("qubit_count");
         std::vector<UINT> classical_register =
@@ -101,6 +117,26 @@ DllExport QuantumStateBase* from_ptree(const boost::property_tree::ptree& pt) {
         }
         dm->load(density_matrix);
         return dm;
+    } else if (name == "PackedDensityMatrix") {
+        UINT qubit_count = pt.get<UINT>("qubit_count");
+        std::vector<UINT> classical_register =
+            ptree::uint_array_from_ptree(pt.get_child("classical_register"));
+        std::vector<CPPCTYPE> packed_density_matrix =
+            ptree::complex_array_from_ptree(
+                pt.get_child("packed_density_matrix"));
+        PackedDensityMatrix* dm = new PackedDensityMatrix(qubit_count);
+        if (packed_density_matrix.size() != dm->dim * (dm->dim + 1) / 2) {
+            delete dm;
+            throw InvalidStateVectorSizeException(
+                "Error: from_ptree(const ptree&): invalid length of "
+                "packed_density_matrix");
+        }
+        for (UINT i = 0; i < classical_register.size(); i++) {
+            dm->set_classical_value(i, classical_register[i]);
+        }
+        std::copy(packed_density_matrix.begin(), packed_density_matrix.end(),
+            dm->data_packed());
+        return dm;
     }
     throw UnknownPTreePropertyValueException(
         "unknown value for property \"name\":" + name);
@@ -203,7 +203,7 @@ public:
                 "invalid qubit count");
         }
         if (_state->is_state_vector()) {
-            if (_state->get_device_name() == "gpu") {
+            if (_state->get_device_name() != "cpu") {
                 auto ptr = _state->duplicate_data_c();
                 dm_initialize_with_pure_state(this->data_c(), ptr, dim);
                 free(ptr);
@@ -211,6 +211,11 @@ public:
                 dm_initialize_with_pure_state(
                     this->data_c(), _state->data_c(), dim);
             }
+        } else if (_state->get_device_name() != "cpu") {
+            auto ptr = _state->duplicate_data_cpp();
+            memcpy(this->data_cpp(), ptr,
+                (size_t)(sizeof(CPPCTYPE) * _dim * _dim));
+            free(ptr);
         } else {
             memcpy(this->data_cpp(), _state->data_cpp(),
                 (size_t)(sizeof(CPPCTYPE) * _dim * _dim));
@@ -401,6 +406,60 @@ public:
         random.set_seed(random_seed);
         return this->sampling(sampling_count);
     }
+
+    /**
+     * \~japanese-en 指定した量子ビットの周辺確率分布を計算する
+     *
+     * 全ての測定結果の周辺確率を密度行列の対角成分の1回の走査で求める。
+     * @param[in] target_qubit_index_list 測定する量子ビットの添え字のリスト
+     * @return 周辺確率分布。添え字の j ビット目は
+     * target_qubit_index_list[j] の測定結果を表す。
+     */
+    virtual std::vector<double> get_marginal_distribution(
+        const std::vector<UINT>& target_qubit_index_list) const {
+        std::vector<bool> is_used(this->_qubit_count, false);
+        for (auto index : target_qubit_index_list) {
+            if (index >= this->_qubit_count) {
+                throw QubitIndexOutOfRangeException(
+                    "Error: DensityMatrixCpu::get_marginal_distribution("
+                    "vector<UINT>): index of target qubit must be smaller "
+                    "than qubit_count");
+            }
+            if (is_used[index]) {
+                throw DuplicatedQubitIndexException(
+                    "Error: DensityMatrixCpu::get_marginal_distribution("
+                    "vector<UINT>): target qubits must be distinct");
+            }
+            is_used[index] = true;
+        }
+        std::vector<double> distribution(
+            1ULL << target_qubit_index_list.size());
+        dm_marginal_distribution(target_qubit_index_list.data(),
+            (UINT)target_qubit_index_list.size(), distribution.data(),
+            this->data_c(), _dim);
+        return distribution;
+    }
+
+    /**
+     * \~japanese-en 一部の量子ビットを測定した際の測定結果のサンプリングを行う
+     *
+     * 周辺確率分布を計算し、その小さな表からサンプリングする。
+     * @param[in] sampling_count サンプリングを行う回数
+     * @param[in] target_qubit_index_list 測定する量子ビットの添え字のリスト
+     * @return サンプルされた値のリスト。値の j ビット目は
+     * target_qubit_index_list[j] の測定結果を表す。
+     */
+    virtual std::vector<ITYPE> sampling(UINT sampling_count,
+        const std::vector<UINT>& target_qubit_index_list) {
+        return _sampling_from_distribution(
+            this->get_marginal_distribution(target_qubit_index_list),
+            sampling_count, random);
+    }
+    virtual std::vector<ITYPE> sampling(UINT sampling_count,
+        const std::vector<UINT>& target_qubit_index_list, UINT random_seed) {
+        random.set_seed(random_seed);
+        return this->sampling(sampling_count, target_qubit_index_list);
+    }
     virtual std::string to_string() const override {
         std::stringstream os;
         ComplexMatrix eigen_state(this->dim, this->dim);
@@ -0,0 +1,202 @@
+#include "state_dm_packed.hpp"
+
+#include <algorithm>
+#include <csim/utility.hpp>
+#include <string>
+
+#include "gate.hpp"
+#include "gate_general.hpp"
+
+// gates which are not represented by a matrix or a sum of them
+static const std::vector<std::string> unsupported_gate_name_list = {
+    "Adaptive", "Reflection", "ReversibleBoolean"};
+
+void PackedDensityMatrixCpu::set_computational_basis(ITYPE comp_basis) {
+    if (comp_basis >= (ITYPE)(1ULL << this->qubit_count)) {
+        throw MatrixIndexOutOfRangeException(
+            "Error: PackedDensityMatrixCpu::set_computational_basis(ITYPE): "
+            "index of computational basis must be smaller than "
+            "2^qubit_count");
+    }
+    set_zero_norm_state();
+    _packed_density_matrix[get_packed_hermitian_index(
+        comp_basis, comp_basis, _dim)] = 1.;
+}
+
+void PackedDensityMatrixCpu::load(const QuantumStateBase* _state) {
+    if (_state->qubit_count != this->qubit_count) {
+        throw InvalidQubitCountException(
+            "Error: PackedDensityMatrixCpu::load(const QuantumStateBase*): "
+            "invalid qubit count");
+    }
+    auto packed_state = dynamic_cast<const PackedDensityMatrixCpu*>(_state);
+    if (packed_state != nullptr) {
+        memcpy(this->data_packed(), packed_state->data_packed(),
+            (size_t)(sizeof(CPPCTYPE) * get_packed_size()));
+    } else if (_state->get_device_name() != "cpu") {
+        // the states on the other devices are expanded into the memory
+        CTYPE* ptr = _state->duplicate_data_c();
+        if (_state->is_state_vector()) {
+            dm_packed_initialize_with_pure_state(
+                this->data_packed_c(), ptr, _dim);
+        } else {
+            dm_packed_from_density_matrix(ptr, this->data_packed_c(), _dim);
+        }
+        free(ptr);
+    } else if (_state->is_state_vector()) {
+        dm_packed_initialize_with_pure_state(
+            this->data_packed_c(), _state->data_c(), _dim);
+    } else {
+        dm_packed_from_density_matrix(
+            _state->data_c(), this->data_packed_c(), _dim);
+    }
+    this->_classical_register = _state->classical_register;
+}
+
+void PackedDensityMatrixCpu::apply_gate(const QuantumGateBase* gate) {
+    const std::string name = gate->get_name();
+    if (std::find(unsupported_gate_name_list.begin(),
+            unsupported_gate_name_list.end(),
+            name) != unsupported_gate_name_list.end()) {
+        throw NotImplementedException(
+            "Error: PackedDensityMatrixCpu::apply_gate(const "
+            "QuantumGateBase*): " +
+            name + " gate cannot be applied to packed density matrix");
+    }
+    for (const auto& target : gate->target_qubit_list) {
+        if (target.index() >= this->qubit_count) {
+            throw QubitIndexOutOfRangeException(
+                "Error: PackedDensityMatrixCpu::apply_gate(const "
+                "QuantumGateBase*): index of target qubit must be smaller "
+                "than qubit_count");
+        }
+    }
+    for (const auto& control : gate->control_qubit_list) {
+        if (control.index() >= this->qubit_count) {
+            throw QubitIndexOutOfRangeException(
+                "Error: PackedDensityMatrixCpu::apply_gate(const "
+                "QuantumGateBase*): index of control qubit must be smaller "
+                "than qubit_count");
+        }
+    }
+    if (name == "I") return;
+
+    // noisy gates are the weighted sums of the states after each branch
+    std::vector<QuantumGateBase*> branch_list;
+    std::vector<double> weight_list;
+    double remaining_weight = 0.;
+    auto probabilistic = dynamic_cast<const QuantumGate_Probabilistic*>(gate);
+    auto cptp = dynamic_cast<const QuantumGate_CPTP*>(gate);
+    auto cp = dynamic_cast<const QuantumGate_CP*>(gate);
+    if (probabilistic != nullptr) {
+        branch_list = probabilistic->get_gate_list();
+        weight_list = probabilistic->get_distribution();
+        remaining_weight = 1.;
+        for (double weight : weight_list) remaining_weight -= weight;
+    } else if (cptp != nullptr || cp != nullptr) {
+        branch_list =
+            (cptp != nullptr) ? cptp->get_gate_list() : cp->get_gate_list();
+        weight_list = std::vector<double>(branch_list.size(), 1.);
+    }
+    if (probabilistic != nullptr || cptp != nullptr || cp != nullptr) {
+        PackedDensityMatrixCpu* org_state = this->copy();
+        PackedDensityMatrixCpu* temp_state = this->allocate_buffer();
+        this->multiply_coef(remaining_weight);
+        for (UINT i = 0; i < branch_list.size(); ++i) {
+            temp_state->load(org_state);
+            temp_state->apply_gate(branch_list[i]);
+            this->add_state_with_coef(weight_list[i], temp_state);
+        }
+        delete org_state;
+        delete temp_state;
+        return;
+    }
+
+    ComplexMatrix matrix;
+    gate->set_matrix(matrix);
+    std::vector<UINT> target_index_list = gate->get_target_index_list();
+    std::vector<UINT> control_index_list = gate->get_control_index_list();
+    std::vector<UINT> control_value_list = gate->get_control_value_list();
+    const ITYPE matrix_dim = 1ULL << target_index_list.size();
+    if ((ITYPE)matrix.rows() != matrix_dim ||
+        (ITYPE)matrix.cols() != matrix_dim) {
+        throw InvalidMatrixGateSizeException(
+            "Error: PackedDensityMatrixCpu::apply_gate(const "
+            "QuantumGateBase*): the size of the gate matrix does not match "
+            "the number of target qubits");
+    }
+    // the kernel takes the matrix in row-major order
+    std::vector<CPPCTYPE> matrix_element(matrix_dim * matrix_dim);
+    for (ITYPE y = 0; y < matrix_dim; ++y) {
+        for (ITYPE x = 0; x < matrix_dim; ++x) {
+            matrix_element[y * matrix_dim + x] = matrix(y, x);
+        }
+    }
+    dm_packed_multi_qubit_control_multi_qubit_dense_matrix_gate(
+        control_index_list.data(), control_value_list.data(),
+        (UINT)control_index_list.size(), target_index_list.data(),
+        (UINT)target_index_list.size(), (const CTYPE*)matrix_element.data(),
+        this->data_packed_c(), _dim);
+}
+
+double PackedDensityMatrixCpu::get_Pauli_expectation_value(
+    const std::vector<UINT>& target_qubit_index_list,
+    const std::vector<UINT>& pauli_id_list) const {
+    return dm_packed_expectation_value_multi_qubit_Pauli_operator_partial_list(
+        target_qubit_index_list.data(), pauli_id_list.data(),
+        (UINT)target_qubit_index_list.size(), this->data_packed_c(), _dim);
+}
+
+std::vector<ITYPE> PackedDensityMatrixCpu::sampling(UINT sampling_count) {
+    std::vector<double> stacked_prob;
+    std::vector<ITYPE> result;
+    double sum = 0.;
+    stacked_prob.push_back(0.);
+    for (ITYPE i = 0; i < this->dim; ++i) {
+        sum += abs(
+            _packed_density_matrix[get_packed_hermitian_index(i, i, _dim)]);
+        stacked_prob.push_back(sum);
+    }
+    for (UINT count = 0; count < sampling_count; ++count) {
+        double r = random.uniform();
+        auto ite =
+            std::lower_bound(stacked_prob.begin(), stacked_prob.end(), r);
+        auto index = std::distance(stacked_prob.begin(), ite) - 1;
+        result.push_back(index);
+    }
+    return result;
+}
+
+std::string PackedDensityMatrixCpu::to_string() const {
+    std::stringstream os;
+    ComplexMatrix eigen_state(this->dim, this->dim);
+    for (ITYPE i = 0; i < this->dim; ++i) {
+        for (ITYPE j = i; j < this->dim; ++j) {
+            eigen_state(i, j) =
+                _packed_density_matrix[get_packed_hermitian_index(i, j, _dim)];
+            eigen_state(j, i) = std::conj(eigen_state(i, j));
+        }
+    }
+    os << " *** Density Matrix ***" << std::endl;
+    os << " * Qubit Count : " << this->qubit_count << std::endl;
+    os << " * Dimension   : " << this->dim << std::endl;
+    os << " * Density matrix : \n" << eigen_state << std::endl;
+    return os.str();
+}
+
+namespace state {
+PackedDensityMatrixCpu* partial_trace(
+    const PackedDensityMatrixCpu* state, std::vector<UINT> target_traceout) {
+    if (state->qubit_count <= target_traceout.size()) {
+        throw InvalidQubitCountException(
+            "Error: drop_qubit(const QuantumState*, "
+            "std::vector<UINT>): invalid qubit count");
+    }
+    UINT qubit_count = state->qubit_count - (UINT)target_traceout.size();
+    PackedDensityMatrixCpu* qs = new PackedDensityMatrixCpu(qubit_count);
+    dm_packed_state_partial_trace(target_traceout.data(),
+        (UINT)target_traceout.size(), state->data_packed_c(),
+        qs->data_packed_c(), state->dim);
+    return qs;
+}
+}  // namespace state
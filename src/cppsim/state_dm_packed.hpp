@@ -0,0 +1,397 @@
+#pragma once
+
+#include <csim/memory_ops_dm.hpp>
+#include <csim/stat_ops_dm.hpp>
+#include <csim/update_ops_dm.hpp>
+
+#include "exception.hpp"
+#include "state.hpp"
+
+class QuantumGateBase;
+
+/**
+ * \~japanese-en 密度行列の上三角部分のみを保持するクラス
+ *
+ * 密度行列はエルミートであるため、対角成分と上三角部分を行ごとに詰めた
+ * dim * (dim + 1) / 2 個の要素のみを保持し、下三角部分は共役から求める。
+ * DensityMatrixCpu の約半分のメモリで同じ量子状態を表せる。
+ * ゲートの作用や統計量の計算は上三角部分のみを読み書きする。
+ * 要素の並びが異なるため data(), data_cpp(), data_c() は使えず、
+ * data_packed() で詰めた配列を取得する。
+ */
+class DllExport PackedDensityMatrixCpu : public QuantumStateBase {
+private:
+    CPPCTYPE* _packed_density_matrix;
+    Random random;
+
+    ITYPE get_packed_size() const { return _dim * (_dim + 1) / 2; }
+
+public:
+    /**
+     * \~japanese-en コンストラクタ
+     *
+     * @param qubit_count_ 量子ビット数
+     */
+    explicit PackedDensityMatrixCpu(UINT qubit_count_)
+        : QuantumStateBase(qubit_count_, false) {
+        this->_packed_density_matrix = reinterpret_cast<CPPCTYPE*>(
+            dm_packed_allocate_quantum_state(this->_dim));
+        dm_packed_initialize_quantum_state(this->data_packed_c(), _dim);
+    }
+    /**
+     * \~japanese-en デストラクタ
+     */
+    virtual ~PackedDensityMatrixCpu() {
+        dm_release_quantum_state(this->data_packed_c());
+    }
+    /**
+     * \~japanese-en 量子状態を計算基底の0状態に初期化する
+     */
+    virtual void set_zero_state() override {
+        dm_packed_initialize_quantum_state(this->data_packed_c(), _dim);
+    }
+    /**
+     * \~japanese-en ノルム0の状態 (すべての要素が0の行列にする)
+     */
+    virtual void set_zero_norm_state() override {
+        set_zero_state();
+        _packed_density_matrix[0] = 0.;
+    }
+    /**
+     * \~japanese-en 量子状態を<code>comp_basis</code>の基底状態に初期化する
+     *
+     * @param comp_basis 初期化する基底を表す整数
+     */
+    virtual void set_computational_basis(ITYPE comp_basis) override;
+    /**
+     * \~japanese-en 量子状態をHaar
+     * randomにサンプリングされた量子状態に初期化する
+     */
+    virtual void set_Haar_random_state() override {
+        this->set_Haar_random_state(random.int32());
+    }
+    /**
+     * \~japanese-en 量子状態をシードを用いてHaar
+     * randomにサンプリングされた量子状態に初期化する
+     */
+    virtual void set_Haar_random_state(UINT seed) override {
+        QuantumStateCpu pure_state(qubit_count);
+        pure_state.set_Haar_random_state(seed);
+        dm_packed_initialize_with_pure_state(
+            this->data_packed_c(), pure_state.data_c(), _dim);
+    }
+    /**
+     * \~japanese-en
+     * <code>target_qubit_index</code>の添え字の量子ビットを測定した時、0が観測される確率を計算する。
+     *
+     * 量子状態は変更しない。
+     * @param target_qubit_index
+     * @return double
+     */
+    virtual double get_zero_probability(
+        UINT target_qubit_index) const override {
+        if (target_qubit_index >= this->qubit_count) {
+            throw QubitIndexOutOfRangeException(
+                "Error: PackedDensityMatrixCpu::get_zero_probability(UINT): "
+                "index of target qubit must be smaller than qubit_count");
+        }
+        return dm_packed_M0_prob(
+            target_qubit_index, this->data_packed_c(), _dim);
+    }
+    /**
+     * \~japanese-en 複数の量子ビットを測定した時の周辺確率を計算する
+     *
+     * @param measured_values
+     * 量子ビット数と同じ長さの0,1,2の配列。0,1はその値が観測され、2は測定をしないことを表す。
+     * @return 計算された周辺確率
+     */
+    virtual double get_marginal_probability(
+        std::vector<UINT> measured_values) const override {
+        if (measured_values.size() != this->qubit_count) {
+            throw InvalidQubitCountException(
+                "Error: PackedDensityMatrixCpu::get_marginal_probability("
+                "vector<UINT>): the length of measured_values must be equal "
+                "to qubit_count");
+        }
+        std::vector<UINT> target_index;
+        std::vector<UINT> target_value;
+        for (UINT i = 0; i < measured_values.size(); ++i) {
+            UINT measured_value = measured_values[i];
+            if (measured_value == 0 || measured_value == 1) {
+                target_index.push_back(i);
+                target_value.push_back(measured_value);
+            }
+        }
+        return dm_packed_marginal_prob(target_index.data(),
+            target_value.data(), (UINT)target_index.size(),
+            this->data_packed_c(), _dim);
+    }
+    /**
+     * \~japanese-en
+     * 計算基底で測定した時得られる確率分布のエントロピーを計算する。
+     *
+     * @return エントロピー
+     */
+    virtual double get_entropy() const override {
+        return dm_packed_measurement_distribution_entropy(
+            this->data_packed_c(), _dim);
+    }
+    /**
+     * \~japanese-en 量子状態のノルムを計算する
+     *
+     * 量子状態のノルムは非ユニタリなゲートを作用した時に小さくなる。
+     * @return ノルム
+     */
+    virtual double get_squared_norm() const override {
+        return dm_packed_state_norm_squared(this->data_packed_c(), _dim);
+    }
+    /**
+     * \~japanese-en 量子状態のノルムを計算する
+     *
+     * 量子状態のノルムは非ユニタリなゲートを作用した時に小さくなる。
+     * @return ノルム
+     */
+    virtual double get_squared_norm_single_thread() const override {
+        return dm_packed_state_norm_squared(this->data_packed_c(), _dim);
+    }
+    /**
+     * \~japanese-en 量子状態を正規化する
+     *
+     * @param norm 自身のノルム
+     */
+    virtual void normalize(double squared_norm) override {
+        dm_packed_normalize(squared_norm, this->data_packed_c(), _dim);
+    }
+    /**
+     * \~japanese-en 量子状態を正規化する
+     *
+     * @param norm 自身のノルム
+     */
+    virtual void normalize_single_thread(double squared_norm) override {
+        dm_packed_normalize(squared_norm, this->data_packed_c(), _dim);
+    }
+    /**
+     * \~japanese-en バッファとして同じサイズの量子状態を作成する。
+     *
+     * @return 生成された量子状態
+     */
+    virtual PackedDensityMatrixCpu* allocate_buffer() const override {
+        return new PackedDensityMatrixCpu(this->_qubit_count);
+    }
+    /**
+     * \~japanese-en 自身の状態のディープコピーを生成する
+     *
+     * @return 自身のディープコピー
+     */
+    virtual PackedDensityMatrixCpu* copy() const override {
+        PackedDensityMatrixCpu* new_state =
+            new PackedDensityMatrixCpu(this->_qubit_count);
+        memcpy(new_state->data_packed(), _packed_density_matrix,
+            (size_t)(sizeof(CPPCTYPE) * get_packed_size()));
+        for (UINT i = 0; i < _classical_register.size(); ++i)
+            new_state->set_classical_value(i, _classical_register[i]);
+        return new_state;
+    }
+    /**
+     * \~japanese-en <code>state</code>の量子状態を自身へコピーする。
+     */
+    virtual void load(const QuantumStateBase* _state) override;
+    /**
+     * \~japanese-en <code>state</code>の量子状態を自身へコピーする。
+     *
+     * 長さが 2^n の場合は状態ベクトル、4^n
+     * の場合は行優先の密度行列とみなす。
+     */
+    virtual void load(const std::vector<CPPCTYPE>& _state) override {
+        if (_state.size() != _dim && _state.size() != _dim * _dim) {
+            throw InvalidStateVectorSizeException(
+                "Error: PackedDensityMatrixCpu::load(vector<Complex>&): "
+                "invalid length of state");
+        }
+        if (_state.size() == _dim) {
+            dm_packed_initialize_with_pure_state(
+                this->data_packed_c(), (const CTYPE*)_state.data(), _dim);
+        } else {
+            dm_packed_from_density_matrix(
+                (const CTYPE*)_state.data(), this->data_packed_c(), _dim);
+        }
+    }
+    /**
+     * \~japanese-en 行優先の密度行列を自身へコピーする。
+     */
+    virtual void load(const CPPCTYPE* _state) override {
+        dm_packed_from_density_matrix(
+            (const CTYPE*)_state, this->data_packed_c(), _dim);
+    }
+    /**
+     * \~japanese-en
+     * 量子状態が配置されているメモリを保持するデバイス名を取得する。
+     */
+    virtual const std::string get_device_name() const override {
+        return "cpu_packed";
+    }
+    [[noreturn]] virtual void* data() const override {
+        throw NotImplementedException(
+            "Error: PackedDensityMatrixCpu::data(): packed density matrix "
+            "does not hold the full matrix, use data_packed()");
+    }
+    [[noreturn]] virtual CPPCTYPE* data_cpp() const override {
+        throw NotImplementedException(
+            "Error: PackedDensityMatrixCpu::data_cpp(): packed density "
+            "matrix does not hold the full matrix, use data_packed()");
+    }
+    [[noreturn]] virtual CTYPE* data_c() const override {
+        throw NotImplementedException(
+            "Error: PackedDensityMatrixCpu::data_c(): packed density matrix "
+            "does not hold the full matrix, use data_packed()");
+    }
+    /**
+     * \~japanese-en 上三角部分を行ごとに詰めた配列を取得する
+     *
+     * (i, j) 成分 (i <= j) は i * dim - i * (i - 1) / 2 + (j - i)
+     * 番目の要素である。
+     * @return 長さ dim * (dim + 1) / 2 の配列のポインタ
+     */
+    virtual CPPCTYPE* data_packed() const {
+        return this->_packed_density_matrix;
+    }
+    /**
+     * \~japanese-en 上三角部分を行ごとに詰めた配列をcsimのComplex型で取得する
+     *
+     * @return 長さ dim * (dim + 1) / 2 の配列のポインタ
+     */
+    virtual CTYPE* data_packed_c() const {
+        return reinterpret_cast<CTYPE*>(this->_packed_density_matrix);
+    }
+    /**
+     * \~japanese-en 行優先の密度行列を生成する。
+     *
+     * @return 長さ dim * dim の配列
+     */
+    virtual CTYPE* duplicate_data_c() const override {
+        CTYPE* new_data = (CTYPE*)malloc(sizeof(CTYPE) * _dim * _dim);
+        dm_packed_to_density_matrix(this->data_packed_c(), new_data, _dim);
+        return new_data;
+    }
+    /**
+     * \~japanese-en 行優先の密度行列を生成する。
+     *
+     * @return 長さ dim * dim の配列
+     */
+    virtual CPPCTYPE* duplicate_data_cpp() const override {
+        return reinterpret_cast<CPPCTYPE*>(this->duplicate_data_c());
+    }
+    /**
+     * \~japanese-en 量子状態を足しこむ
+     */
+    virtual void add_state(const QuantumStateBase* state) override {
+        this->add_state_with_coef(1., state);
+    }
+    /**
+     * \~japanese-en 量子状態を足しこむ
+     *
+     * エルミート性を保つため係数は実数でなければならない。
+     */
+    virtual void add_state_with_coef(
+        CPPCTYPE coef, const QuantumStateBase* state) override {
+        auto packed_state = dynamic_cast<const PackedDensityMatrixCpu*>(state);
+        if (packed_state == nullptr) {
+            throw InoperatableQuantumStateTypeException(
+                "Error: PackedDensityMatrixCpu::add_state_with_coef("
+                "CPPCTYPE, const QuantumStateBase*): only packed density "
+                "matrices can be added");
+        }
+        if (std::abs(coef.imag()) > 0) {
+            throw NonHermitianException(
+                "Error: PackedDensityMatrixCpu::add_state_with_coef("
+                "CPPCTYPE, const QuantumStateBase*): coefficient must be "
+                "real");
+        }
+        dm_packed_state_add_with_coef(coef.real(),
+            packed_state->data_packed_c(), this->data_packed_c(), _dim);
+    }
+    /**
+     * \~japanese-en 量子状態を足しこむ
+     */
+    virtual void add_state_with_coef_single_thread(
+        CPPCTYPE coef, const QuantumStateBase* state) override {
+        this->add_state_with_coef(coef, state);
+    }
+    /**
+     * \~japanese-en 実数をかける
+     *
+     * エルミート性を保つため係数は実数でなければならない。
+     */
+    virtual void multiply_coef(CPPCTYPE coef) override {
+        if (std::abs(coef.imag()) > 0) {
+            throw NonHermitianException(
+                "Error: PackedDensityMatrixCpu::multiply_coef(CPPCTYPE): "
+                "coefficient must be real");
+        }
+        dm_packed_state_multiply(coef.real(), this->data_packed_c(), _dim);
+    }
+    [[noreturn]] virtual void multiply_elementwise_function(
+        const std::function<CPPCTYPE(ITYPE)>&) override {
+        throw NotImplementedException(
+            "multiply_elementwise_function for density matrix is not "
+            "implemented");
+    }
+
+    /**
+     * \~japanese-en 量子ゲートを作用させる
+     *
+     * 行列で表せるゲートは上三角部分のブロックごとに両側から作用させる。
+     * Probabilistic, CPTP, CP のゲートは各ゲートを作用させた状態の和を取る。
+     * @param gate 作用させる量子ゲート
+     */
+    virtual void apply_gate(const QuantumGateBase* gate) override;
+
+    virtual bool is_gate_applied_by_state() const override { return true; }
+
+    virtual bool is_Pauli_expectation_computed_by_state() const override {
+        return true;
+    }
+
+    /**
+     * \~japanese-en パウリ演算子の期待値を計算する
+     *
+     * @param target_qubit_index_list 作用する量子ビットの添え字のリスト
+     * @param pauli_id_list パウリ演算子のリスト。(I,X,Y,Z)が(0,1,2,3)に対応する。
+     * @return 期待値
+     */
+    virtual double get_Pauli_expectation_value(
+        const std::vector<UINT>& target_qubit_index_list,
+        const std::vector<UINT>& pauli_id_list) const override;
+
+    /**
+     * \~japanese-en 量子状態を測定した際の計算基底のサンプリングを行う
+     *
+     * @param[in] sampling_count サンプリングを行う回数
+     * @return サンプルされた値のリスト
+     */
+    virtual std::vector<ITYPE> sampling(UINT sampling_count) override;
+    virtual std::vector<ITYPE> sampling(
+        UINT sampling_count, UINT random_seed) override {
+        random.set_seed(random_seed);
+        return this->sampling(sampling_count);
+    }
+    virtual std::string to_string() const override;
+    virtual boost::property_tree::ptree to_ptree() const override {
+        boost::property_tree::ptree pt;
+        pt.put("name", "PackedDensityMatrix");
+        pt.put("qubit_count", _qubit_count);
+        pt.put_child(
+            "classical_register", ptree::to_ptree(_classical_register));
+        pt.put_child("packed_density_matrix",
+            ptree::to_ptree(std::vector<CPPCTYPE>(_packed_density_matrix,
+                _packed_density_matrix + get_packed_size())));
+        return pt;
+    }
+};
+
+using PackedDensityMatrix = PackedDensityMatrixCpu;
+
+namespace state {
+DllExport PackedDensityMatrixCpu* partial_trace(
+    const PackedDensityMatrixCpu* state, std::vector<UINT> target_traceout);
+}  // namespace state
@@ -0,0 +1,148 @@
+#include "state_f32.hpp"
+
+#include <string>
+
+#include "gate.hpp"
+#include "gate_general.hpp"
+#include "gate_named_pauli.hpp"
+#include "gate_noisy_evolution.hpp"
+#include "gate_reflect.hpp"
+#include "gate_reversible.hpp"
+
+// Pauli id of each target qubit, which is recovered from the commutation
+// flags of the targets of Pauli and Pauli-rotation gates
+static std::vector<UINT> get_pauli_id_list(const QuantumGateBase* gate) {
+    std::vector<UINT> pauli_id_list;
+    for (const auto& target : gate->target_qubit_list) {
+        if (target.is_commute_X())
+            pauli_id_list.push_back(1);
+        else if (target.is_commute_Y())
+            pauli_id_list.push_back(2);
+        else if (target.is_commute_Z())
+            pauli_id_list.push_back(3);
+        else
+            pauli_id_list.push_back(0);
+    }
+    return pauli_id_list;
+}
+
+bool QuantumStateCpuF32::is_supported_gate(
+    const QuantumGateBase* gate) const {
+    // gates which are not represented by a matrix acting on a state vector
+    return dynamic_cast<const QuantumGate_Probabilistic*>(gate) == nullptr &&
+           dynamic_cast<const QuantumGate_CPTP*>(gate) == nullptr &&
+           dynamic_cast<const QuantumGate_CP*>(gate) == nullptr &&
+           dynamic_cast<const QuantumGate_Adaptive*>(gate) == nullptr &&
+           dynamic_cast<const ClsStateReflectionGate*>(gate) == nullptr &&
+           dynamic_cast<const ClsReversibleBooleanGate*>(gate) == nullptr &&
+           dynamic_cast<const ClsNoisyEvolution*>(gate) == nullptr &&
+           dynamic_cast<const ClsNoisyEvolution_fast*>(gate) == nullptr &&
+           dynamic_cast<const ClsNoisyEvolution_auto*>(gate) == nullptr;
+}
+
+void QuantumStateCpuF32::apply_gate(const QuantumGateBase* gate) {
+    if (!this->is_supported_gate(gate)) {
+        throw NotImplementedException(
+            "Error: QuantumStateCpuF32::apply_gate(const QuantumGateBase*): " +
+            gate->get_name() +
+            " gate cannot be applied to single-precision state");
+    }
+    for (const auto& target : gate->target_qubit_list) {
+        if (target.index() >= this->qubit_count) {
+            throw QubitIndexOutOfRangeException(
+                "Error: QuantumStateCpuF32::apply_gate(const "
+                "QuantumGateBase*): index of target qubit must be smaller "
+                "than qubit_count");
+        }
+    }
+    for (const auto& control : gate->control_qubit_list) {
+        if (control.index() >= this->qubit_count) {
+            throw QubitIndexOutOfRangeException(
+                "Error: QuantumStateCpuF32::apply_gate(const "
+                "QuantumGateBase*): index of control qubit must be smaller "
+                "than qubit_count");
+        }
+    }
+
+    std::complex<float>* state = this->_state_vector;
+    std::vector<UINT> target_index_list = gate->get_target_index_list();
+    std::vector<UINT> control_index_list = gate->get_control_index_list();
+    if (dynamic_cast<const ClsPauliGate*>(gate) != nullptr) {
+        std::vector<UINT> pauli_id_list = get_pauli_id_list(gate);
+        return multi_qubit_Pauli_gate_partial_list(target_index_list.data(),
+            pauli_id_list.data(), (UINT)target_index_list.size(), state, _dim);
+    }
+    auto pauli_rotation = dynamic_cast<const ClsPauliRotationGate*>(gate);
+    if (pauli_rotation != nullptr) {
+        std::vector<UINT> pauli_id_list = get_pauli_id_list(gate);
+        return multi_qubit_Pauli_rotation_gate_partial_list(
+            target_index_list.data(), pauli_id_list.data(),
+            (UINT)target_index_list.size(), pauli_rotation->get_angle(), state,
+            _dim);
+    }
+
+    // named gates are applied through their matrices with the diagonal or
+    // dense kernels, which also take one sweep
+    ComplexMatrix matrix;
+    gate->set_matrix(matrix);
+    std::vector<UINT> control_value_list = gate->get_control_value_list();
+    const UINT control_count = (UINT)control_index_list.size();
+    const UINT target_count = (UINT)target_index_list.size();
+    const ITYPE matrix_dim = 1ULL << target_count;
+    if ((ITYPE)matrix.rows() != matrix_dim ||
+        (ITYPE)matrix.cols() != matrix_dim) {
+        throw InvalidMatrixGateSizeException(
+            "Error: QuantumStateCpuF32::apply_gate(const QuantumGateBase*): "
+            "the size of the gate matrix does not match the number of "
+            "target qubits");
+    }
+    if (gate->is_diagonal()) {
+        std::vector<std::complex<float>> diagonal_element(matrix_dim);
+        for (ITYPE i = 0; i < matrix_dim; ++i) {
+            diagonal_element[i] = std::complex<float>(matrix(i, i));
+        }
+        if (control_count == 0 && target_count == 1) {
+            return single_qubit_diagonal_matrix_gate(
+                target_index_list[0], diagonal_element.data(), state, _dim);
+        }
+        return multi_qubit_control_multi_qubit_diagonal_matrix_gate(
+            control_index_list.data(), control_value_list.data(),
+            control_count, target_index_list.data(), target_count,
+            diagonal_element.data(), state, _dim);
+    }
+
+    // the kernels take the matrix in row-major order
+    std::vector<std::complex<float>> matrix_element(matrix_dim * matrix_dim);
+    for (ITYPE y = 0; y < matrix_dim; ++y) {
+        for (ITYPE x = 0; x < matrix_dim; ++x) {
+            matrix_element[y * matrix_dim + x] =
+                std::complex<float>(matrix(y, x));
+        }
+    }
+    if (control_count == 0 && target_count == 1) {
+        return single_qubit_dense_matrix_gate(
+            target_index_list[0], matrix_element.data(), state, _dim);
+    }
+    multi_qubit_control_multi_qubit_dense_matrix_gate(
+        control_index_list.data(), control_value_list.data(), control_count,
+        target_index_list.data(), target_count, matrix_element.data(), state,
+        _dim);
+}
+
+namespace state {
+CPPCTYPE inner_product(
+    const QuantumStateCpuF32* state_bra, const QuantumStateCpuF32* state_ket) {
+    if (state_bra->qubit_count != state_ket->qubit_count) {
+        throw InvalidQubitCountException(
+            "Error: inner_product(const QuantumStateCpuF32*, const "
+            "QuantumStateCpuF32*): invalid qubit count");
+    }
+    return state_inner_product(
+        state_bra->data_f32(), state_ket->data_f32(), state_bra->dim);
+}
+QuantumStateCpuF32* to_single_precision(const QuantumStateBase* state) {
+    QuantumStateCpuF32* qs = new QuantumStateCpuF32(state->qubit_count);
+    qs->load(state);
+    return qs;
+}
+}  // namespace state
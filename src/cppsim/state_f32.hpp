@@ -0,0 +1,499 @@
+#pragma once
+
+#include <csim/memory_ops_template.hpp>
+#include <csim/stat_ops_template.hpp>
+#include <csim/update_ops_template.hpp>
+
+#include "exception.hpp"
+#include "state.hpp"
+
+class QuantumGateBase;
+
+/**
+ * \~japanese-en 単精度の複素数で状態ベクトルを保持する量子状態のクラス
+ *
+ * 状態ベクトルを<code>std::complex\<float\></code>の配列として保持し、
+ * QuantumStateCpu の半分のメモリで同じ量子ビット数の状態を扱う。
+ * 量子ゲートは apply_gate または QuantumCircuit::update_quantum_state
+ * により作用させる。ノルムや期待値などの集計は倍精度で行う。
+ */
+class DllExport QuantumStateCpuF32 : public QuantumStateBase {
+private:
+    std::complex<float>* _state_vector;
+    Random random;
+
+public:
+    /**
+     * \~japanese-en コンストラクタ
+     *
+     * @param qubit_count_ 量子ビット数
+     */
+    explicit QuantumStateCpuF32(UINT qubit_count_)
+        : QuantumStateBase(qubit_count_, true) {
+        this->_state_vector = allocate_quantum_state<float>(this->_dim);
+        initialize_quantum_state(this->_state_vector, _dim);
+    }
+    /**
+     * \~japanese-en デストラクタ
+     */
+    virtual ~QuantumStateCpuF32() {
+        release_quantum_state(this->_state_vector);
+    }
+    /**
+     * \~japanese-en 量子状態を計算基底の0状態に初期化する
+     */
+    virtual void set_zero_state() override {
+        initialize_quantum_state(this->_state_vector, _dim);
+    }
+    /**
+     * \~japanese-en 量子状態をノルム0の状態にする
+     */
+    virtual void set_zero_norm_state() override {
+        set_zero_state();
+        _state_vector[0] = 0;
+    }
+    /**
+     * \~japanese-en 量子状態を<code>comp_basis</code>の基底状態に初期化する
+     *
+     * @param comp_basis 初期化する基底を表す整数
+     */
+    virtual void set_computational_basis(ITYPE comp_basis) override {
+        if (comp_basis >= (ITYPE)(1ULL << this->qubit_count)) {
+            throw MatrixIndexOutOfRangeException(
+                "Error: QuantumStateCpuF32::set_computational_basis(ITYPE): "
+                "index of computational basis must be smaller than "
+                "2^qubit_count");
+        }
+        set_zero_state();
+        _state_vector[0] = 0.f;
+        _state_vector[comp_basis] = 1.f;
+    }
+    /**
+     * \~japanese-en 量子状態をHaar
+     * randomにサンプリングされた量子状態に初期化する
+     */
+    virtual void set_Haar_random_state() override {
+        initialize_Haar_random_state_with_seed(
+            this->_state_vector, _dim, random.int32());
+    }
+    /**
+     * \~japanese-en 量子状態をシードを用いてHaar
+     * randomにサンプリングされた量子状態に初期化する
+     */
+    virtual void set_Haar_random_state(UINT seed) override {
+        initialize_Haar_random_state_with_seed(this->_state_vector, _dim, seed);
+    }
+    /**
+     * \~japanese-en
+     * <code>target_qubit_index</code>の添え字の量子ビットを測定した時、0が観測される確率を計算する。
+     *
+     * 量子状態は変更しない。
+     * @param target_qubit_index
+     * @return double
+     */
+    virtual double get_zero_probability(
+        UINT target_qubit_index) const override {
+        if (target_qubit_index >= this->qubit_count) {
+            throw QubitIndexOutOfRangeException(
+                "Error: QuantumStateCpuF32::get_zero_probability(UINT): "
+                "index of target qubit must be smaller than qubit_count");
+        }
+        return M0_prob(target_qubit_index, this->_state_vector, _dim);
+    }
+    /**
+     * \~japanese-en 複数の量子ビットを測定した時の周辺確率を計算する
+     *
+     * @param measured_values
+     * 量子ビット数と同じ長さの0,1,2の配列。0,1はその値が観測され、2は測定をしないことを表す。
+     * @return 計算された周辺確率
+     */
+    virtual double get_marginal_probability(
+        std::vector<UINT> measured_values) const override {
+        if (measured_values.size() != this->qubit_count) {
+            throw InvalidQubitCountException(
+                "Error: "
+                "QuantumStateCpuF32::get_marginal_probability(vector<UINT>): "
+                "the length of measured_values must be equal to qubit_count");
+        }
+
+        std::vector<UINT> target_index;
+        std::vector<UINT> target_value;
+        for (UINT i = 0; i < measured_values.size(); ++i) {
+            UINT measured_value = measured_values[i];
+            if (measured_value == 0 || measured_value == 1) {
+                target_index.push_back(i);
+                target_value.push_back(measured_value);
+            }
+        }
+        return marginal_prob(target_index.data(), target_value.data(),
+            (UINT)target_index.size(), this->_state_vector, _dim);
+    }
+    /**
+     * \~japanese-en
+     * 計算基底で測定した時得られる確率分布のエントロピーを計算する。
+     *
+     * @return エントロピー
+     */
+    virtual double get_entropy() const override {
+        return measurement_distribution_entropy(this->_state_vector, _dim);
+    }
+    /**
+     * \~japanese-en 量子状態のノルムを計算する
+     *
+     * 量子状態のノルムは非ユニタリなゲートを作用した時に小さくなる。
+     * @return ノルム
+     */
+    virtual double get_squared_norm() const override {
+        return state_norm_squared(this->_state_vector, _dim);
+    }
+    /**
+     * \~japanese-en 量子状態のノルムを計算する
+     *
+     * 量子状態のノルムは非ユニタリなゲートを作用した時に小さくなる。
+     * @return ノルム
+     */
+    virtual double get_squared_norm_single_thread() const override {
+        double norm = 0.;
+        for (ITYPE index = 0; index < _dim; ++index) {
+            norm += std::norm((CPPCTYPE)_state_vector[index]);
+        }
+        return norm;
+    }
+    /**
+     * \~japanese-en 量子状態を正規化する
+     *
+     * @param norm 自身のノルム
+     */
+    virtual void normalize(double squared_norm) override {
+        ::normalize(squared_norm, this->_state_vector, _dim);
+    }
+    /**
+     * \~japanese-en 量子状態を正規化する
+     *
+     * @param norm 自身のノルム
+     */
+    virtual void normalize_single_thread(double squared_norm) override {
+        const float normalize_factor = (float)(1. / sqrt(squared_norm));
+        for (ITYPE index = 0; index < _dim; ++index) {
+            _state_vector[index] *= normalize_factor;
+        }
+    }
+    /**
+     * \~japanese-en バッファとして同じサイズの量子状態を作成する。
+     *
+     * @return 生成された量子状態
+     */
+    virtual QuantumStateCpuF32* allocate_buffer() const override {
+        return new QuantumStateCpuF32(this->_qubit_count);
+    }
+    /**
+     * \~japanese-en 自身の状態のディープコピーを生成する
+     *
+     * @return 自身のディープコピー
+     */
+    virtual QuantumStateCpuF32* copy() const override {
+        QuantumStateCpuF32* new_state =
+            new QuantumStateCpuF32(this->_qubit_count);
+        memcpy(new_state->data_f32(), this->_state_vector,
+            (size_t)(sizeof(std::complex<float>) * _dim));
+        for (UINT i = 0; i < _classical_register.size(); ++i) {
+            new_state->set_classical_value(i, _classical_register[i]);
+        }
+        return new_state;
+    }
+    /**
+     * \~japanese-en <code>state</code>の量子状態を自身へコピーする。
+     *
+     * 倍精度の量子状態は単精度に変換される。
+     */
+    virtual void load(const QuantumStateBase* _state) override {
+        if (_state->qubit_count != this->qubit_count) {
+            throw InvalidQubitCountException(
+                "Error: QuantumStateCpuF32::load(const QuantumStateBase*): "
+                "invalid qubit count");
+        }
+        if (!_state->is_state_vector()) {
+            throw InoperatableQuantumStateTypeException(
+                "Error: QuantumStateCpuF32::load(const QuantumStateBase*): "
+                "cannot load DensityMatrix to StateVector");
+        }
+
+        this->_classical_register = _state->classical_register;
+        auto state_f32 = dynamic_cast<const QuantumStateCpuF32*>(_state);
+        if (state_f32 != nullptr) {
+            memcpy(this->_state_vector, state_f32->data_f32(),
+                (size_t)(sizeof(std::complex<float>) * _dim));
+        } else if (_state->get_device_name() != "cpu") {
+            auto ptr = _state->duplicate_data_c();
+            convert_quantum_state(ptr, this->_state_vector, _dim);
+            free(ptr);
+        } else {
+            convert_quantum_state(_state->data_c(), this->_state_vector, _dim);
+        }
+    }
+    /**
+     * \~japanese-en <code>state</code>の量子状態を自身へコピーする。
+     */
+    virtual void load(const std::vector<CPPCTYPE>& _state) override {
+        if (_state.size() != _dim) {
+            throw InvalidStateVectorSizeException(
+                "Error: QuantumStateCpuF32::load(vector<Complex>&): invalid "
+                "length of state");
+        }
+        convert_quantum_state(_state.data(), this->_state_vector, _dim);
+    }
+    /**
+     * \~japanese-en <code>state</code>の量子状態を自身へコピーする。
+     */
+    virtual void load(const CPPCTYPE* _state) override {
+        convert_quantum_state(_state, this->_state_vector, _dim);
+    }
+    /**
+     * \~japanese-en
+     * 量子状態が配置されているメモリを保持するデバイス名を取得する。
+     */
+    virtual const std::string get_device_name() const override { return "cpu"; }
+    /**
+     * \~japanese-en 量子状態のポインタをvoid*型として返す
+     *
+     * 指す先は<code>std::complex\<float\></code>の配列である。
+     */
+    virtual void* data() const override {
+        return reinterpret_cast<void*>(this->_state_vector);
+    }
+    /**
+     * \~japanese-en
+     * 量子状態を<code>std::complex\<float\></code>の配列として取得する
+     *
+     * @return 複素ベクトルのポインタ
+     */
+    virtual std::complex<float>* data_f32() const {
+        return this->_state_vector;
+    }
+    /**
+     * \~japanese-en 単精度の状態は倍精度の配列として直接取得できない。
+     * duplicate_data_cpp を用いる。
+     */
+    [[noreturn]] virtual CPPCTYPE* data_cpp() const override {
+        throw NotImplementedException(
+            "Error: QuantumStateCpuF32::data_cpp(): single-precision state "
+            "cannot be accessed as complex<double>. Apply gates with "
+            "QuantumCircuit::update_quantum_state or apply_gate, and read "
+            "the state with duplicate_data_cpp()");
+    }
+    /**
+     * \~japanese-en 単精度の状態は倍精度の配列として直接取得できない。
+     * duplicate_data_c を用いる。
+     */
+    [[noreturn]] virtual CTYPE* data_c() const override {
+        throw NotImplementedException(
+            "Error: QuantumStateCpuF32::data_c(): single-precision state "
+            "cannot be accessed as complex<double>. Apply gates with "
+            "QuantumCircuit::update_quantum_state or apply_gate, and read "
+            "the state with duplicate_data_c()");
+    }
+    /**
+     * \~japanese-en
+     * 量子状態を倍精度に変換したcsimのComplex型の配列として新たに確保する
+     *
+     * @return 複素ベクトルのポインタ
+     */
+    virtual CTYPE* duplicate_data_c() const override {
+        CTYPE* new_data = (CTYPE*)malloc(sizeof(CTYPE) * _dim);
+        convert_quantum_state(this->_state_vector, new_data, _dim);
+        return new_data;
+    }
+    /**
+     * \~japanese-en
+     * 量子状態を倍精度に変換したC++の<code>std::complex\<double\></code>の配列として新たに確保する
+     *
+     * @return 複素ベクトルのポインタ
+     */
+    virtual CPPCTYPE* duplicate_data_cpp() const override {
+        return reinterpret_cast<CPPCTYPE*>(this->duplicate_data_c());
+    }
+    /**
+     * \~japanese-en 量子状態を足しこむ
+     */
+    virtual void add_state(const QuantumStateBase* state) override {
+        this->add_state_with_coef(1., state);
+    }
+    /**
+     * \~japanese-en 量子状態を係数付きで足しこむ
+     */
+    virtual void add_state_with_coef(
+        CPPCTYPE coef, const QuantumStateBase* state) override {
+        auto state_f32 = dynamic_cast<const QuantumStateCpuF32*>(state);
+        if (state_f32 == nullptr) {
+            throw InoperatableQuantumStateTypeException(
+                "Error: QuantumStateCpuF32::add_state_with_coef(CPPCTYPE, "
+                "const QuantumStateBase*): only QuantumStateCpuF32 can be "
+                "added to QuantumStateCpuF32");
+        }
+        state_add_with_coef(std::complex<float>(coef), state_f32->data_f32(),
+            this->_state_vector, this->dim);
+    }
+    /**
+     * \~japanese-en 量子状態を係数付きで足しこむ
+     */
+    virtual void add_state_with_coef_single_thread(
+        CPPCTYPE coef, const QuantumStateBase* state) override {
+        auto state_f32 = dynamic_cast<const QuantumStateCpuF32*>(state);
+        if (state_f32 == nullptr) {
+            throw InoperatableQuantumStateTypeException(
+                "Error: "
+                "QuantumStateCpuF32::add_state_with_coef_single_thread("
+                "CPPCTYPE, const QuantumStateBase*): only QuantumStateCpuF32 "
+                "can be added to QuantumStateCpuF32");
+        }
+        const std::complex<float> coef_f32(coef);
+        const std::complex<float>* state_added = state_f32->data_f32();
+        for (ITYPE index = 0; index < _dim; ++index) {
+            _state_vector[index] += coef_f32 * state_added[index];
+        }
+    }
+    /**
+     * \~japanese-en 複素数をかける
+     */
+    virtual void multiply_coef(CPPCTYPE coef) override {
+        state_multiply(
+            std::complex<float>(coef), this->_state_vector, this->dim);
+    }
+
+    virtual void multiply_elementwise_function(
+        const std::function<CPPCTYPE(ITYPE)>& func) override {
+        for (ITYPE idx = 0; idx < dim; ++idx) {
+            _state_vector[idx] = std::complex<float>(
+                (CPPCTYPE)_state_vector[idx] * (CPPCTYPE)func(idx));
+        }
+    }
+
+    /**
+     * \~japanese-en 量子ゲートを作用させる
+     *
+     * パウリゲート、パウリ回転ゲートは専用の関数で、
+     * それ以外のユニタリゲートはゲート行列により作用させる。
+     * 測定やノイズなど行列で表せないゲートは作用できない。
+     * @param gate 作用させる量子ゲート
+     */
+    virtual void apply_gate(const QuantumGateBase* gate) override;
+
+    virtual bool is_gate_applied_by_state() const override { return true; }
+
+    virtual bool is_Pauli_expectation_computed_by_state() const override {
+        return true;
+    }
+
+    /**
+     * \~japanese-en パウリ演算子の期待値を単精度の状態ベクトルから計算する
+     *
+     * @param target_qubit_index_list 作用する量子ビットの添え字のリスト
+     * @param pauli_id_list パウリ演算子のリスト。(I,X,Y,Z)が(0,1,2,3)に対応する。
+     * @return 期待値
+     */
+    virtual double get_Pauli_expectation_value(
+        const std::vector<UINT>& target_qubit_index_list,
+        const std::vector<UINT>& pauli_id_list) const override {
+        return expectation_value_multi_qubit_Pauli_operator_partial_list(
+            target_qubit_index_list.data(), pauli_id_list.data(),
+            (UINT)target_qubit_index_list.size(), this->data_f32(), _dim);
+    }
+    virtual double get_Pauli_expectation_value_single_thread(
+        const std::vector<UINT>& target_qubit_index_list,
+        const std::vector<UINT>& pauli_id_list) const override {
+        return expectation_value_multi_qubit_Pauli_operator_partial_list_single_thread(
+            target_qubit_index_list.data(), pauli_id_list.data(),
+            (UINT)target_qubit_index_list.size(), this->data_f32(), _dim);
+    }
+
+    /**
+     * \~japanese-en 量子ゲートを apply_gate で作用させられるかを判定する
+     *
+     * 測定、ノイズ、適応ゲートなど、状態ベクトルに作用する行列で表せない
+     * ゲートは作用させられない。
+     * @param gate 判定する量子ゲート
+     */
+    virtual bool is_supported_gate(
+        const QuantumGateBase* gate) const override;
+
+    /**
+     * \~japanese-en 量子状態を測定した際の計算基底のサンプリングを行う
+     *
+     * 倍精度の状態ベクトルと同じく、整列した乱数を状態ベクトルの1回の走査で
+     * 割り当てる。確率は倍精度で累積する。
+     * @param[in] sampling_count サンプリングを行う回数
+     * @return サンプルされた値のリスト
+     */
+    virtual std::vector<ITYPE> sampling(UINT sampling_count) override {
+        return _sampling_sorted(sampling_count, random,
+            [this](const double* sorted_random_list, UINT count,
+                ITYPE* sorted_result) {
+                state_sampling_sorted(sorted_random_list, count,
+                    sorted_result, this->_state_vector, _dim);
+            });
+    }
+    virtual std::vector<ITYPE> sampling(
+        UINT sampling_count, UINT random_seed) override {
+        random.set_seed(random_seed);
+        return this->sampling(sampling_count);
+    }
+
+    /**
+     * \~japanese-en 倍精度の量子状態に変換する
+     *
+     * @return 変換された量子状態
+     */
+    virtual QuantumStateCpu* to_double_precision() const {
+        QuantumStateCpu* new_state = new QuantumStateCpu(this->_qubit_count);
+        convert_quantum_state(this->_state_vector, new_state->data_c(), _dim);
+        for (UINT i = 0; i < _classical_register.size(); ++i) {
+            new_state->set_classical_value(i, _classical_register[i]);
+        }
+        return new_state;
+    }
+
+    virtual std::string to_string() const override {
+        std::stringstream os;
+        ComplexVector eigen_state(this->dim);
+        for (ITYPE i = 0; i < this->dim; ++i)
+            eigen_state[i] = (CPPCTYPE)_state_vector[i];
+        os << " *** Quantum State (single precision) ***" << std::endl;
+        os << " * Qubit Count : " << this->qubit_count << std::endl;
+        os << " * Dimension   : " << this->dim << std::endl;
+        os << " * State vector : \n" << eigen_state << std::endl;
+        return os.str();
+    }
+
+    virtual boost::property_tree::ptree to_ptree() const override {
+        boost::property_tree::ptree pt;
+        pt.put("name", "QuantumStateF32");
+        pt.put("qubit_count", _qubit_count);
+        pt.put_child(
+            "classical_register", ptree::to_ptree(_classical_register));
+        std::vector<CPPCTYPE> state_vector(_dim);
+        convert_quantum_state(this->_state_vector,
+            reinterpret_cast<CTYPE*>(state_vector.data()), _dim);
+        pt.put_child("state_vector", ptree::to_ptree(state_vector));
+        return pt;
+    }
+};
+
+namespace state {
+/**
+ * \~japanese-en 単精度の量子状態間の内積を計算する
+ *
+ * @param[in] state_bra 内積のブラ側の量子状態
+ * @param[in] state_ket 内積のケット側の量子状態
+ * @return 内積の値
+ */
+CPPCTYPE DllExport inner_product(
+    const QuantumStateCpuF32* state_bra, const QuantumStateCpuF32* state_ket);
+/**
+ * \~japanese-en 倍精度の量子状態を単精度に変換する
+ *
+ * @param[in] state 変換する量子状態
+ * @return 変換された量子状態
+ */
+DllExport QuantumStateCpuF32* to_single_precision(
+    const QuantumStateBase* state);
+}  // namespace state
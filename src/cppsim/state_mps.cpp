@@ -0,0 +1,547 @@
+#include "state_mps.hpp"
+
+#include <Eigen/QR>
+#include <Eigen/SVD>
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <sstream>
+#include <string>
+
+#include "gate.hpp"
+#include "utility.hpp"
+
+// Split theta into an isometry and the rest, keeping the largest singular
+// values within the bond dimension and the threshold. The kept singular values
+// are rescaled so that the norm is preserved, and the discarded fraction of
+// the squared norm is returned.
+static double split_by_svd(const ComplexMatrix& theta, UINT max_bond_dimension,
+    double truncation_threshold, ComplexMatrix& left, ComplexMatrix& right) {
+    Eigen::BDCSVD<Eigen::MatrixXcd> svd(
+        theta, Eigen::ComputeThinU | Eigen::ComputeThinV);
+    const Eigen::VectorXd& singular_values = svd.singularValues();
+    const double total = singular_values.squaredNorm();
+    UINT rank = std::min(
+        (UINT)singular_values.size(), std::max(max_bond_dimension, 1U));
+    double discarded = 0.;
+    for (UINT i = rank; i < singular_values.size(); ++i) {
+        discarded += singular_values[i] * singular_values[i];
+    }
+    while (rank > 1) {
+        const double weight =
+            singular_values[rank - 1] * singular_values[rank - 1];
+        if (discarded + weight > truncation_threshold * total) break;
+        discarded += weight;
+        --rank;
+    }
+    const double scale =
+        (total > discarded) ? std::sqrt(total / (total - discarded)) : 1.;
+    left = svd.matrixU().leftCols(rank);
+    right = (scale * singular_values.head(rank)).asDiagonal() *
+            svd.matrixV().leftCols(rank).adjoint();
+    return (total > 0.) ? discarded / total : 0.;
+}
+
+MatrixProductState::MatrixProductState(UINT qubit_count_,
+    UINT max_bond_dimension, double truncation_threshold)
+    : QuantumStateBase(qubit_count_, true) {
+    this->set_max_bond_dimension(max_bond_dimension);
+    this->set_truncation_threshold(truncation_threshold);
+    this->set_zero_state();
+}
+
+void MatrixProductState::check_qubit_index(
+    UINT index, const std::string& func) const {
+    if (index >= this->_qubit_count) {
+        throw QubitIndexOutOfRangeException("Error: MatrixProductState::" +
+                                            func +
+                                            ": index of qubit must be "
+                                            "smaller than qubit_count");
+    }
+}
+
+void MatrixProductState::set_zero_state() {
+    _tensor_list.assign(this->_qubit_count,
+        {ComplexMatrix::Ones(1, 1), ComplexMatrix::Zero(1, 1)});
+    _center = 0;
+    _truncation_error = 0.;
+}
+
+void MatrixProductState::set_zero_norm_state() {
+    this->set_zero_state();
+    if (!_tensor_list.empty()) _tensor_list[0][0].setZero();
+}
+
+void MatrixProductState::set_computational_basis(ITYPE comp_basis) {
+    if (this->_qubit_count < 64 &&
+        comp_basis >= (1ULL << this->_qubit_count)) {
+        throw MatrixIndexOutOfRangeException(
+            "Error: MatrixProductState::set_computational_basis(ITYPE): index "
+            "of computational basis must be smaller than 2^qubit_count");
+    }
+    this->set_zero_state();
+    for (UINT i = 0; i < this->_qubit_count && i < 64; ++i) {
+        if ((comp_basis >> i) & 1) {
+            std::swap(_tensor_list[i][0], _tensor_list[i][1]);
+        }
+    }
+}
+
+void MatrixProductState::load(const QuantumStateBase* state) {
+    if (state->qubit_count != this->_qubit_count) {
+        throw InvalidQubitCountException(
+            "Error: MatrixProductState::load(const QuantumStateBase*): "
+            "invalid qubit count");
+    }
+    auto mps = dynamic_cast<const MatrixProductState*>(state);
+    if (mps != nullptr) {
+        _tensor_list = mps->_tensor_list;
+        _center = mps->_center;
+        _truncation_error = mps->_truncation_error;
+    } else if (state->is_state_vector()) {
+        CPPCTYPE* data = state->duplicate_data_cpp();
+        this->load(data);
+        free(data);
+    } else {
+        throw InoperatableQuantumStateTypeException(
+            "Error: MatrixProductState::load(const QuantumStateBase*): "
+            "density matrix cannot be loaded to matrix product state");
+    }
+    this->_classical_register = state->classical_register;
+}
+
+void MatrixProductState::load(const std::vector<CPPCTYPE>& state) {
+    if (state.size() != this->_dim) {
+        throw InvalidStateVectorSizeException(
+            "Error: MatrixProductState::load(vector<Complex>&): invalid "
+            "length of state");
+    }
+    this->load(state.data());
+}
+
+void MatrixProductState::load(const CPPCTYPE* state) {
+    if (this->_qubit_count >= 64) {
+        throw InvalidQubitCountException(
+            "Error: MatrixProductState::load(const CPPCTYPE*): state vector "
+            "of 64 or more qubits cannot be loaded");
+    }
+    const UINT n = this->_qubit_count;
+    _truncation_error = 0.;
+    // the column index of the rest holds the bits of the remaining qubits
+    ComplexMatrix rest = Eigen::Map<const ComplexMatrix>(state, 1, this->_dim);
+    for (UINT site = 0; site + 1 < n; ++site) {
+        const Eigen::Index left_dim = rest.rows();
+        const Eigen::Index column_count = rest.cols() / 2;
+        ComplexMatrix theta(2 * left_dim, column_count);
+        for (Eigen::Index column = 0; column < column_count; ++column) {
+            theta.block(0, column, left_dim, 1) = rest.col(2 * column);
+            theta.block(left_dim, column, left_dim, 1) =
+                rest.col(2 * column + 1);
+        }
+        ComplexMatrix left;
+        _truncation_error += split_by_svd(
+            theta, _max_bond_dimension, _truncation_threshold, left, rest);
+        _tensor_list[site][0] = left.topRows(left_dim);
+        _tensor_list[site][1] = left.bottomRows(left_dim);
+    }
+    _tensor_list[n - 1][0] = rest.col(0);
+    _tensor_list[n - 1][1] = rest.col(1);
+    _center = n - 1;
+}
+
+CPPCTYPE* MatrixProductState::duplicate_data_cpp() const {
+    if (this->_qubit_count >= 64) {
+        throw InvalidQubitCountException(
+            "Error: MatrixProductState::duplicate_data_cpp(): state vector "
+            "of 64 or more qubits cannot be allocated");
+    }
+    // the row index of the amplitudes holds the bits of the contracted sites
+    ComplexMatrix amplitudes = ComplexMatrix::Ones(1, 1);
+    for (UINT site = 0; site < this->_qubit_count; ++site) {
+        const Eigen::Index row_count = amplitudes.rows();
+        ComplexMatrix next(2 * row_count, _tensor_list[site][0].cols());
+        next.topRows(row_count) = amplitudes * _tensor_list[site][0];
+        next.bottomRows(row_count) = amplitudes * _tensor_list[site][1];
+        amplitudes.swap(next);
+    }
+    CPPCTYPE* new_data = (CPPCTYPE*)malloc(sizeof(CPPCTYPE) * this->_dim);
+    for (ITYPE i = 0; i < this->_dim; ++i) {
+        new_data[i] = amplitudes(i, 0);
+    }
+    return new_data;
+}
+
+void MatrixProductState::move_center(UINT site) {
+    while (_center < site) {
+        auto& tensor = _tensor_list[_center];
+        const Eigen::Index left_dim = tensor[0].rows();
+        Eigen::MatrixXcd matrix(2 * left_dim, tensor[0].cols());
+        matrix << tensor[0], tensor[1];
+        Eigen::HouseholderQR<Eigen::MatrixXcd> qr(matrix);
+        const Eigen::Index rank = std::min(matrix.rows(), matrix.cols());
+        const Eigen::MatrixXcd q =
+            qr.householderQ() * Eigen::MatrixXcd::Identity(matrix.rows(), rank);
+        const Eigen::MatrixXcd r =
+            qr.matrixQR().topRows(rank).triangularView<Eigen::Upper>();
+        tensor[0] = q.topRows(left_dim);
+        tensor[1] = q.bottomRows(left_dim);
+        auto& next = _tensor_list[_center + 1];
+        next[0] = r * next[0];
+        next[1] = r * next[1];
+        ++_center;
+    }
+    while (_center > site) {
+        auto& tensor = _tensor_list[_center];
+        const Eigen::Index right_dim = tensor[0].cols();
+        Eigen::MatrixXcd matrix(tensor[0].rows(), 2 * right_dim);
+        matrix << tensor[0], tensor[1];
+        // LQ decomposition from the QR decomposition of the adjoint
+        Eigen::HouseholderQR<Eigen::MatrixXcd> qr(matrix.adjoint());
+        const Eigen::Index rank = std::min(matrix.rows(), matrix.cols());
+        const Eigen::MatrixXcd q =
+            qr.householderQ() * Eigen::MatrixXcd::Identity(matrix.cols(), rank);
+        const Eigen::MatrixXcd r =
+            qr.matrixQR().topRows(rank).triangularView<Eigen::Upper>();
+        tensor[0] = q.topRows(right_dim).adjoint();
+        tensor[1] = q.bottomRows(right_dim).adjoint();
+        auto& prev = _tensor_list[_center - 1];
+        prev[0] = prev[0] * r.adjoint();
+        prev[1] = prev[1] * r.adjoint();
+        --_center;
+    }
+}
+
+void MatrixProductState::apply_block_matrix(
+    UINT first_site, UINT site_count, const ComplexMatrix& matrix) {
+    this->move_center(first_site);
+    const ITYPE block_dim = 1ULL << site_count;
+
+    // contract the sites, where the j-th bit of the index is the j-th site
+    const Eigen::Index left_dim = _tensor_list[first_site][0].rows();
+    std::vector<ComplexMatrix> block(
+        1, ComplexMatrix::Identity(left_dim, left_dim));
+    for (UINT j = 0; j < site_count; ++j) {
+        const auto& tensor = _tensor_list[first_site + j];
+        std::vector<ComplexMatrix> next(2 * block.size());
+        for (ITYPE b = 0; b < block.size(); ++b) {
+            next[b] = block[b] * tensor[0];
+            next[b | (1ULL << j)] = block[b] * tensor[1];
+        }
+        block.swap(next);
+    }
+    std::vector<ComplexMatrix> updated(block_dim,
+        ComplexMatrix::Zero(block[0].rows(), block[0].cols()));
+    for (ITYPE row = 0; row < block_dim; ++row) {
+        for (ITYPE column = 0; column < block_dim; ++column) {
+            const CPPCTYPE value = matrix(row, column);
+            if (value != 0.) updated[row] += value * block[column];
+        }
+    }
+
+    // split the sites from the left, moving the center to the last site
+    for (UINT j = 0; j + 1 < site_count; ++j) {
+        const Eigen::Index site_left_dim = updated[0].rows();
+        const Eigen::Index right_dim = updated[0].cols();
+        const ITYPE rest_count = updated.size() / 2;
+        ComplexMatrix theta(2 * site_left_dim, rest_count * right_dim);
+        for (ITYPE rest = 0; rest < rest_count; ++rest) {
+            for (UINT s = 0; s < 2; ++s) {
+                theta.block(s * site_left_dim, rest * right_dim, site_left_dim,
+                    right_dim) = updated[2 * rest + s];
+            }
+        }
+        ComplexMatrix left, right;
+        _truncation_error += split_by_svd(
+            theta, _max_bond_dimension, _truncation_threshold, left, right);
+        _tensor_list[first_site + j][0] = left.topRows(site_left_dim);
+        _tensor_list[first_site + j][1] = left.bottomRows(site_left_dim);
+        std::vector<ComplexMatrix> next(rest_count);
+        for (ITYPE rest = 0; rest < rest_count; ++rest) {
+            next[rest] = right.middleCols(rest * right_dim, right_dim);
+        }
+        updated.swap(next);
+    }
+    _tensor_list[first_site + site_count - 1][0] = updated[0];
+    _tensor_list[first_site + site_count - 1][1] = updated[1];
+    _center = first_site + site_count - 1;
+}
+
+void MatrixProductState::apply_gate(const QuantumGateBase* gate) {
+    const std::vector<UINT> target_index_list = gate->get_target_index_list();
+    const std::vector<UINT> control_index_list = gate->get_control_index_list();
+    const std::vector<UINT> control_value_list = gate->get_control_value_list();
+    for (UINT index : target_index_list) {
+        check_qubit_index(index, "apply_gate(const QuantumGateBase*)");
+    }
+    for (UINT index : control_index_list) {
+        check_qubit_index(index, "apply_gate(const QuantumGateBase*)");
+    }
+
+    // Pauli gates act on each qubit independently
+    if (gate->get_name() == "Pauli") {
+        for (const auto& target : gate->target_qubit_list) {
+            UINT pauli_id = 0;
+            if (target.is_commute_X()) pauli_id = 1;
+            if (target.is_commute_Y()) pauli_id = 2;
+            if (target.is_commute_Z()) pauli_id = 3;
+            if (pauli_id == 0) continue;
+            ComplexMatrix pauli_matrix;
+            get_Pauli_matrix(pauli_matrix, {pauli_id});
+            this->apply_block_matrix(target.index(), 1, pauli_matrix);
+        }
+        return;
+    }
+
+    ComplexMatrix target_matrix;
+    gate->set_matrix(target_matrix);
+    const UINT target_count = (UINT)target_index_list.size();
+    if (target_count == 0 ||
+        target_matrix.rows() != (Eigen::Index)(1ULL << target_count) ||
+        target_matrix.cols() != target_matrix.rows()) {
+        throw NotImplementedException(
+            "Error: MatrixProductState::apply_gate(const QuantumGateBase*): " +
+            gate->get_name() +
+            " gate cannot be applied to matrix product state");
+    }
+
+    // bring the qubits next to the smallest one with adjacent SWAPs
+    std::vector<UINT> qubit_index_list = target_index_list;
+    qubit_index_list.insert(qubit_index_list.end(), control_index_list.begin(),
+        control_index_list.end());
+    std::vector<UINT> sorted_index_list = qubit_index_list;
+    std::sort(sorted_index_list.begin(), sorted_index_list.end());
+    const UINT first_site = sorted_index_list[0];
+    const UINT site_count = (UINT)sorted_index_list.size();
+    ComplexMatrix swap_matrix = ComplexMatrix::Zero(4, 4);
+    swap_matrix(0, 0) = swap_matrix(1, 2) = swap_matrix(2, 1) =
+        swap_matrix(3, 3) = 1.;
+    std::vector<UINT> swap_site_list;
+    for (UINT i = 1; i < site_count; ++i) {
+        for (UINT site = sorted_index_list[i]; site > first_site + i; --site) {
+            this->apply_block_matrix(site - 1, 2, swap_matrix);
+            swap_site_list.push_back(site - 1);
+        }
+    }
+
+    // bit of the block for each qubit of the gate
+    std::vector<UINT> block_bit_list(site_count);
+    for (UINT i = 0; i < site_count; ++i) {
+        block_bit_list[i] = (UINT)(std::find(sorted_index_list.begin(),
+                                       sorted_index_list.end(),
+                                       qubit_index_list[i]) -
+                                   sorted_index_list.begin());
+    }
+    ITYPE target_mask = 0, control_mask = 0, control_value_mask = 0;
+    for (UINT i = 0; i < target_count; ++i) {
+        target_mask |= 1ULL << block_bit_list[i];
+    }
+    for (UINT i = 0; i < control_index_list.size(); ++i) {
+        const ITYPE bit = 1ULL << block_bit_list[target_count + i];
+        control_mask |= bit;
+        if (control_value_list[i]) control_value_mask |= bit;
+    }
+    const ITYPE block_dim = 1ULL << site_count;
+    const ITYPE target_dim = 1ULL << target_count;
+    auto get_block_index = [&](ITYPE others, ITYPE target_basis) {
+        ITYPE index = others;
+        for (UINT i = 0; i < target_count; ++i) {
+            if ((target_basis >> i) & 1) index |= 1ULL << block_bit_list[i];
+        }
+        return index;
+    };
+    ComplexMatrix block_matrix = ComplexMatrix::Identity(block_dim, block_dim);
+    for (ITYPE others = 0; others < block_dim; ++others) {
+        if ((others & target_mask) != 0 ||
+            (others & control_mask) != control_value_mask) {
+            continue;
+        }
+        for (ITYPE row = 0; row < target_dim; ++row) {
+            for (ITYPE column = 0; column < target_dim; ++column) {
+                block_matrix(get_block_index(others, row),
+                    get_block_index(others, column)) =
+                    target_matrix(row, column);
+            }
+        }
+    }
+    this->apply_block_matrix(first_site, site_count, block_matrix);
+
+    for (auto ite = swap_site_list.rbegin(); ite != swap_site_list.rend();
+         ++ite) {
+        this->apply_block_matrix(*ite, 2, swap_matrix);
+    }
+}
+
+CPPCTYPE MatrixProductState::get_local_operator_expectation(
+    const std::vector<std::pair<UINT, ComplexMatrix>>& operator_list) const {
+    // the environments outside the range are the identity by the canonical
+    // form
+    UINT first_site = _center, last_site = _center;
+    if (!operator_list.empty()) {
+        first_site = std::min(first_site, operator_list.front().first);
+        last_site = std::max(last_site, operator_list.back().first);
+    }
+    const Eigen::Index left_dim = _tensor_list[first_site][0].rows();
+    ComplexMatrix environment = ComplexMatrix::Identity(left_dim, left_dim);
+    auto ite = operator_list.cbegin();
+    for (UINT site = first_site; site <= last_site; ++site) {
+        const auto& tensor = _tensor_list[site];
+        const Eigen::Index right_dim = tensor[0].cols();
+        ComplexMatrix next = ComplexMatrix::Zero(right_dim, right_dim);
+        if (ite != operator_list.cend() && ite->first == site) {
+            for (UINT bra = 0; bra < 2; ++bra) {
+                for (UINT ket = 0; ket < 2; ++ket) {
+                    const CPPCTYPE value = ite->second(bra, ket);
+                    if (value == 0.) continue;
+                    next += value * tensor[bra].adjoint() * environment *
+                            tensor[ket];
+                }
+            }
+            ++ite;
+        } else {
+            for (UINT s = 0; s < 2; ++s) {
+                next += tensor[s].adjoint() * environment * tensor[s];
+            }
+        }
+        environment.swap(next);
+    }
+    return environment.trace();
+}
+
+double MatrixProductState::get_zero_probability(
+    UINT target_qubit_index) const {
+    check_qubit_index(target_qubit_index, "get_zero_probability(UINT)");
+    ComplexMatrix projection = ComplexMatrix::Zero(2, 2);
+    projection(0, 0) = 1.;
+    return this
+        ->get_local_operator_expectation({{target_qubit_index, projection}})
+        .real();
+}
+
+double MatrixProductState::get_marginal_probability(
+    std::vector<UINT> measured_values) const {
+    if (measured_values.size() != this->_qubit_count) {
+        throw InvalidQubitCountException(
+            "Error: MatrixProductState::get_marginal_probability("
+            "vector<UINT>): the length of measured_values must be equal to "
+            "qubit_count");
+    }
+    std::vector<std::pair<UINT, ComplexMatrix>> operator_list;
+    for (UINT i = 0; i < measured_values.size(); ++i) {
+        const UINT value = measured_values[i];
+        if (value != 0 && value != 1) continue;
+        ComplexMatrix projection = ComplexMatrix::Zero(2, 2);
+        projection(value, value) = 1.;
+        operator_list.emplace_back(i, projection);
+    }
+    return this->get_local_operator_expectation(operator_list).real();
+}
+
+double MatrixProductState::get_squared_norm() const {
+    const auto& tensor = _tensor_list[_center];
+    return tensor[0].squaredNorm() + tensor[1].squaredNorm();
+}
+
+void MatrixProductState::normalize(double squared_norm) {
+    const double scale = 1. / std::sqrt(squared_norm);
+    _tensor_list[_center][0] *= scale;
+    _tensor_list[_center][1] *= scale;
+}
+
+void MatrixProductState::multiply_coef(CPPCTYPE coef) {
+    _tensor_list[_center][0] *= coef;
+    _tensor_list[_center][1] *= coef;
+}
+
+double MatrixProductState::get_Pauli_expectation_value(
+    const std::vector<UINT>& target_qubit_index_list,
+    const std::vector<UINT>& pauli_id_list) const {
+    std::map<UINT, ComplexMatrix> operator_map;
+    for (UINT i = 0; i < target_qubit_index_list.size(); ++i) {
+        const UINT index = target_qubit_index_list[i];
+        check_qubit_index(index,
+            "get_Pauli_expectation_value(const vector<UINT>&, const "
+            "vector<UINT>&)");
+        if (pauli_id_list[i] == 0) continue;
+        ComplexMatrix pauli_matrix;
+        get_Pauli_matrix(pauli_matrix, {pauli_id_list[i]});
+        auto ite = operator_map.find(index);
+        if (ite == operator_map.end()) {
+            operator_map.emplace(index, pauli_matrix);
+        } else {
+            ite->second = pauli_matrix * ite->second;
+        }
+    }
+    const std::vector<std::pair<UINT, ComplexMatrix>> operator_list(
+        operator_map.begin(), operator_map.end());
+    return this->get_local_operator_expectation(operator_list).real();
+}
+
+std::vector<ITYPE> MatrixProductState::sampling(UINT sampling_count) {
+    if (this->_qubit_count > 64) {
+        throw InvalidQubitCountException(
+            "Error: MatrixProductState::sampling(UINT): samples of more than "
+            "64 qubits cannot be represented by integers");
+    }
+    // with the center at the first site, the probability of each qubit
+    // conditioned on the previous outcomes only needs the prefix
+    this->move_center(0);
+    std::vector<ITYPE> result(sampling_count);
+    for (UINT count = 0; count < sampling_count; ++count) {
+        ComplexMatrix prefix = ComplexMatrix::Ones(1, 1);
+        ITYPE sample = 0;
+        for (UINT site = 0; site < this->_qubit_count; ++site) {
+            ComplexMatrix zero_prefix = prefix * _tensor_list[site][0];
+            ComplexMatrix one_prefix = prefix * _tensor_list[site][1];
+            const double zero_weight = zero_prefix.squaredNorm();
+            const double one_weight = one_prefix.squaredNorm();
+            if (random.uniform() * (zero_weight + one_weight) < zero_weight) {
+                prefix = zero_prefix / std::sqrt(zero_weight);
+            } else {
+                prefix = one_prefix / std::sqrt(one_weight);
+                sample |= 1ULL << site;
+            }
+        }
+        result[count] = sample;
+    }
+    return result;
+}
+
+void MatrixProductState::set_max_bond_dimension(UINT max_bond_dimension) {
+    if (max_bond_dimension == 0) {
+        throw InvalidTruncationParameterException(
+            "Error: MatrixProductState::set_max_bond_dimension(UINT): bond "
+            "dimension must be positive");
+    }
+    _max_bond_dimension = max_bond_dimension;
+}
+
+void MatrixProductState::set_truncation_threshold(double truncation_threshold) {
+    if (truncation_threshold < 0.) {
+        throw InvalidTruncationParameterException(
+            "Error: MatrixProductState::set_truncation_threshold(double): "
+            "threshold must be non-negative");
+    }
+    _truncation_threshold = truncation_threshold;
+}
+
+std::vector<UINT> MatrixProductState::get_bond_dimension_list() const {
+    std::vector<UINT> bond_dimension_list;
+    for (UINT site = 0; site + 1 < this->_qubit_count; ++site) {
+        bond_dimension_list.push_back((UINT)_tensor_list[site][0].cols());
+    }
+    return bond_dimension_list;
+}
+
+std::string MatrixProductState::to_string() const {
+    std::stringstream os;
+    os << " *** Quantum State (MPS) ***" << std::endl;
+    os << " * Qubit Count : " << this->_qubit_count << std::endl;
+    os << " * Max Bond Dimension : " << _max_bond_dimension << std::endl;
+    os << " * Bond Dimensions : ";
+    for (UINT bond_dimension : this->get_bond_dimension_list()) {
+        os << bond_dimension << " ";
+    }
+    os << std::endl;
+    os << " * Truncation Error : " << _truncation_error << std::endl;
+    return os.str();
+}
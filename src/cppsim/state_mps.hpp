@@ -0,0 +1,345 @@
+#pragma once
+
+#include <array>
+#include <utility>
+
+#include "exception.hpp"
+#include "state.hpp"
+
+class QuantumGateBase;
+
+/**
+ * \~japanese-en 行列積状態(MPS)として量子状態を保持するクラス
+ *
+ * 各量子ビットは添え字の順にサイトとして並び、サイトごとに物理添え字0,1に
+ * 対応する2つの行列を保持する。ゲートの作用後は隣接するサイトを特異値分解で
+ * 分離し、ボンド次元が最大値を超える場合や小さな特異値がある場合は打ち切る。
+ * 打ち切られた特異値の2乗和は get_truncation_error で取得できる。
+ * 隣接しない量子ビットに作用するゲートはSWAPで隣接させてから作用させ、
+ * その後元の配置に戻す。
+ * 状態は直交中心を持つ混合正準形に保たれ、直交中心はゲートを作用させる
+ * サイトへ移動される。
+ */
+class DllExport MatrixProductState : public QuantumStateBase {
+private:
+    // two matrices of shape (left bond, right bond) for each site
+    std::vector<std::array<ComplexMatrix, 2>> _tensor_list;
+    // sites on the left are left-canonical, and those on the right are
+    // right-canonical
+    UINT _center;
+    UINT _max_bond_dimension;
+    double _truncation_threshold;
+    double _truncation_error;
+    Random random;
+
+    void check_qubit_index(UINT index, const std::string& func) const;
+    /**
+     * \~japanese-en 直交中心を指定したサイトへQR分解で移動する
+     *
+     * @param site 移動先のサイト
+     */
+    void move_center(UINT site);
+    /**
+     * \~japanese-en 連続するサイトに行列を作用させる
+     *
+     * 作用後はサイトを左から特異値分解で分離し、直交中心は最後のサイトになる。
+     * @param first_site 最初のサイト
+     * @param site_count サイトの数
+     * @param matrix 作用させる行列。基底のj番目のビットが first_site+j
+     * 番目のサイトに対応する。
+     */
+    void apply_block_matrix(
+        UINT first_site, UINT site_count, const ComplexMatrix& matrix);
+    /**
+     * \~japanese-en サイトごとの演算子の積の期待値を計算する
+     *
+     * @param operator_list
+     * サイトの昇順に並んだ、サイトと2x2の演算子の組のリスト
+     * @return 期待値
+     */
+    CPPCTYPE get_local_operator_expectation(
+        const std::vector<std::pair<UINT, ComplexMatrix>>& operator_list) const;
+
+public:
+    /**
+     * \~japanese-en コンストラクタ
+     *
+     * @param qubit_count_ 量子ビット数
+     * @param max_bond_dimension ボンド次元の最大値
+     * @param truncation_threshold
+     * 打ち切る特異値の2乗和の、全体の2乗和に対する割合の上限
+     */
+    explicit MatrixProductState(UINT qubit_count_,
+        UINT max_bond_dimension = 64, double truncation_threshold = 1e-12);
+    /**
+     * \~japanese-en デストラクタ
+     */
+    virtual ~MatrixProductState() {}
+    /**
+     * \~japanese-en 量子状態を計算基底の0状態に初期化する
+     */
+    virtual void set_zero_state() override;
+    /**
+     * \~japanese-en ノルム0の状態 (すべての要素が0の状態にする)
+     */
+    virtual void set_zero_norm_state() override;
+    /**
+     * \~japanese-en 量子状態を<code>comp_basis</code>の基底状態に初期化する
+     *
+     * @param comp_basis 初期化する基底を表す整数
+     */
+    virtual void set_computational_basis(ITYPE comp_basis) override;
+    /**
+     * \~japanese-en Haar randomな状態は低いボンド次元で表せない。
+     */
+    [[noreturn]] virtual void set_Haar_random_state() override {
+        throw NotImplementedException(
+            "Error: MatrixProductState::set_Haar_random_state(): Haar random "
+            "state cannot be represented with a bounded bond dimension");
+    }
+    /**
+     * \~japanese-en Haar randomな状態は低いボンド次元で表せない。
+     */
+    [[noreturn]] virtual void set_Haar_random_state(UINT) override {
+        throw NotImplementedException(
+            "Error: MatrixProductState::set_Haar_random_state(UINT): Haar "
+            "random state cannot be represented with a bounded bond "
+            "dimension");
+    }
+    /**
+     * \~japanese-en
+     * <code>target_qubit_index</code>の添え字の量子ビットを測定した時、0が観測される確率を計算する。
+     *
+     * 量子状態は変更しない。
+     * @param target_qubit_index
+     * @return double
+     */
+    virtual double get_zero_probability(
+        UINT target_qubit_index) const override;
+    /**
+     * \~japanese-en 複数の量子ビットを測定した時の周辺確率を計算する
+     *
+     * @param measured_values
+     * 量子ビット数と同じ長さの0,1,2の配列。0,1はその値が観測され、2は測定をしないことを表す。
+     * @return 計算された周辺確率
+     */
+    virtual double get_marginal_probability(
+        std::vector<UINT> measured_values) const override;
+    /**
+     * \~japanese-en 測定結果の確率分布は量子ビット数に対して指数的な大きさになる。
+     */
+    [[noreturn]] virtual double get_entropy() const override {
+        throw NotImplementedException(
+            "Error: MatrixProductState::get_entropy(): entropy of the "
+            "measurement distribution requires all the amplitudes");
+    }
+    /**
+     * \~japanese-en 量子状態のノルムを計算する
+     *
+     * @return ノルム
+     */
+    virtual double get_squared_norm() const override;
+    virtual double get_squared_norm_single_thread() const override {
+        return this->get_squared_norm();
+    }
+    /**
+     * \~japanese-en 量子状態を正規化する
+     *
+     * @param squared_norm 自身のノルム
+     */
+    virtual void normalize(double squared_norm) override;
+    virtual void normalize_single_thread(double squared_norm) override {
+        this->normalize(squared_norm);
+    }
+    /**
+     * \~japanese-en バッファとして同じサイズの量子状態を作成する。
+     *
+     * @return 生成された量子状態
+     */
+    virtual MatrixProductState* allocate_buffer() const override {
+        return new MatrixProductState(
+            this->_qubit_count, _max_bond_dimension, _truncation_threshold);
+    }
+    /**
+     * \~japanese-en 自身の状態のディープコピーを生成する
+     *
+     * @return 自身のディープコピー
+     */
+    virtual MatrixProductState* copy() const override {
+        MatrixProductState* new_state = this->allocate_buffer();
+        new_state->load(this);
+        return new_state;
+    }
+    /**
+     * \~japanese-en <code>state</code>の量子状態を自身へコピーする。
+     *
+     * 状態ベクトルは特異値分解により行列積状態へ変換される。
+     */
+    virtual void load(const QuantumStateBase* state) override;
+    /**
+     * \~japanese-en <code>state</code>の量子状態を自身へコピーする。
+     */
+    virtual void load(const std::vector<CPPCTYPE>& state) override;
+    /**
+     * \~japanese-en <code>state</code>の量子状態を自身へコピーする。
+     */
+    virtual void load(const CPPCTYPE* state) override;
+    /**
+     * \~japanese-en 量子状態が配置されているメモリを保持するデバイス名を取得する。
+     */
+    virtual const std::string get_device_name() const override {
+        return "mps";
+    }
+    [[noreturn]] virtual void* data() const override {
+        throw NotImplementedException(
+            "Error: MatrixProductState::data(): matrix product state does "
+            "not hold state vector");
+    }
+    [[noreturn]] virtual CPPCTYPE* data_cpp() const override {
+        throw NotImplementedException(
+            "Error: MatrixProductState::data_cpp(): matrix product state "
+            "does not hold state vector");
+    }
+    [[noreturn]] virtual CTYPE* data_c() const override {
+        throw NotImplementedException(
+            "Error: MatrixProductState::data_c(): matrix product state does "
+            "not hold state vector");
+    }
+    /**
+     * \~japanese-en 行列積状態を縮約した状態ベクトルを生成する。
+     *
+     * @return 状態ベクトル
+     */
+    virtual CPPCTYPE* duplicate_data_cpp() const override;
+    /**
+     * \~japanese-en 行列積状態を縮約した状態ベクトルを生成する。
+     *
+     * @return 状態ベクトル
+     */
+    virtual CTYPE* duplicate_data_c() const override {
+        return reinterpret_cast<CTYPE*>(this->duplicate_data_cpp());
+    }
+    [[noreturn]] virtual void add_state(const QuantumStateBase*) override {
+        throw NotImplementedException(
+            "Error: MatrixProductState::add_state(const QuantumStateBase*): "
+            "sum of matrix product states is not supported");
+    }
+    [[noreturn]] virtual void add_state_with_coef(
+        CPPCTYPE, const QuantumStateBase*) override {
+        throw NotImplementedException(
+            "Error: MatrixProductState::add_state_with_coef(CPPCTYPE, const "
+            "QuantumStateBase*): sum of matrix product states is not "
+            "supported");
+    }
+    [[noreturn]] virtual void add_state_with_coef_single_thread(
+        CPPCTYPE, const QuantumStateBase*) override {
+        throw NotImplementedException(
+            "Error: MatrixProductState::add_state_with_coef_single_thread("
+            "CPPCTYPE, const QuantumStateBase*): sum of matrix product states "
+            "is not supported");
+    }
+    /**
+     * \~japanese-en 複素数をかける
+     *
+     * @param coef かける複素数
+     */
+    virtual void multiply_coef(CPPCTYPE coef) override;
+    [[noreturn]] virtual void multiply_elementwise_function(
+        const std::function<CPPCTYPE(ITYPE)>&) override {
+        throw NotImplementedException(
+            "Error: MatrixProductState::multiply_elementwise_function(const "
+            "function<CPPCTYPE(ITYPE)>&): matrix product state does not hold "
+            "state vector");
+    }
+
+    /**
+     * \~japanese-en 量子ゲートを作用させる
+     *
+     * 行列で表せるゲートを作用させられる。ノイズや測定のゲートは作用させられない。
+     * @param gate 作用させる量子ゲート
+     */
+    virtual void apply_gate(const QuantumGateBase* gate) override;
+
+    virtual bool is_gate_applied_by_state() const override { return true; }
+
+    virtual bool is_Pauli_expectation_computed_by_state() const override {
+        return true;
+    }
+
+    /**
+     * \~japanese-en パウリ演算子の期待値を計算する
+     *
+     * @param target_qubit_index_list 作用する量子ビットの添え字のリスト
+     * @param pauli_id_list パウリ演算子のリスト。(I,X,Y,Z)が(0,1,2,3)に対応する。
+     * @return 期待値
+     */
+    virtual double get_Pauli_expectation_value(
+        const std::vector<UINT>& target_qubit_index_list,
+        const std::vector<UINT>& pauli_id_list) const override;
+
+    /**
+     * \~japanese-en 量子状態を測定した際の計算基底のサンプリングを行う
+     *
+     * 各サンプルは量子ビットを順に測定して得る。
+     * 結果は整数で返されるため、量子ビット数は64以下である必要がある。
+     * @param[in] sampling_count サンプリングを行う回数
+     * @return サンプルされた値のリスト
+     */
+    virtual std::vector<ITYPE> sampling(UINT sampling_count) override;
+    virtual std::vector<ITYPE> sampling(
+        UINT sampling_count, UINT random_seed) override {
+        random.set_seed(random_seed);
+        return this->sampling(sampling_count);
+    }
+
+    /**
+     * \~japanese-en ボンド次元の最大値を設定する
+     *
+     * @param max_bond_dimension ボンド次元の最大値
+     */
+    virtual void set_max_bond_dimension(UINT max_bond_dimension);
+    /**
+     * \~japanese-en ボンド次元の最大値を取得する
+     *
+     * @return ボンド次元の最大値
+     */
+    virtual UINT get_max_bond_dimension() const { return _max_bond_dimension; }
+    /**
+     * \~japanese-en 特異値を打ち切る閾値を設定する
+     *
+     * @param truncation_threshold
+     * 打ち切る特異値の2乗和の、全体の2乗和に対する割合の上限
+     */
+    virtual void set_truncation_threshold(double truncation_threshold);
+    /**
+     * \~japanese-en 特異値を打ち切る閾値を取得する
+     *
+     * @return 特異値を打ち切る閾値
+     */
+    virtual double get_truncation_threshold() const {
+        return _truncation_threshold;
+    }
+    /**
+     * \~japanese-en 打ち切られた特異値の2乗和の割合を取得する
+     *
+     * 状態を初期化してから打ち切られた割合の合計を返す。
+     * 状態の忠実度はおよそ1からこの値を引いた値以上になる。
+     * @return 打ち切られた特異値の2乗和の割合
+     */
+    virtual double get_truncation_error() const { return _truncation_error; }
+    /**
+     * \~japanese-en 隣接するサイトの間のボンド次元のリストを取得する
+     *
+     * @return 長さ qubit_count-1 のボンド次元のリスト
+     */
+    virtual std::vector<UINT> get_bond_dimension_list() const;
+
+    virtual std::string to_string() const override;
+
+    [[noreturn]] virtual boost::property_tree::ptree to_ptree()
+        const override {
+        throw NotImplementedException(
+            "Error: MatrixProductState::to_ptree(): matrix product state "
+            "cannot be converted to ptree");
+    }
+};
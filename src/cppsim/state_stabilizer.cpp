@@ -0,0 +1,466 @@
+#include "state_stabilizer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+#include <string>
+
+#include "gate.hpp"
+
+// Multiply the Pauli of row h from the left by that of row i, which is
+// rowsum(h, i) of Aaronson-Gottesman. The exponent of i in the phase is
+// accumulated from the positions where the product gives +i or -i.
+static void multiply_Pauli_row(uint64_t* x_h, uint64_t* z_h, uint8_t* r_h,
+    const uint64_t* x_i, const uint64_t* z_i, uint8_t r_i, UINT word_count) {
+    int exponent = 2 * (*r_h) + 2 * r_i;
+    for (UINT w = 0; w < word_count; ++w) {
+        const uint64_t x1 = x_i[w], z1 = z_i[w], x2 = x_h[w], z2 = z_h[w];
+        // YZ, XY and ZX give +i, and YX, XZ and ZY give -i
+        const uint64_t plus = (x1 & z1 & ~x2 & z2) | (x1 & ~z1 & x2 & z2) |
+                              (~x1 & z1 & x2 & ~z2);
+        const uint64_t minus = (x1 & z1 & x2 & ~z2) | (x1 & ~z1 & ~x2 & z2) |
+                               (~x1 & z1 & x2 & z2);
+        exponent += (int)count_population_cpp(plus) -
+                    (int)count_population_cpp(minus);
+        x_h[w] = x2 ^ x1;
+        z_h[w] = z2 ^ z1;
+    }
+    *r_h = (((exponent % 4) + 4) % 4 == 2) ? 1 : 0;
+}
+
+static bool is_anticommute(const uint64_t* x1, const uint64_t* z1,
+    const uint64_t* x2, const uint64_t* z2, UINT word_count) {
+    uint64_t parity = 0;
+    for (UINT w = 0; w < word_count; ++w) {
+        parity ^= (x1[w] & z2[w]) ^ (z1[w] & x2[w]);
+    }
+    return count_population_cpp(parity) % 2 == 1;
+}
+
+StabilizerState::StabilizerState(UINT qubit_count_)
+    : QuantumStateBase(qubit_count_, false) {
+    // a tableau has no amplitudes, and 2^n overflows for n >= 64
+    this->_dim = 0;
+    _word_count = (qubit_count_ + 63) / 64;
+    const size_t table_size = (size_t)2 * qubit_count_ * _word_count;
+    _x_table.resize(table_size);
+    _z_table.resize(table_size);
+    _phase_list.resize(2 * qubit_count_);
+    this->set_zero_state();
+}
+
+void StabilizerState::check_qubit_index(
+    UINT index, const std::string& func) const {
+    if (index >= this->_qubit_count) {
+        throw QubitIndexOutOfRangeException("Error: StabilizerState::" + func +
+                                            ": index of qubit must be "
+                                            "smaller than qubit_count");
+    }
+}
+
+void StabilizerState::set_zero_state() {
+    std::fill(_x_table.begin(), _x_table.end(), 0);
+    std::fill(_z_table.begin(), _z_table.end(), 0);
+    std::fill(_phase_list.begin(), _phase_list.end(), 0);
+    // destabilizers X_i and stabilizers Z_i
+    for (UINT i = 0; i < this->_qubit_count; ++i) {
+        x_row(i)[i / 64] = 1ULL << (i % 64);
+        z_row(i + this->_qubit_count)[i / 64] = 1ULL << (i % 64);
+    }
+}
+
+void StabilizerState::set_computational_basis(ITYPE comp_basis) {
+    if (this->_qubit_count < 64 &&
+        comp_basis >= (1ULL << this->_qubit_count)) {
+        throw MatrixIndexOutOfRangeException(
+            "Error: StabilizerState::set_computational_basis(ITYPE): index "
+            "of computational basis must be smaller than 2^qubit_count");
+    }
+    this->set_zero_state();
+    for (UINT i = 0; i < this->_qubit_count && i < 64; ++i) {
+        if ((comp_basis >> i) & 1) apply_X(i);
+    }
+}
+
+void StabilizerState::load(const QuantumStateBase* state) {
+    auto stabilizer_state = dynamic_cast<const StabilizerState*>(state);
+    if (stabilizer_state == nullptr) {
+        throw InoperatableQuantumStateTypeException(
+            "Error: StabilizerState::load(const QuantumStateBase*): only "
+            "stabilizer state can be loaded");
+    }
+    if (state->qubit_count != this->_qubit_count) {
+        throw InvalidQubitCountException(
+            "Error: StabilizerState::load(const QuantumStateBase*): invalid "
+            "qubit count");
+    }
+    _x_table = stabilizer_state->_x_table;
+    _z_table = stabilizer_state->_z_table;
+    _phase_list = stabilizer_state->_phase_list;
+    this->_classical_register = state->classical_register;
+}
+
+void StabilizerState::apply_H(UINT index) {
+    const UINT word = index / 64;
+    const uint64_t bit = 1ULL << (index % 64);
+    for (UINT row = 0; row < 2 * this->_qubit_count; ++row) {
+        uint64_t& x = x_row(row)[word];
+        uint64_t& z = z_row(row)[word];
+        if ((x & bit) && (z & bit)) _phase_list[row] ^= 1;
+        const uint64_t flip = (x ^ z) & bit;
+        x ^= flip;
+        z ^= flip;
+    }
+}
+
+void StabilizerState::apply_S(UINT index) {
+    const UINT word = index / 64;
+    const uint64_t bit = 1ULL << (index % 64);
+    for (UINT row = 0; row < 2 * this->_qubit_count; ++row) {
+        const uint64_t x = x_row(row)[word];
+        uint64_t& z = z_row(row)[word];
+        if ((x & bit) && (z & bit)) _phase_list[row] ^= 1;
+        z ^= x & bit;
+    }
+}
+
+void StabilizerState::apply_X(UINT index) {
+    const UINT word = index / 64;
+    const uint64_t bit = 1ULL << (index % 64);
+    for (UINT row = 0; row < 2 * this->_qubit_count; ++row) {
+        if (z_row(row)[word] & bit) _phase_list[row] ^= 1;
+    }
+}
+
+void StabilizerState::apply_Y(UINT index) {
+    const UINT word = index / 64;
+    const uint64_t bit = 1ULL << (index % 64);
+    for (UINT row = 0; row < 2 * this->_qubit_count; ++row) {
+        if ((x_row(row)[word] ^ z_row(row)[word]) & bit) {
+            _phase_list[row] ^= 1;
+        }
+    }
+}
+
+void StabilizerState::apply_Z(UINT index) {
+    const UINT word = index / 64;
+    const uint64_t bit = 1ULL << (index % 64);
+    for (UINT row = 0; row < 2 * this->_qubit_count; ++row) {
+        if (x_row(row)[word] & bit) _phase_list[row] ^= 1;
+    }
+}
+
+void StabilizerState::apply_CNOT(UINT control_index, UINT target_index) {
+    const UINT control_word = control_index / 64;
+    const UINT target_word = target_index / 64;
+    const UINT control_shift = control_index % 64;
+    const UINT target_shift = target_index % 64;
+    for (UINT row = 0; row < 2 * this->_qubit_count; ++row) {
+        uint64_t* x = x_row(row);
+        uint64_t* z = z_row(row);
+        const uint64_t x_c = (x[control_word] >> control_shift) & 1;
+        const uint64_t z_c = (z[control_word] >> control_shift) & 1;
+        const uint64_t x_t = (x[target_word] >> target_shift) & 1;
+        const uint64_t z_t = (z[target_word] >> target_shift) & 1;
+        if (x_c & z_t & (x_t ^ z_c ^ 1)) _phase_list[row] ^= 1;
+        x[target_word] ^= x_c << target_shift;
+        z[control_word] ^= z_t << control_shift;
+    }
+}
+
+void StabilizerState::apply_SWAP(UINT index0, UINT index1) {
+    const UINT word0 = index0 / 64, word1 = index1 / 64;
+    const UINT shift0 = index0 % 64, shift1 = index1 % 64;
+    for (UINT row = 0; row < 2 * this->_qubit_count; ++row) {
+        for (uint64_t* p : {x_row(row), z_row(row)}) {
+            const uint64_t diff =
+                ((p[word0] >> shift0) ^ (p[word1] >> shift1)) & 1;
+            p[word0] ^= diff << shift0;
+            p[word1] ^= diff << shift1;
+        }
+    }
+}
+
+void StabilizerState::apply_gate(const QuantumGateBase* gate) {
+    const std::string name = gate->get_name();
+    const std::vector<UINT> target_index_list = gate->get_target_index_list();
+    const std::vector<UINT> control_index_list = gate->get_control_index_list();
+    for (UINT index : target_index_list) {
+        check_qubit_index(index, "apply_gate(const QuantumGateBase*)");
+    }
+    for (UINT index : control_index_list) {
+        check_qubit_index(index, "apply_gate(const QuantumGateBase*)");
+    }
+
+    if (name == "CNOT" || name == "CZ") {
+        const UINT control = control_index_list[0];
+        const UINT target = target_index_list[0];
+        const bool flip_control = gate->get_control_value_list()[0] == 0;
+        if (flip_control) apply_X(control);
+        if (name == "CZ") apply_H(target);
+        apply_CNOT(control, target);
+        if (name == "CZ") apply_H(target);
+        if (flip_control) apply_X(control);
+        return;
+    }
+    if (name == "SWAP") {
+        apply_SWAP(target_index_list[0], target_index_list[1]);
+        return;
+    }
+    if (name == "Pauli") {
+        for (const auto& target : gate->target_qubit_list) {
+            if (target.is_commute_X()) {
+                apply_X(target.index());
+            } else if (target.is_commute_Y()) {
+                apply_Y(target.index());
+            } else if (target.is_commute_Z()) {
+                apply_Z(target.index());
+            }
+        }
+        return;
+    }
+    if (target_index_list.size() == 1 && control_index_list.empty()) {
+        const UINT target = target_index_list[0];
+        if (name == "I") return;
+        if (name == "X") return apply_X(target);
+        if (name == "Y") return apply_Y(target);
+        if (name == "Z") return apply_Z(target);
+        if (name == "H") return apply_H(target);
+        if (name == "S") return apply_S(target);
+        if (name == "Sdag") {
+            apply_S(target);
+            apply_Z(target);
+            return;
+        }
+        if (name == "sqrtX" || name == "sqrtXdag") {
+            apply_H(target);
+            apply_S(target);
+            if (name == "sqrtXdag") apply_Z(target);
+            apply_H(target);
+            return;
+        }
+        if (name == "sqrtY") {
+            apply_Z(target);
+            apply_H(target);
+            return;
+        }
+        if (name == "sqrtYdag") {
+            apply_H(target);
+            apply_Z(target);
+            return;
+        }
+    }
+    throw NotImplementedException(
+        "Error: StabilizerState::apply_gate(const QuantumGateBase*): " +
+        name + " gate cannot be applied to stabilizer state");
+}
+
+bool StabilizerState::get_deterministic_outcome(
+    UINT target_qubit_index, UINT* outcome) const {
+    const UINT n = this->_qubit_count;
+    const UINT word = target_qubit_index / 64;
+    const uint64_t bit = 1ULL << (target_qubit_index % 64);
+    for (UINT row = n; row < 2 * n; ++row) {
+        if (x_row(row)[word] & bit) return false;
+    }
+    // Z of the target is the product of the stabilizers whose destabilizers
+    // anticommute with it
+    std::vector<uint64_t> x(_word_count, 0), z(_word_count, 0);
+    uint8_t phase = 0;
+    for (UINT row = 0; row < n; ++row) {
+        if (x_row(row)[word] & bit) {
+            multiply_Pauli_row(x.data(), z.data(), &phase, x_row(row + n),
+                z_row(row + n), _phase_list[row + n], _word_count);
+        }
+    }
+    *outcome = phase;
+    return true;
+}
+
+UINT StabilizerState::measure_with_outcome(
+    UINT target_qubit_index, int forced_outcome) {
+    const UINT n = this->_qubit_count;
+    const UINT word = target_qubit_index / 64;
+    const uint64_t bit = 1ULL << (target_qubit_index % 64);
+    UINT pivot = 2 * n;
+    for (UINT row = n; row < 2 * n; ++row) {
+        if (x_row(row)[word] & bit) {
+            pivot = row;
+            break;
+        }
+    }
+    if (pivot == 2 * n) {
+        UINT outcome;
+        get_deterministic_outcome(target_qubit_index, &outcome);
+        return outcome;
+    }
+
+    for (UINT row = 0; row < 2 * n; ++row) {
+        if (row != pivot && (x_row(row)[word] & bit)) {
+            multiply_Pauli_row(x_row(row), z_row(row), &_phase_list[row],
+                x_row(pivot), z_row(pivot), _phase_list[pivot], _word_count);
+        }
+    }
+    // the pivot becomes the destabilizer and Z of the target the stabilizer
+    std::copy(x_row(pivot), x_row(pivot) + _word_count, x_row(pivot - n));
+    std::copy(z_row(pivot), z_row(pivot) + _word_count, z_row(pivot - n));
+    _phase_list[pivot - n] = _phase_list[pivot];
+    std::fill(x_row(pivot), x_row(pivot) + _word_count, 0);
+    std::fill(z_row(pivot), z_row(pivot) + _word_count, 0);
+    z_row(pivot)[word] = bit;
+    const UINT outcome = (forced_outcome < 0)
+                             ? (random.uniform() < 0.5 ? 0 : 1)
+                             : (UINT)forced_outcome;
+    _phase_list[pivot] = (uint8_t)outcome;
+    return outcome;
+}
+
+double StabilizerState::get_zero_probability(UINT target_qubit_index) const {
+    check_qubit_index(target_qubit_index, "get_zero_probability(UINT)");
+    UINT outcome;
+    if (!get_deterministic_outcome(target_qubit_index, &outcome)) return 0.5;
+    return (outcome == 0) ? 1. : 0.;
+}
+
+double StabilizerState::get_marginal_probability(
+    std::vector<UINT> measured_values) const {
+    if (measured_values.size() != this->_qubit_count) {
+        throw InvalidQubitCountException(
+            "Error: StabilizerState::get_marginal_probability(vector<UINT>): "
+            "the length of measured_values must be equal to qubit_count");
+    }
+    StabilizerState state(this->_qubit_count);
+    state.load(this);
+    double probability = 1.;
+    for (UINT i = 0; i < measured_values.size(); ++i) {
+        const UINT value = measured_values[i];
+        if (value != 0 && value != 1) continue;
+        UINT outcome;
+        if (state.get_deterministic_outcome(i, &outcome)) {
+            if (outcome != value) return 0.;
+        } else {
+            probability *= 0.5;
+            state.measure_with_outcome(i, (int)value);
+        }
+    }
+    return probability;
+}
+
+double StabilizerState::get_entropy() const {
+    // the outcomes are uniform over 2^k values, where k is the rank of the X
+    // part of the stabilizers
+    const UINT n = this->_qubit_count;
+    std::vector<uint64_t> x_part(_x_table.begin() + (size_t)n * _word_count,
+        _x_table.begin() + (size_t)2 * n * _word_count);
+    UINT rank = 0;
+    for (UINT column = 0; column < n && rank < n; ++column) {
+        const UINT word = column / 64;
+        const uint64_t bit = 1ULL << (column % 64);
+        UINT pivot = rank;
+        while (pivot < n &&
+               !(x_part[(size_t)pivot * _word_count + word] & bit)) {
+            ++pivot;
+        }
+        if (pivot == n) continue;
+        std::swap_ranges(x_part.begin() + (size_t)pivot * _word_count,
+            x_part.begin() + (size_t)(pivot + 1) * _word_count,
+            x_part.begin() + (size_t)rank * _word_count);
+        for (UINT row = rank + 1; row < n; ++row) {
+            if (x_part[(size_t)row * _word_count + word] & bit) {
+                for (UINT w = 0; w < _word_count; ++w) {
+                    x_part[(size_t)row * _word_count + w] ^=
+                        x_part[(size_t)rank * _word_count + w];
+                }
+            }
+        }
+        ++rank;
+    }
+    return rank * std::log(2.);
+}
+
+UINT StabilizerState::measure(UINT target_qubit_index) {
+    check_qubit_index(target_qubit_index, "measure(UINT)");
+    return measure_with_outcome(target_qubit_index, -1);
+}
+
+double StabilizerState::get_Pauli_expectation_value(
+    const std::vector<UINT>& target_qubit_index_list,
+    const std::vector<UINT>& pauli_id_list) const {
+    const UINT n = this->_qubit_count;
+    std::vector<uint64_t> x(_word_count, 0), z(_word_count, 0);
+    for (UINT i = 0; i < target_qubit_index_list.size(); ++i) {
+        const UINT index = target_qubit_index_list[i];
+        check_qubit_index(index,
+            "get_Pauli_expectation_value(const vector<UINT>&, const "
+            "vector<UINT>&)");
+        const uint64_t bit = 1ULL << (index % 64);
+        if (pauli_id_list[i] == 1 || pauli_id_list[i] == 2) {
+            x[index / 64] ^= bit;
+        }
+        if (pauli_id_list[i] == 2 || pauli_id_list[i] == 3) {
+            z[index / 64] ^= bit;
+        }
+    }
+    // the operator is in the stabilizer group up to sign iff it commutes
+    // with all the stabilizers
+    for (UINT row = n; row < 2 * n; ++row) {
+        if (is_anticommute(x.data(), z.data(), x_row(row), z_row(row),
+                _word_count)) {
+            return 0.;
+        }
+    }
+    std::vector<uint64_t> product_x(_word_count, 0), product_z(_word_count, 0);
+    uint8_t phase = 0;
+    for (UINT row = 0; row < n; ++row) {
+        if (is_anticommute(
+                x.data(), z.data(), x_row(row), z_row(row), _word_count)) {
+            multiply_Pauli_row(product_x.data(), product_z.data(), &phase,
+                x_row(row + n), z_row(row + n), _phase_list[row + n],
+                _word_count);
+        }
+    }
+    return (phase == 0) ? 1. : -1.;
+}
+
+std::vector<ITYPE> StabilizerState::sampling(UINT sampling_count) {
+    if (this->_qubit_count > 64) {
+        throw InvalidQubitCountException(
+            "Error: StabilizerState::sampling(UINT): samples of more than 64 "
+            "qubits cannot be represented by integers. Use measure() "
+            "instead");
+    }
+    std::vector<ITYPE> result(sampling_count);
+    StabilizerState state(this->_qubit_count);
+    for (UINT count = 0; count < sampling_count; ++count) {
+        state.load(this);
+        ITYPE sample = 0;
+        for (UINT i = 0; i < this->_qubit_count; ++i) {
+            UINT outcome;
+            if (!state.get_deterministic_outcome(i, &outcome)) {
+                outcome = state.measure_with_outcome(
+                    i, random.uniform() < 0.5 ? 0 : 1);
+            }
+            sample |= (ITYPE)outcome << i;
+        }
+        result[count] = sample;
+    }
+    return result;
+}
+
+std::string StabilizerState::to_string() const {
+    static const char pauli_char[] = {'I', 'X', 'Z', 'Y'};
+    std::stringstream os;
+    os << " *** Quantum State (stabilizer) ***" << std::endl;
+    os << " * Qubit Count : " << this->_qubit_count << std::endl;
+    os << " * Stabilizers : " << std::endl;
+    for (UINT row = this->_qubit_count; row < 2 * this->_qubit_count; ++row) {
+        os << (_phase_list[row] ? "-" : "+");
+        for (UINT i = 0; i < this->_qubit_count; ++i) {
+            const UINT x = (x_row(row)[i / 64] >> (i % 64)) & 1;
+            const UINT z = (z_row(row)[i / 64] >> (i % 64)) & 1;
+            os << pauli_char[x + 2 * z];
+        }
+        os << std::endl;
+    }
+    return os.str();
+}
@@ -0,0 +1,318 @@
+#pragma once
+
+#include <cstdint>
+
+#include "exception.hpp"
+#include "state.hpp"
+
+class QuantumGateBase;
+
+/**
+ * \~japanese-en スタビライザー状態をタブローで保持する量子状態のクラス
+ *
+ * Aaronson-Gottesman のタブローとして n 個のデスタビライザーと n 個の
+ * スタビライザーを保持する。各行の X、Z の成分は64量子ビットを1ワードに
+ * まとめたビット列で、行どうしの積はワード単位で計算される。
+ * そのため、状態ベクトルを保持できない数千量子ビットのクリフォード回路も扱える。
+ * クリフォードゲートは apply_gate または QuantumCircuit::update_quantum_state
+ * により作用させる。振幅を必要とする操作はサポートしない。
+ * 状態ベクトルではないため、is_state_vector は false を、dim は 0 を返す。
+ */
+class DllExport StabilizerState : public QuantumStateBase {
+private:
+    UINT _word_count;
+    // n rows of destabilizers followed by n rows of stabilizers
+    std::vector<uint64_t> _x_table;
+    std::vector<uint64_t> _z_table;
+    std::vector<uint8_t> _phase_list;
+    Random random;
+
+    uint64_t* x_row(UINT row) {
+        return _x_table.data() + (size_t)row * _word_count;
+    }
+    uint64_t* z_row(UINT row) {
+        return _z_table.data() + (size_t)row * _word_count;
+    }
+    const uint64_t* x_row(UINT row) const {
+        return _x_table.data() + (size_t)row * _word_count;
+    }
+    const uint64_t* z_row(UINT row) const {
+        return _z_table.data() + (size_t)row * _word_count;
+    }
+
+    void check_qubit_index(UINT index, const std::string& func) const;
+    /**
+     * \~japanese-en
+     * 測定結果が確定している場合にその値を計算する。状態は変更しない。
+     *
+     * @param target_qubit_index 測定する量子ビットの添え字
+     * @param outcome 確定している測定結果
+     * @return 測定結果が確定しているかどうか
+     */
+    bool get_deterministic_outcome(
+        UINT target_qubit_index, UINT* outcome) const;
+    /**
+     * \~japanese-en
+     * Z基底で測定して状態を射影する。
+     *
+     * @param target_qubit_index 測定する量子ビットの添え字
+     * @param forced_outcome
+     * 結果がランダムな場合に選ぶ値。負の場合は一様にランダムに選ぶ。
+     * @return 測定結果
+     */
+    UINT measure_with_outcome(UINT target_qubit_index, int forced_outcome);
+
+    void apply_H(UINT index);
+    void apply_S(UINT index);
+    void apply_X(UINT index);
+    void apply_Y(UINT index);
+    void apply_Z(UINT index);
+    void apply_CNOT(UINT control_index, UINT target_index);
+    void apply_SWAP(UINT index0, UINT index1);
+
+public:
+    /**
+     * \~japanese-en コンストラクタ
+     *
+     * @param qubit_count_ 量子ビット数
+     */
+    explicit StabilizerState(UINT qubit_count_);
+    /**
+     * \~japanese-en デストラクタ
+     */
+    virtual ~StabilizerState() {}
+    /**
+     * \~japanese-en 量子状態を計算基底の0状態に初期化する
+     */
+    virtual void set_zero_state() override;
+    /**
+     * \~japanese-en スタビライザー状態はノルム0の状態を表せない。
+     */
+    [[noreturn]] virtual void set_zero_norm_state() override {
+        throw NotImplementedException(
+            "Error: StabilizerState::set_zero_norm_state(): stabilizer state "
+            "cannot have zero norm");
+    }
+    /**
+     * \~japanese-en 量子状態を<code>comp_basis</code>の基底状態に初期化する
+     *
+     * @param comp_basis 初期化する基底を表す整数
+     */
+    virtual void set_computational_basis(ITYPE comp_basis) override;
+    /**
+     * \~japanese-en スタビライザー状態はHaar randomな状態を表せない。
+     */
+    [[noreturn]] virtual void set_Haar_random_state() override {
+        throw NotImplementedException(
+            "Error: StabilizerState::set_Haar_random_state(): Haar random "
+            "state is not a stabilizer state");
+    }
+    /**
+     * \~japanese-en スタビライザー状態はHaar randomな状態を表せない。
+     */
+    [[noreturn]] virtual void set_Haar_random_state(UINT) override {
+        throw NotImplementedException(
+            "Error: StabilizerState::set_Haar_random_state(UINT): Haar random "
+            "state is not a stabilizer state");
+    }
+    /**
+     * \~japanese-en
+     * <code>target_qubit_index</code>の添え字の量子ビットを測定した時、0が観測される確率を計算する。
+     *
+     * 確率は0、1、0.5のいずれかになる。量子状態は変更しない。
+     * @param target_qubit_index
+     * @return double
+     */
+    virtual double get_zero_probability(
+        UINT target_qubit_index) const override;
+    /**
+     * \~japanese-en 複数の量子ビットを測定した時の周辺確率を計算する
+     *
+     * @param measured_values
+     * 量子ビット数と同じ長さの0,1,2の配列。0,1はその値が観測され、2は測定をしないことを表す。
+     * @return 計算された周辺確率
+     */
+    virtual double get_marginal_probability(
+        std::vector<UINT> measured_values) const override;
+    /**
+     * \~japanese-en
+     * 計算基底で測定した時得られる確率分布のエントロピーを計算する。
+     *
+     * 測定結果は 2^k 個の値の一様分布になるため、k log 2 を返す。
+     * @return エントロピー
+     */
+    virtual double get_entropy() const override;
+    /**
+     * \~japanese-en スタビライザー状態のノルムは常に1である。
+     */
+    virtual double get_squared_norm() const override { return 1.; }
+    /**
+     * \~japanese-en スタビライザー状態のノルムは常に1である。
+     */
+    virtual double get_squared_norm_single_thread() const override {
+        return 1.;
+    }
+    /**
+     * \~japanese-en スタビライザー状態は常に正規化されている。
+     */
+    virtual void normalize(double) override {}
+    /**
+     * \~japanese-en スタビライザー状態は常に正規化されている。
+     */
+    virtual void normalize_single_thread(double) override {}
+    /**
+     * \~japanese-en バッファとして同じサイズの量子状態を作成する。
+     *
+     * @return 生成された量子状態
+     */
+    virtual StabilizerState* allocate_buffer() const override {
+        return new StabilizerState(this->_qubit_count);
+    }
+    /**
+     * \~japanese-en 自身の状態のディープコピーを生成する
+     *
+     * @return 自身のディープコピー
+     */
+    virtual StabilizerState* copy() const override {
+        StabilizerState* new_state = new StabilizerState(this->_qubit_count);
+        new_state->load(this);
+        return new_state;
+    }
+    /**
+     * \~japanese-en <code>state</code>の量子状態を自身へコピーする。
+     *
+     * <code>state</code>はスタビライザー状態である必要がある。
+     */
+    virtual void load(const QuantumStateBase* state) override;
+    [[noreturn]] virtual void load(const std::vector<CPPCTYPE>&) override {
+        throw NotImplementedException(
+            "Error: StabilizerState::load(const vector<CPPCTYPE>&): state "
+            "vector cannot be loaded to stabilizer state");
+    }
+    [[noreturn]] virtual void load(const CPPCTYPE*) override {
+        throw NotImplementedException(
+            "Error: StabilizerState::load(const CPPCTYPE*): state vector "
+            "cannot be loaded to stabilizer state");
+    }
+    /**
+     * \~japanese-en 量子状態が配置されているメモリを保持するデバイス名を取得する。
+     */
+    virtual const std::string get_device_name() const override {
+        return "stabilizer";
+    }
+    [[noreturn]] virtual void* data() const override {
+        throw NotImplementedException(
+            "Error: StabilizerState::data(): stabilizer state does not hold "
+            "state vector");
+    }
+    [[noreturn]] virtual CPPCTYPE* data_cpp() const override {
+        throw NotImplementedException(
+            "Error: StabilizerState::data_cpp(): stabilizer state does not "
+            "hold state vector");
+    }
+    [[noreturn]] virtual CTYPE* data_c() const override {
+        throw NotImplementedException(
+            "Error: StabilizerState::data_c(): stabilizer state does not hold "
+            "state vector");
+    }
+    [[noreturn]] virtual CPPCTYPE* duplicate_data_cpp() const override {
+        throw NotImplementedException(
+            "Error: StabilizerState::duplicate_data_cpp(): stabilizer state "
+            "does not hold state vector");
+    }
+    [[noreturn]] virtual CTYPE* duplicate_data_c() const override {
+        throw NotImplementedException(
+            "Error: StabilizerState::duplicate_data_c(): stabilizer state "
+            "does not hold state vector");
+    }
+    [[noreturn]] virtual void add_state(const QuantumStateBase*) override {
+        throw NotImplementedException(
+            "Error: StabilizerState::add_state(const QuantumStateBase*): "
+            "sum of stabilizer states is not a stabilizer state");
+    }
+    [[noreturn]] virtual void add_state_with_coef(
+        CPPCTYPE, const QuantumStateBase*) override {
+        throw NotImplementedException(
+            "Error: StabilizerState::add_state_with_coef(CPPCTYPE, const "
+            "QuantumStateBase*): sum of stabilizer states is not a "
+            "stabilizer state");
+    }
+    [[noreturn]] virtual void add_state_with_coef_single_thread(
+        CPPCTYPE, const QuantumStateBase*) override {
+        throw NotImplementedException(
+            "Error: StabilizerState::add_state_with_coef_single_thread("
+            "CPPCTYPE, const QuantumStateBase*): sum of stabilizer states is "
+            "not a stabilizer state");
+    }
+    [[noreturn]] virtual void multiply_coef(CPPCTYPE) override {
+        throw NotImplementedException(
+            "Error: StabilizerState::multiply_coef(CPPCTYPE): stabilizer "
+            "state does not hold the global phase");
+    }
+    [[noreturn]] virtual void multiply_elementwise_function(
+        const std::function<CPPCTYPE(ITYPE)>&) override {
+        throw NotImplementedException(
+            "Error: StabilizerState::multiply_elementwise_function(const "
+            "function<CPPCTYPE(ITYPE)>&): stabilizer state does not hold "
+            "state vector");
+    }
+
+    /**
+     * \~japanese-en 量子ゲートを作用させる
+     *
+     * H, S, Sdag, X, Y, Z, sqrtX, sqrtXdag, sqrtY, sqrtYdag, CNOT, CZ,
+     * SWAP, Pauli ゲートを作用させられる。
+     * @param gate 作用させる量子ゲート
+     */
+    virtual void apply_gate(const QuantumGateBase* gate) override;
+
+    virtual bool is_gate_applied_by_state() const override { return true; }
+
+    virtual bool is_Pauli_expectation_computed_by_state() const override {
+        return true;
+    }
+
+    /**
+     * \~japanese-en 量子ビットをZ基底で測定し、状態を射影する
+     *
+     * @param target_qubit_index 測定する量子ビットの添え字
+     * @return 測定結果
+     */
+    virtual UINT measure(UINT target_qubit_index);
+
+    /**
+     * \~japanese-en パウリ演算子の期待値を計算する
+     *
+     * 期待値は1、-1、0のいずれかになる。
+     * @param target_qubit_index_list 作用する量子ビットの添え字のリスト
+     * @param pauli_id_list パウリ演算子のリスト。(I,X,Y,Z)が(0,1,2,3)に対応する。
+     * @return 期待値
+     */
+    virtual double get_Pauli_expectation_value(
+        const std::vector<UINT>& target_qubit_index_list,
+        const std::vector<UINT>& pauli_id_list) const override;
+
+    /**
+     * \~japanese-en 量子状態を測定した際の計算基底のサンプリングを行う
+     *
+     * 各サンプルはタブローの複製を全ての量子ビットについて測定して得る。
+     * 結果は整数で返されるため、量子ビット数は64以下である必要がある。
+     * @param[in] sampling_count サンプリングを行う回数
+     * @return サンプルされた値のリスト
+     */
+    virtual std::vector<ITYPE> sampling(UINT sampling_count) override;
+    virtual std::vector<ITYPE> sampling(
+        UINT sampling_count, UINT random_seed) override {
+        random.set_seed(random_seed);
+        return this->sampling(sampling_count);
+    }
+
+    virtual std::string to_string() const override;
+
+    [[noreturn]] virtual boost::property_tree::ptree to_ptree()
+        const override {
+        throw NotImplementedException(
+            "Error: StabilizerState::to_ptree(): stabilizer state cannot be "
+            "converted to ptree");
+    }
+};
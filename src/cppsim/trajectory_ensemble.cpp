@@ -0,0 +1,146 @@
+#include "trajectory_ensemble.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <csim/utility.hpp>
+#include <memory>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "exception.hpp"
+#include "gate.hpp"
+
+TrajectoryEnsemble::TrajectoryEnsemble(
+    const QuantumCircuit* init_circuit, const QuantumState* init_state) {
+    if (init_state == NULL) {
+        // initialize with zero state if not provided.
+        initial_state = new QuantumState(init_circuit->qubit_count);
+        initial_state->set_zero_state();
+    } else {
+        if (init_state->qubit_count != init_circuit->qubit_count) {
+            throw InvalidQubitCountException(
+                "Error: TrajectoryEnsemble::TrajectoryEnsemble(const "
+                "QuantumCircuit*, const QuantumState*): invalid qubit count");
+        }
+        initial_state = init_state->copy();
+    }
+    circuit = init_circuit->copy();
+}
+
+TrajectoryEnsemble::~TrajectoryEnsemble() {
+    delete initial_state;
+    delete circuit;
+}
+
+TrajectoryEnsemble::Result TrajectoryEnsemble::estimate(
+    const GeneralQuantumOperator* observable, UINT max_trajectory_count,
+    double target_standard_error, UINT batch_size) {
+    const UINT qubit_count = initial_state->qubit_count;
+    if (observable->get_qubit_count() != qubit_count) {
+        throw InvalidQubitCountException(
+            "Error: TrajectoryEnsemble::estimate(const "
+            "GeneralQuantumOperator*, UINT, double, UINT): invalid qubit "
+            "count");
+    }
+    if (batch_size == 0 || target_standard_error <= 0.) {
+        batch_size = max_trajectory_count;
+    }
+    batch_size = std::max(1U, std::min(batch_size, max_trajectory_count));
+
+    // the same layout as NoiseSimulator::execute_parallel
+    const UINT trajectory_parallel_qubit_count = 20;
+    UINT thread_per_trajectory = 1;
+    UINT worker_count = 1;
+#ifdef _OPENMP
+    const UINT thread_count = (UINT)omp_get_max_threads();
+    if (qubit_count > trajectory_parallel_qubit_count) {
+        const UINT shift =
+            std::min(qubit_count - trajectory_parallel_qubit_count, 31U);
+        thread_per_trajectory = std::min(thread_count, 1U << shift);
+    }
+    worker_count = std::max(
+        1U, std::min(thread_count / thread_per_trajectory, batch_size));
+    const int max_active_levels = omp_get_max_active_levels();
+    if (worker_count > 1 && thread_per_trajectory > 1) {
+        omp_set_max_active_levels(2);
+    }
+#endif
+
+    // each worker owns its state and its copy of the circuit, since the
+    // gates keep random engines of their own
+    std::vector<std::unique_ptr<QuantumCircuit>> circuit_list;
+    std::vector<std::unique_ptr<QuantumState>> state_list;
+    for (UINT worker = 0; worker < worker_count; ++worker) {
+        circuit_list.emplace_back(circuit->copy());
+        state_list.emplace_back(new QuantumState(qubit_count));
+    }
+
+    // running mean and sum of squared deviations by Welford's method
+    double mean = 0.;
+    double squared_deviation_sum = 0.;
+    UINT trajectory_count = 0;
+    double standard_error = 0.;
+    std::vector<uint64_t> seed_list(batch_size);
+    std::vector<double> value_list(batch_size);
+    while (trajectory_count < max_trajectory_count) {
+        const UINT count =
+            std::min(batch_size, max_trajectory_count - trajectory_count);
+        // the seeds are drawn here to be independent of the thread count
+        for (UINT i = 0; i < count; ++i) seed_list[i] = random.int64();
+
+#ifdef _OPENMP
+#pragma omp parallel num_threads(worker_count) if (worker_count > 1)
+#endif
+        {
+#ifdef _OPENMP
+            const UINT worker = (UINT)omp_get_thread_num();
+            OMPutil::get_inst().set_qulacs_num_thread_limit(
+                thread_per_trajectory);
+#else
+            const UINT worker = 0;
+#endif
+            QuantumCircuit* worker_circuit = circuit_list[worker].get();
+            QuantumState* state = state_list[worker].get();
+            Random trajectory_random;
+            for (UINT i = worker; i < count; i += worker_count) {
+                // every gate draws its branches from a stream of the
+                // trajectory
+                trajectory_random.set_seed(seed_list[i]);
+                for (auto gate : worker_circuit->gate_list) {
+                    gate->set_seed((int)trajectory_random.int32());
+                }
+                state->load(initial_state);
+                worker_circuit->update_quantum_state(state);
+                value_list[i] = observable->get_expectation_value(state).real();
+            }
+#ifdef _OPENMP
+            OMPutil::get_inst().set_qulacs_num_thread_limit(0);
+#endif
+        }
+
+        for (UINT i = 0; i < count; ++i) {
+            ++trajectory_count;
+            const double delta = value_list[i] - mean;
+            mean += delta / trajectory_count;
+            squared_deviation_sum += delta * (value_list[i] - mean);
+        }
+        if (trajectory_count > 1) {
+            standard_error = std::sqrt(squared_deviation_sum /
+                                       (trajectory_count - 1) /
+                                       trajectory_count);
+            if (standard_error <= target_standard_error) break;
+        }
+    }
+#ifdef _OPENMP
+    omp_set_max_active_levels(max_active_levels);
+#endif
+
+    Result result;
+    result.mean = mean;
+    result.standard_error = standard_error;
+    result.trajectory_count = trajectory_count;
+    return result;
+}
+
+void TrajectoryEnsemble::set_seed(UINT seed) { random.set_seed(seed); }
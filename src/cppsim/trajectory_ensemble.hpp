@@ -0,0 +1,84 @@
+#pragma once
+
+#include "circuit.hpp"
+#include "general_quantum_operator.hpp"
+#include "state.hpp"
+#include "type.hpp"
+#include "utility.hpp"
+
+/**
+ * \~japanese-en
+ * ノイズを含む回路の物理量の期待値を、状態ベクトルのトラジェクトリの平均で
+ * 推定するクラス
+ *
+ * 密度行列の4^nのメモリを必要とせず、各トラジェクトリはCPTP、Probabilistic
+ * などのノイズゲートの分岐を確率的に選んで状態ベクトルとして計算される。
+ * トラジェクトリは並列に実行され、推定値の標準誤差が目標値を下回ると
+ * 打ち切られる。
+ */
+class DllExport TrajectoryEnsemble {
+private:
+    Random random;
+    QuantumCircuit* circuit;
+    QuantumState* initial_state;
+
+public:
+    /**
+     * \~japanese-en 推定の結果をまとめた構造体
+     */
+    struct Result {
+    public:
+        //! トラジェクトリごとの期待値の平均
+        double mean;
+        //! 平均の標準誤差。トラジェクトリが1つ以下の場合は0
+        double standard_error;
+        //! 実行したトラジェクトリの数
+        UINT trajectory_count;
+    };
+
+    /**
+     * \~japanese-en
+     * コンストラクタ。
+     *
+     * @param[in] init_circuit  シミュレータに使用する量子回路。
+     * @param[in] init_state
+     * 最初の状態。指定されなかった場合は|00...0>で初期化される。
+     * @return TrajectoryEnsembleのインスタンス
+     */
+    explicit TrajectoryEnsemble(const QuantumCircuit* init_circuit,
+        const QuantumState* init_state = NULL);
+    /**
+     * \~japanese-en
+     * デストラクタ。このとき、TrajectoryEnsembleが保持しているcircuitとinitial_stateは解放される。
+     */
+    virtual ~TrajectoryEnsemble();
+
+    /**
+     * \~japanese-en
+     *
+     * トラジェクトリを並列に実行し、物理量の期待値の平均と標準誤差を返す。
+     *
+     * トラジェクトリはbatch_size個ずつ実行され、各バッチの後に標準誤差が
+     * target_standard_error以下であれば打ち切られる。
+     * 各トラジェクトリの乱数はシードから順に生成されるため、結果は
+     * スレッド数によらない。
+     * @param[in] observable 期待値を求めるエルミートな演算子
+     * @param[in] max_trajectory_count 実行するトラジェクトリの数の上限
+     * @param[in] target_standard_error
+     * 目標とする標準誤差。0の場合は上限まで実行する。
+     * @param[in] batch_size
+     * 打ち切りを判定する間隔のトラジェクトリ数。0の場合は上限まで実行する。
+     * @return 推定の結果
+     */
+    virtual Result estimate(const GeneralQuantumOperator* observable,
+        UINT max_trajectory_count, double target_standard_error = 0.,
+        UINT batch_size = 100);
+
+    /**
+     * \~japanese-en
+     *
+     * 乱数のシードを設定する。
+     * @param[in] seed シード値
+     */
+    virtual void set_seed(UINT seed);
+};
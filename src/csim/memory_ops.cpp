@@ -1,32 +1,388 @@
 #include "memory_ops.hpp"
 
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+
+#include <map>
+#include <mutex>
+#include <vector>
 
 #include "utility.hpp"
 #ifdef _OPENMP
 #include <omp.h>
 #endif
 
-#ifdef _MSC_VER
-#define aligned_free _aligned_free;
-#define aligned_malloc _aligned_malloc;
+#ifdef __linux__
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
 #endif
 
-// memory allocation
-CTYPE* allocate_quantum_state(ITYPE dim) {
-    CTYPE* state = (CTYPE*)malloc((size_t)(sizeof(CTYPE) * dim));
-    // CTYPE* state = (CTYPE*)_aligned_malloc((size_t)(sizeof(CTYPE)*dim), 32);
+#define DEFAULT_MEMORY_ALIGNMENT 64
+#define HUGE_PAGE_SIZE (2ULL << 20)
+// MPOL_INTERLEAVE in linux/mempolicy.h
+#define LINUX_MPOL_INTERLEAVE 3
+// number of released buffers kept for each size
+#define STATE_POOL_BUCKET_LIMIT 4
+// the pool is disabled unless a capacity is given
+#define DEFAULT_STATE_POOL_CAPACITY 0
+
+// Bookkeeping stored just before the pointer returned to the caller, so that
+// release_state_memory knows how the memory was obtained.
+typedef struct {
+    void* base;
+    size_t mapped_size;  // 0 when the memory is obtained by malloc
+    size_t size;         // requested size in bytes
+    UINT generation;     // generation of the allocator policy
+} StateMemoryHeader;
+
+typedef struct {
+    UINT alignment;
+    UINT huge_page_policy;
+    UINT numa_policy;
+} StateAllocatorPolicy;
+
+static UINT parse_policy_env(
+    const char* name, const char* const* values, UINT value_count) {
+    const char* env = getenv(name);
+    if (env == NULL) return 0;
+    for (UINT index = 0; index < value_count; ++index) {
+        if (strcmp(env, values[index]) == 0) return index;
+    }
+    const UINT index = (UINT)strtol(env, NULL, 0);
+    return (index < value_count) ? index : 0;
+}
+
+static int is_valid_alignment(UINT alignment) {
+    return alignment >= DEFAULT_MEMORY_ALIGNMENT &&
+           (alignment & (alignment - 1)) == 0;
+}
+
+static StateAllocatorPolicy get_default_allocator_policy() {
+    StateAllocatorPolicy policy;
+    policy.alignment = DEFAULT_MEMORY_ALIGNMENT;
+    if (const char* env = getenv("QULACS_MEMORY_ALIGNMENT")) {
+        const UINT alignment = (UINT)strtol(env, NULL, 0);
+        if (is_valid_alignment(alignment)) policy.alignment = alignment;
+    }
+    const char* huge_page_values[] = {"none", "transparent", "explicit"};
+    policy.huge_page_policy =
+        parse_policy_env("QULACS_HUGE_PAGE", huge_page_values, 3);
+    const char* numa_values[] = {"none", "interleave", "first_touch"};
+    policy.numa_policy =
+        parse_policy_env("QULACS_NUMA_POLICY", numa_values, 3);
+    return policy;
+}
+
+// Released buffers kept for reuse, bucketed by their size in bytes, and the
+// allocator policy, both guarded by the mutex. Every change of the policy
+// starts a new generation. Buffers of the older generations are not cached,
+// so all the cached buffers are allocated with the current policy.
+typedef struct {
+    std::mutex mutex;
+    std::map<size_t, std::vector<void*>> buckets;
+    size_t capacity;
+    StateMemoryPoolStatistics statistics;
+    StateAllocatorPolicy policy;
+    UINT generation;
+} StateMemoryPool;
+
+static StateMemoryPool& get_state_memory_pool() {
+    // never destructed so that states released at exit can be returned
+    static StateMemoryPool* pool = []() {
+        StateMemoryPool* init = new StateMemoryPool();
+        init->policy = get_default_allocator_policy();
+        init->generation = 0;
+        init->capacity = DEFAULT_STATE_POOL_CAPACITY;
+        if (const char* env = getenv("QULACS_STATE_POOL_MAX_BYTES")) {
+            init->capacity = (size_t)strtoull(env, NULL, 0);
+        }
+        memset(&init->statistics, 0, sizeof(init->statistics));
+        return init;
+    }();
+    return *pool;
+}
+
+static void release_state_memory_direct(void* ptr);
+
+// Release cached buffers until at most max_bytes are cached. Buffers of
+// size keep_size are released last. Must be called with the mutex held.
+static void shrink_state_memory_pool(
+    StateMemoryPool& pool, size_t max_bytes, size_t keep_size) {
+    auto it = pool.buckets.begin();
+    while (pool.statistics.cached_bytes > max_bytes &&
+           it != pool.buckets.end()) {
+        if (it->first == keep_size) {
+            ++it;
+            continue;
+        }
+        while (!it->second.empty() &&
+               pool.statistics.cached_bytes > max_bytes) {
+            release_state_memory_direct(it->second.back());
+            it->second.pop_back();
+            pool.statistics.cached_bytes -= it->first;
+            --pool.statistics.cached_count;
+        }
+        it = it->second.empty() ? pool.buckets.erase(it) : std::next(it);
+    }
+    auto keep = pool.buckets.find(keep_size);
+    while (pool.statistics.cached_bytes > max_bytes &&
+           keep != pool.buckets.end() && !keep->second.empty()) {
+        release_state_memory_direct(keep->second.back());
+        keep->second.pop_back();
+        pool.statistics.cached_bytes -= keep_size;
+        --pool.statistics.cached_count;
+    }
+}
+
+void clear_state_memory_pool() {
+    StateMemoryPool& pool = get_state_memory_pool();
+    std::lock_guard<std::mutex> lock(pool.mutex);
+    shrink_state_memory_pool(pool, 0, 0);
+    pool.buckets.clear();
+}
+
+void set_state_memory_pool_capacity(size_t max_bytes) {
+    StateMemoryPool& pool = get_state_memory_pool();
+    std::lock_guard<std::mutex> lock(pool.mutex);
+    pool.capacity = max_bytes;
+    shrink_state_memory_pool(pool, max_bytes, 0);
+}
+
+size_t get_state_memory_pool_capacity() {
+    StateMemoryPool& pool = get_state_memory_pool();
+    std::lock_guard<std::mutex> lock(pool.mutex);
+    return pool.capacity;
+}
+
+StateMemoryPoolStatistics get_state_memory_pool_statistics() {
+    StateMemoryPool& pool = get_state_memory_pool();
+    std::lock_guard<std::mutex> lock(pool.mutex);
+    return pool.statistics;
+}
+
+void reset_state_memory_pool_statistics() {
+    StateMemoryPool& pool = get_state_memory_pool();
+    std::lock_guard<std::mutex> lock(pool.mutex);
+    pool.statistics.allocation_count = 0;
+    pool.statistics.reuse_count = 0;
+    pool.statistics.release_count = 0;
+}
+
+void set_quantum_state_allocator(
+    UINT alignment, UINT huge_page_policy, UINT numa_policy) {
+    StateMemoryPool& pool = get_state_memory_pool();
+    std::lock_guard<std::mutex> lock(pool.mutex);
+    pool.policy.alignment =
+        is_valid_alignment(alignment) ? alignment : DEFAULT_MEMORY_ALIGNMENT;
+    pool.policy.huge_page_policy =
+        (huge_page_policy <= HUGE_PAGE_EXPLICIT) ? huge_page_policy : 0;
+    pool.policy.numa_policy =
+        (numa_policy <= NUMA_POLICY_FIRST_TOUCH) ? numa_policy : 0;
+    // cached buffers and buffers still in use follow the previous policy
+    ++pool.generation;
+    shrink_state_memory_pool(pool, 0, 0);
+    pool.buckets.clear();
+}
+
+static StateAllocatorPolicy get_allocator_policy() {
+    StateMemoryPool& pool = get_state_memory_pool();
+    std::lock_guard<std::mutex> lock(pool.mutex);
+    return pool.policy;
+}
+
+UINT get_quantum_state_alignment() { return get_allocator_policy().alignment; }
+
+UINT get_quantum_state_huge_page_policy() {
+    return get_allocator_policy().huge_page_policy;
+}
+
+UINT get_quantum_state_numa_policy() {
+    return get_allocator_policy().numa_policy;
+}
+
+#ifdef __linux__
+// Interleave the pages of [addr, addr+size) over the online NUMA nodes. Does
+// nothing on single-node machines.
+static void interleave_pages(void* addr, size_t size) {
+    FILE* fp = fopen("/sys/devices/system/node/online", "r");
+    if (fp == NULL) return;
+    unsigned long node_mask = 0;
+    unsigned int first, last;
+    while (fscanf(fp, "%u", &first) == 1) {
+        last = first;
+        if (fscanf(fp, "-%u", &last) != 1) last = first;
+        for (unsigned int node = first; node <= last && node < 64; ++node) {
+            node_mask |= 1UL << node;
+        }
+        if (fgetc(fp) != ',') break;
+    }
+    fclose(fp);
+    if ((node_mask & (node_mask - 1)) == 0) return;
+    syscall(SYS_mbind, addr, size, LINUX_MPOL_INTERLEAVE, &node_mask,
+        sizeof(node_mask) * 8, 0);
+}
 
-    if (!state) {
+// Map anonymous memory following the huge page and NUMA policy.
+static void* map_state_memory(size_t size, UINT huge_page_policy,
+    UINT numa_policy, size_t* mapped_size) {
+    void* base = MAP_FAILED;
+    if (huge_page_policy == HUGE_PAGE_EXPLICIT) {
+        *mapped_size = (size + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1);
+        base = mmap(NULL, *mapped_size, PROT_READ | PROT_WRITE,
+            MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (base == MAP_FAILED) {
+            static bool is_warned = false;
+            if (!is_warned) {
+                fprintf(stderr,
+                    "Warning: explicit huge pages are not available. "
+                    "Transparent huge pages are used instead.\n");
+                is_warned = true;
+            }
+            huge_page_policy = HUGE_PAGE_TRANSPARENT;
+        }
+    }
+    if (base == MAP_FAILED) {
+        const size_t page_size = (size_t)sysconf(_SC_PAGESIZE);
+        *mapped_size = (size + page_size - 1) & ~(page_size - 1);
+        base = mmap(NULL, *mapped_size, PROT_READ | PROT_WRITE,
+            MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (base == MAP_FAILED) return NULL;
+#ifdef MADV_HUGEPAGE
+        if (huge_page_policy == HUGE_PAGE_TRANSPARENT) {
+            madvise(base, *mapped_size, MADV_HUGEPAGE);
+        }
+#endif
+    }
+    if (numa_policy == NUMA_POLICY_INTERLEAVE) {
+        interleave_pages(base, *mapped_size);
+    }
+    return base;
+}
+#endif
+
+// Touch the pages with the same static schedule as the loops over the state
+// vector, so that each page is placed on the NUMA node of the thread which
+// processes it.
+static void first_touch_pages(char* ptr, ITYPE dim, size_t element_size) {
+#ifdef _OPENMP
+    OMPutil::get_inst().set_qulacs_num_threads(dim, 15);
+#pragma omp parallel
+    {
+        const size_t thread_count = (size_t)omp_get_num_threads();
+        const size_t thread_index = (size_t)omp_get_thread_num();
+        const ITYPE begin = dim * thread_index / thread_count;
+        const ITYPE end = dim * (thread_index + 1) / thread_count;
+        memset(ptr + begin * element_size, 0,
+            (size_t)(end - begin) * element_size);
+    }
+    OMPutil::get_inst().reset_qulacs_num_threads();
+#else
+    memset(ptr, 0, (size_t)dim * element_size);
+#endif
+}
+
+void* allocate_state_memory(ITYPE dim, size_t element_size) {
+    const size_t size = (size_t)dim * element_size;
+    StateAllocatorPolicy policy;
+    UINT generation;
+    {
+        StateMemoryPool& pool = get_state_memory_pool();
+        std::lock_guard<std::mutex> lock(pool.mutex);
+        ++pool.statistics.allocation_count;
+        policy = pool.policy;
+        generation = pool.generation;
+        auto it = pool.buckets.find(size);
+        if (it != pool.buckets.end() && !it->second.empty()) {
+            void* ptr = it->second.back();
+            it->second.pop_back();
+            pool.statistics.cached_bytes -= size;
+            --pool.statistics.cached_count;
+            ++pool.statistics.reuse_count;
+            return ptr;
+        }
+    }
+
+    // the header is placed in the padding in front of the aligned pointer
+    const size_t padding = policy.alignment + sizeof(StateMemoryHeader);
+
+    void* base = NULL;
+    size_t mapped_size = 0;
+#ifdef __linux__
+    if (policy.huge_page_policy != HUGE_PAGE_NONE ||
+        policy.numa_policy != NUMA_POLICY_NONE) {
+        base = map_state_memory(size + padding, policy.huge_page_policy,
+            policy.numa_policy, &mapped_size);
+    }
+#endif
+    if (base == NULL) {
+        mapped_size = 0;
+        base = malloc(size + padding);
+    }
+    if (!base) {
         fprintf(stderr, "Out of memory\n");
         fflush(stderr);
         exit(1);
     }
-    return state;
+
+    uintptr_t address = (uintptr_t)base + sizeof(StateMemoryHeader);
+    address = (address + policy.alignment - 1) &
+              ~((uintptr_t)policy.alignment - 1);
+    StateMemoryHeader* header = (StateMemoryHeader*)address - 1;
+    header->base = base;
+    header->mapped_size = mapped_size;
+    header->size = size;
+    header->generation = generation;
+
+    if (policy.numa_policy == NUMA_POLICY_FIRST_TOUCH) {
+        first_touch_pages((char*)address, dim, element_size);
+    }
+    return (void*)address;
+}
+
+void release_state_memory(void* ptr) {
+    if (ptr == NULL) return;
+    const StateMemoryHeader* header = (StateMemoryHeader*)ptr - 1;
+    const size_t size = header->size;
+    StateMemoryPool& pool = get_state_memory_pool();
+    {
+        std::lock_guard<std::mutex> lock(pool.mutex);
+        ++pool.statistics.release_count;
+        // a disabled pool does not create buckets
+        auto it = pool.buckets.find(size);
+        const size_t bucket_count =
+            (it == pool.buckets.end()) ? 0 : it->second.size();
+        if (header->generation == pool.generation && size <= pool.capacity &&
+            bucket_count < STATE_POOL_BUCKET_LIMIT) {
+            // make room by releasing buffers of the other sizes first
+            shrink_state_memory_pool(pool, pool.capacity - size, size);
+            if (pool.statistics.cached_bytes + size <= pool.capacity) {
+                pool.buckets[size].push_back(ptr);
+                pool.statistics.cached_bytes += size;
+                ++pool.statistics.cached_count;
+                return;
+            }
+        }
+    }
+    release_state_memory_direct(ptr);
 }
 
-void release_quantum_state(CTYPE* state) {
-    free(state);
-    //_aligned_free(state);
+static void release_state_memory_direct(void* ptr) {
+    StateMemoryHeader* header = (StateMemoryHeader*)ptr - 1;
+#ifdef __linux__
+    if (header->mapped_size != 0) {
+        munmap(header->base, header->mapped_size);
+        return;
+    }
+#endif
+    free(header->base);
 }
+
+// memory allocation
+CTYPE* allocate_quantum_state(ITYPE dim) {
+    return (CTYPE*)allocate_state_memory(dim, sizeof(CTYPE));
+}
+
+void release_quantum_state(CTYPE* state) { release_state_memory(state); }
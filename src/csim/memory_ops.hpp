@@ -8,6 +8,20 @@
 
 #include "type.hpp"
 
+//! huge pages are not requested
+#define HUGE_PAGE_NONE 0
+//! transparent huge pages are requested with madvise
+#define HUGE_PAGE_TRANSPARENT 1
+//! explicit huge pages are allocated with MAP_HUGETLB
+#define HUGE_PAGE_EXPLICIT 2
+
+//! pages are placed by the default policy of OS
+#define NUMA_POLICY_NONE 0
+//! pages are interleaved over all the NUMA nodes
+#define NUMA_POLICY_INTERLEAVE 1
+//! pages are touched first by the threads which process them
+#define NUMA_POLICY_FIRST_TOUCH 2
+
 /**
  * allocate quantum state in memory
  *
@@ -24,3 +38,171 @@ DllExport CTYPE* allocate_quantum_state(ITYPE dim);
  * @param[in] psi quantum state
  */
 DllExport void release_quantum_state(CTYPE* state);
+
+/**
+ * \~english
+ * Set the policy of the allocator used for state vectors.
+ *
+ * The policy applies to the states allocated afterwards. The default policy
+ * is read from the environment variables QULACS_MEMORY_ALIGNMENT,
+ * QULACS_HUGE_PAGE (none, transparent or explicit) and QULACS_NUMA_POLICY
+ * (none, interleave or first_touch). Huge pages and NUMA placement are only
+ * available on Linux and are ignored elsewhere. The policy may be changed
+ * while other threads allocate states. The buffers cached by the pool are
+ * released, and states allocated with the previous policy are not cached.
+ *
+ * @param[in] alignment alignment in bytes, a power of two not smaller than 64
+ * @param[in] huge_page_policy one of HUGE_PAGE_*
+ * @param[in] numa_policy one of NUMA_POLICY_*
+ *
+ * \~japanese-en
+ * 状態ベクトルの確保に用いるアロケータの方針を設定する。
+ *
+ * 設定は以降に確保される状態に適用される。既定の方針は環境変数
+ * QULACS_MEMORY_ALIGNMENT、QULACS_HUGE_PAGE (none, transparent, explicit)、
+ * QULACS_NUMA_POLICY (none, interleave, first_touch)
+ * から読み込まれる。ヒュージページと NUMA 配置は Linux
+ * でのみ有効で、それ以外では無視される。他のスレッドが状態を確保している間に
+ * 変更してもよい。プールに保持されたメモリは解放され、以前の方針で確保された
+ * 状態はプールに保持されない。
+ *
+ * @param[in] alignment バイト単位のアライメント。64 以上の 2 のべき
+ * @param[in] huge_page_policy HUGE_PAGE_* のいずれか
+ * @param[in] numa_policy NUMA_POLICY_* のいずれか
+ */
+DllExport void set_quantum_state_allocator(
+    UINT alignment, UINT huge_page_policy, UINT numa_policy);
+
+/**
+ * \~english
+ * Get the alignment in bytes of the allocated state vectors.
+ *
+ * \~japanese-en
+ * 確保される状態ベクトルのバイト単位のアライメントを取得する。
+ */
+DllExport UINT get_quantum_state_alignment();
+
+/**
+ * \~english
+ * Get the huge page policy of the allocator.
+ *
+ * \~japanese-en
+ * アロケータのヒュージページの方針を取得する。
+ */
+DllExport UINT get_quantum_state_huge_page_policy();
+
+/**
+ * \~english
+ * Get the NUMA policy of the allocator.
+ *
+ * \~japanese-en
+ * アロケータの NUMA 配置の方針を取得する。
+ */
+DllExport UINT get_quantum_state_numa_policy();
+
+/**
+ * \~english
+ * Allocate memory for dim elements of element_size bytes with the policy of
+ * the allocator. The memory must be released with release_state_memory. A
+ * buffer of the same size cached in the pool is reused if available, so the
+ * content of the memory is not initialized.
+ *
+ * \~japanese-en
+ * element_size バイトの要素 dim 個分のメモリをアロケータの方針で確保する。
+ * 確保したメモリは release_state_memory で解放する。プールに同じサイズの
+ * バッファがあればそれを再利用するため、メモリの内容は初期化されない。
+ */
+DllExport void* allocate_state_memory(ITYPE dim, size_t element_size);
+
+/**
+ * \~english
+ * Release memory allocated by allocate_state_memory. The memory is kept in
+ * the pool for reuse while the capacity of the pool allows.
+ *
+ * \~japanese-en
+ * allocate_state_memory で確保したメモリを解放する。プールの容量が許す限り、
+ * メモリは再利用のためにプールに保持される。
+ */
+DllExport void release_state_memory(void* ptr);
+
+/**
+ * \~english
+ * Statistics of the pool of released state buffers.
+ *
+ * \~japanese-en
+ * 解放された状態バッファのプールの統計情報。
+ */
+typedef struct {
+    //! number of calls of allocate_state_memory
+    ITYPE allocation_count;
+    //! number of allocations served by a cached buffer
+    ITYPE reuse_count;
+    //! number of calls of release_state_memory
+    ITYPE release_count;
+    //! number of buffers currently cached
+    ITYPE cached_count;
+    //! total size in bytes of the buffers currently cached
+    size_t cached_bytes;
+} StateMemoryPoolStatistics;
+
+/**
+ * \~english
+ * Set the maximum total size in bytes of the buffers kept by the pool.
+ *
+ * Memory released by release_state_memory is kept in a pool bucketed by size
+ * and reused by the next allocation of the same size, so that temporary
+ * states do not pay for the allocation and the page faults every time. Up to
+ * four buffers are kept for each size. The pool is opt-in: the default
+ * capacity is 0, which disables the pool, or the value of the environment
+ * variable QULACS_STATE_POOL_MAX_BYTES.
+ *
+ * @param[in] max_bytes maximum total size in bytes of the cached buffers
+ *
+ * \~japanese-en
+ * プールに保持するバッファの合計サイズの上限をバイト単位で設定する。
+ *
+ * release_state_memory で解放されたメモリはサイズごとにプールに保持され、
+ * 同じサイズの次の確保で再利用される。これにより一時的な状態の確保と
+ * ページフォールトのコストを毎回払わずに済む。サイズごとに最大 4
+ * 個のバッファが保持される。既定値はプールを無効にする 0 または環境変数
+ * QULACS_STATE_POOL_MAX_BYTES の値である。
+ *
+ * @param[in] max_bytes キャッシュするバッファの合計サイズの上限
+ */
+DllExport void set_state_memory_pool_capacity(size_t max_bytes);
+
+/**
+ * \~english
+ * Get the maximum total size in bytes of the buffers kept by the pool.
+ *
+ * \~japanese-en
+ * プールに保持するバッファの合計サイズの上限を取得する。
+ */
+DllExport size_t get_state_memory_pool_capacity();
+
+/**
+ * \~english
+ * Get the statistics of the pool of state buffers.
+ *
+ * \~japanese-en
+ * 状態バッファのプールの統計情報を取得する。
+ */
+DllExport StateMemoryPoolStatistics get_state_memory_pool_statistics();
+
+/**
+ * \~english
+ * Reset the allocation, reuse and release counters of the pool.
+ *
+ * \~japanese-en
+ * プールの確保・再利用・解放の回数をリセットする。
+ */
+DllExport void reset_state_memory_pool_statistics();
+
+/**
+ * \~english
+ * Release all the buffers cached in the pool.
+ *
+ * \~japanese-en
+ * プールにキャッシュされたバッファをすべて解放する。
+ */
+DllExport void clear_state_memory_pool();
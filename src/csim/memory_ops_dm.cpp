@@ -5,18 +5,14 @@
 #include <stdlib.h>
 #include <time.h>
 
+#include "memory_ops.hpp"
 #include "utility.hpp"
 #ifdef _OPENMP
 #include <omp.h>
 #endif
 
 CTYPE* dm_allocate_quantum_state(ITYPE dim) {
-    CTYPE* state = (CTYPE*)malloc((size_t)(sizeof(CTYPE) * dim * dim));
-    if (!state) {
-        fprintf(stderr, "Out of memory\n");
-        exit(1);
-    }
-    return state;
+    return (CTYPE*)allocate_state_memory(dim * dim, sizeof(CTYPE));
 }
 
 void dm_initialize_quantum_state(CTYPE* state, ITYPE dim) {
@@ -34,7 +30,7 @@ void dm_initialize_quantum_state(CTYPE* state, ITYPE dim) {
     state[0] = 1.0;
 }
 
-void dm_release_quantum_state(CTYPE* state) { free(state); }
+void dm_release_quantum_state(CTYPE* state) { release_state_memory(state); }
 
 void dm_initialize_with_pure_state(
     CTYPE* state, const CTYPE* pure_state, ITYPE dim) {
@@ -54,3 +50,82 @@ void dm_initialize_with_pure_state(
     OMPutil::get_inst().reset_qulacs_num_threads();
 #endif
 }
+
+CTYPE* dm_packed_allocate_quantum_state(ITYPE dim) {
+    return (CTYPE*)allocate_state_memory(dim * (dim + 1) / 2, sizeof(CTYPE));
+}
+
+void dm_packed_initialize_quantum_state(CTYPE* state, ITYPE dim) {
+    const ITYPE packed_dim = dim * (dim + 1) / 2;
+    ITYPE index;
+#ifdef _OPENMP
+    OMPutil::get_inst().set_qulacs_num_threads(dim, 10);
+#pragma omp parallel for
+#endif
+    for (index = 0; index < packed_dim; ++index) {
+        state[index] = 0;
+    }
+#ifdef _OPENMP
+    OMPutil::get_inst().reset_qulacs_num_threads();
+#endif
+    state[0] = 1.0;
+}
+
+void dm_packed_initialize_with_pure_state(
+    CTYPE* state, const CTYPE* pure_state, ITYPE dim) {
+    ITYPE ind_y;
+#ifdef _OPENMP
+    OMPutil::get_inst().set_qulacs_num_threads(dim, 10);
+#pragma omp parallel for schedule(dynamic, 16)
+#endif
+    for (ind_y = 0; ind_y < dim; ++ind_y) {
+        CTYPE* row = state + get_packed_hermitian_index(ind_y, ind_y, dim);
+        ITYPE ind_x;
+        for (ind_x = ind_y; ind_x < dim; ++ind_x) {
+            row[ind_x - ind_y] = pure_state[ind_y] * conj(pure_state[ind_x]);
+        }
+    }
+#ifdef _OPENMP
+    OMPutil::get_inst().reset_qulacs_num_threads();
+#endif
+}
+
+void dm_packed_from_density_matrix(
+    const CTYPE* density_matrix, CTYPE* state, ITYPE dim) {
+    ITYPE ind_y;
+#ifdef _OPENMP
+    OMPutil::get_inst().set_qulacs_num_threads(dim, 10);
+#pragma omp parallel for schedule(dynamic, 16)
+#endif
+    for (ind_y = 0; ind_y < dim; ++ind_y) {
+        CTYPE* row = state + get_packed_hermitian_index(ind_y, ind_y, dim);
+        ITYPE ind_x;
+        for (ind_x = ind_y; ind_x < dim; ++ind_x) {
+            row[ind_x - ind_y] = density_matrix[ind_y * dim + ind_x];
+        }
+    }
+#ifdef _OPENMP
+    OMPutil::get_inst().reset_qulacs_num_threads();
+#endif
+}
+
+void dm_packed_to_density_matrix(
+    const CTYPE* state, CTYPE* density_matrix, ITYPE dim) {
+    ITYPE ind_y;
+#ifdef _OPENMP
+    OMPutil::get_inst().set_qulacs_num_threads(dim, 10);
+#pragma omp parallel for schedule(dynamic, 16)
+#endif
+    for (ind_y = 0; ind_y < dim; ++ind_y) {
+        const CTYPE* row =
+            state + get_packed_hermitian_index(ind_y, ind_y, dim);
+        ITYPE ind_x;
+        for (ind_x = ind_y; ind_x < dim; ++ind_x) {
+            density_matrix[ind_x * dim + ind_y] = conj(row[ind_x - ind_y]);
+            density_matrix[ind_y * dim + ind_x] = row[ind_x - ind_y];
+        }
+    }
+#ifdef _OPENMP
+    OMPutil::get_inst().reset_qulacs_num_threads();
+#endif
+}
@@ -44,3 +44,56 @@ DllExport void dm_release_quantum_state(CTYPE* state);
  */
 DllExport void dm_initialize_with_pure_state(
     CTYPE* state, const CTYPE* pure_state, ITYPE dim);
+
+/**
+ * allocate density matrix whose upper triangle is packed
+ *
+ * allocate density matrix which holds only the dim * (dim + 1) / 2 elements
+ * on and above the diagonal row by row
+ * @param[in] dim dimension
+ * @return pointer to allocated array
+ */
+DllExport CTYPE* dm_packed_allocate_quantum_state(ITYPE dim);
+
+/**
+ * intiialize packed density matrix to zero state
+ *
+ * intiialize packed density matrix to zero state
+ * @param[out] state pointer of packed density matrix
+ * @param[in] dim dimension
+ */
+DllExport void dm_packed_initialize_quantum_state(CTYPE* state, ITYPE dim);
+
+/**
+ * initialize packed density matrix from pure state
+ *
+ * initialize packed density matrix from pure state
+ * @param[out] state pointer of packed density matrix
+ * @param[in] pure_state pointer of quantum state
+ * @param[in] dim dimension
+ */
+DllExport void dm_packed_initialize_with_pure_state(
+    CTYPE* state, const CTYPE* pure_state, ITYPE dim);
+
+/**
+ * pack the upper triangle of density matrix
+ *
+ * pack the upper triangle of density matrix
+ * @param[in] density_matrix pointer of dim x dim density matrix
+ * @param[out] state pointer of packed density matrix
+ * @param[in] dim dimension
+ */
+DllExport void dm_packed_from_density_matrix(
+    const CTYPE* density_matrix, CTYPE* state, ITYPE dim);
+
+/**
+ * unpack density matrix
+ *
+ * unpack density matrix, where the lower triangle is the conjugate of the
+ * upper triangle
+ * @param[in] state pointer of packed density matrix
+ * @param[out] density_matrix pointer of dim x dim density matrix
+ * @param[in] dim dimension
+ */
+DllExport void dm_packed_to_density_matrix(
+    const CTYPE* state, CTYPE* density_matrix, ITYPE dim);
@@ -0,0 +1,99 @@
+#include "memory_ops_template.hpp"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "memory_ops.hpp"
+#include "utility.hpp"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+// defined in init_ops_random.cpp
+unsigned long xor_shift(unsigned long* state);
+double random_normal(unsigned long* state);
+
+template <typename T>
+std::complex<T>* allocate_quantum_state(ITYPE dim) {
+    return (std::complex<T>*)allocate_state_memory(
+        dim, sizeof(std::complex<T>));
+}
+
+template <typename T>
+void release_quantum_state(std::complex<T>* state) {
+    release_state_memory(state);
+}
+
+template <typename T>
+void initialize_quantum_state(std::complex<T>* state, ITYPE dim) {
+    ITYPE index;
+#ifdef _OPENMP
+    OMPutil::get_inst().set_qulacs_num_threads(dim, 15);
+#pragma omp parallel for
+#endif
+    for (index = 0; index < dim; ++index) {
+        state[index] = 0;
+    }
+    state[0] = 1;
+#ifdef _OPENMP
+    OMPutil::get_inst().reset_qulacs_num_threads();
+#endif
+}
+
+template <typename T>
+void initialize_Haar_random_state_with_seed(
+    std::complex<T>* state, ITYPE dim, UINT seed) {
+    // same sequence as initialize_Haar_random_state_with_seed_single
+    const int ignore_first = 40;
+    double norm = 0.;
+    unsigned long random_state[4];
+    srand(seed);
+    random_state[0] = rand();
+    random_state[1] = rand();
+    random_state[2] = rand();
+    random_state[3] = rand();
+    for (int i = 0; i < ignore_first; ++i) xor_shift(random_state);
+    for (ITYPE index = 0; index < dim; ++index) {
+        double r1 = random_normal(random_state);
+        double r2 = random_normal(random_state);
+        state[index] = std::complex<T>((T)r1, (T)r2);
+        norm += r1 * r1 + r2 * r2;
+    }
+    const T normalizer = (T)(1. / sqrt(norm));
+    for (ITYPE index = 0; index < dim; ++index) {
+        state[index] *= normalizer;
+    }
+}
+
+template <typename SrcT, typename DstT>
+void convert_quantum_state(const std::complex<SrcT>* state_src,
+    std::complex<DstT>* state_dst, ITYPE dim) {
+    ITYPE index;
+#ifdef _OPENMP
+    OMPutil::get_inst().set_qulacs_num_threads(dim, 15);
+#pragma omp parallel for
+#endif
+    for (index = 0; index < dim; ++index) {
+        state_dst[index] = std::complex<DstT>(
+            (DstT)state_src[index].real(), (DstT)state_src[index].imag());
+    }
+#ifdef _OPENMP
+    OMPutil::get_inst().reset_qulacs_num_threads();
+#endif
+}
+
+template DllExport std::complex<float>* allocate_quantum_state<float>(
+    ITYPE dim);
+template DllExport void release_quantum_state<float>(
+    std::complex<float>* state);
+template DllExport void initialize_quantum_state<float>(
+    std::complex<float>* state, ITYPE dim);
+template DllExport void initialize_Haar_random_state_with_seed<float>(
+    std::complex<float>* state, ITYPE dim, UINT seed);
+template DllExport void convert_quantum_state<double, float>(
+    const std::complex<double>* state_src, std::complex<float>* state_dst,
+    ITYPE dim);
+template DllExport void convert_quantum_state<float, double>(
+    const std::complex<float>* state_src, std::complex<double>* state_dst,
+    ITYPE dim);
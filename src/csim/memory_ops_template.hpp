@@ -0,0 +1,101 @@
+/**
+ * @file memory_ops_template.hpp
+ * @brief Allocation and initialization of state vectors with an arbitrary
+ * floating-point precision
+ */
+
+#pragma once
+
+#include "type.hpp"
+
+/**
+ * \~english
+ * Allocate a state vector whose elements are std::complex<T>.
+ *
+ * Only T = float is instantiated. Use allocate_quantum_state(ITYPE) for
+ * double precision.
+ * @param[in] dim dimension, i.e. size of vector
+ * @return pointer to allocated vector
+ *
+ * \~japanese-en
+ * 要素が std::complex<T> である状態ベクトルを確保する。
+ *
+ * T = float のみ実体化されている。倍精度の場合は allocate_quantum_state(ITYPE)
+ * を用いる。
+ * @param[in] dim 次元
+ * @return 確保したベクトルのポインタ
+ */
+template <typename T>
+DllExport std::complex<T>* allocate_quantum_state(ITYPE dim);
+
+/**
+ * \~english
+ * Release a state vector allocated by allocate_quantum_state<T>.
+ *
+ * @param[in] state quantum state
+ *
+ * \~japanese-en
+ * allocate_quantum_state<T> で確保した状態ベクトルを解放する。
+ *
+ * @param[in] state 量子状態
+ */
+template <typename T>
+DllExport void release_quantum_state(std::complex<T>* state);
+
+/**
+ * \~english
+ * Initialize the quantum state to the zero state.
+ *
+ * @param[out] state quantum state
+ * @param[in] dim dimension
+ *
+ * \~japanese-en
+ * 量子状態を計算基底の0状態に初期化する。
+ *
+ * @param[out] state 量子状態
+ * @param[in] dim 次元
+ */
+template <typename T>
+DllExport void initialize_quantum_state(std::complex<T>* state, ITYPE dim);
+
+/**
+ * \~english
+ * Initialize the quantum state to a Haar random state with a seed.
+ *
+ * Amplitudes are sampled in double precision and rounded to T.
+ * @param[out] state quantum state
+ * @param[in] dim dimension
+ * @param[in] seed random seed
+ *
+ * \~japanese-en
+ * シードを用いて量子状態をHaar randomな状態に初期化する。
+ *
+ * 振幅は倍精度でサンプリングしてから T に丸める。
+ * @param[out] state 量子状態
+ * @param[in] dim 次元
+ * @param[in] seed 乱数のシード値
+ */
+template <typename T>
+DllExport void initialize_Haar_random_state_with_seed(
+    std::complex<T>* state, ITYPE dim, UINT seed);
+
+/**
+ * \~english
+ * Convert the precision of a state vector.
+ *
+ * Instantiated for double to float and float to double.
+ * @param[in] state_src source quantum state
+ * @param[out] state_dst destination quantum state
+ * @param[in] dim dimension
+ *
+ * \~japanese-en
+ * 状態ベクトルの精度を変換する。
+ *
+ * double から float と float から double が実体化されている。
+ * @param[in] state_src 変換元の量子状態
+ * @param[out] state_dst 変換先の量子状態
+ * @param[in] dim 次元
+ */
+template <typename SrcT, typename DstT>
+DllExport void convert_quantum_state(const std::complex<SrcT>* state_src,
+    std::complex<DstT>* state_dst, ITYPE dim);
@@ -70,16 +70,37 @@ void state_tensor_product(const CTYPE* state_left, ITYPE dim_left,
 }
 void state_permutate_qubit(const UINT* qubit_order, const CTYPE* state_src,
     CTYPE* state_dst, UINT qubit_count, ITYPE dim) {
+    // bits of qubits staying at the same position are copied at once
+    ITYPE fixed_mask = 0;
+    UINT* moved_qubit_list = (UINT*)malloc(sizeof(UINT) * qubit_count);
+    UINT moved_qubit_count = 0;
+    for (UINT qubit_index = 0; qubit_index < qubit_count; ++qubit_index) {
+        if (qubit_order[qubit_index] == qubit_index) {
+            fixed_mask |= 1ULL << qubit_index;
+        } else {
+            moved_qubit_list[moved_qubit_count++] = qubit_index;
+        }
+    }
+
     ITYPE index;
+#ifdef _OPENMP
+    OMPutil::get_inst().set_qulacs_num_threads(dim, 13);
+#pragma omp parallel for
+#endif
     for (index = 0; index < dim; ++index) {
-        ITYPE src_index = 0;
-        for (UINT qubit_index = 0; qubit_index < qubit_count; ++qubit_index) {
+        ITYPE src_index = index & fixed_mask;
+        for (UINT cursor = 0; cursor < moved_qubit_count; ++cursor) {
+            UINT qubit_index = moved_qubit_list[cursor];
             if ((index >> qubit_index) % 2) {
                 src_index += 1ULL << qubit_order[qubit_index];
             }
         }
         state_dst[index] = state_src[src_index];
     }
+#ifdef _OPENMP
+    OMPutil::get_inst().reset_qulacs_num_threads();
+#endif
+    free(moved_qubit_list);
 }
 
 void state_drop_qubits(const UINT* target, const UINT* projection,
@@ -24,6 +24,30 @@ DllExport double M1_prob(
 DllExport double marginal_prob(const UINT* sorted_target_qubit_index_list,
     const UINT* measured_value_list, UINT target_qubit_index_count,
     const CTYPE* state, ITYPE dim);
+DllExport void marginal_distribution(const UINT* target_qubit_index_list,
+    UINT target_qubit_index_count, double* distribution, const CTYPE* state,
+    ITYPE dim);
+// Squared norms |K_i psi|^2 of the Kraus operators K_i acting on the target
+// qubits. matrix_list holds matrix_count row-major matrices of size
+// 2^target_qubit_index_count, whose basis order follows
+// target_qubit_index_list as in multi_qubit_dense_matrix_gate. The norms are
+// accumulated in a single pass over the state, and the squared norm of the
+// state itself is returned.
+DllExport double Kraus_operator_probabilities(
+    const UINT* target_qubit_index_list, UINT target_qubit_index_count,
+    const CTYPE* matrix_list, UINT matrix_count, double* probability_list,
+    const CTYPE* state, ITYPE dim);
+
+// Sample basis indices for uniform random numbers in [0, 1) sorted in
+// ascending order. The probabilities are accumulated in parallel blocks and
+// swept once together with the random numbers.
+DllExport void state_sampling_sorted(const double* sorted_random_list,
+    UINT sampling_count, ITYPE* result, const CTYPE* state, ITYPE dim);
+// Build the Walker alias table of the probability distribution. A basis
+// index i drawn uniformly is kept with probability threshold_list[i] and
+// replaced with alias_list[i] otherwise.
+DllExport void state_sampling_alias_table(
+    double* threshold_list, ITYPE* alias_list, const CTYPE* state, ITYPE dim);
 
 DllExport double expectation_value_single_qubit_Pauli_operator(
     UINT target_qubit_index, UINT Pauli_operator_type, const CTYPE* state,
@@ -35,6 +59,16 @@ DllExport double expectation_value_multi_qubit_Pauli_operator_partial_list(
     const UINT* target_qubit_index_list, const UINT* Pauli_operator_type_list,
     UINT target_qubit_index_count, const CTYPE* state, ITYPE dim);
 
+// Expectation value of the Pauli operator given by the masks of
+// get_Pauli_masks_partial_list, which skips building the masks from the
+// lists of indices and Pauli IDs.
+DllExport double expectation_value_Pauli_operator_masks(ITYPE bit_flip_mask,
+    ITYPE phase_flip_mask, UINT global_phase_90rot_count,
+    UINT pivot_qubit_index, const CTYPE* state, ITYPE dim);
+DllExport double expectation_value_Pauli_operator_masks_single_thread(
+    ITYPE bit_flip_mask, ITYPE phase_flip_mask, UINT global_phase_90rot_count,
+    UINT pivot_qubit_index, const CTYPE* state, ITYPE dim);
+
 DllExport CTYPE transition_amplitude_multi_qubit_Pauli_operator_whole_list(
     const UINT* Pauli_operator_type_list, UINT qubit_count,
     const CTYPE* state_bra, const CTYPE* state_ket, ITYPE dim);
@@ -42,6 +76,10 @@ DllExport CTYPE transition_amplitude_multi_qubit_Pauli_operator_partial_list(
     const UINT* target_qubit_index_list, const UINT* Pauli_operator_type_list,
     UINT target_qubit_index_count, const CTYPE* state_bra,
     const CTYPE* state_ket, ITYPE dim);
+DllExport CTYPE transition_amplitude_Pauli_operator_masks(ITYPE bit_flip_mask,
+    ITYPE phase_flip_mask, UINT global_phase_90rot_count,
+    UINT pivot_qubit_index, const CTYPE* state_bra, const CTYPE* state_ket,
+    ITYPE dim);
 
 DllExport double
 expectation_value_multi_qubit_Pauli_operator_XZ_mask_single_thread(
@@ -65,3 +103,17 @@ DllExport double
 expectation_value_multi_qubit_Pauli_operator_partial_list_single_thread(
     const UINT* target_qubit_index_list, const UINT* Pauli_operator_type_list,
     UINT target_qubit_index_count, const CTYPE* state, ITYPE dim);
+
+// Sum of coef_list[t] times the expectation value of Pauli terms which share
+// bit_flip_mask, evaluated in a single sweep over the state. The masks of
+// each term are those given by get_Pauli_masks_partial_list, and
+// pivot_qubit_index is any qubit in bit_flip_mask.
+DllExport CTYPE expectation_value_Pauli_operator_group(ITYPE bit_flip_mask,
+    UINT pivot_qubit_index, const ITYPE* phase_flip_mask_list,
+    const UINT* global_phase_90rot_count_list, const CTYPE* coef_list,
+    UINT term_count, const CTYPE* state, ITYPE dim);
+DllExport CTYPE expectation_value_Pauli_operator_group_single_thread(
+    ITYPE bit_flip_mask, UINT pivot_qubit_index,
+    const ITYPE* phase_flip_mask_list,
+    const UINT* global_phase_90rot_count_list, const CTYPE* coef_list,
+    UINT term_count, const CTYPE* state, ITYPE dim);
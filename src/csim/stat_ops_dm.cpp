@@ -118,6 +118,73 @@ double dm_marginal_prob(const UINT* sorted_target_qubit_index_list,
     return sum;
 }
 
+// calculate the marginal probability distribution of the target qubits in a
+// single sweep. The j-th bit of the index of distribution corresponds to
+// target_qubit_index_list[j], which need not be sorted.
+void dm_marginal_distribution(const UINT* target_qubit_index_list,
+    UINT target_qubit_index_count, double* distribution, const CTYPE* state,
+    ITYPE dim) {
+    const ITYPE outcome_count = 1ULL << target_qubit_index_count;
+    const ITYPE loop_dim = dim >> target_qubit_index_count;
+    UINT* sorted_target_qubit_index_list = create_sorted_ui_list(
+        target_qubit_index_list, target_qubit_index_count);
+    ITYPE* outcome_mask_list =
+        (ITYPE*)malloc((size_t)(sizeof(ITYPE) * outcome_count));
+    for (ITYPE outcome = 0; outcome < outcome_count; ++outcome) {
+        ITYPE mask = 0;
+        for (UINT cursor = 0; cursor < target_qubit_index_count; ++cursor) {
+            if ((outcome >> cursor) & 1) {
+                mask |= 1ULL << target_qubit_index_list[cursor];
+            }
+        }
+        outcome_mask_list[outcome] = mask;
+        distribution[outcome] = 0.;
+    }
+
+#ifdef _OPENMP
+    OMPutil::get_inst().set_qulacs_num_threads(dim, 10);
+#pragma omp parallel
+#endif
+    {
+        // each thread accumulates its own table, which is small
+        double* local_distribution =
+            (double*)calloc((size_t)outcome_count, sizeof(double));
+        ITYPE state_index;
+#ifdef _OPENMP
+#pragma omp for
+#endif
+        for (state_index = 0; state_index < loop_dim; ++state_index) {
+            ITYPE basis_0 = state_index;
+            for (UINT cursor = 0; cursor < target_qubit_index_count;
+                 cursor++) {
+                UINT insert_index = sorted_target_qubit_index_list[cursor];
+                ITYPE mask = 1ULL << insert_index;
+                basis_0 =
+                    insert_zero_to_basis_index(basis_0, mask, insert_index);
+            }
+            for (ITYPE outcome = 0; outcome < outcome_count; ++outcome) {
+                ITYPE basis = basis_0 ^ outcome_mask_list[outcome];
+                local_distribution[outcome] +=
+                    _creal(state[basis * dim + basis]);
+            }
+        }
+#ifdef _OPENMP
+#pragma omp critical
+#endif
+        {
+            for (ITYPE outcome = 0; outcome < outcome_count; ++outcome) {
+                distribution[outcome] += local_distribution[outcome];
+            }
+        }
+        free(local_distribution);
+    }
+#ifdef _OPENMP
+    OMPutil::get_inst().reset_qulacs_num_threads();
+#endif
+    free(sorted_target_qubit_index_list);
+    free(outcome_mask_list);
+}
+
 void dm_state_add(const CTYPE* state_added, CTYPE* state, ITYPE dim) {
     ITYPE index;
 #ifdef _OPENMP
@@ -190,6 +257,20 @@ double dm_expectation_value_multi_qubit_Pauli_operator_partial_list(
     return _creal(sum);
 }
 
+double dm_expectation_value_Pauli_operator_masks(ITYPE bit_flip_mask,
+    ITYPE phase_flip_mask, UINT global_phase_90rot_count, const CTYPE* state,
+    ITYPE dim) {
+    CTYPE sum = 0;
+    for (ITYPE state_index = 0; state_index < dim; ++state_index) {
+        CTYPE value = state[state_index * dim + (state_index ^ bit_flip_mask)];
+        if (count_population(state_index & phase_flip_mask) % 2) {
+            value *= -1.;
+        }
+        sum += value;
+    }
+    return _creal(sum * PHASE_90ROT[global_phase_90rot_count % 4]);
+}
+
 void dm_state_tensor_product(const CTYPE* state_left, ITYPE dim_left,
     const CTYPE* state_right, ITYPE dim_right, CTYPE* state_dst) {
     ITYPE y_left, x_left, y_right, x_right;
@@ -26,7 +26,40 @@ DllExport double dm_M1_prob(
 DllExport double dm_marginal_prob(const UINT* sorted_target_qubit_index_list,
     const UINT* measured_value_list, UINT target_qubit_index_count,
     const CTYPE* state, ITYPE dim);
+DllExport void dm_marginal_distribution(const UINT* target_qubit_index_list,
+    UINT target_qubit_index_count, double* distribution, const CTYPE* state,
+    ITYPE dim);
 
 DllExport double dm_expectation_value_multi_qubit_Pauli_operator_partial_list(
     const UINT* target_qubit_index_list, const UINT* Pauli_operator_type_list,
     UINT target_qubit_index_count, const CTYPE* state, ITYPE dim);
+// Expectation value of the Pauli operator given by the masks of
+// get_Pauli_masks_partial_list, i.e. the sum over i of
+// i^global_phase_90rot_count (-1)^|i & phase_flip_mask|
+// rho[i, i ^ bit_flip_mask].
+DllExport double dm_expectation_value_Pauli_operator_masks(ITYPE bit_flip_mask,
+    ITYPE phase_flip_mask, UINT global_phase_90rot_count, const CTYPE* state,
+    ITYPE dim);
+
+// The dm_packed_* functions take a Hermitian density matrix whose upper
+// triangle is packed row by row, and read only the upper triangle.
+DllExport double dm_packed_state_norm_squared(const CTYPE* state, ITYPE dim);
+DllExport double dm_packed_measurement_distribution_entropy(
+    const CTYPE* state, ITYPE dim);
+DllExport double dm_packed_M0_prob(
+    UINT target_qubit_index, const CTYPE* state, ITYPE dim);
+DllExport double dm_packed_marginal_prob(
+    const UINT* sorted_target_qubit_index_list,
+    const UINT* measured_value_list, UINT target_qubit_index_count,
+    const CTYPE* state, ITYPE dim);
+// The coefficients are real so that the matrices stay Hermitian.
+DllExport void dm_packed_state_add_with_coef(
+    double coef, const CTYPE* state_added, CTYPE* state, ITYPE dim);
+DllExport void dm_packed_state_multiply(double coef, CTYPE* state, ITYPE dim);
+DllExport double
+dm_packed_expectation_value_multi_qubit_Pauli_operator_partial_list(
+    const UINT* target_qubit_index_list, const UINT* Pauli_operator_type_list,
+    UINT target_qubit_index_count, const CTYPE* state, ITYPE dim);
+// state_dst is a packed matrix of dimension dim >> target_count.
+DllExport void dm_packed_state_partial_trace(const UINT* target,
+    UINT target_count, const CTYPE* state_src, CTYPE* state_dst, ITYPE dim);
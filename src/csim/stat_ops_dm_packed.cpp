@@ -0,0 +1,239 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "constant.hpp"
+#include "stat_ops_dm.hpp"
+#include "utility.hpp"
+
+// The functions in this file take a density matrix whose upper triangle is
+// packed row by row, see get_packed_hermitian_index. Only the diagonal or the
+// upper triangle is read.
+
+double dm_packed_state_norm_squared(const CTYPE* state, ITYPE dim) {
+    ITYPE index;
+    double norm = 0;
+#ifdef _OPENMP
+    OMPutil::get_inst().set_qulacs_num_threads(dim, 10);
+#pragma omp parallel for reduction(+ : norm)
+#endif
+    for (index = 0; index < dim; ++index) {
+        norm += _creal(state[get_packed_hermitian_index(index, index, dim)]);
+    }
+#ifdef _OPENMP
+    OMPutil::get_inst().reset_qulacs_num_threads();
+#endif
+    return norm;
+}
+
+double dm_packed_measurement_distribution_entropy(
+    const CTYPE* state, ITYPE dim) {
+    ITYPE index;
+    double ent = 0;
+    const double eps = 1e-15;
+#ifdef _OPENMP
+    OMPutil::get_inst().set_qulacs_num_threads(dim, 10);
+#pragma omp parallel for reduction(+ : ent)
+#endif
+    for (index = 0; index < dim; ++index) {
+        double prob =
+            _creal(state[get_packed_hermitian_index(index, index, dim)]);
+        if (prob > eps) {
+            ent += -1.0 * prob * log(prob);
+        }
+    }
+#ifdef _OPENMP
+    OMPutil::get_inst().reset_qulacs_num_threads();
+#endif
+    return ent;
+}
+
+double dm_packed_M0_prob(
+    UINT target_qubit_index, const CTYPE* state, ITYPE dim) {
+    const ITYPE loop_dim = dim / 2;
+    const ITYPE mask = 1ULL << target_qubit_index;
+    ITYPE state_index;
+    double sum = 0.;
+#ifdef _OPENMP
+    OMPutil::get_inst().set_qulacs_num_threads(dim, 10);
+#pragma omp parallel for reduction(+ : sum)
+#endif
+    for (state_index = 0; state_index < loop_dim; ++state_index) {
+        ITYPE basis_0 =
+            insert_zero_to_basis_index(state_index, mask, target_qubit_index);
+        sum += _creal(state[get_packed_hermitian_index(basis_0, basis_0, dim)]);
+    }
+#ifdef _OPENMP
+    OMPutil::get_inst().reset_qulacs_num_threads();
+#endif
+    return sum;
+}
+
+double dm_packed_marginal_prob(const UINT* sorted_target_qubit_index_list,
+    const UINT* measured_value_list, UINT target_qubit_index_count,
+    const CTYPE* state, ITYPE dim) {
+    ITYPE loop_dim = dim >> target_qubit_index_count;
+    ITYPE state_index;
+    double sum = 0.;
+#ifdef _OPENMP
+    OMPutil::get_inst().set_qulacs_num_threads(dim, 10);
+#pragma omp parallel for reduction(+ : sum)
+#endif
+    for (state_index = 0; state_index < loop_dim; ++state_index) {
+        ITYPE basis = state_index;
+        for (UINT cursor = 0; cursor < target_qubit_index_count; cursor++) {
+            UINT insert_index = sorted_target_qubit_index_list[cursor];
+            ITYPE mask = 1ULL << insert_index;
+            basis = insert_zero_to_basis_index(basis, mask, insert_index);
+            basis ^= mask * measured_value_list[cursor];
+        }
+        sum += _creal(state[get_packed_hermitian_index(basis, basis, dim)]);
+    }
+#ifdef _OPENMP
+    OMPutil::get_inst().reset_qulacs_num_threads();
+#endif
+    return sum;
+}
+
+void dm_packed_state_add_with_coef(
+    double coef, const CTYPE* state_added, CTYPE* state, ITYPE dim) {
+    const ITYPE packed_dim = dim * (dim + 1) / 2;
+    ITYPE index;
+#ifdef _OPENMP
+    OMPutil::get_inst().set_qulacs_num_threads(dim, 10);
+#pragma omp parallel for
+#endif
+    for (index = 0; index < packed_dim; ++index) {
+        state[index] += coef * state_added[index];
+    }
+#ifdef _OPENMP
+    OMPutil::get_inst().reset_qulacs_num_threads();
+#endif
+}
+
+void dm_packed_state_multiply(double coef, CTYPE* state, ITYPE dim) {
+    const ITYPE packed_dim = dim * (dim + 1) / 2;
+    ITYPE index;
+#ifdef _OPENMP
+    OMPutil::get_inst().set_qulacs_num_threads(dim, 10);
+#pragma omp parallel for
+#endif
+    for (index = 0; index < packed_dim; ++index) {
+        state[index] *= coef;
+    }
+#ifdef _OPENMP
+    OMPutil::get_inst().reset_qulacs_num_threads();
+#endif
+}
+
+double dm_packed_expectation_value_multi_qubit_Pauli_operator_partial_list(
+    const UINT* target_qubit_index_list, const UINT* Pauli_operator_type_list,
+    UINT target_qubit_index_count, const CTYPE* state, ITYPE dim) {
+    ITYPE bit_flip_mask = 0;
+    ITYPE phase_flip_mask = 0;
+    UINT global_phase_90rot_count = 0;
+    UINT pivot_qubit_index = 0;
+    get_Pauli_masks_partial_list(target_qubit_index_list,
+        Pauli_operator_type_list, target_qubit_index_count, &bit_flip_mask,
+        &phase_flip_mask, &global_phase_90rot_count, &pivot_qubit_index);
+    const CTYPE phase = PHASE_90ROT[global_phase_90rot_count % 4];
+
+    ITYPE state_index;
+    double sum = 0.;
+    if (bit_flip_mask == 0) {
+#ifdef _OPENMP
+        OMPutil::get_inst().set_qulacs_num_threads(dim, 10);
+#pragma omp parallel for reduction(+ : sum)
+#endif
+        for (state_index = 0; state_index < dim; ++state_index) {
+            double value = _creal(state[get_packed_hermitian_index(
+                state_index, state_index, dim)]);
+            if (count_population(state_index & phase_flip_mask) % 2) {
+                value *= -1.;
+            }
+            sum += value;
+        }
+#ifdef _OPENMP
+        OMPutil::get_inst().reset_qulacs_num_threads();
+#endif
+        return sum * _creal(phase);
+    }
+
+    // rho[i, j] and rho[j, i] for j = i ^ bit_flip_mask are taken from the
+    // same element, where i has 0 at the highest flipped qubit and is smaller
+    // than j
+    pivot_qubit_index = 0;
+    while (bit_flip_mask >> (pivot_qubit_index + 1)) ++pivot_qubit_index;
+    const ITYPE loop_dim = dim / 2;
+    const ITYPE pivot_mask = 1ULL << pivot_qubit_index;
+#ifdef _OPENMP
+    OMPutil::get_inst().set_qulacs_num_threads(dim, 10);
+#pragma omp parallel for reduction(+ : sum)
+#endif
+    for (state_index = 0; state_index < loop_dim; ++state_index) {
+        ITYPE basis_0 = insert_zero_to_basis_index(
+            state_index, pivot_mask, pivot_qubit_index);
+        ITYPE basis_1 = basis_0 ^ bit_flip_mask;
+        CTYPE value = state[get_packed_hermitian_index(basis_0, basis_1, dim)];
+        CTYPE value_0 = value;
+        CTYPE value_1 = conj(value);
+        if (count_population(basis_0 & phase_flip_mask) % 2) {
+            value_0 *= -1.;
+        }
+        if (count_population(basis_1 & phase_flip_mask) % 2) {
+            value_1 *= -1.;
+        }
+        sum += _creal(phase * (value_0 + value_1));
+    }
+#ifdef _OPENMP
+    OMPutil::get_inst().reset_qulacs_num_threads();
+#endif
+    return sum;
+}
+
+void dm_packed_state_partial_trace(const UINT* target, UINT target_count,
+    const CTYPE* state_src, CTYPE* state_dst, ITYPE dim) {
+    const ITYPE dst_dim = dim >> target_count;
+    const ITYPE trace_dim = 1ULL << target_count;
+    UINT* sorted_target = create_sorted_ui_list(target, target_count);
+    ITYPE* mask_list = create_matrix_mask_list(target, target_count);
+
+    // inserting the same bits keeps the order of indices, so the traced
+    // elements of the upper triangle are in the upper triangle
+    ITYPE y;
+#ifdef _OPENMP
+    OMPutil::get_inst().set_qulacs_num_threads(dim, 10);
+#pragma omp parallel for schedule(dynamic, 16)
+#endif
+    for (y = 0; y < dst_dim; ++y) {
+        ITYPE base_y = y;
+        for (UINT target_index = 0; target_index < target_count;
+             ++target_index) {
+            UINT insert_index = sorted_target[target_index];
+            base_y = insert_zero_to_basis_index(
+                base_y, 1ULL << insert_index, insert_index);
+        }
+        for (ITYPE x = y; x < dst_dim; ++x) {
+            ITYPE base_x = x;
+            for (UINT target_index = 0; target_index < target_count;
+                 ++target_index) {
+                UINT insert_index = sorted_target[target_index];
+                base_x = insert_zero_to_basis_index(
+                    base_x, 1ULL << insert_index, insert_index);
+            }
+            CTYPE val = 0.;
+            for (ITYPE idx = 0; idx < trace_dim; ++idx) {
+                ITYPE src_x = base_x ^ mask_list[idx];
+                ITYPE src_y = base_y ^ mask_list[idx];
+                val += state_src[get_packed_hermitian_index(src_y, src_x, dim)];
+            }
+            state_dst[get_packed_hermitian_index(y, x, dst_dim)] = val;
+        }
+    }
+#ifdef _OPENMP
+    OMPutil::get_inst().reset_qulacs_num_threads();
+#endif
+    free(sorted_target);
+    free(mask_list);
+}
@@ -554,6 +554,14 @@ double expectation_value_multi_qubit_Pauli_operator_partial_list(
     get_Pauli_masks_partial_list(target_qubit_index_list,
         Pauli_operator_type_list, target_qubit_index_count, &bit_flip_mask,
         &phase_flip_mask, &global_phase_90rot_count, &pivot_qubit_index);
+    return expectation_value_Pauli_operator_masks(bit_flip_mask,
+        phase_flip_mask, global_phase_90rot_count, pivot_qubit_index, state,
+        dim);
+}
+
+double expectation_value_Pauli_operator_masks(ITYPE bit_flip_mask,
+    ITYPE phase_flip_mask, UINT global_phase_90rot_count,
+    UINT pivot_qubit_index, const CTYPE* state, ITYPE dim) {
     double result;
 
 #ifdef _USE_SVE
@@ -822,6 +830,14 @@ double expectation_value_multi_qubit_Pauli_operator_partial_list_single_thread(
     get_Pauli_masks_partial_list(target_qubit_index_list,
         Pauli_operator_type_list, target_qubit_index_count, &bit_flip_mask,
         &phase_flip_mask, &global_phase_90rot_count, &pivot_qubit_index);
+    return expectation_value_Pauli_operator_masks_single_thread(bit_flip_mask,
+        phase_flip_mask, global_phase_90rot_count, pivot_qubit_index, state,
+        dim);
+}
+
+double expectation_value_Pauli_operator_masks_single_thread(ITYPE bit_flip_mask,
+    ITYPE phase_flip_mask, UINT global_phase_90rot_count,
+    UINT pivot_qubit_index, const CTYPE* state, ITYPE dim) {
     double result;
 
 #ifdef _USE_SVE
@@ -860,3 +876,96 @@ double expectation_value_multi_qubit_Pauli_operator_partial_list_single_thread(
     }
     return result;
 }
+
+// Calculate sum_t coef_list[t] <P_t> for Pauli terms P_t which share
+// bit_flip_mask. Each pair of amplitudes is loaded once for all the terms.
+// With v = state[basis_0] * conj(state[basis_1]), the term contributes
+// 2 Re(v i^g) (-1)^parity, and Re(v i^g) is Re(v), -Im(v), -Re(v), Im(v)
+// for g = 0, 1, 2, 3. When bit_flip_mask is zero, the terms are diagonal
+// and |state[basis]|^2 (-1)^parity is accumulated instead.
+// The loops are parallelized only when use_multi_thread is true.
+static CTYPE expectation_value_Pauli_operator_group_impl(
+    ITYPE bit_flip_mask, UINT pivot_qubit_index,
+    const ITYPE* phase_flip_mask_list,
+    const UINT* global_phase_90rot_count_list, const CTYPE* coef_list,
+    UINT term_count, const CTYPE* state, ITYPE dim, bool use_multi_thread) {
+    // coefficients with the sign and the factor 2 of the off-diagonal terms
+    double* weight_real = (double*)malloc(sizeof(double) * term_count);
+    double* weight_imag = (double*)malloc(sizeof(double) * term_count);
+    int* use_imag_list = (int*)malloc(sizeof(int) * term_count);
+    for (UINT term = 0; term < term_count; ++term) {
+        double weight = 1.;
+        use_imag_list[term] = 0;
+        if (bit_flip_mask != 0) {
+            const UINT rot = global_phase_90rot_count_list[term] % 4;
+            weight = (rot == 1 || rot == 2) ? -2. : 2.;
+            use_imag_list[term] = rot % 2;
+        }
+        weight_real[term] = _creal(coef_list[term]) * weight;
+        weight_imag[term] = _cimag(coef_list[term]) * weight;
+    }
+
+    const ITYPE loop_dim = (bit_flip_mask == 0) ? dim : dim / 2;
+    const ITYPE pivot_mask = 1ULL << pivot_qubit_index;
+    ITYPE state_index;
+    double sum_real = 0.;
+    double sum_imag = 0.;
+#ifdef _OPENMP
+    if (use_multi_thread) {
+        OMPutil::get_inst().set_qulacs_num_threads(dim, 10);
+    }
+#pragma omp parallel for reduction(+ : sum_real, sum_imag) if (use_multi_thread)
+#endif
+    for (state_index = 0; state_index < loop_dim; ++state_index) {
+        ITYPE basis_0 = state_index;
+        double value[2];
+        if (bit_flip_mask == 0) {
+            value[0] = _creal(state[basis_0]) * _creal(state[basis_0]) +
+                       _cimag(state[basis_0]) * _cimag(state[basis_0]);
+            value[1] = 0.;
+        } else {
+            basis_0 = insert_zero_to_basis_index(
+                state_index, pivot_mask, pivot_qubit_index);
+            const CTYPE product =
+                state[basis_0] * conj(state[basis_0 ^ bit_flip_mask]);
+            value[0] = _creal(product);
+            value[1] = _cimag(product);
+        }
+        for (UINT term = 0; term < term_count; ++term) {
+            double term_value = value[use_imag_list[term]];
+            if (count_population(basis_0 & phase_flip_mask_list[term]) % 2) {
+                term_value = -term_value;
+            }
+            sum_real += weight_real[term] * term_value;
+            sum_imag += weight_imag[term] * term_value;
+        }
+    }
+#ifdef _OPENMP
+    if (use_multi_thread) OMPutil::get_inst().reset_qulacs_num_threads();
+#endif
+    free(weight_real);
+    free(weight_imag);
+    free(use_imag_list);
+    return CTYPE(sum_real, sum_imag);
+}
+
+CTYPE expectation_value_Pauli_operator_group(ITYPE bit_flip_mask,
+    UINT pivot_qubit_index, const ITYPE* phase_flip_mask_list,
+    const UINT* global_phase_90rot_count_list, const CTYPE* coef_list,
+    UINT term_count, const CTYPE* state, ITYPE dim) {
+    return expectation_value_Pauli_operator_group_impl(bit_flip_mask,
+        pivot_qubit_index, phase_flip_mask_list,
+        global_phase_90rot_count_list, coef_list, term_count, state, dim,
+        true);
+}
+
+CTYPE expectation_value_Pauli_operator_group_single_thread(
+    ITYPE bit_flip_mask, UINT pivot_qubit_index,
+    const ITYPE* phase_flip_mask_list,
+    const UINT* global_phase_90rot_count_list, const CTYPE* coef_list,
+    UINT term_count, const CTYPE* state, ITYPE dim) {
+    return expectation_value_Pauli_operator_group_impl(bit_flip_mask,
+        pivot_qubit_index, phase_flip_mask_list,
+        global_phase_90rot_count_list, coef_list, term_count, state, dim,
+        false);
+}
@@ -50,6 +50,34 @@ double M1_prob(UINT target_qubit_index, const CTYPE* state, ITYPE dim) {
     return sum;
 }
 
+// insert zeros at the sorted target qubits into the index of the other qubits
+static inline ITYPE insert_zeros_to_basis_index(ITYPE basis,
+    const UINT* sorted_target_qubit_index_list, UINT target_qubit_index_count) {
+    for (UINT cursor = 0; cursor < target_qubit_index_count; cursor++) {
+        UINT insert_index = sorted_target_qubit_index_list[cursor];
+        ITYPE mask = 1ULL << insert_index;
+        basis = insert_zero_to_basis_index(basis, mask, insert_index);
+    }
+    return basis;
+}
+
+// add the marginal distribution of the basis states from begin_index to
+// end_index (as indices of the other qubits) to distribution
+static void add_marginal_distribution_block(
+    const UINT* sorted_target_qubit_index_list, UINT target_qubit_index_count,
+    const ITYPE* outcome_mask_list, ITYPE outcome_count, double* distribution,
+    const CTYPE* state, ITYPE begin_index, ITYPE end_index) {
+    for (ITYPE state_index = begin_index; state_index < end_index;
+         ++state_index) {
+        const ITYPE basis_0 = insert_zeros_to_basis_index(state_index,
+            sorted_target_qubit_index_list, target_qubit_index_count);
+        for (ITYPE outcome = 0; outcome < outcome_count; ++outcome) {
+            ITYPE basis = basis_0 ^ outcome_mask_list[outcome];
+            distribution[outcome] += pow(_cabs(state[basis]), 2);
+        }
+    }
+}
+
 // calculate merginal probability with which we obtain the set of values
 // measured_value_list at sorted_target_qubit_index_list warning:
 // sorted_target_qubit_index_list must be sorted.
@@ -57,6 +85,11 @@ double marginal_prob(const UINT* sorted_target_qubit_index_list,
     const UINT* measured_value_list, UINT target_qubit_index_count,
     const CTYPE* state, ITYPE dim) {
     ITYPE loop_dim = dim >> target_qubit_index_count;
+    ITYPE measured_mask = 0;
+    for (UINT cursor = 0; cursor < target_qubit_index_count; cursor++) {
+        measured_mask ^= (1ULL << sorted_target_qubit_index_list[cursor]) *
+                         measured_value_list[cursor];
+    }
     ITYPE state_index;
     double sum = 0.;
 #ifdef _OPENMP
@@ -64,13 +97,10 @@ double marginal_prob(const UINT* sorted_target_qubit_index_list,
 #pragma omp parallel for reduction(+ : sum)
 #endif
     for (state_index = 0; state_index < loop_dim; ++state_index) {
-        ITYPE basis = state_index;
-        for (UINT cursor = 0; cursor < target_qubit_index_count; cursor++) {
-            UINT insert_index = sorted_target_qubit_index_list[cursor];
-            ITYPE mask = 1ULL << insert_index;
-            basis = insert_zero_to_basis_index(basis, mask, insert_index);
-            basis ^= mask * measured_value_list[cursor];
-        }
+        ITYPE basis = insert_zeros_to_basis_index(state_index,
+                          sorted_target_qubit_index_list,
+                          target_qubit_index_count) ^
+                      measured_mask;
         sum += pow(_cabs(state[basis]), 2);
     }
 #ifdef _OPENMP
@@ -79,6 +109,67 @@ double marginal_prob(const UINT* sorted_target_qubit_index_list,
     return sum;
 }
 
+// calculate the marginal probability distribution of the target qubits in a
+// single sweep. The j-th bit of the index of distribution corresponds to
+// target_qubit_index_list[j], which need not be sorted.
+void marginal_distribution(const UINT* target_qubit_index_list,
+    UINT target_qubit_index_count, double* distribution, const CTYPE* state,
+    ITYPE dim) {
+    const ITYPE outcome_count = 1ULL << target_qubit_index_count;
+    const ITYPE loop_dim = dim >> target_qubit_index_count;
+    UINT* sorted_target_qubit_index_list = create_sorted_ui_list(
+        target_qubit_index_list, target_qubit_index_count);
+    ITYPE* outcome_mask_list =
+        (ITYPE*)malloc((size_t)(sizeof(ITYPE) * outcome_count));
+    for (ITYPE outcome = 0; outcome < outcome_count; ++outcome) {
+        ITYPE mask = 0;
+        for (UINT cursor = 0; cursor < target_qubit_index_count; ++cursor) {
+            if ((outcome >> cursor) & 1) {
+                mask |= 1ULL << target_qubit_index_list[cursor];
+            }
+        }
+        outcome_mask_list[outcome] = mask;
+        distribution[outcome] = 0.;
+    }
+
+#ifdef _OPENMP
+    OMPutil::get_inst().set_qulacs_num_threads(dim, 10);
+    const UINT max_thread_count = omp_get_max_threads();
+    // each thread accumulates its own table over a contiguous block, and the
+    // tables are summed in the order of the threads so that the result does
+    // not depend on the scheduling
+    double* local_distribution_list = (double*)calloc(
+        (size_t)(max_thread_count * outcome_count), sizeof(double));
+    UINT used_thread_count = 1;
+#pragma omp parallel
+    {
+        const UINT thread_count = omp_get_num_threads();
+        const UINT thread_id = omp_get_thread_num();
+        if (thread_id == 0) used_thread_count = thread_count;
+        add_marginal_distribution_block(sorted_target_qubit_index_list,
+            target_qubit_index_count, outcome_mask_list, outcome_count,
+            local_distribution_list + thread_id * outcome_count, state,
+            loop_dim * thread_id / thread_count,
+            loop_dim * (thread_id + 1) / thread_count);
+    }
+    for (UINT thread_id = 0; thread_id < used_thread_count; ++thread_id) {
+        const double* local_distribution =
+            local_distribution_list + thread_id * outcome_count;
+        for (ITYPE outcome = 0; outcome < outcome_count; ++outcome) {
+            distribution[outcome] += local_distribution[outcome];
+        }
+    }
+    free(local_distribution_list);
+    OMPutil::get_inst().reset_qulacs_num_threads();
+#else
+    add_marginal_distribution_block(sorted_target_qubit_index_list,
+        target_qubit_index_count, outcome_mask_list, outcome_count,
+        distribution, state, 0, loop_dim);
+#endif
+    free(sorted_target_qubit_index_list);
+    free(outcome_mask_list);
+}
+
 // calculate entropy of probability distribution of Z-basis measurements
 double measurement_distribution_entropy(const CTYPE* state, ITYPE dim) {
     ITYPE index;
@@ -98,3 +189,81 @@ double measurement_distribution_entropy(const CTYPE* state, ITYPE dim) {
 #endif
     return ent;
 }
+
+double Kraus_operator_probabilities(const UINT* target_qubit_index_list,
+    UINT target_qubit_index_count, const CTYPE* matrix_list, UINT matrix_count,
+    double* probability_list, const CTYPE* state, ITYPE dim) {
+    const ITYPE matrix_dim = 1ULL << target_qubit_index_count;
+    const ITYPE matrix_size = matrix_dim * matrix_dim;
+    const ITYPE loop_dim = dim >> target_qubit_index_count;
+    UINT* sorted_target_qubit_index_list = create_sorted_ui_list(
+        target_qubit_index_list, target_qubit_index_count);
+    ITYPE* matrix_mask_list = create_matrix_mask_list(
+        target_qubit_index_list, target_qubit_index_count);
+    for (UINT matrix_index = 0; matrix_index < matrix_count; ++matrix_index) {
+        probability_list[matrix_index] = 0.;
+    }
+    double norm = 0.;
+
+#ifdef _OPENMP
+    OMPutil::get_inst().set_qulacs_num_threads(dim, 10);
+#pragma omp parallel
+#endif
+    {
+        double* local_probability_list =
+            (double*)calloc((size_t)matrix_count, sizeof(double));
+        CTYPE* buffer = (CTYPE*)malloc((size_t)(sizeof(CTYPE) * matrix_dim));
+        double local_norm = 0.;
+        ITYPE state_index;
+#ifdef _OPENMP
+#pragma omp for
+#endif
+        for (state_index = 0; state_index < loop_dim; ++state_index) {
+            ITYPE basis_0 = state_index;
+            for (UINT cursor = 0; cursor < target_qubit_index_count;
+                 cursor++) {
+                UINT insert_index = sorted_target_qubit_index_list[cursor];
+                ITYPE mask = 1ULL << insert_index;
+                basis_0 =
+                    insert_zero_to_basis_index(basis_0, mask, insert_index);
+            }
+            // the sub-block is read once and shared by all the operators
+            for (ITYPE x = 0; x < matrix_dim; ++x) {
+                buffer[x] = state[basis_0 ^ matrix_mask_list[x]];
+                local_norm += pow(_cabs(buffer[x]), 2);
+            }
+            for (UINT matrix_index = 0; matrix_index < matrix_count;
+                 ++matrix_index) {
+                const CTYPE* matrix = matrix_list + matrix_index * matrix_size;
+                double sum = 0.;
+                for (ITYPE y = 0; y < matrix_dim; ++y) {
+                    CTYPE value = 0.;
+                    for (ITYPE x = 0; x < matrix_dim; ++x) {
+                        value += matrix[y * matrix_dim + x] * buffer[x];
+                    }
+                    sum += pow(_cabs(value), 2);
+                }
+                local_probability_list[matrix_index] += sum;
+            }
+        }
+#ifdef _OPENMP
+#pragma omp critical
+#endif
+        {
+            for (UINT matrix_index = 0; matrix_index < matrix_count;
+                 ++matrix_index) {
+                probability_list[matrix_index] +=
+                    local_probability_list[matrix_index];
+            }
+            norm += local_norm;
+        }
+        free(local_probability_list);
+        free(buffer);
+    }
+#ifdef _OPENMP
+    OMPutil::get_inst().reset_qulacs_num_threads();
+#endif
+    free(sorted_target_qubit_index_list);
+    free(matrix_mask_list);
+    return norm;
+}
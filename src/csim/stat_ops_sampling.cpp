@@ -0,0 +1,176 @@
+#include <stdlib.h>
+
+#include "stat_ops.hpp"
+#include "stat_ops_template.hpp"
+#include "utility.hpp"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+template <typename T>
+static inline double squared_abs(const std::complex<T>& value) {
+    const double real = (double)value.real();
+    const double imag = (double)value.imag();
+    return real * real + imag * imag;
+}
+
+// the first index k such that sorted_random_list[k] * scale >= value
+static UINT lower_bound_scaled(const double* sorted_random_list,
+    UINT sampling_count, double scale, double value) {
+    UINT begin = 0, end = sampling_count;
+    while (begin < end) {
+        const UINT middle = begin + (end - begin) / 2;
+        if (sorted_random_list[middle] * scale < value) {
+            begin = middle + 1;
+        } else {
+            end = middle;
+        }
+    }
+    return begin;
+}
+
+template <typename T>
+static double block_norm_squared(
+    const std::complex<T>* state, ITYPE begin_index, ITYPE end_index) {
+    double sum = 0.;
+    for (ITYPE index = begin_index; index < end_index; ++index) {
+        sum += squared_abs(state[index]);
+    }
+    return sum;
+}
+
+// Assign the basis indices in [begin_index, end_index) to the random numbers
+// in [begin_count, end_count), where offset is the probability accumulated
+// before begin_index.
+template <typename T>
+static void sampling_sweep_block(const double* sorted_random_list,
+    UINT begin_count, UINT end_count, double scale, double offset,
+    ITYPE* result, const std::complex<T>* state, ITYPE begin_index,
+    ITYPE end_index) {
+    if (begin_count >= end_count) return;
+    double cumulative = offset;
+    ITYPE last_index = (end_index > begin_index) ? end_index - 1 : 0;
+    UINT count = begin_count;
+    for (ITYPE index = begin_index; index < end_index; ++index) {
+        const double prob = squared_abs(state[index]);
+        if (prob <= 0.) continue;
+        cumulative += prob;
+        last_index = index;
+        while (count < end_count &&
+               sorted_random_list[count] * scale < cumulative) {
+            result[count++] = index;
+        }
+        if (count == end_count) return;
+    }
+    // random numbers left by the rounding error of the accumulation
+    for (; count < end_count; ++count) result[count] = last_index;
+}
+
+template <typename T>
+void state_sampling_sorted(const double* sorted_random_list,
+    UINT sampling_count, ITYPE* result, const std::complex<T>* state,
+    ITYPE dim) {
+#ifdef _OPENMP
+    OMPutil::get_inst().set_qulacs_num_threads(dim, 13);
+    const UINT max_thread_count = omp_get_max_threads();
+    // probability accumulated before each block
+    double* offset_list =
+        (double*)malloc(sizeof(double) * (max_thread_count + 1));
+#pragma omp parallel
+    {
+        const UINT thread_count = omp_get_num_threads();
+        const UINT thread_id = omp_get_thread_num();
+        const ITYPE begin_index = dim * thread_id / thread_count;
+        const ITYPE end_index = dim * (thread_id + 1) / thread_count;
+        offset_list[thread_id + 1] =
+            block_norm_squared(state, begin_index, end_index);
+#pragma omp barrier
+#pragma omp single
+        {
+            offset_list[0] = 0.;
+            for (UINT i = 0; i < thread_count; ++i) {
+                offset_list[i + 1] += offset_list[i];
+            }
+        }
+        const double scale = offset_list[thread_count];
+        const UINT begin_count =
+            (thread_id == 0) ? 0
+                             : lower_bound_scaled(sorted_random_list,
+                                   sampling_count, scale,
+                                   offset_list[thread_id]);
+        const UINT end_count = (thread_id + 1 == thread_count)
+                                   ? sampling_count
+                                   : lower_bound_scaled(sorted_random_list,
+                                         sampling_count, scale,
+                                         offset_list[thread_id + 1]);
+        sampling_sweep_block(sorted_random_list, begin_count, end_count,
+            scale, offset_list[thread_id], result, state, begin_index,
+            end_index);
+    }
+    free(offset_list);
+    OMPutil::get_inst().reset_qulacs_num_threads();
+#else
+    const double scale = block_norm_squared(state, 0, dim);
+    sampling_sweep_block(sorted_random_list, 0, sampling_count, scale, 0.,
+        result, state, 0, dim);
+#endif
+}
+
+void state_sampling_sorted(const double* sorted_random_list,
+    UINT sampling_count, ITYPE* result, const CTYPE* state, ITYPE dim) {
+    state_sampling_sorted<double>(
+        sorted_random_list, sampling_count, result, state, dim);
+}
+
+template DllExport void state_sampling_sorted<float>(
+    const double* sorted_random_list, UINT sampling_count, ITYPE* result,
+    const std::complex<float>* state, ITYPE dim);
+
+void state_sampling_alias_table(
+    double* threshold_list, ITYPE* alias_list, const CTYPE* state, ITYPE dim) {
+    const double scale = (double)dim / state_norm_squared(state, dim);
+    ITYPE index;
+#ifdef _OPENMP
+    OMPutil::get_inst().set_qulacs_num_threads(dim, 13);
+#pragma omp parallel for
+#endif
+    for (index = 0; index < dim; ++index) {
+        threshold_list[index] = squared_abs(state[index]) * scale;
+        alias_list[index] = index;
+    }
+#ifdef _OPENMP
+    OMPutil::get_inst().reset_qulacs_num_threads();
+#endif
+
+    // Pair each entry below 1 with an entry above 1 without auxiliary
+    // stacks. Two cursors scan for the next small and large entries. A large
+    // entry which becomes small behind the small cursor is paired at once.
+    ITYPE small_index = 0, large_index = 0;
+    while (small_index < dim && threshold_list[small_index] >= 1.) {
+        ++small_index;
+    }
+    while (large_index < dim && threshold_list[large_index] < 1.) {
+        ++large_index;
+    }
+    ITYPE current = small_index;
+    while (current < dim && large_index < dim) {
+        alias_list[current] = large_index;
+        threshold_list[large_index] -= 1. - threshold_list[current];
+        if (threshold_list[large_index] < 1.) {
+            const ITYPE become_small = large_index;
+            ++large_index;
+            while (large_index < dim && threshold_list[large_index] < 1.) {
+                ++large_index;
+            }
+            if (become_small < small_index) {
+                current = become_small;
+                continue;
+            }
+        }
+        ++small_index;
+        while (small_index < dim && threshold_list[small_index] >= 1.) {
+            ++small_index;
+        }
+        current = small_index;
+    }
+}
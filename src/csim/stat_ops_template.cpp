@@ -0,0 +1,230 @@
+#include "stat_ops_template.hpp"
+
+#include <math.h>
+#include <stdlib.h>
+
+#include "constant.hpp"
+#include "utility.hpp"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+template <typename T>
+static inline double squared_abs(const std::complex<T>& val) {
+    double real = (double)val.real();
+    double imag = (double)val.imag();
+    return real * real + imag * imag;
+}
+
+template <typename T>
+double state_norm_squared(const std::complex<T>* state, ITYPE dim) {
+    ITYPE index;
+    double norm = 0;
+#ifdef _OPENMP
+    OMPutil::get_inst().set_qulacs_num_threads(dim, 10);
+#pragma omp parallel for reduction(+ : norm)
+#endif
+    for (index = 0; index < dim; ++index) {
+        norm += squared_abs(state[index]);
+    }
+#ifdef _OPENMP
+    OMPutil::get_inst().reset_qulacs_num_threads();
+#endif
+    return norm;
+}
+
+template <typename T>
+double measurement_distribution_entropy(
+    const std::complex<T>* state, ITYPE dim) {
+    ITYPE index;
+    double ent = 0;
+    const double eps = 1e-15;
+#ifdef _OPENMP
+    OMPutil::get_inst().set_qulacs_num_threads(dim, 10);
+#pragma omp parallel for reduction(+ : ent)
+#endif
+    for (index = 0; index < dim; ++index) {
+        double prob = squared_abs(state[index]);
+        prob = (prob > eps) ? prob : eps;
+        ent += -1.0 * prob * log(prob);
+    }
+#ifdef _OPENMP
+    OMPutil::get_inst().reset_qulacs_num_threads();
+#endif
+    return ent;
+}
+
+template <typename T>
+CTYPE state_inner_product(const std::complex<T>* state_bra,
+    const std::complex<T>* state_ket, ITYPE dim) {
+    double real_sum = 0.;
+    double imag_sum = 0.;
+    ITYPE index;
+#ifdef _OPENMP
+    OMPutil::get_inst().set_qulacs_num_threads(dim, 10);
+#pragma omp parallel for reduction(+ : real_sum, imag_sum)
+#endif
+    for (index = 0; index < dim; ++index) {
+        CTYPE bra((double)state_bra[index].real(),
+            (double)state_bra[index].imag());
+        CTYPE ket((double)state_ket[index].real(),
+            (double)state_ket[index].imag());
+        CTYPE value = conj(bra) * ket;
+        real_sum += _creal(value);
+        imag_sum += _cimag(value);
+    }
+#ifdef _OPENMP
+    OMPutil::get_inst().reset_qulacs_num_threads();
+#endif
+    return CTYPE(real_sum, imag_sum);
+}
+
+template <typename T>
+double M0_prob(
+    UINT target_qubit_index, const std::complex<T>* state, ITYPE dim) {
+    const ITYPE loop_dim = dim / 2;
+    const ITYPE mask = 1ULL << target_qubit_index;
+    ITYPE state_index;
+    double sum = 0.;
+#ifdef _OPENMP
+    OMPutil::get_inst().set_qulacs_num_threads(dim, 10);
+#pragma omp parallel for reduction(+ : sum)
+#endif
+    for (state_index = 0; state_index < loop_dim; ++state_index) {
+        ITYPE basis_0 =
+            insert_zero_to_basis_index(state_index, mask, target_qubit_index);
+        sum += squared_abs(state[basis_0]);
+    }
+#ifdef _OPENMP
+    OMPutil::get_inst().reset_qulacs_num_threads();
+#endif
+    return sum;
+}
+
+template <typename T>
+double marginal_prob(const UINT* sorted_target_qubit_index_list,
+    const UINT* measured_value_list, UINT target_qubit_index_count,
+    const std::complex<T>* state, ITYPE dim) {
+    ITYPE loop_dim = dim >> target_qubit_index_count;
+    ITYPE state_index;
+    double sum = 0.;
+#ifdef _OPENMP
+    OMPutil::get_inst().set_qulacs_num_threads(dim, 10);
+#pragma omp parallel for reduction(+ : sum)
+#endif
+    for (state_index = 0; state_index < loop_dim; ++state_index) {
+        ITYPE basis = state_index;
+        for (UINT cursor = 0; cursor < target_qubit_index_count; cursor++) {
+            UINT insert_index = sorted_target_qubit_index_list[cursor];
+            ITYPE mask = 1ULL << insert_index;
+            basis = insert_zero_to_basis_index(basis, mask, insert_index);
+            basis ^= mask * measured_value_list[cursor];
+        }
+        sum += squared_abs(state[basis]);
+    }
+#ifdef _OPENMP
+    OMPutil::get_inst().reset_qulacs_num_threads();
+#endif
+    return sum;
+}
+
+// The loops are parallelized only when use_multi_thread is true, so that the
+// single-thread version can be called inside parallel regions.
+template <typename T>
+static double expectation_value_multi_qubit_Pauli_operator_partial_list_impl(
+    const UINT* target_qubit_index_list, const UINT* Pauli_operator_type_list,
+    UINT target_qubit_index_count, const std::complex<T>* state, ITYPE dim,
+    bool use_multi_thread) {
+    ITYPE bit_flip_mask = 0;
+    ITYPE phase_flip_mask = 0;
+    UINT global_phase_90rot_count = 0;
+    UINT pivot_qubit_index = 0;
+    get_Pauli_masks_partial_list(target_qubit_index_list,
+        Pauli_operator_type_list, target_qubit_index_count, &bit_flip_mask,
+        &phase_flip_mask, &global_phase_90rot_count, &pivot_qubit_index);
+
+    ITYPE state_index;
+    double sum = 0.;
+    if (bit_flip_mask == 0) {
+#ifdef _OPENMP
+        if (use_multi_thread) {
+            OMPutil::get_inst().set_qulacs_num_threads(dim, 10);
+        }
+#pragma omp parallel for reduction(+ : sum) if (use_multi_thread)
+#endif
+        for (state_index = 0; state_index < dim; ++state_index) {
+            int bit_parity =
+                count_population(state_index & phase_flip_mask) % 2;
+            int sign = 1 - 2 * bit_parity;
+            sum += squared_abs(state[state_index]) * sign;
+        }
+    } else {
+        const ITYPE loop_dim = dim / 2;
+        const ITYPE pivot_mask = 1ULL << pivot_qubit_index;
+#ifdef _OPENMP
+        if (use_multi_thread) {
+            OMPutil::get_inst().set_qulacs_num_threads(dim, 10);
+        }
+#pragma omp parallel for reduction(+ : sum) if (use_multi_thread)
+#endif
+        for (state_index = 0; state_index < loop_dim; ++state_index) {
+            ITYPE basis_0 = insert_zero_to_basis_index(
+                state_index, pivot_mask, pivot_qubit_index);
+            ITYPE basis_1 = basis_0 ^ bit_flip_mask;
+            UINT sign_0 = count_population(basis_0 & phase_flip_mask) % 2;
+            CTYPE cval_0((double)state[basis_0].real(),
+                (double)state[basis_0].imag());
+            CTYPE cval_1((double)state[basis_1].real(),
+                (double)state[basis_1].imag());
+            CTYPE phase =
+                PHASE_90ROT[(global_phase_90rot_count + sign_0 * 2) % 4];
+            sum += _creal(cval_0 * conj(cval_1) * phase * 2.0);
+        }
+    }
+#ifdef _OPENMP
+    if (use_multi_thread) OMPutil::get_inst().reset_qulacs_num_threads();
+#endif
+    return sum;
+}
+
+template <typename T>
+double expectation_value_multi_qubit_Pauli_operator_partial_list(
+    const UINT* target_qubit_index_list, const UINT* Pauli_operator_type_list,
+    UINT target_qubit_index_count, const std::complex<T>* state, ITYPE dim) {
+    return expectation_value_multi_qubit_Pauli_operator_partial_list_impl(
+        target_qubit_index_list, Pauli_operator_type_list,
+        target_qubit_index_count, state, dim, true);
+}
+
+template <typename T>
+double expectation_value_multi_qubit_Pauli_operator_partial_list_single_thread(
+    const UINT* target_qubit_index_list, const UINT* Pauli_operator_type_list,
+    UINT target_qubit_index_count, const std::complex<T>* state, ITYPE dim) {
+    return expectation_value_multi_qubit_Pauli_operator_partial_list_impl(
+        target_qubit_index_list, Pauli_operator_type_list,
+        target_qubit_index_count, state, dim, false);
+}
+
+template DllExport double state_norm_squared<float>(
+    const std::complex<float>* state, ITYPE dim);
+template DllExport double measurement_distribution_entropy<float>(
+    const std::complex<float>* state, ITYPE dim);
+template DllExport CTYPE state_inner_product<float>(
+    const std::complex<float>* state_bra,
+    const std::complex<float>* state_ket, ITYPE dim);
+template DllExport double M0_prob<float>(
+    UINT target_qubit_index, const std::complex<float>* state, ITYPE dim);
+template DllExport double marginal_prob<float>(
+    const UINT* sorted_target_qubit_index_list,
+    const UINT* measured_value_list, UINT target_qubit_index_count,
+    const std::complex<float>* state, ITYPE dim);
+template DllExport double
+expectation_value_multi_qubit_Pauli_operator_partial_list<float>(
+    const UINT* target_qubit_index_list, const UINT* Pauli_operator_type_list,
+    UINT target_qubit_index_count, const std::complex<float>* state,
+    ITYPE dim);
+template DllExport double
+expectation_value_multi_qubit_Pauli_operator_partial_list_single_thread<float>(
+    const UINT* target_qubit_index_list, const UINT* Pauli_operator_type_list,
+    UINT target_qubit_index_count, const std::complex<float>* state,
+    ITYPE dim);
@@ -0,0 +1,98 @@
+/**
+ * @file stat_ops_template.hpp
+ * @brief Statistics of state vectors with an arbitrary floating-point precision
+ *
+ * The functions have the same semantics as the double-precision functions of
+ * the same names in stat_ops.hpp. Results are accumulated in double precision.
+ * Only T = float is instantiated.
+ */
+
+#pragma once
+
+#include "type.hpp"
+
+/**
+ * \~english
+ * Compute the squared norm, the entropy of the measurement distribution, and
+ * the inner product <bra|ket>.
+ *
+ * \~japanese-en
+ * ノルムの二乗、測定確率分布のエントロピー、内積 <bra|ket> を計算する。
+ */
+template <typename T>
+DllExport double state_norm_squared(const std::complex<T>* state, ITYPE dim);
+template <typename T>
+DllExport double measurement_distribution_entropy(
+    const std::complex<T>* state, ITYPE dim);
+template <typename T>
+DllExport CTYPE state_inner_product(const std::complex<T>* state_bra,
+    const std::complex<T>* state_ket, ITYPE dim);
+
+/**
+ * \~english
+ * Compute the probability of measurement outcomes.
+ *
+ * See M0_prob and marginal_prob in stat_ops.hpp for the parameters.
+ *
+ * \~japanese-en
+ * 測定結果の確率を計算する。
+ *
+ * 引数は stat_ops.hpp の M0_prob および marginal_prob と同じ。
+ */
+template <typename T>
+DllExport double M0_prob(
+    UINT target_qubit_index, const std::complex<T>* state, ITYPE dim);
+template <typename T>
+DllExport double marginal_prob(const UINT* sorted_target_qubit_index_list,
+    const UINT* measured_value_list, UINT target_qubit_index_count,
+    const std::complex<T>* state, ITYPE dim);
+
+/**
+ * \~english
+ * Compute the expectation value of a multi-qubit Pauli operator.
+ *
+ * See expectation_value_multi_qubit_Pauli_operator_partial_list in
+ * stat_ops.hpp for the parameters.
+ *
+ * \~japanese-en
+ * 複数量子ビットのパウリ演算子の期待値を計算する。
+ *
+ * 引数は stat_ops.hpp の
+ * expectation_value_multi_qubit_Pauli_operator_partial_list と同じ。
+ */
+template <typename T>
+DllExport double expectation_value_multi_qubit_Pauli_operator_partial_list(
+    const UINT* target_qubit_index_list, const UINT* Pauli_operator_type_list,
+    UINT target_qubit_index_count, const std::complex<T>* state, ITYPE dim);
+
+/**
+ * \~english
+ * Single-thread version of
+ * expectation_value_multi_qubit_Pauli_operator_partial_list, which can be
+ * called inside parallel regions.
+ *
+ * \~japanese-en
+ * expectation_value_multi_qubit_Pauli_operator_partial_list
+ * のシングルスレッド版。並列領域の内部から呼び出せる。
+ */
+template <typename T>
+DllExport double
+expectation_value_multi_qubit_Pauli_operator_partial_list_single_thread(
+    const UINT* target_qubit_index_list, const UINT* Pauli_operator_type_list,
+    UINT target_qubit_index_count, const std::complex<T>* state, ITYPE dim);
+
+/**
+ * \~english
+ * Sample basis indices for sorted uniform random numbers.
+ *
+ * See state_sampling_sorted in stat_ops.hpp for the parameters.
+ *
+ * \~japanese-en
+ * 整列した一様乱数に対して計算基底をサンプリングする。
+ *
+ * 引数は stat_ops.hpp の state_sampling_sorted と同じ。
+ */
+template <typename T>
+DllExport void state_sampling_sorted(const double* sorted_random_list,
+    UINT sampling_count, ITYPE* result, const std::complex<T>* state,
+    ITYPE dim);
@@ -92,6 +92,16 @@ transition_amplitude_multi_qubit_Pauli_operator_partial_list(
     get_Pauli_masks_partial_list(target_qubit_index_list,
         Pauli_operator_type_list, target_qubit_index_count, &bit_flip_mask,
         &phase_flip_mask, &global_phase_90rot_count, &pivot_qubit_index);
+    return transition_amplitude_Pauli_operator_masks(bit_flip_mask,
+        phase_flip_mask, global_phase_90rot_count, pivot_qubit_index,
+        state_bra, state_ket, dim);
+}
+
+CTYPE
+transition_amplitude_Pauli_operator_masks(ITYPE bit_flip_mask,
+    ITYPE phase_flip_mask, UINT global_phase_90rot_count,
+    UINT pivot_qubit_index, const CTYPE* state_bra, const CTYPE* state_ket,
+    ITYPE dim) {
     CTYPE result;
     if (bit_flip_mask == 0) {
         result = transition_amplitude_multi_qubit_Pauli_operator_Z_mask(
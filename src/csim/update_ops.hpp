@@ -380,6 +380,33 @@ void SWAP_gate_parallel_simd(UINT target_qubit_index_0,
 void SWAP_gate_parallel_sve(UINT target_qubit_index_0,
     UINT target_qubit_index_1, CTYPE* state, ITYPE dim);
 
+/**
+ * \~english
+ * Apply several SWAP gates on disjoint pairs of qubits in a single sweep.
+ *
+ * The i-th qubit of target_qubit_index_list_0 is exchanged with the i-th qubit
+ * of target_qubit_index_list_1. All the qubits must be distinct.
+ * @param[in] target_qubit_index_list_0 list of the first qubits of pairs
+ * @param[in] target_qubit_index_list_1 list of the second qubits of pairs
+ * @param[in] pair_count the number of pairs
+ * @param[in,out] state quantum state
+ * @param[in] dim dimension
+ *
+ * \~japanese-en
+ * 互いに素な量子ビットの組に対する複数のSWAP演算を一度の走査で作用させる。
+ *
+ * target_qubit_index_list_0 の i 番目の量子ビットと target_qubit_index_list_1
+ * の i 番目の量子ビットを入れ替える。全ての量子ビットは相異なる必要がある。
+ * @param[in] target_qubit_index_list_0 組の一方の量子ビットのリスト
+ * @param[in] target_qubit_index_list_1 組のもう一方の量子ビットのリスト
+ * @param[in] pair_count 組の数
+ * @param[in,out] state 量子状態
+ * @param[in] dim 次元
+ */
+DllExport void multi_SWAP_gate(const UINT* target_qubit_index_list_0,
+    const UINT* target_qubit_index_list_1, UINT pair_count, CTYPE* state,
+    ITYPE dim);
+
 /**
  * \~english
  * Project the quantum state to the 0 state.
@@ -1334,6 +1361,57 @@ DllExport void multi_qubit_control_multi_qubit_dense_matrix_gate(
     UINT target_qubit_index_count, const CTYPE* matrix, CTYPE* state,
     ITYPE dim);
 
+/**
+ * \~english
+ * Apply a sequence of dense matrix gates block by block.
+ *
+ * All the target and control qubits of the given gates must be smaller than
+ * block_qubit_count. The state is split into blocks of 2^block_qubit_count
+ * amplitudes, and every gate is applied to a block before moving to the next
+ * one, so that each block is loaded from memory only once. Blocks are
+ * distributed among threads in a single parallel region.
+ * The lists of each gate are concatenated in gate order.
+ *
+ * @param[in] gate_count the number of gates
+ * @param[in] control_qubit_index_count_list the number of control qubits of
+ * each gate
+ * @param[in] control_qubit_index_list concatenated list of control qubits
+ * @param[in] control_value_list concatenated list of control values
+ * @param[in] target_qubit_index_count_list the number of target qubits of each
+ * gate
+ * @param[in] target_qubit_index_list concatenated list of target qubits
+ * @param[in] matrix_list concatenated gate matrices as one-dimensional arrays
+ * @param[in] block_qubit_count the number of qubits in a block
+ * @param[in,out] state quantum state
+ * @param[in] dim dimension
+ *
+ *
+ * \~japanese-en
+ * 複数の密行列ゲートをブロック単位で作用させて状態を更新。
+ *
+ * 全てのゲートのターゲット量子ビットと制御量子ビットは block_qubit_count
+ * 未満である必要がある。状態を 2^block_qubit_count
+ * 要素のブロックに分割し、各ブロックに全てのゲートを作用させてから次のブロックに移るため、
+ * 各ブロックはメモリから一度だけ読み込まれる。各ゲートのリストはゲート順に連結して与える。
+ *
+ * @param[in] gate_count ゲートの数
+ * @param[in] control_qubit_index_count_list 各ゲートの制御量子ビットの数
+ * @param[in] control_qubit_index_list 連結された制御量子ビットのリスト
+ * @param[in] control_value_list 連結された制御量子ビットの値のリスト
+ * @param[in] target_qubit_index_count_list 各ゲートのターゲット量子ビットの数
+ * @param[in] target_qubit_index_list 連結されたターゲット量子ビットのリスト
+ * @param[in] matrix_list 連結されたゲート行列の一次元配列
+ * @param[in] block_qubit_count ブロックの量子ビット数
+ * @param[in,out] state 量子状態
+ * @param[in] dim 次元
+ */
+DllExport void multi_gate_blocked_dense_matrix_gate(UINT gate_count,
+    const UINT* control_qubit_index_count_list,
+    const UINT* control_qubit_index_list, const UINT* control_value_list,
+    const UINT* target_qubit_index_count_list,
+    const UINT* target_qubit_index_list, const CTYPE* matrix_list,
+    UINT block_qubit_count, CTYPE* state, ITYPE dim);
+
 /**
  * Diagonal gate
  **/
@@ -0,0 +1,233 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "constant.hpp"
+#include "update_ops.hpp"
+#include "utility.hpp"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+// Per-gate information precomputed for blocked application
+typedef struct {
+    UINT target_qubit_index_count;
+    UINT insert_index_count;
+    ITYPE matrix_dim;
+    ITYPE control_mask;
+    const CTYPE* matrix;
+    ITYPE* matrix_mask_list;
+    UINT* sorted_insert_index_list;
+    UINT first_target_qubit_index;
+    UINT second_target_qubit_index;
+    UINT first_control_qubit_index;
+} BlockedGateInfo;
+
+static void apply_single_qubit_dense_matrix_to_block(UINT target_qubit_index,
+    const CTYPE matrix[4], CTYPE* block, ITYPE block_dim) {
+    const ITYPE loop_dim = block_dim / 2;
+    const ITYPE mask = (1ULL << target_qubit_index);
+    const ITYPE mask_low = mask - 1;
+    const ITYPE mask_high = ~mask_low;
+    for (ITYPE state_index = 0; state_index < loop_dim; ++state_index) {
+        ITYPE basis_0 =
+            (state_index & mask_low) + ((state_index & mask_high) << 1);
+        ITYPE basis_1 = basis_0 + mask;
+        CTYPE cval_0 = block[basis_0];
+        CTYPE cval_1 = block[basis_1];
+        block[basis_0] = matrix[0] * cval_0 + matrix[1] * cval_1;
+        block[basis_1] = matrix[2] * cval_0 + matrix[3] * cval_1;
+    }
+}
+
+static void apply_double_qubit_dense_matrix_to_block(UINT target_qubit_index1,
+    UINT target_qubit_index2, const CTYPE matrix[16], CTYPE* block,
+    ITYPE block_dim) {
+    const UINT min_qubit_index =
+        get_min_ui(target_qubit_index1, target_qubit_index2);
+    const UINT max_qubit_index =
+        get_max_ui(target_qubit_index1, target_qubit_index2);
+    const ITYPE min_qubit_mask = 1ULL << min_qubit_index;
+    const ITYPE max_qubit_mask = 1ULL << (max_qubit_index - 1);
+    const ITYPE low_mask = min_qubit_mask - 1;
+    const ITYPE mid_mask = (max_qubit_mask - 1) ^ low_mask;
+    const ITYPE high_mask = ~(max_qubit_mask - 1);
+    const ITYPE target_mask1 = 1ULL << target_qubit_index1;
+    const ITYPE target_mask2 = 1ULL << target_qubit_index2;
+    const ITYPE loop_dim = block_dim / 4;
+    for (ITYPE state_index = 0; state_index < loop_dim; ++state_index) {
+        ITYPE basis_0 = (state_index & low_mask) +
+                        ((state_index & mid_mask) << 1) +
+                        ((state_index & high_mask) << 2);
+        ITYPE basis_1 = basis_0 + target_mask1;
+        ITYPE basis_2 = basis_0 + target_mask2;
+        ITYPE basis_3 = basis_1 + target_mask2;
+        CTYPE cval_0 = block[basis_0];
+        CTYPE cval_1 = block[basis_1];
+        CTYPE cval_2 = block[basis_2];
+        CTYPE cval_3 = block[basis_3];
+        block[basis_0] = matrix[0] * cval_0 + matrix[1] * cval_1 +
+                         matrix[2] * cval_2 + matrix[3] * cval_3;
+        block[basis_1] = matrix[4] * cval_0 + matrix[5] * cval_1 +
+                         matrix[6] * cval_2 + matrix[7] * cval_3;
+        block[basis_2] = matrix[8] * cval_0 + matrix[9] * cval_1 +
+                         matrix[10] * cval_2 + matrix[11] * cval_3;
+        block[basis_3] = matrix[12] * cval_0 + matrix[13] * cval_1 +
+                         matrix[14] * cval_2 + matrix[15] * cval_3;
+    }
+}
+
+static void apply_single_control_single_target_dense_matrix_to_block(
+    UINT control_qubit_index, ITYPE control_mask, UINT target_qubit_index,
+    const CTYPE matrix[4], CTYPE* block, ITYPE block_dim) {
+    const UINT min_qubit_index =
+        get_min_ui(control_qubit_index, target_qubit_index);
+    const UINT max_qubit_index =
+        get_max_ui(control_qubit_index, target_qubit_index);
+    const ITYPE min_qubit_mask = 1ULL << min_qubit_index;
+    const ITYPE max_qubit_mask = 1ULL << (max_qubit_index - 1);
+    const ITYPE low_mask = min_qubit_mask - 1;
+    const ITYPE mid_mask = (max_qubit_mask - 1) ^ low_mask;
+    const ITYPE high_mask = ~(max_qubit_mask - 1);
+    const ITYPE target_mask = 1ULL << target_qubit_index;
+    const ITYPE loop_dim = block_dim / 4;
+    for (ITYPE state_index = 0; state_index < loop_dim; ++state_index) {
+        ITYPE basis_0 = (state_index & low_mask) +
+                        ((state_index & mid_mask) << 1) +
+                        ((state_index & high_mask) << 2) + control_mask;
+        ITYPE basis_1 = basis_0 + target_mask;
+        CTYPE cval_0 = block[basis_0];
+        CTYPE cval_1 = block[basis_1];
+        block[basis_0] = matrix[0] * cval_0 + matrix[1] * cval_1;
+        block[basis_1] = matrix[2] * cval_0 + matrix[3] * cval_1;
+    }
+}
+
+static void apply_dense_matrix_to_block(const BlockedGateInfo* info,
+    CTYPE* buffer, CTYPE* block, ITYPE block_dim) {
+    const ITYPE matrix_dim = info->matrix_dim;
+    const ITYPE loop_dim = block_dim >> info->insert_index_count;
+    for (ITYPE state_index = 0; state_index < loop_dim; ++state_index) {
+        // create base index
+        ITYPE basis_0 = state_index;
+        for (UINT cursor = 0; cursor < info->insert_index_count; ++cursor) {
+            UINT insert_index = info->sorted_insert_index_list[cursor];
+            basis_0 = insert_zero_to_basis_index(
+                basis_0, 1ULL << insert_index, insert_index);
+        }
+        // flip control masks
+        basis_0 ^= info->control_mask;
+
+        // compute matrix mul
+        for (ITYPE y = 0; y < matrix_dim; ++y) {
+            CTYPE sum = 0;
+            for (ITYPE x = 0; x < matrix_dim; ++x) {
+                sum += info->matrix[y * matrix_dim + x] *
+                       block[basis_0 ^ info->matrix_mask_list[x]];
+            }
+            buffer[y] = sum;
+        }
+
+        // set result
+        for (ITYPE y = 0; y < matrix_dim; ++y) {
+            block[basis_0 ^ info->matrix_mask_list[y]] = buffer[y];
+        }
+    }
+}
+
+void multi_gate_blocked_dense_matrix_gate(UINT gate_count,
+    const UINT* control_qubit_index_count_list,
+    const UINT* control_qubit_index_list, const UINT* control_value_list,
+    const UINT* target_qubit_index_count_list,
+    const UINT* target_qubit_index_list, const CTYPE* matrix_list,
+    UINT block_qubit_count, CTYPE* state, ITYPE dim) {
+    if (gate_count == 0) return;
+
+    BlockedGateInfo* info_list =
+        (BlockedGateInfo*)malloc(sizeof(BlockedGateInfo) * gate_count);
+    ITYPE max_matrix_dim = 1;
+    const UINT* control_ptr = control_qubit_index_list;
+    const UINT* value_ptr = control_value_list;
+    const UINT* target_ptr = target_qubit_index_list;
+    const CTYPE* matrix_ptr = matrix_list;
+    for (UINT gate_index = 0; gate_index < gate_count; ++gate_index) {
+        BlockedGateInfo* info = &info_list[gate_index];
+        const UINT control_count = control_qubit_index_count_list[gate_index];
+        const UINT target_count = target_qubit_index_count_list[gate_index];
+        info->target_qubit_index_count = target_count;
+        info->insert_index_count = control_count + target_count;
+        info->matrix_dim = 1ULL << target_count;
+        info->control_mask =
+            create_control_mask(control_ptr, value_ptr, control_count);
+        info->matrix = matrix_ptr;
+        info->matrix_mask_list =
+            create_matrix_mask_list(target_ptr, target_count);
+        info->sorted_insert_index_list = create_sorted_ui_list_list(
+            target_ptr, target_count, control_ptr, control_count);
+        // gates without targets, such as controlled phases, have a 1x1
+        // matrix and are applied by apply_dense_matrix_to_block
+        info->first_target_qubit_index =
+            (target_count > 0) ? target_ptr[0] : 0;
+        info->second_target_qubit_index =
+            (target_count > 1) ? target_ptr[1] : 0;
+        info->first_control_qubit_index =
+            (control_count > 0) ? control_ptr[0] : 0;
+        max_matrix_dim = get_max_ll(max_matrix_dim, info->matrix_dim);
+
+        control_ptr += control_count;
+        value_ptr += control_count;
+        target_ptr += target_count;
+        matrix_ptr += info->matrix_dim * info->matrix_dim;
+    }
+    const ITYPE block_dim = get_min_ll(1ULL << block_qubit_count, dim);
+    const ITYPE block_count = dim / block_dim;
+
+#ifdef _OPENMP
+    OMPutil::get_inst().set_qulacs_num_threads(dim, 13);
+#pragma omp parallel
+#endif
+    {
+        CTYPE* buffer =
+            (CTYPE*)malloc((size_t)(sizeof(CTYPE) * max_matrix_dim));
+        ITYPE block_index;
+#ifdef _OPENMP
+#pragma omp for
+#endif
+        for (block_index = 0; block_index < block_count; ++block_index) {
+            CTYPE* block = state + block_index * block_dim;
+            for (UINT gate_index = 0; gate_index < gate_count; ++gate_index) {
+                const BlockedGateInfo* info = &info_list[gate_index];
+                if (info->insert_index_count == 1 &&
+                    info->target_qubit_index_count == 1) {
+                    apply_single_qubit_dense_matrix_to_block(
+                        info->sorted_insert_index_list[0], info->matrix, block,
+                        block_dim);
+                } else if (info->insert_index_count == 2 &&
+                           info->target_qubit_index_count == 2) {
+                    apply_double_qubit_dense_matrix_to_block(
+                        info->first_target_qubit_index,
+                        info->second_target_qubit_index, info->matrix, block,
+                        block_dim);
+                } else if (info->insert_index_count == 2 &&
+                           info->target_qubit_index_count == 1) {
+                    apply_single_control_single_target_dense_matrix_to_block(
+                        info->first_control_qubit_index, info->control_mask,
+                        info->first_target_qubit_index, info->matrix, block,
+                        block_dim);
+                } else {
+                    apply_dense_matrix_to_block(info, buffer, block, block_dim);
+                }
+            }
+        }
+        free(buffer);
+    }
+#ifdef _OPENMP
+    OMPutil::get_inst().reset_qulacs_num_threads();
+#endif
+
+    for (UINT gate_index = 0; gate_index < gate_count; ++gate_index) {
+        free(info_list[gate_index].matrix_mask_list);
+        free(info_list[gate_index].sorted_insert_index_list);
+    }
+    free(info_list);
+}
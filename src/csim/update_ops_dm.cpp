@@ -686,6 +686,147 @@ void dm_multi_qubit_control_multi_qubit_dense_matrix_gate(
     free(matrix_mask_list);
 }
 
+void dm_multi_qubit_control_multi_qubit_dense_matrix_gate_tiled(
+    const UINT* control_qubit_index_list, const UINT* control_value_list,
+    UINT control_qubit_index_count, const UINT* target_qubit_index_list,
+    UINT target_qubit_index_count, const CTYPE* matrix, CTYPE* state,
+    ITYPE dim) {
+    // matrix dim, mask
+    const ITYPE matrix_dim = 1ULL << target_qubit_index_count;
+    ITYPE* matrix_mask_list = create_matrix_mask_list(
+        target_qubit_index_list, target_qubit_index_count);
+
+    // rows are grouped by the target bits, and columns are grouped by the
+    // target and control bits
+    UINT* sorted_target_index_list = create_sorted_ui_list(
+        target_qubit_index_list, target_qubit_index_count);
+    const UINT insert_index_count =
+        target_qubit_index_count + control_qubit_index_count;
+    UINT* sorted_insert_index_list = create_sorted_ui_list_list(
+        target_qubit_index_list, target_qubit_index_count,
+        control_qubit_index_list, control_qubit_index_count);
+
+    // control mask
+    const ITYPE control_mask = create_control_mask(control_qubit_index_list,
+        control_value_list, control_qubit_index_count);
+    ITYPE control_index_mask = 0;
+    for (UINT i = 0; i < control_qubit_index_count; ++i) {
+        control_index_mask |= 1ULL << control_qubit_index_list[i];
+    }
+
+    // loop variables
+    const ITYPE row_group_count = dim >> target_qubit_index_count;
+    const ITYPE column_group_count = dim >> insert_index_count;
+
+    // the first column of each column group is shared by all the rows
+    ITYPE* column_basis_list =
+        (ITYPE*)malloc((size_t)(sizeof(ITYPE) * column_group_count));
+#ifdef _OPENMP
+    OMPutil::get_inst().set_qulacs_num_threads(dim, 5);
+    const UINT max_thread_count = omp_get_max_threads();
+#else
+    const UINT max_thread_count = 1;
+#endif
+    CTYPE* buffer_list = (CTYPE*)malloc(
+        (size_t)(sizeof(CTYPE) * matrix_dim * 2 * max_thread_count));
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    {
+#ifdef _OPENMP
+        const UINT thread_id = omp_get_thread_num();
+#else
+        const UINT thread_id = 0;
+#endif
+        CTYPE* buffer = buffer_list + matrix_dim * 2 * thread_id;
+        CTYPE* result = buffer + matrix_dim;
+        ITYPE column_group;
+#ifdef _OPENMP
+#pragma omp for
+#endif
+        for (column_group = 0; column_group < column_group_count;
+             ++column_group) {
+            ITYPE basis_0_x = column_group;
+            for (UINT cursor = 0; cursor < insert_index_count; cursor++) {
+                UINT insert_index = sorted_insert_index_list[cursor];
+                basis_0_x = insert_zero_to_basis_index(
+                    basis_0_x, 1ULL << insert_index, insert_index);
+            }
+            column_basis_list[column_group] = basis_0_x ^ control_mask;
+        }
+
+        ITYPE row_group;
+#ifdef _OPENMP
+#pragma omp for
+#endif
+        for (row_group = 0; row_group < row_group_count; ++row_group) {
+            // the rows coupled by the matrix stay in cache while they are
+            // multiplied from the left and from the right
+            ITYPE basis_0_y = row_group;
+            for (UINT cursor = 0; cursor < target_qubit_index_count;
+                 cursor++) {
+                UINT insert_index = sorted_target_index_list[cursor];
+                basis_0_y = insert_zero_to_basis_index(
+                    basis_0_y, 1ULL << insert_index, insert_index);
+            }
+
+            // left multiplication U rho
+            if ((basis_0_y & control_index_mask) == control_mask) {
+                for (ITYPE state_index_x = 0; state_index_x < dim;
+                     ++state_index_x) {
+                    for (ITYPE y = 0; y < matrix_dim; ++y) {
+                        buffer[y] =
+                            state[(basis_0_y ^ matrix_mask_list[y]) * dim +
+                                  state_index_x];
+                    }
+                    for (ITYPE y = 0; y < matrix_dim; ++y) {
+                        CTYPE sum = 0;
+                        for (ITYPE x = 0; x < matrix_dim; ++x) {
+                            sum += matrix[y * matrix_dim + x] * buffer[x];
+                        }
+                        result[y] = sum;
+                    }
+                    for (ITYPE y = 0; y < matrix_dim; ++y) {
+                        state[(basis_0_y ^ matrix_mask_list[y]) * dim +
+                              state_index_x] = result[y];
+                    }
+                }
+            }
+
+            // right multiplication rho U^dagger on each row of the group
+            for (ITYPE m = 0; m < matrix_dim; ++m) {
+                CTYPE* row = state + (basis_0_y ^ matrix_mask_list[m]) * dim;
+                for (ITYPE group = 0; group < column_group_count; ++group) {
+                    const ITYPE basis_0_x = column_basis_list[group];
+                    for (ITYPE x = 0; x < matrix_dim; ++x) {
+                        buffer[x] = row[basis_0_x ^ matrix_mask_list[x]];
+                    }
+                    for (ITYPE x = 0; x < matrix_dim; ++x) {
+                        const CTYPE* matrix_row = matrix + x * matrix_dim;
+                        CTYPE sum = 0;
+                        for (ITYPE k = 0; k < matrix_dim; ++k) {
+                            sum += buffer[k] * conj(matrix_row[k]);
+                        }
+                        result[x] = sum;
+                    }
+                    for (ITYPE x = 0; x < matrix_dim; ++x) {
+                        row[basis_0_x ^ matrix_mask_list[x]] = result[x];
+                    }
+                }
+            }
+        }
+    }
+#ifdef _OPENMP
+    OMPutil::get_inst().reset_qulacs_num_threads();
+#endif
+    free(buffer_list);
+    free(column_basis_list);
+    free(sorted_insert_index_list);
+    free(sorted_target_index_list);
+    free(matrix_mask_list);
+}
+
 void dm_X_gate(UINT target_qubit_index, CTYPE* state, ITYPE dim) {
     dm_single_qubit_dense_matrix_gate(
         target_qubit_index, PAULI_MATRIX[1], state, dim);
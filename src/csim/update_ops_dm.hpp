@@ -33,6 +33,27 @@ DllExport void dm_multi_qubit_control_multi_qubit_dense_matrix_gate(
     UINT control_qubit_index_count, const UINT* target_qubit_index_list,
     UINT target_qubit_index_count, const CTYPE* matrix, CTYPE* state,
     ITYPE dim);
+// U rho U^dagger for U acting on the target qubits under the control qubits.
+// Unlike dm_multi_qubit_control_multi_qubit_dense_matrix_gate, rho is swept
+// once: each tile of rows coupled by U is multiplied from the left and then
+// from the right while it is in cache, and no matrix of dimension 4^k is
+// built.
+DllExport void dm_multi_qubit_control_multi_qubit_dense_matrix_gate_tiled(
+    const UINT* control_qubit_index_list, const UINT* control_value_list,
+    UINT control_qubit_index_count, const UINT* target_qubit_index_list,
+    UINT target_qubit_index_count, const CTYPE* matrix, CTYPE* state,
+    ITYPE dim);
+
+// The dm_packed_* functions take a Hermitian density matrix whose upper
+// triangle is packed row by row. The gate updates the blocks of rho on and
+// above the diagonal, and reads and writes only the upper triangle.
+DllExport void dm_packed_normalize(
+    double squared_norm, CTYPE* state, ITYPE dim);
+DllExport void dm_packed_multi_qubit_control_multi_qubit_dense_matrix_gate(
+    const UINT* control_qubit_index_list, const UINT* control_value_list,
+    UINT control_qubit_index_count, const UINT* target_qubit_index_list,
+    UINT target_qubit_index_count, const CTYPE* matrix, CTYPE* state,
+    ITYPE dim);
 
 DllExport void dm_X_gate(UINT target_qubit_index, CTYPE* state, ITYPE dim);
 DllExport void dm_Y_gate(UINT target_qubit_index, CTYPE* state, ITYPE dim);
@@ -0,0 +1,177 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "constant.hpp"
+#include "update_ops_dm.hpp"
+#include "utility.hpp"
+
+// The functions in this file take a density matrix whose upper triangle is
+// packed row by row, see get_packed_hermitian_index.
+
+void dm_packed_normalize(double squared_norm, CTYPE* state, ITYPE dim) {
+    const ITYPE packed_dim = dim * (dim + 1) / 2;
+    const double normalize_factor = 1. / squared_norm;
+    ITYPE index;
+#ifdef _OPENMP
+    OMPutil::get_inst().set_qulacs_num_threads(dim, 10);
+#pragma omp parallel for
+#endif
+    for (index = 0; index < packed_dim; ++index) {
+        state[index] *= normalize_factor;
+    }
+#ifdef _OPENMP
+    OMPutil::get_inst().reset_qulacs_num_threads();
+#endif
+}
+
+void dm_packed_multi_qubit_control_multi_qubit_dense_matrix_gate(
+    const UINT* control_qubit_index_list, const UINT* control_value_list,
+    UINT control_qubit_index_count, const UINT* target_qubit_index_list,
+    UINT target_qubit_index_count, const CTYPE* matrix, CTYPE* state,
+    ITYPE dim) {
+    // matrix dim, mask
+    const ITYPE matrix_dim = 1ULL << target_qubit_index_count;
+    const ITYPE block_size = matrix_dim * matrix_dim;
+    ITYPE* matrix_mask_list = create_matrix_mask_list(
+        target_qubit_index_list, target_qubit_index_count);
+    UINT* sorted_target_index_list = create_sorted_ui_list(
+        target_qubit_index_list, target_qubit_index_count);
+
+    // control mask
+    const ITYPE control_mask = create_control_mask(control_qubit_index_list,
+        control_value_list, control_qubit_index_count);
+    ITYPE control_index_mask = 0;
+    for (UINT i = 0; i < control_qubit_index_count; ++i) {
+        control_index_mask |= 1ULL << control_qubit_index_list[i];
+    }
+
+    CTYPE* adjoint_matrix =
+        (CTYPE*)malloc((size_t)(sizeof(CTYPE) * block_size));
+    for (ITYPE y = 0; y < matrix_dim; ++y) {
+        for (ITYPE x = 0; x < matrix_dim; ++x) {
+            adjoint_matrix[y * matrix_dim + x] =
+                conj(matrix[x * matrix_dim + y]);
+        }
+    }
+
+    // Indices sharing the bits other than the targets form a group. The block
+    // of rho between the row group a and the column group b is updated as
+    // U_a rho_ab U_b^dagger, where U_a is U if the control bits of a match
+    // and the identity otherwise. Only the blocks with a <= b are visited,
+    // and each of them owns the elements of the upper triangle which couple
+    // the two groups.
+    const ITYPE group_count = dim >> target_qubit_index_count;
+
+#ifdef _OPENMP
+    OMPutil::get_inst().set_qulacs_num_threads(dim, 5);
+#pragma omp parallel
+#endif
+    {
+        CTYPE* buffer =
+            (CTYPE*)malloc((size_t)(sizeof(CTYPE) * block_size * 2));
+        ITYPE group_y;
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic)
+#endif
+        for (group_y = 0; group_y < group_count; ++group_y) {
+            ITYPE basis_0_y = group_y;
+            for (UINT cursor = 0; cursor < target_qubit_index_count;
+                 cursor++) {
+                UINT insert_index = sorted_target_index_list[cursor];
+                basis_0_y = insert_zero_to_basis_index(
+                    basis_0_y, 1ULL << insert_index, insert_index);
+            }
+            const bool apply_left =
+                (basis_0_y & control_index_mask) == control_mask;
+
+            for (ITYPE group_x = group_y; group_x < group_count; ++group_x) {
+                ITYPE basis_0_x = group_x;
+                for (UINT cursor = 0; cursor < target_qubit_index_count;
+                     cursor++) {
+                    UINT insert_index = sorted_target_index_list[cursor];
+                    basis_0_x = insert_zero_to_basis_index(
+                        basis_0_x, 1ULL << insert_index, insert_index);
+                }
+                const bool apply_right =
+                    (basis_0_x & control_index_mask) == control_mask;
+                if (!apply_left && !apply_right) continue;
+
+                // gather the block, where the elements below the diagonal
+                // are the conjugates of the transposed ones
+                CTYPE* block = buffer;
+                CTYPE* product = buffer + block_size;
+                for (ITYPE y = 0; y < matrix_dim; ++y) {
+                    ITYPE row = basis_0_y ^ matrix_mask_list[y];
+                    for (ITYPE x = 0; x < matrix_dim; ++x) {
+                        ITYPE col = basis_0_x ^ matrix_mask_list[x];
+                        block[y * matrix_dim + x] =
+                            (row <= col)
+                                ? state[get_packed_hermitian_index(
+                                      row, col, dim)]
+                                : conj(state[get_packed_hermitian_index(
+                                      col, row, dim)]);
+                    }
+                }
+
+                // left multiplication U rho
+                if (apply_left) {
+                    for (ITYPE y = 0; y < matrix_dim; ++y) {
+                        for (ITYPE x = 0; x < matrix_dim; ++x) {
+                            CTYPE sum = 0;
+                            for (ITYPE k = 0; k < matrix_dim; ++k) {
+                                sum += matrix[y * matrix_dim + k] *
+                                       block[k * matrix_dim + x];
+                            }
+                            product[y * matrix_dim + x] = sum;
+                        }
+                    }
+                    CTYPE* temp = block;
+                    block = product;
+                    product = temp;
+                }
+
+                // right multiplication rho U^dagger
+                if (apply_right) {
+                    for (ITYPE y = 0; y < matrix_dim; ++y) {
+                        for (ITYPE x = 0; x < matrix_dim; ++x) {
+                            CTYPE sum = 0;
+                            for (ITYPE k = 0; k < matrix_dim; ++k) {
+                                sum += block[y * matrix_dim + k] *
+                                       adjoint_matrix[k * matrix_dim + x];
+                            }
+                            product[y * matrix_dim + x] = sum;
+                        }
+                    }
+                    CTYPE* temp = block;
+                    block = product;
+                    product = temp;
+                }
+
+                // scatter the block. In a diagonal block, the elements below
+                // the diagonal are skipped since their transposes are in the
+                // same block.
+                for (ITYPE y = 0; y < matrix_dim; ++y) {
+                    ITYPE row = basis_0_y ^ matrix_mask_list[y];
+                    for (ITYPE x = 0; x < matrix_dim; ++x) {
+                        ITYPE col = basis_0_x ^ matrix_mask_list[x];
+                        if (row <= col) {
+                            state[get_packed_hermitian_index(row, col, dim)] =
+                                block[y * matrix_dim + x];
+                        } else if (group_x != group_y) {
+                            state[get_packed_hermitian_index(col, row, dim)] =
+                                conj(block[y * matrix_dim + x]);
+                        }
+                    }
+                }
+            }
+        }
+        free(buffer);
+    }
+#ifdef _OPENMP
+    OMPutil::get_inst().reset_qulacs_num_threads();
+#endif
+    free(adjoint_matrix);
+    free(sorted_target_index_list);
+    free(matrix_mask_list);
+}
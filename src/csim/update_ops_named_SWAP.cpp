@@ -1,3 +1,5 @@
+#include <stdlib.h>
+
 
 #include "constant.hpp"
 #include "update_ops.hpp"
@@ -197,3 +199,44 @@ void SWAP_gate_parallel_sve(UINT target_qubit_index_0,
     }  // if ((dim > VL) && (min_qubit_mask >= VL))
 }
 #endif
+
+void multi_SWAP_gate(const UINT* target_qubit_index_list_0,
+    const UINT* target_qubit_index_list_1, UINT pair_count, CTYPE* state,
+    ITYPE dim) {
+    ITYPE* mask_list_0 = (ITYPE*)malloc(sizeof(ITYPE) * pair_count);
+    ITYPE* mask_list_1 = (ITYPE*)malloc(sizeof(ITYPE) * pair_count);
+    for (UINT pair_index = 0; pair_index < pair_count; ++pair_index) {
+        mask_list_0[pair_index] = 1ULL << target_qubit_index_list_0[pair_index];
+        mask_list_1[pair_index] = 1ULL << target_qubit_index_list_1[pair_index];
+    }
+
+    // The permutation is an involution, so each pair of indices is swapped
+    // once by the thread visiting the smaller index.
+    ITYPE state_index;
+#ifdef _OPENMP
+    OMPutil::get_inst().set_qulacs_num_threads(dim, 13);
+#pragma omp parallel for
+#endif
+    for (state_index = 0; state_index < dim; ++state_index) {
+        ITYPE swapped_index = state_index;
+        for (UINT pair_index = 0; pair_index < pair_count; ++pair_index) {
+            ITYPE mask_0 = mask_list_0[pair_index];
+            ITYPE mask_1 = mask_list_1[pair_index];
+            if (((state_index & mask_0) == 0) !=
+                ((state_index & mask_1) == 0)) {
+                swapped_index ^= mask_0 | mask_1;
+            }
+        }
+        if (state_index < swapped_index) {
+            CTYPE temp = state[state_index];
+            state[state_index] = state[swapped_index];
+            state[swapped_index] = temp;
+        }
+    }
+#ifdef _OPENMP
+    OMPutil::get_inst().reset_qulacs_num_threads();
+#endif
+
+    free(mask_list_0);
+    free(mask_list_1);
+}
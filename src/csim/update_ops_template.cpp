@@ -0,0 +1,541 @@
+#include "update_ops_template.hpp"
+
+#include <math.h>
+#include <stdlib.h>
+
+#include "constant.hpp"
+#include "utility.hpp"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+// Apply func(state[basis_0], state[basis_1]) to all the pairs of basis
+// differing only at target_qubit_index
+template <typename T, typename Func>
+static void apply_single_qubit_pair_loop(
+    UINT target_qubit_index, std::complex<T>* state, ITYPE dim, Func func) {
+    const ITYPE loop_dim = dim / 2;
+    const ITYPE mask = (1ULL << target_qubit_index);
+    const ITYPE mask_low = mask - 1;
+    const ITYPE mask_high = ~mask_low;
+    ITYPE state_index;
+#ifdef _OPENMP
+    OMPutil::get_inst().set_qulacs_num_threads(dim, 13);
+#pragma omp parallel for
+#endif
+    for (state_index = 0; state_index < loop_dim; ++state_index) {
+        ITYPE basis_0 =
+            (state_index & mask_low) + ((state_index & mask_high) << 1);
+        ITYPE basis_1 = basis_0 + mask;
+        func(state[basis_0], state[basis_1]);
+    }
+#ifdef _OPENMP
+    OMPutil::get_inst().reset_qulacs_num_threads();
+#endif
+}
+
+// Apply func(basis_0) to all the basis of which the bits at
+// target_qubit_index_0 and target_qubit_index_1 are zero
+template <typename Func>
+static void apply_double_qubit_loop(UINT target_qubit_index_0,
+    UINT target_qubit_index_1, ITYPE dim, Func func) {
+    const ITYPE loop_dim = dim / 4;
+    const UINT min_qubit_index =
+        get_min_ui(target_qubit_index_0, target_qubit_index_1);
+    const UINT max_qubit_index =
+        get_max_ui(target_qubit_index_0, target_qubit_index_1);
+    const ITYPE min_qubit_mask = 1ULL << min_qubit_index;
+    const ITYPE max_qubit_mask = 1ULL << (max_qubit_index - 1);
+    const ITYPE low_mask = min_qubit_mask - 1;
+    const ITYPE mid_mask = (max_qubit_mask - 1) ^ low_mask;
+    const ITYPE high_mask = ~(max_qubit_mask - 1);
+    ITYPE state_index;
+#ifdef _OPENMP
+    OMPutil::get_inst().set_qulacs_num_threads(dim, 13);
+#pragma omp parallel for
+#endif
+    for (state_index = 0; state_index < loop_dim; ++state_index) {
+        ITYPE basis_0 = (state_index & low_mask) +
+                        ((state_index & mid_mask) << 1) +
+                        ((state_index & high_mask) << 2);
+        func(basis_0);
+    }
+#ifdef _OPENMP
+    OMPutil::get_inst().reset_qulacs_num_threads();
+#endif
+}
+
+template <typename T>
+void X_gate(UINT target_qubit_index, std::complex<T>* state, ITYPE dim) {
+    apply_single_qubit_pair_loop(target_qubit_index, state, dim,
+        [](std::complex<T>& cval_0, std::complex<T>& cval_1) {
+            std::swap(cval_0, cval_1);
+        });
+}
+
+template <typename T>
+void Y_gate(UINT target_qubit_index, std::complex<T>* state, ITYPE dim) {
+    const std::complex<T> imag_unit(0, 1);
+    apply_single_qubit_pair_loop(target_qubit_index, state, dim,
+        [imag_unit](std::complex<T>& cval_0, std::complex<T>& cval_1) {
+            std::complex<T> temp = cval_0;
+            cval_0 = -imag_unit * cval_1;
+            cval_1 = imag_unit * temp;
+        });
+}
+
+template <typename T>
+void Z_gate(UINT target_qubit_index, std::complex<T>* state, ITYPE dim) {
+    apply_single_qubit_pair_loop(target_qubit_index, state, dim,
+        [](std::complex<T>&, std::complex<T>& cval_1) { cval_1 = -cval_1; });
+}
+
+template <typename T>
+void H_gate(UINT target_qubit_index, std::complex<T>* state, ITYPE dim) {
+    const T sqrt2inv = (T)(1. / SQRT2);
+    apply_single_qubit_pair_loop(target_qubit_index, state, dim,
+        [sqrt2inv](std::complex<T>& cval_0, std::complex<T>& cval_1) {
+            std::complex<T> temp = cval_0;
+            cval_0 = (temp + cval_1) * sqrt2inv;
+            cval_1 = (temp - cval_1) * sqrt2inv;
+        });
+}
+
+template <typename T>
+static void single_qubit_phase_gate_template(UINT target_qubit_index,
+    std::complex<T> phase, std::complex<T>* state, ITYPE dim) {
+    apply_single_qubit_pair_loop(target_qubit_index, state, dim,
+        [phase](std::complex<T>&, std::complex<T>& cval_1) {
+            cval_1 *= phase;
+        });
+}
+
+template <typename T>
+void S_gate(UINT target_qubit_index, std::complex<T>* state, ITYPE dim) {
+    single_qubit_phase_gate_template(
+        target_qubit_index, std::complex<T>(0, 1), state, dim);
+}
+
+template <typename T>
+void Sdag_gate(UINT target_qubit_index, std::complex<T>* state, ITYPE dim) {
+    single_qubit_phase_gate_template(
+        target_qubit_index, std::complex<T>(0, -1), state, dim);
+}
+
+template <typename T>
+void T_gate(UINT target_qubit_index, std::complex<T>* state, ITYPE dim) {
+    const T val = (T)(1. / SQRT2);
+    single_qubit_phase_gate_template(
+        target_qubit_index, std::complex<T>(val, val), state, dim);
+}
+
+template <typename T>
+void Tdag_gate(UINT target_qubit_index, std::complex<T>* state, ITYPE dim) {
+    const T val = (T)(1. / SQRT2);
+    single_qubit_phase_gate_template(
+        target_qubit_index, std::complex<T>(val, -val), state, dim);
+}
+
+template <typename T>
+void CNOT_gate(UINT control_qubit_index, UINT target_qubit_index,
+    std::complex<T>* state, ITYPE dim) {
+    const ITYPE control_mask = 1ULL << control_qubit_index;
+    const ITYPE target_mask = 1ULL << target_qubit_index;
+    apply_double_qubit_loop(control_qubit_index, target_qubit_index, dim,
+        [=](ITYPE basis_0) {
+            ITYPE basis_10 = basis_0 + control_mask;
+            std::swap(state[basis_10], state[basis_10 + target_mask]);
+        });
+}
+
+template <typename T>
+void CZ_gate(UINT control_qubit_index, UINT target_qubit_index,
+    std::complex<T>* state, ITYPE dim) {
+    const ITYPE mask =
+        (1ULL << control_qubit_index) + (1ULL << target_qubit_index);
+    apply_double_qubit_loop(control_qubit_index, target_qubit_index, dim,
+        [=](ITYPE basis_0) { state[basis_0 + mask] *= -1; });
+}
+
+template <typename T>
+void SWAP_gate(UINT target_qubit_index_0, UINT target_qubit_index_1,
+    std::complex<T>* state, ITYPE dim) {
+    const ITYPE mask_0 = 1ULL << target_qubit_index_0;
+    const ITYPE mask_1 = 1ULL << target_qubit_index_1;
+    apply_double_qubit_loop(target_qubit_index_0, target_qubit_index_1, dim,
+        [=](ITYPE basis_0) {
+            std::swap(state[basis_0 + mask_0], state[basis_0 + mask_1]);
+        });
+}
+
+template <typename T>
+void single_qubit_dense_matrix_gate(UINT target_qubit_index,
+    const std::complex<T> matrix[4], std::complex<T>* state, ITYPE dim) {
+    const std::complex<T> m00 = matrix[0], m01 = matrix[1], m10 = matrix[2],
+                          m11 = matrix[3];
+    apply_single_qubit_pair_loop(target_qubit_index, state, dim,
+        [=](std::complex<T>& cval_0, std::complex<T>& cval_1) {
+            std::complex<T> temp = cval_0;
+            cval_0 = m00 * temp + m01 * cval_1;
+            cval_1 = m10 * temp + m11 * cval_1;
+        });
+}
+
+template <typename T>
+void single_qubit_diagonal_matrix_gate(UINT target_qubit_index,
+    const std::complex<T> diagonal_matrix[2], std::complex<T>* state,
+    ITYPE dim) {
+    const std::complex<T> d0 = diagonal_matrix[0], d1 = diagonal_matrix[1];
+    apply_single_qubit_pair_loop(target_qubit_index, state, dim,
+        [=](std::complex<T>& cval_0, std::complex<T>& cval_1) {
+            cval_0 *= d0;
+            cval_1 *= d1;
+        });
+}
+
+template <typename T>
+void multi_qubit_control_multi_qubit_dense_matrix_gate(
+    const UINT* control_qubit_index_list, const UINT* control_value_list,
+    UINT control_qubit_index_count, const UINT* target_qubit_index_list,
+    UINT target_qubit_index_count, const std::complex<T>* matrix,
+    std::complex<T>* state, ITYPE dim) {
+    // matrix dim, mask, buffer
+    const ITYPE matrix_dim = 1ULL << target_qubit_index_count;
+    ITYPE* matrix_mask_list = create_matrix_mask_list(
+        target_qubit_index_list, target_qubit_index_count);
+
+    // insert index
+    const UINT insert_index_count =
+        target_qubit_index_count + control_qubit_index_count;
+    UINT* sorted_insert_index_list = create_sorted_ui_list_list(
+        target_qubit_index_list, target_qubit_index_count,
+        control_qubit_index_list, control_qubit_index_count);
+
+    // control mask
+    ITYPE control_mask = create_control_mask(control_qubit_index_list,
+        control_value_list, control_qubit_index_count);
+
+    // loop varaibles
+    const ITYPE loop_dim = dim >> insert_index_count;
+
+#ifdef _OPENMP
+    OMPutil::get_inst().set_qulacs_num_threads(dim, 13);
+#pragma omp parallel
+#endif
+    {
+        std::complex<T>* buffer = (std::complex<T>*)malloc(
+            (size_t)(sizeof(std::complex<T>) * matrix_dim));
+        ITYPE state_index;
+#ifdef _OPENMP
+#pragma omp for
+#endif
+        for (state_index = 0; state_index < loop_dim; ++state_index) {
+            // create base index
+            ITYPE basis_0 = state_index;
+            for (UINT cursor = 0; cursor < insert_index_count; cursor++) {
+                UINT insert_index = sorted_insert_index_list[cursor];
+                basis_0 = insert_zero_to_basis_index(
+                    basis_0, 1ULL << insert_index, insert_index);
+            }
+
+            // flip control masks
+            basis_0 ^= control_mask;
+
+            // compute matrix mul
+            for (ITYPE y = 0; y < matrix_dim; ++y) {
+                std::complex<T> sum = 0;
+                for (ITYPE x = 0; x < matrix_dim; ++x) {
+                    sum += matrix[y * matrix_dim + x] *
+                           state[basis_0 ^ matrix_mask_list[x]];
+                }
+                buffer[y] = sum;
+            }
+
+            // set result
+            for (ITYPE y = 0; y < matrix_dim; ++y) {
+                state[basis_0 ^ matrix_mask_list[y]] = buffer[y];
+            }
+        }
+        free(buffer);
+    }
+#ifdef _OPENMP
+    OMPutil::get_inst().reset_qulacs_num_threads();
+#endif
+    free(sorted_insert_index_list);
+    free(matrix_mask_list);
+}
+
+template <typename T>
+void multi_qubit_control_multi_qubit_diagonal_matrix_gate(
+    const UINT* control_qubit_index_list, const UINT* control_value_list,
+    UINT control_qubit_index_count, const UINT* target_qubit_index_list,
+    UINT target_qubit_index_count, const std::complex<T>* diagonal_element,
+    std::complex<T>* state, ITYPE dim) {
+    // matrix dim, mask
+    const ITYPE matrix_dim = 1ULL << target_qubit_index_count;
+    ITYPE* matrix_mask_list = create_matrix_mask_list(
+        target_qubit_index_list, target_qubit_index_count);
+
+    // insert index
+    const UINT insert_index_count =
+        target_qubit_index_count + control_qubit_index_count;
+    UINT* sorted_insert_index_list = create_sorted_ui_list_list(
+        target_qubit_index_list, target_qubit_index_count,
+        control_qubit_index_list, control_qubit_index_count);
+
+    // control mask
+    ITYPE control_mask = create_control_mask(control_qubit_index_list,
+        control_value_list, control_qubit_index_count);
+
+    // loop varaibles
+    const ITYPE loop_dim = dim >> insert_index_count;
+    ITYPE state_index;
+
+#ifdef _OPENMP
+    OMPutil::get_inst().set_qulacs_num_threads(dim, 14);
+#pragma omp parallel for
+#endif
+    for (state_index = 0; state_index < loop_dim; ++state_index) {
+        // create base index
+        ITYPE basis_0 = state_index;
+        for (UINT cursor = 0; cursor < insert_index_count; cursor++) {
+            UINT insert_index = sorted_insert_index_list[cursor];
+            basis_0 = insert_zero_to_basis_index(
+                basis_0, 1ULL << insert_index, insert_index);
+        }
+
+        // flip control masks
+        basis_0 ^= control_mask;
+
+        // compute matrix mul
+        for (ITYPE y = 0; y < matrix_dim; ++y) {
+            state[basis_0 ^ matrix_mask_list[y]] *= diagonal_element[y];
+        }
+    }
+#ifdef _OPENMP
+    OMPutil::get_inst().reset_qulacs_num_threads();
+#endif
+    free(sorted_insert_index_list);
+    free(matrix_mask_list);
+}
+
+// phase factor (-i)^k in precision T
+template <typename T>
+static std::complex<T> get_phase_m90rot(UINT k) {
+    return std::complex<T>(
+        (T)_creal(PHASE_M90ROT[k % 4]), (T)_cimag(PHASE_M90ROT[k % 4]));
+}
+
+template <typename T>
+void multi_qubit_Pauli_gate_partial_list(const UINT* target_qubit_index_list,
+    const UINT* Pauli_operator_type_list, UINT target_qubit_index_count,
+    std::complex<T>* state, ITYPE dim) {
+    // create pauli mask
+    ITYPE bit_flip_mask = 0;
+    ITYPE phase_flip_mask = 0;
+    UINT global_phase_90rot_count = 0;
+    UINT pivot_qubit_index = 0;
+    get_Pauli_masks_partial_list(target_qubit_index_list,
+        Pauli_operator_type_list, target_qubit_index_count, &bit_flip_mask,
+        &phase_flip_mask, &global_phase_90rot_count, &pivot_qubit_index);
+
+    ITYPE state_index;
+    if (bit_flip_mask == 0) {
+#ifdef _OPENMP
+        OMPutil::get_inst().set_qulacs_num_threads(dim, 14);
+#pragma omp parallel for
+#endif
+        for (state_index = 0; state_index < dim; ++state_index) {
+            if (count_population(state_index & phase_flip_mask) % 2 == 1) {
+                state[state_index] *= -1;
+            }
+        }
+    } else {
+        const std::complex<T> phase_list[2] = {
+            get_phase_m90rot<T>(global_phase_90rot_count),
+            get_phase_m90rot<T>(global_phase_90rot_count + 2)};
+        const ITYPE loop_dim = dim / 2;
+        const ITYPE mask = (1ULL << pivot_qubit_index);
+        const ITYPE mask_low = mask - 1;
+        const ITYPE mask_high = ~mask_low;
+#ifdef _OPENMP
+        OMPutil::get_inst().set_qulacs_num_threads(dim, 14);
+#pragma omp parallel for
+#endif
+        for (state_index = 0; state_index < loop_dim; ++state_index) {
+            ITYPE basis_0 =
+                (state_index & mask_low) + ((state_index & mask_high) << 1);
+            ITYPE basis_1 = basis_0 ^ bit_flip_mask;
+            UINT sign_0 = count_population(basis_0 & phase_flip_mask) % 2;
+            UINT sign_1 = count_population(basis_1 & phase_flip_mask) % 2;
+            std::complex<T> cval_0 = state[basis_0];
+            std::complex<T> cval_1 = state[basis_1];
+            state[basis_0] = cval_1 * phase_list[sign_0];
+            state[basis_1] = cval_0 * phase_list[sign_1];
+        }
+    }
+#ifdef _OPENMP
+    OMPutil::get_inst().reset_qulacs_num_threads();
+#endif
+}
+
+template <typename T>
+void multi_qubit_Pauli_rotation_gate_partial_list(
+    const UINT* target_qubit_index_list, const UINT* Pauli_operator_type_list,
+    UINT target_qubit_index_count, double angle, std::complex<T>* state,
+    ITYPE dim) {
+    // create pauli mask
+    ITYPE bit_flip_mask = 0;
+    ITYPE phase_flip_mask = 0;
+    UINT global_phase_90rot_count = 0;
+    UINT pivot_qubit_index = 0;
+    get_Pauli_masks_partial_list(target_qubit_index_list,
+        Pauli_operator_type_list, target_qubit_index_count, &bit_flip_mask,
+        &phase_flip_mask, &global_phase_90rot_count, &pivot_qubit_index);
+
+    // coefs
+    const T cosval = (T)cos(angle / 2);
+    const T sinval = (T)sin(angle / 2);
+    ITYPE state_index;
+    if (bit_flip_mask == 0) {
+        const std::complex<T> phase_list[2] = {
+            std::complex<T>(cosval, sinval), std::complex<T>(cosval, -sinval)};
+#ifdef _OPENMP
+        OMPutil::get_inst().set_qulacs_num_threads(dim, 14);
+#pragma omp parallel for
+#endif
+        for (state_index = 0; state_index < dim; ++state_index) {
+            int bit_parity =
+                count_population(state_index & phase_flip_mask) % 2;
+            state[state_index] *= phase_list[bit_parity];
+        }
+    } else {
+        // i * sin * (-i)^k for both parities
+        const std::complex<T> isin(0, sinval);
+        const std::complex<T> phase_list[2] = {
+            isin * get_phase_m90rot<T>(global_phase_90rot_count),
+            isin * get_phase_m90rot<T>(global_phase_90rot_count + 2)};
+        const ITYPE loop_dim = dim / 2;
+        const ITYPE mask = (1ULL << pivot_qubit_index);
+        const ITYPE mask_low = mask - 1;
+        const ITYPE mask_high = ~mask_low;
+#ifdef _OPENMP
+        OMPutil::get_inst().set_qulacs_num_threads(dim, 14);
+#pragma omp parallel for
+#endif
+        for (state_index = 0; state_index < loop_dim; ++state_index) {
+            ITYPE basis_0 =
+                (state_index & mask_low) + ((state_index & mask_high) << 1);
+            ITYPE basis_1 = basis_0 ^ bit_flip_mask;
+            int bit_parity_0 = count_population(basis_0 & phase_flip_mask) % 2;
+            int bit_parity_1 = count_population(basis_1 & phase_flip_mask) % 2;
+            std::complex<T> cval_0 = state[basis_0];
+            std::complex<T> cval_1 = state[basis_1];
+            state[basis_0] =
+                cosval * cval_0 + cval_1 * phase_list[bit_parity_0];
+            state[basis_1] =
+                cosval * cval_1 + cval_0 * phase_list[bit_parity_1];
+        }
+    }
+#ifdef _OPENMP
+    OMPutil::get_inst().reset_qulacs_num_threads();
+#endif
+}
+
+template <typename T>
+void normalize(double squared_norm, std::complex<T>* state, ITYPE dim) {
+    const T normalize_factor = (T)(1. / sqrt(squared_norm));
+    ITYPE state_index;
+#ifdef _OPENMP
+    OMPutil::get_inst().set_qulacs_num_threads(dim, 13);
+#pragma omp parallel for
+#endif
+    for (state_index = 0; state_index < dim; ++state_index) {
+        state[state_index] *= normalize_factor;
+    }
+#ifdef _OPENMP
+    OMPutil::get_inst().reset_qulacs_num_threads();
+#endif
+}
+
+template <typename T>
+void state_add_with_coef(std::complex<T> coef,
+    const std::complex<T>* state_added, std::complex<T>* state, ITYPE dim) {
+    ITYPE index;
+#ifdef _OPENMP
+    OMPutil::get_inst().set_qulacs_num_threads(dim, 15);
+#pragma omp parallel for
+#endif
+    for (index = 0; index < dim; ++index) {
+        state[index] += coef * state_added[index];
+    }
+#ifdef _OPENMP
+    OMPutil::get_inst().reset_qulacs_num_threads();
+#endif
+}
+
+template <typename T>
+void state_multiply(std::complex<T> coef, std::complex<T>* state, ITYPE dim) {
+    ITYPE index;
+#ifdef _OPENMP
+    OMPutil::get_inst().set_qulacs_num_threads(dim, 15);
+#pragma omp parallel for
+#endif
+    for (index = 0; index < dim; ++index) {
+        state[index] *= coef;
+    }
+#ifdef _OPENMP
+    OMPutil::get_inst().reset_qulacs_num_threads();
+#endif
+}
+
+#define INSTANTIATE_SINGLE_QUBIT_GATE(name, type) \
+    template DllExport void name<type>(           \
+        UINT target_qubit_index, std::complex<type>* state, ITYPE dim);
+#define INSTANTIATE_DOUBLE_QUBIT_GATE(name, type)                        \
+    template DllExport void name<type>(UINT target_qubit_index_0,        \
+        UINT target_qubit_index_1, std::complex<type>* state, ITYPE dim);
+
+INSTANTIATE_SINGLE_QUBIT_GATE(X_gate, float)
+INSTANTIATE_SINGLE_QUBIT_GATE(Y_gate, float)
+INSTANTIATE_SINGLE_QUBIT_GATE(Z_gate, float)
+INSTANTIATE_SINGLE_QUBIT_GATE(H_gate, float)
+INSTANTIATE_SINGLE_QUBIT_GATE(S_gate, float)
+INSTANTIATE_SINGLE_QUBIT_GATE(Sdag_gate, float)
+INSTANTIATE_SINGLE_QUBIT_GATE(T_gate, float)
+INSTANTIATE_SINGLE_QUBIT_GATE(Tdag_gate, float)
+INSTANTIATE_DOUBLE_QUBIT_GATE(CNOT_gate, float)
+INSTANTIATE_DOUBLE_QUBIT_GATE(CZ_gate, float)
+INSTANTIATE_DOUBLE_QUBIT_GATE(SWAP_gate, float)
+
+template DllExport void single_qubit_dense_matrix_gate<float>(
+    UINT target_qubit_index, const std::complex<float> matrix[4],
+    std::complex<float>* state, ITYPE dim);
+template DllExport void single_qubit_diagonal_matrix_gate<float>(
+    UINT target_qubit_index, const std::complex<float> diagonal_matrix[2],
+    std::complex<float>* state, ITYPE dim);
+template DllExport void multi_qubit_control_multi_qubit_dense_matrix_gate<
+    float>(const UINT* control_qubit_index_list,
+    const UINT* control_value_list, UINT control_qubit_index_count,
+    const UINT* target_qubit_index_list, UINT target_qubit_index_count,
+    const std::complex<float>* matrix, std::complex<float>* state, ITYPE dim);
+template DllExport void multi_qubit_control_multi_qubit_diagonal_matrix_gate<
+    float>(const UINT* control_qubit_index_list,
+    const UINT* control_value_list, UINT control_qubit_index_count,
+    const UINT* target_qubit_index_list, UINT target_qubit_index_count,
+    const std::complex<float>* diagonal_element, std::complex<float>* state,
+    ITYPE dim);
+template DllExport void multi_qubit_Pauli_gate_partial_list<float>(
+    const UINT* target_qubit_index_list, const UINT* Pauli_operator_type_list,
+    UINT target_qubit_index_count, std::complex<float>* state, ITYPE dim);
+template DllExport void multi_qubit_Pauli_rotation_gate_partial_list<float>(
+    const UINT* target_qubit_index_list, const UINT* Pauli_operator_type_list,
+    UINT target_qubit_index_count, double angle, std::complex<float>* state,
+    ITYPE dim);
+template DllExport void normalize<float>(
+    double squared_norm, std::complex<float>* state, ITYPE dim);
+template DllExport void state_add_with_coef<float>(std::complex<float> coef,
+    const std::complex<float>* state_added, std::complex<float>* state,
+    ITYPE dim);
+template DllExport void state_multiply<float>(
+    std::complex<float> coef, std::complex<float>* state, ITYPE dim);
@@ -0,0 +1,175 @@
+/**
+ * @file update_ops_template.hpp
+ * @brief Update functions for state vectors with an arbitrary floating-point
+ * precision
+ *
+ * The functions have the same semantics as the double-precision functions of
+ * the same names in update_ops.hpp. Only T = float is instantiated; calls with
+ * CTYPE* resolve to the double-precision functions.
+ */
+
+#pragma once
+
+#include "type.hpp"
+
+/**
+ * \~english
+ * Apply a named single-qubit gate.
+ *
+ * @param[in] target_qubit_index index of the target qubit
+ * @param[in,out] state quantum state
+ * @param[in] dim dimension
+ *
+ * \~japanese-en
+ * 名前付きの1量子ビットゲートを作用させる。
+ *
+ * @param[in] target_qubit_index ターゲット量子ビットの添え字
+ * @param[in,out] state 量子状態
+ * @param[in] dim 次元
+ */
+template <typename T>
+DllExport void X_gate(UINT target_qubit_index, std::complex<T>* state,
+    ITYPE dim);
+template <typename T>
+DllExport void Y_gate(UINT target_qubit_index, std::complex<T>* state,
+    ITYPE dim);
+template <typename T>
+DllExport void Z_gate(UINT target_qubit_index, std::complex<T>* state,
+    ITYPE dim);
+template <typename T>
+DllExport void H_gate(UINT target_qubit_index, std::complex<T>* state,
+    ITYPE dim);
+template <typename T>
+DllExport void S_gate(UINT target_qubit_index, std::complex<T>* state,
+    ITYPE dim);
+template <typename T>
+DllExport void Sdag_gate(UINT target_qubit_index, std::complex<T>* state,
+    ITYPE dim);
+template <typename T>
+DllExport void T_gate(UINT target_qubit_index, std::complex<T>* state,
+    ITYPE dim);
+template <typename T>
+DllExport void Tdag_gate(UINT target_qubit_index, std::complex<T>* state,
+    ITYPE dim);
+
+/**
+ * \~english
+ * Apply a named two-qubit gate.
+ *
+ * @param[in] control_qubit_index index of the control qubit (the first qubit
+ * for SWAP)
+ * @param[in] target_qubit_index index of the target qubit (the second qubit
+ * for SWAP)
+ * @param[in,out] state quantum state
+ * @param[in] dim dimension
+ *
+ * \~japanese-en
+ * 名前付きの2量子ビットゲートを作用させる。
+ *
+ * @param[in] control_qubit_index 制御量子ビットの添え字(SWAPでは一つ目の量子ビット)
+ * @param[in] target_qubit_index ターゲット量子ビットの添え字(SWAPでは二つ目の量子ビット)
+ * @param[in,out] state 量子状態
+ * @param[in] dim 次元
+ */
+template <typename T>
+DllExport void CNOT_gate(UINT control_qubit_index, UINT target_qubit_index,
+    std::complex<T>* state, ITYPE dim);
+template <typename T>
+DllExport void CZ_gate(UINT control_qubit_index, UINT target_qubit_index,
+    std::complex<T>* state, ITYPE dim);
+template <typename T>
+DllExport void SWAP_gate(UINT target_qubit_index_0, UINT target_qubit_index_1,
+    std::complex<T>* state, ITYPE dim);
+
+/**
+ * \~english
+ * Apply a single-qubit dense matrix or diagonal matrix gate.
+ *
+ * @param[in] target_qubit_index index of the target qubit
+ * @param[in] matrix 2x2 row-major matrix, or its two diagonal elements
+ * @param[in,out] state quantum state
+ * @param[in] dim dimension
+ *
+ * \~japanese-en
+ * 1量子ビットの密行列ゲート、または対角行列ゲートを作用させる。
+ *
+ * @param[in] target_qubit_index ターゲット量子ビットの添え字
+ * @param[in] matrix 行優先の2x2行列、またはその対角成分
+ * @param[in,out] state 量子状態
+ * @param[in] dim 次元
+ */
+template <typename T>
+DllExport void single_qubit_dense_matrix_gate(UINT target_qubit_index,
+    const std::complex<T> matrix[4], std::complex<T>* state, ITYPE dim);
+template <typename T>
+DllExport void single_qubit_diagonal_matrix_gate(UINT target_qubit_index,
+    const std::complex<T> diagonal_matrix[2], std::complex<T>* state,
+    ITYPE dim);
+
+/**
+ * \~english
+ * Apply a multi-qubit dense matrix or diagonal matrix gate with control
+ * qubits.
+ *
+ * See multi_qubit_control_multi_qubit_dense_matrix_gate in update_ops.hpp for
+ * the parameters.
+ *
+ * \~japanese-en
+ * 制御量子ビットを持つ複数量子ビットの密行列ゲート、または対角行列ゲートを作用させる。
+ *
+ * 引数は update_ops.hpp の multi_qubit_control_multi_qubit_dense_matrix_gate
+ * と同じ。
+ */
+template <typename T>
+DllExport void multi_qubit_control_multi_qubit_dense_matrix_gate(
+    const UINT* control_qubit_index_list, const UINT* control_value_list,
+    UINT control_qubit_index_count, const UINT* target_qubit_index_list,
+    UINT target_qubit_index_count, const std::complex<T>* matrix,
+    std::complex<T>* state, ITYPE dim);
+template <typename T>
+DllExport void multi_qubit_control_multi_qubit_diagonal_matrix_gate(
+    const UINT* control_qubit_index_list, const UINT* control_value_list,
+    UINT control_qubit_index_count, const UINT* target_qubit_index_list,
+    UINT target_qubit_index_count, const std::complex<T>* diagonal_element,
+    std::complex<T>* state, ITYPE dim);
+
+/**
+ * \~english
+ * Apply a multi-qubit Pauli operator or Pauli rotation.
+ *
+ * See multi_qubit_Pauli_gate_partial_list and
+ * multi_qubit_Pauli_rotation_gate_partial_list in update_ops.hpp for the
+ * parameters.
+ *
+ * \~japanese-en
+ * 複数量子ビットのパウリ演算子、またはパウリ回転を作用させる。
+ *
+ * 引数は update_ops.hpp の multi_qubit_Pauli_gate_partial_list および
+ * multi_qubit_Pauli_rotation_gate_partial_list と同じ。
+ */
+template <typename T>
+DllExport void multi_qubit_Pauli_gate_partial_list(
+    const UINT* target_qubit_index_list, const UINT* Pauli_operator_type_list,
+    UINT target_qubit_index_count, std::complex<T>* state, ITYPE dim);
+template <typename T>
+DllExport void multi_qubit_Pauli_rotation_gate_partial_list(
+    const UINT* target_qubit_index_list, const UINT* Pauli_operator_type_list,
+    UINT target_qubit_index_count, double angle, std::complex<T>* state,
+    ITYPE dim);
+
+/**
+ * \~english
+ * Normalize, scale, or add states.
+ *
+ * \~japanese-en
+ * 量子状態の正規化、定数倍、足し合わせを行う。
+ */
+template <typename T>
+DllExport void normalize(
+    double squared_norm, std::complex<T>* state, ITYPE dim);
+template <typename T>
+DllExport void state_add_with_coef(std::complex<T> coef,
+    const std::complex<T>* state_added, std::complex<T>* state, ITYPE dim);
+template <typename T>
+DllExport void state_multiply(
+    std::complex<T> coef, std::complex<T>* state, ITYPE dim);
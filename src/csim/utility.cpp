@@ -131,17 +131,31 @@ UINT* create_sorted_ui_list_list(
 }
 
 #ifdef _OPENMP
+// limit set by set_qulacs_num_thread_limit for each thread
+static thread_local UINT qulacs_num_thread_limit = 0;
+
+static UINT limit_num_threads(UINT thread_count) {
+    if (qulacs_num_thread_limit > 0 && qulacs_num_thread_limit < thread_count)
+        return qulacs_num_thread_limit;
+    return thread_count;
+}
+
 void OMPutil::set_qulacs_num_threads(ITYPE dim, UINT para_threshold) {
     UINT threshold = para_threshold;
     if (qulacs_force_threshold > 0) threshold = qulacs_force_threshold;
     if (dim < (((ITYPE)1) << threshold)) {
         omp_set_num_threads(1);
     } else {
-        omp_set_num_threads(qulacs_num_thread_max);
+        omp_set_num_threads(limit_num_threads(qulacs_num_thread_max));
     }
 }
 
 void OMPutil::reset_qulacs_num_threads() {
-    omp_set_num_threads(qulacs_num_default_thread_max);
+    omp_set_num_threads(limit_num_threads(qulacs_num_default_thread_max));
+}
+
+void OMPutil::set_qulacs_num_thread_limit(UINT thread_limit) {
+    qulacs_num_thread_limit = thread_limit;
+    omp_set_num_threads(limit_num_threads(qulacs_num_default_thread_max));
 }
 #endif
@@ -26,6 +26,15 @@ inline static void swap_amplitude(
     state[basis_index_0] = state[basis_index_1];
     state[basis_index_1] = temp;
 }
+/**
+ * Index of the element (row, col) of a dim x dim Hermitian matrix whose upper
+ * triangle is packed row by row. row must not be larger than col.
+ */
+inline static ITYPE get_packed_hermitian_index(
+    ITYPE row, ITYPE col, ITYPE dim) {
+    return row * dim - row * (row - 1) / 2 + (col - row);
+}
+
 /**
  * min for ITYPE
  */
@@ -153,5 +162,9 @@ public:
     }
     void set_qulacs_num_threads(ITYPE dim, UINT para_threshold);
     void reset_qulacs_num_threads();
+    // Limit the number of threads used by the calling thread, e.g. a worker
+    // which processes one of the states handled in parallel. 0 removes the
+    // limit.
+    void set_qulacs_num_thread_limit(UINT thread_limit);
 };
 #endif
@@ -3,44 +3,50 @@
 
 #include <math.h>
 
+#include <cppsim/exception.hpp>
+#include <memory>
+
+#include "adjoint_differentiation.hpp"
 #include "causalcone_simulator.hpp"
 
-std::vector<std::complex<double>> GradCalculator::calculate_grad(
+static std::vector<std::complex<double>> calculate_grad_by_parameter_shift(
     ParametricQuantumCircuit& circuit, Observable& obs,
     std::vector<double> theta) {
-    ParametricQuantumCircuit* circuit_copy = circuit.copy();
-    UINT parameter_count = circuit_copy->get_parameter_count();
+    UINT parameter_count = circuit.get_parameter_count();
+
+    // the cones do not depend on the parameters, so they are built once
+    CausalConeSimulator cone(circuit, obs);
+    for (UINT q = 0; q < parameter_count; ++q) {
+        cone.set_parameter(q, theta[q]);
+    }
+    cone.build();
 
     std::vector<std::complex<double>> grad(parameter_count);
     for (UINT target_gate_itr = 0; target_gate_itr < parameter_count;
          target_gate_itr++) {
         std::complex<double> plus_delta, minus_delta;
-        {
-            for (UINT q = 0; q < parameter_count; ++q) {
-                if (target_gate_itr == q) {
-                    circuit_copy->set_parameter(q, theta[q] + M_PI_2);
-                } else {
-                    circuit_copy->set_parameter(q, theta[q]);
-                }
-            }
-            CausalConeSimulator tmp(*circuit_copy, obs);
-            plus_delta = tmp.get_expectation_value();
-        }
-        {
-            for (UINT q = 0; q < parameter_count; ++q) {
-                if (target_gate_itr == q) {
-                    circuit_copy->set_parameter(q, theta[q] - M_PI_2);
-                } else {
-                    circuit_copy->set_parameter(q, theta[q]);
-                }
-            }
-            CausalConeSimulator tmp(*circuit_copy, obs);
-            minus_delta = tmp.get_expectation_value();
-        }
+        cone.set_parameter(target_gate_itr, theta[target_gate_itr] + M_PI_2);
+        plus_delta = cone.get_expectation_value();
+        cone.set_parameter(target_gate_itr, theta[target_gate_itr] - M_PI_2);
+        minus_delta = cone.get_expectation_value();
+        cone.set_parameter(target_gate_itr, theta[target_gate_itr]);
         grad[target_gate_itr] = (plus_delta - minus_delta) / 2.0;
     }
-    delete circuit_copy;
     return grad;
+}
+
+std::vector<std::complex<double>> GradCalculator::calculate_grad(
+    ParametricQuantumCircuit& circuit, Observable& obs,
+    std::vector<double> theta) {
+    try {
+        auto energy_and_grad = calculate_energy_and_grad(circuit, obs, theta);
+        return std::vector<std::complex<double>>(
+            energy_and_grad.second.begin(), energy_and_grad.second.end());
+    } catch (const NotImplementedException&) {
+        // gates without their inverses, such as noises and non-unitary
+        // matrices, are differentiated by the parameter shift rule
+        return calculate_grad_by_parameter_shift(circuit, obs, theta);
+    }
 };
 
 std::vector<std::complex<double>> GradCalculator::calculate_grad(
@@ -51,3 +57,39 @@ std::vector<std::complex<double>> GradCalculator::calculate_grad(
     }
     return calculate_grad(x, obs, initial_parameter);
 };
+
+std::pair<double, std::vector<double>>
+GradCalculator::calculate_energy_and_grad(
+    ParametricQuantumCircuit& circuit, Observable& obs) {
+    // the inverses of the gates are created before the state, since they
+    // may throw
+    AdjointDifferentiation adjoint(&circuit);
+
+    // state holds the state after the first gates, and the inverse of each
+    // gate is applied to it in the backward pass
+    const UINT qubit_count = circuit.qubit_count;
+    QuantumState state(qubit_count);
+    QuantumState bistate(qubit_count);
+    QuantumState work_state(qubit_count);
+    state.set_zero_state();
+    circuit.update_quantum_state(&state);
+    obs.apply_to_state(&work_state, state, &bistate);
+    const double energy = state::inner_product(&state, &bistate).real();
+
+    auto grad = adjoint.compute_gradient(&bistate, [&](UINT i) {
+        adjoint.apply_inverse(i, &state);
+        return &state;
+    });
+    return std::make_pair(energy, grad);
+}
+
+std::pair<double, std::vector<double>>
+GradCalculator::calculate_energy_and_grad(
+    ParametricQuantumCircuit& circuit, Observable& obs,
+    std::vector<double> theta) {
+    std::unique_ptr<ParametricQuantumCircuit> circuit_copy(circuit.copy());
+    for (UINT q = 0; q < circuit_copy->get_parameter_count(); ++q) {
+        circuit_copy->set_parameter(q, theta[q]);
+    }
+    return calculate_energy_and_grad(*circuit_copy, obs);
+}
@@ -2,6 +2,7 @@
 
 #include <cppsim/observable.hpp>
 #include <cppsim/state.hpp>
+#include <utility>
 
 #include "parametric_circuit.hpp"
 
@@ -12,4 +13,32 @@ public:
         std::vector<double> theta);
     std::vector<std::complex<double>> calculate_grad(
         ParametricQuantumCircuit& x, Observable& obs);
+
+    /**
+     * \~japanese-en
+     * |0...0>に回路を作用させた状態での期待値と、各パラメータについての勾配を
+     * adjoint法で計算する。
+     *
+     * 回路を1度前から適用した後、状態とobsを作用させた状態の2つに後ろから
+     * ゲートの逆を作用させながら、各パラメトリックゲートの微分を求める。
+     * そのため、ゲートの適用回数はパラメータ数によらず回路の長さに比例する。
+     * パラメトリックでないゲートはユニタリであり、get_inverseを持つ必要がある。
+     * そうでないゲートがある場合はNotImplementedExceptionを送出する。
+     * @param[in] x 量子回路。パラメータは計算中に変更されるが、元に戻される。
+     * @param[in] obs 期待値を求めるオブザーバブル
+     * @return 期待値と勾配の組
+     */
+    std::pair<double, std::vector<double>> calculate_energy_and_grad(
+        ParametricQuantumCircuit& x, Observable& obs);
+    /**
+     * \~japanese-en
+     * パラメータをthetaとして、期待値と勾配をadjoint法で計算する。
+     * @param[in] x 量子回路
+     * @param[in] obs 期待値を求めるオブザーバブル
+     * @param[in] theta 各パラメータの値
+     * @return 期待値と勾配の組
+     */
+    std::pair<double, std::vector<double>> calculate_energy_and_grad(
+        ParametricQuantumCircuit& x, Observable& obs,
+        std::vector<double> theta);
 };
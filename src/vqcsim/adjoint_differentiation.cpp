@@ -0,0 +1,73 @@
+#include "adjoint_differentiation.hpp"
+
+#include <cppsim/exception.hpp>
+#include <cppsim/gate_matrix.hpp>
+#include <cppsim/gate_matrix_diagonal.hpp>
+
+#include "parametric_gate.hpp"
+
+// The inverse of a matrix gate is its conjugate transpose, which is only
+// the inverse of a unitary matrix.
+static QuantumGateBase* get_unitary_inverse(const QuantumGateBase* gate) {
+    if (dynamic_cast<const QuantumGateMatrix*>(gate) != nullptr ||
+        dynamic_cast<const QuantumGateDiagonalMatrix*>(gate) != nullptr) {
+        ComplexMatrix matrix;
+        gate->set_matrix(matrix);
+        if (!matrix.isUnitary()) {
+            throw NotImplementedException(
+                "Error: AdjointDifferentiation: the inverse of a non-unitary " +
+                gate->get_name() + " gate is not available");
+        }
+    }
+    return gate->get_inverse();
+}
+
+AdjointDifferentiation::AdjointDifferentiation(
+    const ParametricQuantumCircuit* circuit)
+    : _circuit(circuit) {
+    const UINT gate_count = (UINT)circuit->gate_list.size();
+    const UINT parameter_count = circuit->get_parameter_count();
+    _parameter_index_list.assign(gate_count, -1);
+    for (UINT p = 0; p < parameter_count; ++p) {
+        _parameter_index_list[circuit->get_parametric_gate_position(p)] = p;
+    }
+    _inverse_gate_list.resize(gate_count);
+    for (UINT i = 0; i < gate_count; ++i) {
+        if (_parameter_index_list[i] == -1) {
+            _inverse_gate_list[i].reset(
+                get_unitary_inverse(circuit->gate_list[i]));
+        }
+    }
+}
+
+void AdjointDifferentiation::apply_inverse(
+    UINT index, QuantumStateBase* state) const {
+    if (_parameter_index_list[index] == -1) {
+        _inverse_gate_list[index]->update_quantum_state(state);
+    } else {
+        static_cast<QuantumGate_SingleParameter*>(_circuit->gate_list[index])
+            ->apply_inverse(state);
+    }
+}
+
+std::vector<double> AdjointDifferentiation::compute_gradient(
+    QuantumState* bistate,
+    const std::function<const QuantumState*(UINT)>& previous_state) const {
+    const UINT gate_count = (UINT)_circuit->gate_list.size();
+    std::vector<double> gradient(_circuit->get_parameter_count());
+    QuantumState derivative_state(_circuit->qubit_count);
+    // the gradient is 2 Re <bistate| dU |state> with the state before U
+    for (int i = (int)gate_count - 1; i >= 0; --i) {
+        const QuantumState* state = previous_state((UINT)i);
+        const int parameter_index = _parameter_index_list[i];
+        if (parameter_index != -1) {
+            derivative_state.load(state);
+            static_cast<QuantumGate_SingleParameter*>(_circuit->gate_list[i])
+                ->apply_derivative(&derivative_state);
+            gradient[parameter_index] =
+                2. * state::inner_product(bistate, &derivative_state).real();
+        }
+        if (i > 0) this->apply_inverse(i, bistate);
+    }
+    return gradient;
+}
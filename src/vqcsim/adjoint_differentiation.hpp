@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cppsim/gate.hpp>
+#include <cppsim/state.hpp>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "parametric_circuit.hpp"
+
+/**
+ * \~japanese-en
+ * adjoint法による勾配計算の後ろ向きの計算を行うクラス
+ *
+ * GradCalculatorとGradientByAdjointで共有される。ゲートの直前の量子状態を
+ * 求める方法(ゲートの逆の作用やチェックポイントからの再計算)は呼び出し側が
+ * 与える。
+ */
+class DllExport AdjointDifferentiation {
+private:
+    const ParametricQuantumCircuit* _circuit;
+    std::vector<int> _parameter_index_list;
+    std::vector<std::unique_ptr<QuantumGateBase>> _inverse_gate_list;
+
+public:
+    /**
+     * \~japanese-en コンストラクタ
+     *
+     * パラメトリックでないゲートの逆をあらかじめ作成する。行列ゲートの逆は
+     * エルミート共役であるため、逆を持たないゲートやユニタリでない行列ゲートが
+     * ある場合はNotImplementedExceptionを送出する。
+     * @param circuit 量子回路
+     */
+    explicit AdjointDifferentiation(const ParametricQuantumCircuit* circuit);
+
+    /**
+     * \~japanese-en 量子状態にindex番目のゲートの逆を作用させる
+     *
+     * @param[in] index ゲートの添字
+     * @param[in,out] state 量子状態
+     */
+    void apply_inverse(UINT index, QuantumStateBase* state) const;
+
+    /**
+     * \~japanese-en 各パラメータについての勾配を求める
+     *
+     * bistateに後ろからゲートの逆を作用させながら、各パラメトリックゲートの
+     * 微分を作用させた直前の量子状態との内積から勾配を求める。
+     * previous_stateはゲートの添字の降順に一度ずつ呼ばれ、そのゲートの直前の
+     * 量子状態を返す。
+     * @param[in,out] bistate
+     * 最終状態にオブザーバブルを作用させた量子状態。計算後の内容は不定
+     * @param[in] previous_state ゲートの直前の量子状態を返す関数
+     * @return 各パラメータについての勾配
+     */
+    std::vector<double> compute_gradient(QuantumState* bistate,
+        const std::function<const QuantumState*(UINT)>& previous_state)
+        const;
+};
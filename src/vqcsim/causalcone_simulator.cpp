@@ -0,0 +1,283 @@
+#include "causalcone_simulator.hpp"
+
+#include <algorithm>
+#include <climits>
+#include <csim/utility.hpp>
+#include <map>
+#include <memory>
+#include <string>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "parametric_gate.hpp"
+
+CausalConeSimulator::CausalConeSimulator(
+    const ParametricQuantumCircuit& _init_circuit,
+    const Observable& _init_observable) {
+    init_observable = _init_observable.copy();
+    init_circuit = _init_circuit.copy();
+}
+
+CausalConeSimulator::~CausalConeSimulator() {
+    delete init_circuit;
+    delete init_observable;
+    // circuit_list only refers to the circuits of the cones
+    for (auto& cone : _cone_list) {
+        delete cone.circuit;
+    }
+}
+
+void CausalConeSimulator::build() {
+    if (build_run) return;
+    build_run = true;
+    const UINT gate_count = (UINT)init_circuit->gate_list.size();
+    const UINT qubit_count = init_circuit->qubit_count;
+    const UINT parameter_count = init_circuit->get_parameter_count();
+    std::vector<int> parameter_index_of_gate(gate_count, -1);
+    for (UINT p = 0; p < parameter_count; ++p) {
+        parameter_index_of_gate[init_circuit->get_parametric_gate_position(
+            p)] = p;
+    }
+    _parameter_cone_list.assign(parameter_count, {});
+
+    // a cone is identified by its qubits and its gates
+    std::map<std::vector<UINT>, UINT> cone_index_map;
+    std::vector<std::map<std::string, UINT>> measurement_index_map;
+
+    auto terms = init_observable->get_terms();
+    for (auto term : terms) {
+        std::vector<UINT> observable_index_list = term->get_index_list();
+        const UINT observable_count = observable_index_list.size();
+        UnionFind uf(qubit_count + observable_count);
+        std::vector<bool> use_qubit(qubit_count);
+        std::vector<bool> use_gate(gate_count);
+        for (UINT i = 0; i < observable_count; i++) {
+            UINT observable_index = observable_index_list[i];
+            use_qubit[observable_index] = true;
+        }
+        for (int i = gate_count - 1; i >= 0; i--) {
+            auto target_index_list =
+                init_circuit->gate_list[i]->get_target_index_list();
+            auto control_index_list =
+                init_circuit->gate_list[i]->get_control_index_list();
+            for (auto target_index : target_index_list) {
+                if (use_qubit[target_index]) {
+                    use_gate[i] = true;
+                    break;
+                }
+            }
+            if (!use_gate[i]) {
+                for (auto control_index : control_index_list) {
+                    if (use_qubit[control_index]) {
+                        use_gate[i] = true;
+                        break;
+                    }
+                }
+            }
+            if (use_gate[i]) {
+                for (auto target_index : target_index_list) {
+                    use_qubit[target_index] = true;
+                }
+
+                for (auto control_index : control_index_list) {
+                    use_qubit[control_index] = true;
+                }
+
+                for (UINT j = 0; j + 1 < (UINT)target_index_list.size(); j++) {
+                    uf.connect(target_index_list[j], target_index_list[j + 1]);
+                }
+                for (UINT j = 0; j + 1 < (UINT)control_index_list.size();
+                     j++) {
+                    uf.connect(
+                        control_index_list[j], control_index_list[j + 1]);
+                }
+                if (!target_index_list.empty() &&
+                    !control_index_list.empty()) {
+                    uf.connect(target_index_list[0], control_index_list[0]);
+                }
+            }
+        }
+        // 分解処理
+
+        auto term_index_list = term->get_index_list();
+        auto pauli_id_list = term->get_pauli_id_list();
+        std::vector<UINT> roots;
+        for (UINT i = 0; i < qubit_count; i++) {
+            if (use_qubit[i] && i == (UINT)uf.root(i)) {
+                roots.emplace_back(uf.root(i));
+            }
+        }
+        std::vector<ParametricQuantumCircuit*> circuits;
+        std::vector<PauliOperator> pauli_operators;
+        std::vector<std::pair<UINT, UINT>> measurements;
+        for (UINT root : roots) {
+            std::vector<int> qubit_encode(qubit_count, -1);
+            std::vector<UINT> key;
+            int idx = 0;
+            for (UINT j = 0; j < qubit_count; j++) {
+                if (root == (UINT)uf.root(j)) {
+                    qubit_encode[j] = idx++;
+                    key.push_back(j);
+                }
+            }
+            key.push_back(UINT_MAX);
+            std::vector<UINT> cone_gate_list;
+            for (UINT j = 0; j < gate_count; j++) {
+                if (!use_gate[j]) continue;
+                auto target_index_list =
+                    init_circuit->gate_list[j]->get_target_index_list();
+                if ((UINT)uf.root(target_index_list[0]) != root) continue;
+                cone_gate_list.push_back(j);
+                key.push_back(j);
+            }
+
+            auto found = cone_index_map.find(key);
+            UINT cone_index;
+            if (found != cone_index_map.end()) {
+                cone_index = found->second;
+            } else {
+                cone_index = (UINT)_cone_list.size();
+                cone_index_map[key] = cone_index;
+                measurement_index_map.emplace_back();
+
+                Cone cone;
+                cone.circuit = new ParametricQuantumCircuit(idx);
+                for (UINT j : cone_gate_list) {
+                    auto gate = init_circuit->gate_list[j]->copy();
+                    auto target_index_list = gate->get_target_index_list();
+                    auto control_index_list = gate->get_control_index_list();
+                    for (auto& target_idx : target_index_list)
+                        target_idx = qubit_encode[target_idx];
+                    for (auto& control_idx : control_index_list)
+                        control_idx = qubit_encode[control_idx];
+
+                    gate->set_target_index_list(target_index_list);
+                    gate->set_control_index_list(control_index_list);
+                    const int p = parameter_index_of_gate[j];
+                    if (p < 0) {
+                        cone.circuit->add_gate(gate);
+                    } else {
+                        // keep the gate parametric to update it in place
+                        _parameter_cone_list[p].emplace_back(cone_index,
+                            (UINT)cone.parameter_index_list.size());
+                        cone.parameter_index_list.push_back(p);
+                        cone.circuit->add_parametric_gate(
+                            dynamic_cast<QuantumGate_SingleParameter*>(gate));
+                    }
+                }
+                _cone_list.push_back(cone);
+            }
+
+            Cone& cone = _cone_list[cone_index];
+            PauliOperator paulioperator(1.0);
+            for (UINT j = 0; j < (UINT)term_index_list.size(); j++) {
+                if ((UINT)uf.root(term_index_list[j]) != root) continue;
+                paulioperator.add_single_Pauli(
+                    qubit_encode[term_index_list[j]], pauli_id_list[j]);
+            }
+            // terms sharing the cone and the Pauli string share the value
+            auto& measurement_index = measurement_index_map[cone_index];
+            const std::string pauli_string = paulioperator.get_pauli_string();
+            auto measured = measurement_index.find(pauli_string);
+            UINT measurement;
+            if (measured != measurement_index.end()) {
+                measurement = measured->second;
+            } else {
+                measurement = (UINT)cone.pauli_operator_list.size();
+                measurement_index[pauli_string] = measurement;
+                cone.pauli_operator_list.push_back(paulioperator);
+            }
+
+            circuits.push_back(cone.circuit);
+            pauli_operators.push_back(paulioperator);
+            measurements.emplace_back(cone_index, measurement);
+        }
+        circuit_list.emplace_back(circuits);
+        pauli_operator_list.emplace_back(pauli_operators);
+        coef_list.emplace_back(term->get_coef());
+        _measurement_list.emplace_back(measurements);
+    }
+}
+
+CPPCTYPE CausalConeSimulator::get_expectation_value() {
+    if (!build_run) build();
+    const UINT cone_count = (UINT)_cone_list.size();
+    std::vector<std::vector<CPPCTYPE>> value_list(cone_count);
+
+    // small cones are simulated in parallel with a thread each, and large
+    // cones one by one with all the threads, as NoiseSimulator does for
+    // trajectories
+    const UINT cone_parallel_qubit_count = 20;
+    std::vector<UINT> small_cone_list, large_cone_list;
+    for (UINT i = 0; i < cone_count; ++i) {
+        value_list[i].resize(_cone_list[i].pauli_operator_list.size());
+        if (_cone_list[i].circuit->qubit_count <= cone_parallel_qubit_count) {
+            small_cone_list.push_back(i);
+        } else {
+            large_cone_list.push_back(i);
+        }
+    }
+
+    // the work states are kept for each qubit count while a thread runs its
+    // cones, which takes at most twice the memory of its largest cone
+    auto simulate_cone =
+        [this, &value_list](UINT i,
+            std::vector<std::unique_ptr<QuantumState>>& state_list) {
+            Cone& cone = _cone_list[i];
+            const UINT cone_qubit_count = cone.circuit->qubit_count;
+            if (state_list.size() <= cone_qubit_count) {
+                state_list.resize(cone_qubit_count + 1);
+            }
+            if (!state_list[cone_qubit_count]) {
+                state_list[cone_qubit_count].reset(
+                    new QuantumState(cone_qubit_count));
+            }
+            QuantumState* state = state_list[cone_qubit_count].get();
+            state->set_zero_state();
+            cone.circuit->update_quantum_state(state);
+            for (UINT m = 0; m < (UINT)cone.pauli_operator_list.size(); ++m) {
+                value_list[i][m] =
+                    cone.pauli_operator_list[m].get_expectation_value(state);
+            }
+        };
+
+    std::vector<std::unique_ptr<QuantumState>> state_list;
+#ifdef _OPENMP
+    if (small_cone_list.size() > 1) {
+#pragma omp parallel
+        {
+            OMPutil::get_inst().set_qulacs_num_thread_limit(1);
+            std::vector<std::unique_ptr<QuantumState>> thread_state_list;
+            int k;
+#pragma omp for schedule(dynamic)
+            for (k = 0; k < (int)small_cone_list.size(); ++k) {
+                simulate_cone(small_cone_list[k], thread_state_list);
+            }
+            OMPutil::get_inst().set_qulacs_num_thread_limit(0);
+        }
+        small_cone_list.clear();
+    }
+#endif
+    for (UINT i : small_cone_list) simulate_cone(i, state_list);
+    for (UINT i : large_cone_list) simulate_cone(i, state_list);
+
+    CPPCTYPE ret;
+    for (UINT i = 0; i < (UINT)_measurement_list.size(); i++) {
+        CPPCTYPE expectation(1.0, 0);
+        for (auto& measurement : _measurement_list[i]) {
+            expectation *= value_list[measurement.first][measurement.second];
+        }
+        ret += expectation * coef_list[i];
+    }
+    return ret;
+}
+
+void CausalConeSimulator::set_parameter(UINT index, double value) {
+    init_circuit->set_parameter(index, value);
+    if (!build_run) return;
+    for (auto& cone_parameter : _parameter_cone_list[index]) {
+        _cone_list[cone_parameter.first].circuit->set_parameter(
+            cone_parameter.second, value);
+    }
+}
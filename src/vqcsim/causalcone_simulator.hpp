@@ -1,3 +1,5 @@
+#pragma once
+
 #include <cppsim/gate.hpp>
 #include <cppsim/gate_factory.hpp>
 #include <cppsim/gate_merge.hpp>
@@ -43,7 +45,34 @@ public:
     }
 };
 
+/**
+ * \~japanese-en
+ * 物理量の各項の後方光円錐(causal cone)に含まれるゲートだけを、連結成分ごとの
+ * 小さな部分回路としてシミュレーションし、期待値を求めるクラス
+ *
+ * 分解は回路の構造だけに依存するため、build()で一度だけ行われる。
+ * 異なる項から得られた同じ部分回路(同じゲートと同じ量子ビットの組)は共有され、
+ * 一度のシミュレーションで、その部分回路に属するすべてのパウリ演算子が
+ * 測定される。パラメータはset_parameterで部分回路に直接反映されるので、
+ * 分解をやり直す必要はない。
+ */
 class DllExport CausalConeSimulator {
+private:
+    /**
+     * \~japanese-en 重複を除いた部分回路と、そこで測定するパウリ演算子
+     */
+    struct Cone {
+        ParametricQuantumCircuit* circuit;
+        //! 部分回路のパラメータに対応する元の回路のパラメータの添字
+        std::vector<UINT> parameter_index_list;
+        std::vector<PauliOperator> pauli_operator_list;
+    };
+    std::vector<Cone> _cone_list;
+    //! 項と連結成分ごとの、_cone_listの添字と測定するパウリ演算子の添字
+    std::vector<std::vector<std::pair<UINT, UINT>>> _measurement_list;
+    //! 元の回路のパラメータごとの、部分回路とそのパラメータの添字
+    std::vector<std::vector<std::pair<UINT, UINT>>> _parameter_cone_list;
+
 public:
     ParametricQuantumCircuit* init_circuit;
     Observable* init_observable;
@@ -52,157 +81,46 @@ public:
     std::vector<CPPCTYPE> coef_list;
     bool build_run = false;
     CausalConeSimulator(const ParametricQuantumCircuit& _init_circuit,
-        const Observable& _init_observable) {
-        init_observable = _init_observable.copy();
-        init_circuit = _init_circuit.copy();
-    }
-    ~CausalConeSimulator() {
-        delete init_circuit;
-        delete init_observable;
-        for (auto& circuit1 : circuit_list) {
-            for (auto& circuit2 : circuit1) {
-                delete circuit2;
-            }
-        }
-    }
-
-    void build() {
-        build_run = true;
-        auto terms = init_observable->get_terms();
-        for (auto term : terms) {
-            std::vector<UINT> observable_index_list = term->get_index_list();
-            const UINT gate_count = init_circuit->gate_list.size();
-            const UINT qubit_count = init_circuit->qubit_count;
-            const UINT observable_count = observable_index_list.size();
-            UnionFind uf(qubit_count + observable_count);
-            std::vector<bool> use_qubit(qubit_count);
-            std::vector<bool> use_gate(gate_count);
-            for (UINT i = 0; i < observable_count; i++) {
-                UINT observable_index = observable_index_list[i];
-                use_qubit[observable_index] = true;
-            }
-            for (int i = gate_count - 1; i >= 0; i--) {
-                auto target_index_list =
-                    init_circuit->gate_list[i]->get_target_index_list();
-                auto control_index_list =
-                    init_circuit->gate_list[i]->get_control_index_list();
-                for (auto target_index : target_index_list) {
-                    if (use_qubit[target_index]) {
-                        use_gate[i] = true;
-                        break;
-                    }
-                }
-                if (!use_gate[i]) {
-                    for (auto control_index : control_index_list) {
-                        if (use_qubit[control_index]) {
-                            use_gate[i] = true;
-                            break;
-                        }
-                    }
-                }
-                if (use_gate[i]) {
-                    for (auto target_index : target_index_list) {
-                        use_qubit[target_index] = true;
-                    }
-
-                    for (auto control_index : control_index_list) {
-                        use_qubit[control_index] = true;
-                    }
-
-                    for (UINT j = 0; j + 1 < (UINT)target_index_list.size();
-                         j++) {
-                        uf.connect(
-                            target_index_list[j], target_index_list[j + 1]);
-                    }
-                    for (UINT j = 0; j + 1 < (UINT)control_index_list.size();
-                         j++) {
-                        uf.connect(
-                            control_index_list[j], control_index_list[j + 1]);
-                    }
-                    if (!target_index_list.empty() &&
-                        !control_index_list.empty()) {
-                        uf.connect(target_index_list[0], control_index_list[0]);
-                    }
-                }
-            }
-            // 分解処理
+        const Observable& _init_observable);
+    ~CausalConeSimulator();
+
+    /**
+     * \~japanese-en
+     * 物理量の項ごとに光円錐を求め、部分回路に分解する。
+     *
+     * 同じ部分回路は項をまたいで共有される。二度目以降の呼び出しでは何もしない。
+     */
+    void build();
+
+    /**
+     * \~japanese-en
+     * 期待値を計算する。
+     *
+     * 部分回路はそれぞれ一度だけ計算される。小さな部分回路は1スレッドずつ
+     * 並列に、大きな部分回路は全スレッドで1つずつシミュレーションされる。
+     * 作業用の量子状態は呼び出しの間だけ確保される。
+     * buildが呼ばれていない場合は最初にbuildを行う。
+     * @return 期待値
+     */
+    CPPCTYPE get_expectation_value();
+
+    /**
+     * \~japanese-en
+     * 回路のパラメータを設定する。
+     *
+     * 分解済みの部分回路のパラメータも更新されるため、再度buildする必要はない。
+     * @param[in] index パラメータの添字
+     * @param[in] value パラメータの値
+     */
+    void set_parameter(UINT index, double value);
+
+    /**
+     * \~japanese-en
+     * 重複を除いた部分回路の数を返す。
+     * @return 部分回路の数
+     */
+    UINT get_cone_count() const { return (UINT)_cone_list.size(); }
 
-            auto term_index_list = term->get_index_list();
-            auto pauli_id_list = term->get_pauli_id_list();
-            UINT circuit_count = 0;
-            std::vector<UINT> roots;
-            for (UINT i = 0; i < qubit_count; i++) {
-                if (use_qubit[i] && i == (UINT)uf.root(i)) {
-                    roots.emplace_back(uf.root(i));
-                    circuit_count += 1;
-                }
-            }
-            std::vector<ParametricQuantumCircuit*> circuits(
-                circuit_count, nullptr);
-            std::vector<PauliOperator> pauli_operators(
-                circuit_count, PauliOperator(1.0));
-            // CPPCTYPE expectation(1.0, 0);
-            for (UINT i = 0; i < circuit_count; i++) {
-                UINT root = roots[i];
-                circuits[i] = new ParametricQuantumCircuit(uf.size(root));
-                auto& circuit = circuits[i];
-                std::vector<int> qubit_encode(qubit_count, -1);
-
-                int idx = 0;
-                for (UINT j = 0; j < (UINT)qubit_count; j++) {
-                    if (root == (UINT)uf.root(j)) {
-                        qubit_encode[j] = idx++;
-                    }
-                }
-
-                for (UINT j = 0; j < gate_count; j++) {
-                    if (!use_gate[j]) continue;
-
-                    auto gate = init_circuit->gate_list[j]->copy();
-                    auto target_index_list = gate->get_target_index_list();
-                    auto control_index_list = gate->get_control_index_list();
-                    if ((UINT)uf.root(target_index_list[0]) != root) continue;
-                    for (auto& target_idx : target_index_list)
-                        target_idx = qubit_encode[target_idx];
-                    for (auto& control_idx : control_index_list)
-                        control_idx = qubit_encode[control_idx];
-
-                    gate->set_target_index_list(target_index_list);
-                    gate->set_control_index_list(control_index_list);
-                    circuit->add_gate(gate);
-                }
-                auto& paulioperator = pauli_operators[i];
-                for (UINT j = 0; j < (UINT)term_index_list.size(); j++) {
-                    paulioperator.add_single_Pauli(
-                        qubit_encode[term_index_list[j]], pauli_id_list[j]);
-                }
-            }
-            circuit_list.emplace_back(circuits);
-            pauli_operator_list.emplace_back(pauli_operators);
-            coef_list.emplace_back(term->get_coef());
-        }
-    }
-
-    CPPCTYPE get_expectation_value() {
-        if (!build_run) build();
-        CPPCTYPE ret;
-        for (UINT i = 0; i < (UINT)circuit_list.size(); i++) {
-            CPPCTYPE expectation(1.0, 0);
-            auto& circuits = circuit_list[i];
-            auto& pauli_operators = pauli_operator_list[i];
-            auto& coef = coef_list[i];
-            for (UINT j = 0; j < (UINT)circuits.size(); j++) {
-                auto& circuit = circuits[j];
-                auto& paulioperator = pauli_operators[j];
-                QuantumState state(circuit->qubit_count);
-                state.set_zero_state();
-                circuit->update_quantum_state(&state);
-                expectation *= paulioperator.get_expectation_value(&state);
-            }
-            ret += expectation * coef;
-        }
-        return ret;
-    }
     std::vector<std::vector<ParametricQuantumCircuit*>> get_circuit_list() {
         return circuit_list;
     }
@@ -1,6 +1,12 @@
 
 #include "differential.hpp"
 
+#include <algorithm>
+#include <cppsim/exception.hpp>
+#include <memory>
+
+#include "adjoint_differentiation.hpp"
+
 double GradientByHalfPi::compute_gradient(
     ParametricQuantumCircuitSimulator* sim,
     const EnergyMinimizationProblem* instance,
@@ -37,4 +43,89 @@ double GradientByHalfPi::compute_gradient(
     sim->simulate_range(previous_pos, last_pos);
     double loss = instance->compute_loss(sim->get_state_ptr());
     return loss;
-}
\ No newline at end of file
+}
+
+GradientByAdjoint::GradientByAdjoint(size_t checkpoint_memory_budget)
+    : _checkpoint_memory_budget(checkpoint_memory_budget) {}
+
+double GradientByAdjoint::compute_gradient(
+    ParametricQuantumCircuitSimulator* sim,
+    const EnergyMinimizationProblem* instance,
+    const std::vector<double>& parameter, std::vector<double>* gradient) {
+    for (UINT i = 0; i < parameter.size(); ++i) {
+        sim->set_parameter_value(i, parameter[i]);
+    }
+    ParametricQuantumCircuit* circuit = sim->get_parametric_circuit();
+    const UINT gate_count = sim->get_gate_count();
+    const UINT qubit_count = circuit->qubit_count;
+    AdjointDifferentiation adjoint(circuit);
+
+    // A checkpoint is kept at the start of each segment, and the backward
+    // pass replays one segment at a time keeping the states before its
+    // gates. Both are about sqrt(gate_count) states.
+    UINT segment_length = 1;
+    while ((ITYPE)segment_length * segment_length < gate_count) {
+        ++segment_length;
+    }
+    const UINT segment_count =
+        (gate_count + segment_length - 1) / segment_length;
+    const size_t state_size = sizeof(CPPCTYPE) << qubit_count;
+    const bool use_checkpoint =
+        (size_t)(segment_count + segment_length - 1) * state_size <=
+        _checkpoint_memory_budget;
+
+    sim->initialize_state();
+    if (!sim->get_state_ptr()->is_state_vector()) {
+        throw NotImplementedException(
+            "Error: GradientByAdjoint::compute_gradient("
+            "ParametricQuantumCircuitSimulator*, const "
+            "EnergyMinimizationProblem*, const std::vector<double>&, "
+            "std::vector<double>*): only state vectors are supported");
+    }
+    std::vector<std::unique_ptr<QuantumState>> checkpoint_list;
+    std::vector<std::unique_ptr<QuantumState>> segment_state_list;
+    if (use_checkpoint) {
+        for (UINT k = 0; k < segment_count; ++k) {
+            checkpoint_list.emplace_back(new QuantumState(qubit_count));
+            checkpoint_list.back()->load(sim->get_state_ptr());
+            sim->simulate_range(k * segment_length,
+                std::min(gate_count, (k + 1) * segment_length));
+        }
+        for (UINT j = 1; j < segment_length; ++j) {
+            segment_state_list.emplace_back(new QuantumState(qubit_count));
+        }
+    } else {
+        sim->simulate_range(0, gate_count);
+    }
+    const double loss = instance->compute_loss(sim->get_state_ptr());
+
+    QuantumState state(qubit_count);
+    QuantumState bistate(qubit_count);
+    QuantumState work_state(qubit_count);
+    state.load(sim->get_state_ptr());
+    instance->get_observable()->apply_to_state(&work_state, state, &bistate);
+
+    // the state before the i-th gate is replayed from the checkpoint of its
+    // segment, or obtained by applying the inverse of the i-th gate
+    auto previous_state = [&](UINT i) -> const QuantumState* {
+        if (!use_checkpoint) {
+            adjoint.apply_inverse(i, &state);
+            return &state;
+        }
+        const UINT k = i / segment_length;
+        const UINT offset = i % segment_length;
+        if (i == gate_count - 1 || offset == segment_length - 1) {
+            const QuantumState* replayed = checkpoint_list[k].get();
+            for (UINT j = 1; j <= offset; ++j) {
+                segment_state_list[j - 1]->load(replayed);
+                circuit->gate_list[k * segment_length + j - 1]
+                    ->update_quantum_state(segment_state_list[j - 1].get());
+                replayed = segment_state_list[j - 1].get();
+            }
+        }
+        return (offset == 0) ? checkpoint_list[k].get()
+                             : segment_state_list[offset - 1].get();
+    };
+    *gradient = adjoint.compute_gradient(&bistate, previous_state);
+    return loss;
+}
@@ -24,3 +24,36 @@ public:
         const std::vector<double>& parameter,
         std::vector<double>* gradient) override;
 };
+
+/**
+ * \~japanese-en
+ * adjoint法で勾配を計算するクラス
+ *
+ * オブザーバブルを作用させた量子状態に後ろからゲートの逆を作用させ、
+ * 各パラメトリックゲートの直前の量子状態との内積から勾配を求める。
+ * 直前の量子状態は、前向きの計算でゲート数の平方根ごとに保存した
+ * チェックポイントから区間ごとに再計算する。そのため、ゲートの適用回数は
+ * 合計でゲート数のおよそ3倍となる。
+ * チェックポイントがメモリの上限に収まらない場合は、量子状態にもゲートの逆を
+ * 作用させて直前の量子状態を求める。
+ * パラメトリックでないゲートはユニタリであり、get_inverseを持つ必要がある。
+ */
+class DllExport GradientByAdjoint
+    : public QuantumCircuitGradientDifferentiation {
+private:
+    size_t _checkpoint_memory_budget;
+
+public:
+    /**
+     * \~japanese-en コンストラクタ
+     *
+     * @param checkpoint_memory_budget
+     * チェックポイントと再計算した量子状態に使うメモリのバイト数
+     */
+    explicit GradientByAdjoint(
+        size_t checkpoint_memory_budget = (size_t)1 << 30);
+    virtual double compute_gradient(ParametricQuantumCircuitSimulator* sim,
+        const EnergyMinimizationProblem* instance,
+        const std::vector<double>& parameter,
+        std::vector<double>* gradient) override;
+};
@@ -1,13 +1,19 @@
 #define _USE_MATH_DEFINES
 #include "parametric_circuit.hpp"
 
+#include <algorithm>
 #include <cppsim/exception.hpp>
 #include <cppsim/gate_factory.hpp>
 #include <cppsim/gate_matrix.hpp>
 #include <cppsim/gate_merge.hpp>
 #include <cppsim/state.hpp>
 #include <cppsim/type.hpp>
+#include <csim/utility.hpp>
 #include <iostream>
+#include <memory>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 #include "parametric_gate.hpp"
 #include "parametric_gate_factory.hpp"
@@ -202,55 +208,42 @@ std::vector<double> ParametricQuantumCircuit::backprop_inner_product(
     前から2番までのゲートを適用した状態がstate
     最後の微分値から逆算して3番までgateの逆行列を掛けたのがbistate
 
-    1番まで掛けて、YのΘ微分した行列を掛けたやつと、bistateの内積の実数部分をとれば答えが出ることが知られている(知られてないかも)
+    1番まで掛けて、ゲートのΘ微分を掛けたやつと、bistateの内積の実数部分をとれば答えが出る
 
-    ParametricR? の微分値を計算した行列は、Θに180°を足した行列/2 と等しい
-
-    だから、2番まで掛けて、 R?(π) を掛けたやつと、bistateの内積を取る
+    パラメトリックゲートは exp(iΘG/2) なので、Θ微分は iG/2 を掛けたものと等しい
+    Gはゲートと可換なので、2番まで掛けたstateにapply_generatorでGを掛けて、bistateとの内積を取る
 
     さらに、見るゲートは逆順である。
     だから、最初にstateを最後までやって、ゲートを進めるたびにstateに逆行列を掛けている
     さらに、bistateが複素共役になっていることを忘れると、bistateに転置行列を掛ける必要がある。
     しかしこのプログラムではbistateはずっと複素共役なので、転置して共役な行列を掛ける必要がある。
     ユニタリ性より、転置して共役な行列 = 逆行列
-    なので、両社にadjoint_gateを掛けている
+    なので、両者に逆ゲートを掛けている
+    パラメトリックゲートはapply_inverseで角度を反転して掛け、それ以外のゲートの逆ゲートは最初に一度だけ作る
     */
+    std::vector<std::unique_ptr<QuantumGateBase>> inverse_gate_list(num_gates);
+    for (int i = 0; i < num_gates; i++) {
+        if (inverse_parametric_gate_position[i] == -1) {
+            inverse_gate_list[i].reset(this->gate_list[i]->get_inverse());
+        }
+    }
     QuantumState* Astate = new QuantumState(n);  // 一時的なやつ
     for (int i = num_gates - 1; i >= 0; i--) {
-        QuantumGateBase* gate_now = this->gate_list[i];  // sono gate
-        if (inverse_parametric_gate_position[i] != -1) {
-            Astate->load(state);
-            QuantumGateBase* RcPI;
-            if (gate_now->get_name() == "ParametricRX") {
-                RcPI = gate::RX(gate_now->get_target_index_list()[0], M_PI);
-            } else if (gate_now->get_name() == "ParametricRY") {
-                RcPI = gate::RY(gate_now->get_target_index_list()[0], M_PI);
-            } else if (gate_now->get_name() == "ParametricRZ") {
-                RcPI = gate::RZ(gate_now->get_target_index_list()[0],
-                    M_PI);  // 本当はここで2で割りたいけど、行列を割るのは実装が面倒
-            } else if (gate_now->get_name() == "ParametricPauliRotation") {
-                ClsParametricPauliRotationGate* pauli_gate_now =
-                    dynamic_cast<ClsParametricPauliRotationGate*>(gate_now);
-                RcPI =
-                    gate::PauliRotation(pauli_gate_now->get_target_index_list(),
-                        pauli_gate_now->get_pauli()->get_pauli_id_list(), M_PI);
-            } else {
-                std::stringstream error_message_stream;
-                error_message_stream
-                    << "Error: " << gate_now->get_name()
-                    << " does not support backprop in parametric";
-                throw NotImplementedException(error_message_stream.str());
-            }
-            RcPI->update_quantum_state(Astate);
-            ans[inverse_parametric_gate_position[i]] =
-                state::inner_product(bistate, Astate).real() /
-                2.0;  // だからここで2で割る
-            delete RcPI;
+        const int parameter_index = inverse_parametric_gate_position[i];
+        if (parameter_index == -1) {
+            inverse_gate_list[i]->update_quantum_state(bistate);
+            inverse_gate_list[i]->update_quantum_state(state);
+            continue;
         }
-        auto Agate = gate_now->get_inverse();
-        Agate->update_quantum_state(bistate);
-        Agate->update_quantum_state(state);
-        delete Agate;
+        QuantumGate_SingleParameter* gate_now =
+            _parametric_gate_list[parameter_index];
+        Astate->load(state);
+        gate_now->apply_generator(Astate);
+        // Re(i <bistate|G|state>) / 2
+        ans[parameter_index] =
+            -state::inner_product(bistate, Astate).imag() / 2.0;
+        gate_now->apply_inverse(bistate);
+        gate_now->apply_inverse(state);
     }
     delete Astate;
     delete state;
@@ -288,6 +281,127 @@ std::vector<double> ParametricQuantumCircuit::backprop(
 
 }  // CPP
 
+std::vector<double> ParametricQuantumCircuit::evaluate_batch(
+    const std::vector<std::vector<double>>& theta_matrix,
+    const GeneralQuantumOperator& observable) {
+    const UINT parameter_count = this->get_parameter_count();
+    const UINT batch_size = (UINT)theta_matrix.size();
+    if (observable.get_qubit_count() != this->qubit_count) {
+        throw InvalidQubitCountException(
+            "Error: ParametricQuantumCircuit::evaluate_batch(const "
+            "std::vector<std::vector<double>>&, const "
+            "GeneralQuantumOperator&): invalid qubit count");
+    }
+    for (const auto& theta : theta_matrix) {
+        if (theta.size() != parameter_count) {
+            throw ParameterIndexOutOfRangeException(
+                "Error: ParametricQuantumCircuit::evaluate_batch(const "
+                "std::vector<std::vector<double>>&, const "
+                "GeneralQuantumOperator&): each row of theta_matrix must "
+                "have parameter_count elements");
+        }
+    }
+    std::vector<double> result(batch_size);
+    if (batch_size == 0) return result;
+
+    // the fusable gates before the first parametric gate give the same
+    // state for every item, while random gates must be applied every time
+    UINT prefix_gate_count = 0;
+    while (prefix_gate_count < this->gate_list.size() &&
+           is_fusable_gate(this->gate_list[prefix_gate_count])) {
+        ++prefix_gate_count;
+    }
+    QuantumState prefix_state(this->qubit_count);
+    prefix_state.set_zero_state();
+    this->update_quantum_state(&prefix_state, 0, prefix_gate_count);
+
+    // the same layout as NoiseSimulator::execute_parallel, where the items
+    // of the batch take the place of the trajectories
+    const UINT item_parallel_qubit_count = 20;
+    UINT thread_per_item = 1;
+    UINT worker_count = 1;
+#ifdef _OPENMP
+    const UINT thread_count = (UINT)omp_get_max_threads();
+    if (this->qubit_count > item_parallel_qubit_count) {
+        const UINT shift =
+            std::min(this->qubit_count - item_parallel_qubit_count, 31U);
+        thread_per_item = std::min(thread_count, 1U << shift);
+    }
+    worker_count =
+        std::max(1U, std::min(thread_count / thread_per_item, batch_size));
+    const int max_active_levels = omp_get_max_active_levels();
+    if (worker_count > 1 && thread_per_item > 1) {
+        omp_set_max_active_levels(2);
+    }
+#endif
+
+    // the parametric gates of the remaining gates in the order of position,
+    // as the parameters of the suffix circuits are numbered
+    std::vector<UINT> parameter_index_list(parameter_count);
+    for (UINT p = 0; p < parameter_count; ++p) parameter_index_list[p] = p;
+    std::sort(parameter_index_list.begin(), parameter_index_list.end(),
+        [this](UINT a, UINT b) {
+            return this->_parametric_gate_position[a] <
+                   this->_parametric_gate_position[b];
+        });
+
+    // each worker owns the remaining gates, whose parameters it rewrites
+    std::vector<std::unique_ptr<ParametricQuantumCircuit>> circuit_list;
+    for (UINT worker = 0; worker < worker_count; ++worker) {
+        ParametricQuantumCircuit* suffix_circuit =
+            new ParametricQuantumCircuit(this->qubit_count);
+        UINT next_parameter = 0;
+        for (UINT pos = prefix_gate_count; pos < this->gate_list.size();
+             ++pos) {
+            if (next_parameter < parameter_count &&
+                this->_parametric_gate_position
+                        [parameter_index_list[next_parameter]] == pos) {
+                suffix_circuit->add_parametric_gate(
+                    (QuantumGate_SingleParameter*)this->gate_list[pos]
+                        ->copy());
+                ++next_parameter;
+            } else {
+                suffix_circuit->add_gate(this->gate_list[pos]->copy());
+            }
+        }
+        suffix_circuit->set_fusion_max_block_size(
+            this->get_fusion_max_block_size());
+        suffix_circuit->set_cache_blocking_qubit_count(
+            this->get_cache_blocking_qubit_count());
+        circuit_list.emplace_back(suffix_circuit);
+    }
+
+#ifdef _OPENMP
+#pragma omp parallel num_threads(worker_count) if (worker_count > 1)
+#endif
+    {
+#ifdef _OPENMP
+        const UINT worker = (UINT)omp_get_thread_num();
+        OMPutil::get_inst().set_qulacs_num_thread_limit(thread_per_item);
+#else
+        const UINT worker = 0;
+#endif
+        ParametricQuantumCircuit* suffix_circuit = circuit_list[worker].get();
+        QuantumState state(this->qubit_count);
+        for (UINT i = worker; i < batch_size; i += worker_count) {
+            for (UINT p = 0; p < parameter_count; ++p) {
+                suffix_circuit->set_parameter(
+                    p, theta_matrix[i][parameter_index_list[p]]);
+            }
+            state.load(&prefix_state);
+            suffix_circuit->update_quantum_state(&state);
+            result[i] = observable.get_expectation_value(&state).real();
+        }
+#ifdef _OPENMP
+        OMPutil::get_inst().set_qulacs_num_thread_limit(0);
+#endif
+    }
+#ifdef _OPENMP
+    omp_set_max_active_levels(max_active_levels);
+#endif
+    return result;
+}
+
 boost::property_tree::ptree ParametricQuantumCircuit::to_ptree() const {
     boost::property_tree::ptree pt;
     pt.put("name", "ParametricQuantumCircuit");
@@ -62,6 +62,22 @@ public:
     virtual std::vector<double> backprop(GeneralQuantumOperator* obs);
     virtual std::vector<double> backprop_inner_product(QuantumState* bistate);
 
+    /**
+     * \~japanese-en 複数のパラメータの組について期待値を計算する
+     *
+     * 最初のパラメトリックゲートやノイズなどより前の、行列が決まっている
+     * ゲートは一度だけシミュレートされ、各組の計算はその量子状態を
+     * コピーして残りのゲートを作用させる。
+     * 量子ビット数が小さい場合は組ごとにスレッドを割り当て、大きい場合は
+     * 各組の振幅の計算を並列化する。回路のパラメータは変更されない。
+     * @param[in] theta_matrix 各行がパラメータの組である行列
+     * @param[in] observable 期待値を求めるオブザーバブル
+     * @return 各組の期待値の実部を並べた配列
+     */
+    virtual std::vector<double> evaluate_batch(
+        const std::vector<std::vector<double>>& theta_matrix,
+        const GeneralQuantumOperator& observable);
+
     /**
      * \~japanese-en ptreeに変換
      *
@@ -6,8 +6,10 @@
 #include <cppsim/pauli_operator.hpp>
 #include <cppsim/state.hpp>
 #include <cppsim/utility.hpp>
+#include <csim/constant.hpp>
 #include <csim/update_ops.hpp>
 #include <csim/update_ops_dm.hpp>
+#include <memory>
 
 #ifdef _USE_GPU
 #include <gpusim/update_ops_cuda.h>
@@ -26,6 +28,59 @@ public:
     virtual void set_parameter_value(double value) { _angle = value; }
     virtual double get_parameter_value() const { return _angle; }
     virtual QuantumGate_SingleParameter* copy() const override = 0;
+
+    /**
+     * \~japanese-en 生成子を状態ベクトルに作用させる
+     *
+     * ゲートが exp(i angle G / 2) (G^2 = I) と書けるとき、G を作用させる。
+     * 既定の実装は G = -i U(angle + pi) U(angle)^dagger を用いるため、
+     * ゲートを2回作用させる。
+     * @param state 更新する状態ベクトル
+     */
+    virtual void apply_generator(QuantumStateBase* state) {
+        _check_state_vector(state, "apply_generator");
+        this->apply_inverse(state);
+        _apply_with_angle(_angle + PI, state);
+        state->multiply_coef(CPPCTYPE(0, -1));
+    }
+    /**
+     * \~japanese-en ゲートの角度による微分を状態ベクトルに作用させる
+     *
+     * 微分は i G U(angle) / 2 = U(angle + pi) / 2 であり、
+     * 既定の実装は角度をずらしたゲートを作用させる。
+     * @param state 更新する状態ベクトル
+     */
+    virtual void apply_derivative(QuantumStateBase* state) {
+        _check_state_vector(state, "apply_derivative");
+        _apply_with_angle(_angle + PI, state);
+        state->multiply_coef(0.5);
+    }
+    /**
+     * \~japanese-en 逆ゲートを量子状態に作用させる
+     *
+     * 既定の実装は角度を反転したゲートを作用させ、ゲート自身は変更しない。
+     * @param state 更新する量子状態
+     */
+    virtual void apply_inverse(QuantumStateBase* state) {
+        _apply_with_angle(-_angle, state);
+    }
+
+protected:
+    // The gate itself is left unchanged so that it can be shared by threads
+    // through a const circuit and stays valid when the update throws.
+    void _apply_with_angle(double angle, QuantumStateBase* state) const {
+        std::unique_ptr<QuantumGate_SingleParameter> gate(this->copy());
+        gate->set_parameter_value(angle);
+        gate->update_quantum_state(state);
+    }
+    void _check_state_vector(
+        const QuantumStateBase* state, const std::string& func_name) const {
+        if (!state->is_state_vector()) {
+            throw NotImplementedException(
+                "Error: QuantumGate_SingleParameter::" + func_name +
+                "(QuantumStateBase*): only state vectors are supported");
+        }
+    }
 };
 
 class QuantumGate_SingleParameterOneQubitRotation
@@ -33,9 +88,11 @@ class QuantumGate_SingleParameterOneQubitRotation
 protected:
     using UpdateFunc = void (*)(UINT, double, CTYPE*, ITYPE);
     using UpdateFuncGpu = void (*)(UINT, double, void*, ITYPE, void*, UINT);
+    using GeneratorFunc = void (*)(UINT, CTYPE*, ITYPE);
     UpdateFunc _update_func = nullptr;
     UpdateFunc _update_func_dm = nullptr;
     UpdateFuncGpu _update_func_gpu = nullptr;
+    GeneratorFunc _generator_func = nullptr;
 
     QuantumGate_SingleParameterOneQubitRotation(double angle)
         : QuantumGate_SingleParameter(angle) {}
@@ -79,6 +136,27 @@ public:
                 state->data_c(), state->dim);
         }
     }
+
+    virtual void apply_generator(QuantumStateBase* state) override {
+        if (_generator_func == nullptr || !state->is_state_vector() ||
+            state->get_device_name() != "cpu") {
+            QuantumGate_SingleParameter::apply_generator(state);
+            return;
+        }
+        _generator_func(
+            this->_target_qubit_list[0].index(), state->data_c(), state->dim);
+    }
+    virtual void apply_derivative(QuantumStateBase* state) override {
+        if (_generator_func == nullptr || !state->is_state_vector() ||
+            state->get_device_name() != "cpu") {
+            QuantumGate_SingleParameter::apply_derivative(state);
+            return;
+        }
+        this->update_quantum_state(state);
+        _generator_func(
+            this->_target_qubit_list[0].index(), state->data_c(), state->dim);
+        state->multiply_coef(CPPCTYPE(0, 0.5));
+    }
 };
 
 class ClsParametricRXGate : public QuantumGate_SingleParameterOneQubitRotation {
@@ -88,6 +166,7 @@ public:
         this->_name = "ParametricRX";
         this->_update_func = RX_gate;
         this->_update_func_dm = dm_RX_gate;
+        this->_generator_func = X_gate;
 #ifdef _USE_GPU
         this->_update_func_gpu = RX_gate_host;
 #endif
@@ -122,6 +201,7 @@ public:
         this->_name = "ParametricRY";
         this->_update_func = RY_gate;
         this->_update_func_dm = dm_RY_gate;
+        this->_generator_func = Y_gate;
 #ifdef _USE_GPU
         this->_update_func_gpu = RY_gate_host;
 #endif
@@ -156,6 +236,7 @@ public:
         this->_name = "ParametricRZ";
         this->_update_func = RZ_gate;
         this->_update_func_dm = dm_RZ_gate;
+        this->_generator_func = Z_gate;
 #ifdef _USE_GPU
         this->_update_func_gpu = RZ_gate_host;
 #endif
@@ -236,6 +317,26 @@ public:
                 state->dim);
         }
     };
+    virtual void apply_generator(QuantumStateBase* state) override {
+        if (!state->is_state_vector() || state->get_device_name() != "cpu") {
+            QuantumGate_SingleParameter::apply_generator(state);
+            return;
+        }
+        auto target_index_list = _pauli->get_index_list();
+        auto pauli_id_list = _pauli->get_pauli_id_list();
+        multi_qubit_Pauli_gate_partial_list(target_index_list.data(),
+            pauli_id_list.data(), (UINT)target_index_list.size(),
+            state->data_c(), state->dim);
+    }
+    virtual void apply_derivative(QuantumStateBase* state) override {
+        if (!state->is_state_vector() || state->get_device_name() != "cpu") {
+            QuantumGate_SingleParameter::apply_derivative(state);
+            return;
+        }
+        this->update_quantum_state(state);
+        this->apply_generator(state);
+        state->multiply_coef(CPPCTYPE(0, 0.5));
+    }
     virtual ClsParametricPauliRotationGate* copy() const override {
         return new ClsParametricPauliRotationGate(_angle, _pauli);
     };
@@ -23,3 +23,7 @@ UINT ParametricQuantumCircuitSimulator::get_parametric_gate_position(
     UINT index) {
     return _parametric_circuit->get_parametric_gate_position(index);
 }
+ParametricQuantumCircuit*
+ParametricQuantumCircuitSimulator::get_parametric_circuit() {
+    return _parametric_circuit;
+}
@@ -17,4 +17,5 @@ public:
     void set_parameter_value(UINT index, double value);
     UINT get_parametric_gate_count();
     UINT get_parametric_gate_position(UINT index);
+    ParametricQuantumCircuit* get_parametric_circuit();
 };
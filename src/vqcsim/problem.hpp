@@ -86,6 +86,7 @@ public:
     virtual UINT get_qubit_count() const {
         return _observable->get_qubit_count();
     }
+    virtual const Observable* get_observable() const { return _observable; }
     virtual double compute_loss(const QuantumStateBase* state) const {
         return _observable->get_expectation_value(state).real();
     };
@@ -68,6 +68,8 @@ public:
             return;
         if (differentiation_method == "HalfPi") {
             differentiation = new GradientByHalfPi();
+        } else if (differentiation_method == "Adjoint") {
+            differentiation = new GradientByAdjoint();
         }
         std::vector<double> old_param;
         for (UINT iteration = 0; iteration < max_iteration; ++iteration) {
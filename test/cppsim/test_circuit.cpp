@@ -9,6 +9,7 @@
 #include <cppsim/observable.hpp>
 #include <cppsim/pauli_operator.hpp>
 #include <cppsim/state.hpp>
+#include <cppsim/state_dm.hpp>
 #include <cppsim/type.hpp>
 #include <cppsim/utility.hpp>
 #include <csim/constant.hpp>
@@ -945,3 +946,196 @@ TEST(CircuitTest, MergeCircuits) {
     circuit1.update_quantum_state(&state);
     ASSERT_NEAR(abs(state.data_cpp()[3]), 1.0, 0.0001);
 }
+
+TEST(CircuitTest, RandomCircuitGateFusion) {
+    const UINT n = 6;
+    const UINT depth = 10;
+    Random random;
+
+    UINT max_repeat = 3;
+    UINT max_block_size = 4;
+
+    for (UINT repeat = 0; repeat < max_repeat; ++repeat) {
+        QuantumState state(n), org_state(n), test_state(n);
+        state.set_Haar_random_state();
+        org_state.load(&state);
+        QuantumCircuit circuit(n);
+
+        for (UINT d = 0; d < depth; ++d) {
+            for (UINT i = 0; i < n; ++i) {
+                UINT r = random.int32() % 7;
+                if (r == 0)
+                    circuit.add_sqrtX_gate(i);
+                else if (r == 1)
+                    circuit.add_RY_gate(i, random.uniform());
+                else if (r == 2)
+                    circuit.add_T_gate(i);
+                else if (r == 3) {
+                    if (i + 1 < n) circuit.add_CNOT_gate(i, i + 1);
+                } else if (r == 4) {
+                    if (i + 1 < n) circuit.add_CZ_gate(i, i + 1);
+                } else if (r == 5) {
+                    circuit.add_gate(gate::DepolarizingNoise(i, 0));
+                } else if (r == 6) {
+                    circuit.add_multi_Pauli_rotation_gate(
+                        {i, (i + 2) % n}, {1, 3}, random.uniform());
+                }
+            }
+        }
+
+        test_state.load(&org_state);
+        circuit.update_quantum_state(&test_state);
+        UINT gate_count = (UINT)circuit.gate_list.size();
+        ASSERT_EQ(circuit.get_fused_gate_count(), gate_count);
+
+        for (UINT block_size = 2; block_size <= max_block_size; ++block_size) {
+            circuit.set_fusion_max_block_size(block_size);
+            ASSERT_EQ(circuit.get_fusion_max_block_size(), block_size);
+            ASSERT_LT(circuit.get_fused_gate_count(), gate_count);
+            state.load(&org_state);
+            circuit.update_quantum_state(&state);
+            ASSERT_STATE_NEAR(state, test_state, eps);
+        }
+
+        // cache must be invalidated by add_gate and remove_gate
+        circuit.add_H_gate(0);
+        circuit.add_CNOT_gate(0, 1);
+        gate_count += 2;
+        test_state.load(&org_state);
+        state.load(&org_state);
+        circuit.update_quantum_state(&state);
+        circuit.set_fusion_max_block_size(0);
+        ASSERT_EQ(circuit.get_fused_gate_count(), gate_count);
+        circuit.update_quantum_state(&test_state);
+        ASSERT_STATE_NEAR(state, test_state, eps);
+
+        circuit.set_fusion_max_block_size(max_block_size);
+        circuit.get_fused_gate_count();
+        circuit.remove_gate(gate_count - 1);
+        test_state.load(&org_state);
+        state.load(&org_state);
+        circuit.update_quantum_state(&state);
+        circuit.set_fusion_max_block_size(0);
+        circuit.update_quantum_state(&test_state);
+        ASSERT_STATE_NEAR(state, test_state, eps);
+    }
+}
+
+TEST(CircuitTest, GateFusionDiagonal) {
+    const UINT n = 4;
+    QuantumState state(n), test_state(n);
+    state.set_Haar_random_state();
+    test_state.load(&state);
+
+    QuantumCircuit circuit(n);
+    for (UINT i = 0; i < n; ++i) {
+        circuit.add_T_gate(i);
+        circuit.add_RZ_gate(i, 0.1 * (i + 1));
+    }
+    circuit.add_CZ_gate(0, 1);
+    circuit.add_CZ_gate(2, 3);
+    circuit.update_quantum_state(&test_state);
+
+    circuit.set_fusion_max_block_size(n);
+    ASSERT_EQ(circuit.get_fused_gate_count(), 1);
+    circuit.update_quantum_state(&state);
+    ASSERT_STATE_NEAR(state, test_state, eps);
+}
+
+TEST(CircuitTest, CacheBlockedExecution) {
+    const UINT n = 8;
+    const UINT block_qubit_count = 4;
+    const UINT depth = 5;
+    Random random;
+
+    QuantumState state(n), org_state(n), test_state(n);
+    state.set_Haar_random_state();
+    org_state.load(&state);
+    QuantumCircuit circuit(n);
+    for (UINT d = 0; d < depth; ++d) {
+        for (UINT i = 0; i < n; ++i) {
+            circuit.add_RX_gate(i, random.uniform());
+            circuit.add_RZ_gate(i, random.uniform());
+        }
+        for (UINT i = d % 2; i + 1 < n; i += 2) {
+            circuit.add_CNOT_gate(i, i + 1);
+        }
+    }
+    test_state.load(&org_state);
+    circuit.update_quantum_state(&test_state);
+
+    circuit.set_cache_blocking_qubit_count(block_qubit_count);
+    ASSERT_EQ(circuit.get_cache_blocking_qubit_count(), block_qubit_count);
+    ASSERT_LT(circuit.get_fused_gate_count(), circuit.gate_list.size());
+    state.load(&org_state);
+    circuit.update_quantum_state(&state);
+    ASSERT_STATE_NEAR(state, test_state, eps);
+
+    // combined with gate fusion
+    circuit.set_fusion_max_block_size(2);
+    state.load(&org_state);
+    circuit.update_quantum_state(&state);
+    ASSERT_STATE_NEAR(state, test_state, eps);
+}
+
+TEST(CircuitTest, DensityMatrixTiledExecution) {
+    const UINT n = 5;
+    const UINT depth = 6;
+    Random random;
+    random.set_seed(2);
+
+    QuantumState pure_state(n);
+    pure_state.set_Haar_random_state(3);
+    DensityMatrix org_state(n), state(n), test_state(n);
+    org_state.load(&pure_state);
+    QuantumCircuit circuit(n);
+    for (UINT d = 0; d < depth; ++d) {
+        for (UINT i = 0; i < n; ++i) {
+            const UINT j = (i + 1 + random.int32() % (n - 1)) % n;
+            UINT r = random.int32() % 6;
+            if (r == 0) {
+                circuit.add_RX_gate(i, random.uniform());
+            } else if (r == 1) {
+                circuit.add_CNOT_gate(i, j);
+            } else if (r == 2) {
+                circuit.add_random_unitary_gate({j, i});
+            } else if (r == 3) {
+                auto gate = gate::to_matrix_gate(gate::RY(i, random.uniform()));
+                gate->add_control_qubit(j, 0);
+                circuit.add_gate(gate);
+            } else if (r == 4) {
+                circuit.add_gate(gate::AmplitudeDampingNoise(i, 0.1));
+            } else {
+                circuit.add_multi_Pauli_rotation_gate(
+                    {i, j}, {2, 1}, random.uniform());
+            }
+        }
+    }
+    // gates applied one by one with the dm kernels of each gate
+    test_state.load(&org_state);
+    for (const auto& gate : circuit.gate_list) {
+        gate->update_quantum_state(&test_state);
+    }
+
+    for (UINT block_size : {0, 2, 3}) {
+        circuit.set_fusion_max_block_size(block_size);
+        state.load(&org_state);
+        circuit.update_quantum_state(&state);
+        for (ITYPE i = 0; i < state.dim * state.dim; ++i) {
+            ASSERT_NEAR(abs(state.data_cpp()[i] - test_state.data_cpp()[i]),
+                0., eps);
+        }
+    }
+
+    // cache must be invalidated by add_gate
+    circuit.add_H_gate(0);
+    auto h_gate = gate::H(0);
+    h_gate->update_quantum_state(&test_state);
+    delete h_gate;
+    state.load(&org_state);
+    circuit.update_quantum_state(&state);
+    for (ITYPE i = 0; i < state.dim * state.dim; ++i) {
+        ASSERT_NEAR(
+            abs(state.data_cpp()[i] - test_state.data_cpp()[i]), 0., eps);
+    }
+}
@@ -1289,6 +1289,84 @@ TEST(GateTest, InstrumentGate) {
     delete Inst;
 }
 
+TEST(GateTest, CPTPGateChoosesOneKrausBranch) {
+    const UINT n = 4;
+    const UINT trial_count = 200;
+    // K_0 = I / sqrt(2) on qubit 2 and K_1 = U / sqrt(2) on qubits 3 and 2
+    auto identity = gate::DenseMatrix(
+        2, ComplexMatrix::Identity(2, 2) * CPPCTYPE(sqrt(0.5)));
+    auto unitary = gate::RandomUnitary({3, 2});
+    ComplexMatrix unitary_matrix;
+    unitary->set_matrix(unitary_matrix);
+    auto scaled_unitary =
+        gate::DenseMatrix({3, 2}, unitary_matrix * CPPCTYPE(sqrt(0.5)));
+    auto cptp = gate::Instrument({identity, scaled_unitary}, 0);
+    auto cp = gate::CP({scaled_unitary}, true, true, false);
+    ASSERT_EQ(cptp->get_target_index_list(), std::vector<UINT>({2, 3}));
+
+    QuantumState state(n), initial_state(n), unitary_state(n);
+    UINT count[2] = {0, 0};
+    for (UINT trial = 0; trial < trial_count; ++trial) {
+        initial_state.set_Haar_random_state();
+        unitary_state.load(&initial_state);
+        unitary->update_quantum_state(&unitary_state);
+
+        state.load(&initial_state);
+        cptp->update_quantum_state(&state);
+        const UINT index = state.get_classical_value(0);
+        ASSERT_LT(index, 2U);
+        ++count[index];
+        const QuantumState* expected =
+            (index == 0) ? &initial_state : &unitary_state;
+        ASSERT_NEAR(std::abs(state::inner_product(expected, &state)), 1., eps);
+
+        // the only operator is always chosen when the probability is
+        // normalized
+        state.load(&initial_state);
+        cp->update_quantum_state(&state);
+        ASSERT_NEAR(
+            std::abs(state::inner_product(&unitary_state, &state)), 1., eps);
+    }
+    ASSERT_GT(count[0], 0U);
+    ASSERT_GT(count[1], 0U);
+
+    // amplitude damping projects onto one of the two branches
+    const double prob = 0.3;
+    auto amplitude_damping = gate::AmplitudeDampingNoise(1, prob);
+    ComplexMatrix damping_matrix(2, 2), decay_matrix(2, 2);
+    damping_matrix << 1, 0, 0, sqrt(1 - prob);
+    decay_matrix << 0, sqrt(prob), 0, 0;
+    auto damping = gate::DenseMatrix(1, damping_matrix);
+    auto decay = gate::DenseMatrix(1, decay_matrix);
+    QuantumState damping_state(n), decay_state(n);
+    for (UINT trial = 0; trial < trial_count; ++trial) {
+        initial_state.set_Haar_random_state();
+        damping_state.load(&initial_state);
+        damping->update_quantum_state(&damping_state);
+        damping_state.normalize(damping_state.get_squared_norm());
+        decay_state.load(&initial_state);
+        decay->update_quantum_state(&decay_state);
+        decay_state.normalize(decay_state.get_squared_norm());
+
+        state.load(&initial_state);
+        amplitude_damping->update_quantum_state(&state);
+        ASSERT_NEAR(state.get_squared_norm(), 1., eps);
+        const double overlap = std::max(
+            std::abs(state::inner_product(&damping_state, &state)),
+            std::abs(state::inner_product(&decay_state, &state)));
+        ASSERT_NEAR(overlap, 1., eps);
+    }
+
+    delete identity;
+    delete unitary;
+    delete scaled_unitary;
+    delete cptp;
+    delete cp;
+    delete amplitude_damping;
+    delete damping;
+    delete decay;
+}
+
 TEST(GateTest, AdaptiveGateWithoutID) {
     auto x = gate::X(0);
     auto adaptive = gate::Adaptive(
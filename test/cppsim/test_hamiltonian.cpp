@@ -579,6 +579,64 @@ TEST(ObservableTest, ApplyIdentityToState) {
     ASSERT_NEAR(0., state.get_squared_norm(), eps);
 }
 
+TEST(ObservableTest, ExpectationValueOfGroupedTerms) {
+    const UINT term_count = 20;
+    const std::string pauli_name = "IXYZ";
+
+    for (UINT n : {3, 11}) {
+        // bit flips only on the first two qubits make many terms share them
+        auto add_random_term = [&](GeneralQuantumOperator& op) {
+            std::string pauli_string;
+            for (UINT i = 0; i < n; ++i) {
+                const UINT pauli = (i < 2) ? rand_int(4) : 3 * rand_int(2);
+                if (pauli == 0) continue;
+                pauli_string +=
+                    pauli_name[pauli] + std::string(" ") + std::to_string(i) +
+                    " ";
+            }
+            op.add_operator(CPPCTYPE(rand_real(), rand_real()), pauli_string);
+        };
+        auto get_sum_of_terms = [](const GeneralQuantumOperator& op,
+                                    const QuantumStateBase* state) {
+            CPPCTYPE sum = 0.;
+            for (UINT i = 0; i < op.get_term_count(); ++i) {
+                sum += op.get_term(i)->get_expectation_value(state);
+            }
+            return sum;
+        };
+        auto check = [&](const GeneralQuantumOperator& op,
+                         const QuantumStateBase* state) {
+            const CPPCTYPE test_res = get_sum_of_terms(op, state);
+            const CPPCTYPE res = op.get_expectation_value(state);
+            const CPPCTYPE res_single_thread =
+                op.get_expectation_value_single_thread(state);
+            ASSERT_NEAR(res.real(), test_res.real(), eps);
+            ASSERT_NEAR(res.imag(), test_res.imag(), eps);
+            ASSERT_NEAR(res_single_thread.real(), test_res.real(), eps);
+            ASSERT_NEAR(res_single_thread.imag(), test_res.imag(), eps);
+        };
+
+        QuantumState state(n);
+        state.set_Haar_random_state();
+        GeneralQuantumOperator op(n);
+        for (UINT i = 0; i < term_count; ++i) add_random_term(op);
+        check(op, &state);
+
+        // the grouping is rebuilt after terms are added
+        for (UINT i = 0; i < term_count; ++i) add_random_term(op);
+        check(op, &state);
+
+        // changed coefficients are reflected
+        op.get_terms()[0]->change_coef(CPPCTYPE(2., -1.));
+        check(op, &state);
+        op *= CPPCTYPE(0.5, 0.5);
+        check(op, &state);
+        // the terms are replaced by the product
+        op *= PauliOperator("Y 0 Z 1", CPPCTYPE(0., 1.));
+        check(op, &state);
+    }
+}
+
 TEST(gate_to_general_quantum_operatorTest, Random4bit) {
     QuantumGateBase* random_gate = gate::RandomUnitary({0, 1, 2, 3});
 
@@ -8,6 +8,29 @@
 
 #include "../util/util.hpp"
 
+// a gate which only counts how many times it is applied
+class ClsCountingGate : public QuantumGateBase {
+private:
+    std::shared_ptr<UINT> _count;
+
+public:
+    ClsCountingGate(UINT target_qubit_index, std::shared_ptr<UINT> count)
+        : _count(count) {
+        this->_name = "Counting";
+        this->_target_qubit_list.push_back(
+            TargetQubitInfo(target_qubit_index, 0));
+    }
+    virtual void update_quantum_state(QuantumStateBase*) override {
+        ++*_count;
+    }
+    virtual QuantumGateBase* copy() const override {
+        return new ClsCountingGate(*this);
+    }
+    virtual void set_matrix(ComplexMatrix& matrix) const override {
+        matrix = ComplexMatrix::Identity(2, 2);
+    }
+};
+
 TEST(NoiseSimulatorTest, Random_with_State_Test) {
     // Just Check whether they run without Runtime Errors.
     UINT n = 10, depth = 10;
@@ -127,3 +150,113 @@ TEST(NoiseSimulatorTest, H_gate_twice_test) {
     ASSERT_NE(cnts[1], 0);
     ASSERT_GT(cnts[0], cnts[1]);
 }
+
+TEST(NoiseSimulatorTest, ExecuteParallelTest) {
+    UINT n = 4;
+    QuantumCircuit circuit(n);
+    circuit.add_noise_gate(gate::H(0), "Depolarizing", 0.02);
+    circuit.add_noise_gate(gate::H(0), "Depolarizing", 0.02);
+    circuit.add_X_gate(2);
+    NoiseSimulator sim(&circuit);
+    std::vector<ITYPE> result = sim.execute_parallel(10000);
+    ASSERT_EQ(result.size(), 10000);
+    int cnts[2] = {};
+    for (UINT i = 0; i < result.size(); ++i) {
+        ASSERT_EQ(result[i] & 4, 4);
+        cnts[result[i] & 1]++;
+    }
+    ASSERT_NE(cnts[0], 0);
+    ASSERT_NE(cnts[1], 0);
+    ASSERT_GT(cnts[0], cnts[1]);
+
+    // a noiseless circuit gives a single outcome
+    QuantumCircuit noiseless_circuit(n);
+    noiseless_circuit.add_X_gate(1);
+    noiseless_circuit.add_X_gate(3);
+    QuantumState state(n);
+    state.set_computational_basis(1);
+    NoiseSimulator noiseless_sim(&noiseless_circuit, &state);
+    std::vector<ITYPE> noiseless_result = noiseless_sim.execute_parallel(100);
+    ASSERT_EQ(noiseless_result.size(), 100);
+    for (ITYPE sample : noiseless_result) {
+        ASSERT_EQ(sample, 11);
+    }
+}
+
+TEST(NoiseSimulatorTest, SharedNoiseHistoryTest) {
+    // each qubit is flipped by X twice and by BitFlip noise with probability
+    // p after each X, so it ends in 1 with probability 2p(1-p)
+    const UINT n = 6, sample_count = 10000;
+    const double p = 0.3;
+    QuantumCircuit circuit(n);
+    for (UINT d = 0; d < 2; ++d) {
+        for (UINT i = 0; i < n; ++i) {
+            circuit.add_noise_gate(gate::X(i), "BitFlip", p);
+        }
+    }
+    for (size_t budget : {(size_t)0, (size_t)1 << 30}) {
+        NoiseSimulator sim(&circuit);
+        sim.set_checkpoint_memory_budget(budget);
+        ASSERT_EQ(sim.get_checkpoint_memory_budget(), budget);
+        for (UINT parallel = 0; parallel < 2; ++parallel) {
+            std::vector<ITYPE> result = parallel
+                                            ? sim.execute_parallel(sample_count)
+                                            : sim.execute(sample_count);
+            ASSERT_EQ(result.size(), sample_count);
+            for (UINT i = 0; i < n; ++i) {
+                UINT count = 0;
+                for (ITYPE sample : result) count += (sample >> i) & 1;
+                ASSERT_NEAR(
+                    (double)count / sample_count, 2 * p * (1 - p), 0.05);
+            }
+        }
+    }
+}
+
+TEST(NoiseSimulatorTest, SharedPrefixSimulatedOnce) {
+    // two noises with two branches each give four histories, which share
+    // the gates before the first noise and, per branch, before the second
+    const UINT sample_count = 1000;
+    std::vector<std::shared_ptr<UINT>> count_list;
+    for (UINT i = 0; i < 3; ++i) count_list.emplace_back(new UINT(0));
+    QuantumCircuit circuit(1);
+    circuit.add_gate(new ClsCountingGate(0, count_list[0]));
+    circuit.add_noise_gate(gate::H(0), "BitFlip", 0.5);
+    circuit.add_gate(new ClsCountingGate(0, count_list[1]));
+    circuit.add_noise_gate(gate::H(0), "BitFlip", 0.5);
+    circuit.add_gate(new ClsCountingGate(0, count_list[2]));
+
+    NoiseSimulator sim(&circuit);
+    sim.set_checkpoint_memory_budget((size_t)1 << 20);
+    ASSERT_EQ(sim.execute(sample_count).size(), sample_count);
+    ASSERT_EQ(*count_list[0], 1U);
+    ASSERT_EQ(*count_list[1], 2U);
+    ASSERT_EQ(*count_list[2], 4U);
+
+    // the default keeps a single checkpoint at the shallowest branch
+    for (auto& count : count_list) *count = 0;
+    sim.set_checkpoint_memory_budget(0);
+    ASSERT_EQ(sim.execute(sample_count).size(), sample_count);
+    ASSERT_EQ(*count_list[0], 1U);
+    ASSERT_EQ(*count_list[1], 4U);
+    ASSERT_EQ(*count_list[2], 4U);
+}
+
+TEST(NoiseSimulatorTest, ExecuteStreamingTest) {
+    UINT n = 4;
+    QuantumCircuit circuit(n);
+    circuit.add_noise_gate(gate::H(0), "Depolarizing", 0.02);
+    circuit.add_noise_gate(gate::H(0), "Depolarizing", 0.02);
+    NoiseSimulator sim(&circuit);
+    UINT total = 0;
+    int cnts[2] = {};
+    sim.execute_streaming(10000, [&](const std::vector<ITYPE>& samples) {
+        ASSERT_FALSE(samples.empty());
+        total += (UINT)samples.size();
+        for (ITYPE sample : samples) cnts[sample & 1]++;
+    });
+    ASSERT_EQ(total, 10000);
+    ASSERT_NE(cnts[0], 0);
+    ASSERT_NE(cnts[1], 0);
+    ASSERT_GT(cnts[0], cnts[1]);
+}
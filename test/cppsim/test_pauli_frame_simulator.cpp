@@ -0,0 +1,69 @@
+#include <gtest/gtest.h>
+
+#include <cppsim/circuit.hpp>
+#include <cppsim/exception.hpp>
+#include <cppsim/gate_factory.hpp>
+#include <cppsim/noisesimulator.hpp>
+#include <cppsim/pauli_frame_simulator.hpp>
+#include <cppsim/state.hpp>
+
+#include "../util/util.hpp"
+
+TEST(PauliFrameSimulatorTest, PropagateErrorThroughClifford) {
+    // H Z H = X, and CNOT copies the bit flip to the target
+    const UINT n = 3, sample_count = 1000;
+    QuantumCircuit circuit(n);
+    circuit.add_H_gate(0);
+    circuit.add_gate(gate::DephasingNoise(0, 1.));
+    circuit.add_H_gate(0);
+    circuit.add_CNOT_gate(0, 1);
+    circuit.add_S_gate(2);
+    ASSERT_TRUE(PauliFrameSimulator::is_supported(&circuit));
+    PauliFrameSimulator sim(&circuit);
+    std::vector<ITYPE> result = sim.execute(sample_count);
+    ASSERT_EQ(result.size(), sample_count);
+    for (ITYPE sample : result) {
+        ASSERT_EQ(sample, 3);
+    }
+}
+
+TEST(PauliFrameSimulatorTest, CompareWithNoiseSimulator) {
+    const UINT n = 3, sample_count = 20000;
+    QuantumCircuit circuit(n);
+    circuit.add_noise_gate(gate::H(0), "Depolarizing", 0.1);
+    circuit.add_noise_gate(gate::CNOT(0, 1), "Depolarizing", 0.1);
+    circuit.add_noise_gate(gate::S(1), "BitFlip", 0.2);
+    circuit.add_noise_gate(gate::H(1), "Dephasing", 0.2);
+    circuit.add_noise_gate(gate::CZ(1, 2), "Depolarizing", 0.1);
+    circuit.add_noise_gate(gate::sqrtX(2), "IndependentXZ", 0.1);
+    circuit.add_noise_gate(gate::SWAP(0, 2), "Depolarizing", 0.1);
+    QuantumState state(n);
+    state.set_computational_basis(4);
+
+    PauliFrameSimulator frame_sim(&circuit, &state);
+    frame_sim.set_seed(0);
+    NoiseSimulator noise_sim(&circuit, &state);
+    std::vector<ITYPE> frame_result = frame_sim.execute(sample_count);
+    std::vector<ITYPE> noise_result = noise_sim.execute(sample_count);
+    ASSERT_EQ(frame_result.size(), sample_count);
+    std::vector<double> frame_hist(1ULL << n, 0.), noise_hist(1ULL << n, 0.);
+    for (UINT i = 0; i < sample_count; ++i) {
+        frame_hist[frame_result[i]] += 1. / sample_count;
+        noise_hist[noise_result[i]] += 1. / sample_count;
+    }
+    for (ITYPE i = 0; i < (1ULL << n); ++i) {
+        ASSERT_NEAR(frame_hist[i], noise_hist[i], 0.03);
+    }
+}
+
+TEST(PauliFrameSimulatorTest, RejectNonCliffordCircuit) {
+    QuantumCircuit circuit(2);
+    circuit.add_H_gate(0);
+    circuit.add_T_gate(0);
+    ASSERT_FALSE(PauliFrameSimulator::is_supported(&circuit));
+    ASSERT_THROW(PauliFrameSimulator sim(&circuit), NotImplementedException);
+
+    QuantumCircuit damping_circuit(2);
+    damping_circuit.add_noise_gate(gate::H(0), "AmplitudeDamping", 0.1);
+    ASSERT_FALSE(PauliFrameSimulator::is_supported(&damping_circuit));
+}
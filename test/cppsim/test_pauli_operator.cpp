@@ -1,7 +1,15 @@
 #include <gtest/gtest.h>
 
+#include <cppsim/circuit.hpp>
+#include <cppsim/general_quantum_operator.hpp>
 #include <cppsim/pauli_operator.hpp>
 #include <cppsim/state.hpp>
+#include <cppsim/state_dm.hpp>
+#include <cppsim/state_f32.hpp>
+#include <cppsim/state_stabilizer.hpp>
+#include <csim/stat_ops.hpp>
+#include <csim/stat_ops_dm.hpp>
+#include <csim/utility.hpp>
 
 TEST(PauliOperatorTest, ContainsExtraWhitespace) {
     PauliOperator expected = PauliOperator("X 0", 1.0);
@@ -73,6 +81,131 @@ TEST(PauliOperatorTest, PartedPauliString) {
         PauliOperator(Pauli_string, coef), InvalidPauliIdentifierException);
 }
 
+TEST(PauliOperatorTest, CachedPauliMasks) {
+    const UINT n = 5;
+    const double eps = 1e-10;
+    QuantumState state(n), state_bra(n);
+    state.set_Haar_random_state();
+    state_bra.set_Haar_random_state();
+    // a mixed state of the two states
+    DensityMatrix density_matrix(n), density_matrix_bra(n);
+    density_matrix.load(&state);
+    density_matrix_bra.load(&state_bra);
+    density_matrix.add_state(&density_matrix_bra);
+
+    auto check = [&](const PauliOperator& pauli) {
+        const auto index_list = pauli.get_index_list();
+        const auto pauli_id_list = pauli.get_pauli_id_list();
+        const UINT count = (UINT)index_list.size();
+        ITYPE bit_flip_mask, phase_flip_mask;
+        UINT global_phase_90rot_count, pivot_qubit_index;
+        ASSERT_TRUE(pauli.get_Pauli_masks(&bit_flip_mask, &phase_flip_mask,
+            &global_phase_90rot_count, &pivot_qubit_index));
+        ITYPE test_bit_flip_mask, test_phase_flip_mask;
+        UINT test_global_phase_90rot_count, test_pivot_qubit_index;
+        get_Pauli_masks_partial_list(index_list.data(), pauli_id_list.data(),
+            count, &test_bit_flip_mask, &test_phase_flip_mask,
+            &test_global_phase_90rot_count, &test_pivot_qubit_index);
+        ASSERT_EQ(bit_flip_mask, test_bit_flip_mask);
+        ASSERT_EQ(phase_flip_mask, test_phase_flip_mask);
+        ASSERT_EQ(global_phase_90rot_count, test_global_phase_90rot_count);
+        ASSERT_EQ(pivot_qubit_index, test_pivot_qubit_index);
+
+        const CPPCTYPE coef = pauli.get_coef();
+        const CPPCTYPE test_value =
+            coef * expectation_value_multi_qubit_Pauli_operator_partial_list(
+                       index_list.data(), pauli_id_list.data(), count,
+                       state.data_c(), state.dim);
+        ASSERT_NEAR(
+            std::abs(pauli.get_expectation_value(&state) - test_value), 0, eps);
+        ASSERT_NEAR(std::abs(pauli.get_expectation_value_single_thread(&state) -
+                             test_value),
+            0, eps);
+        const CPPCTYPE test_dm_value =
+            coef *
+            dm_expectation_value_multi_qubit_Pauli_operator_partial_list(
+                index_list.data(), pauli_id_list.data(), count,
+                density_matrix.data_c(), density_matrix.dim);
+        ASSERT_NEAR(std::abs(pauli.get_expectation_value(&density_matrix) -
+                             test_dm_value),
+            0, eps);
+        const CPPCTYPE test_amplitude =
+            coef * transition_amplitude_multi_qubit_Pauli_operator_partial_list(
+                       index_list.data(), pauli_id_list.data(), count,
+                       state_bra.data_c(), state.data_c(), state.dim);
+        ASSERT_NEAR(std::abs(pauli.get_transition_amplitude(&state_bra, &state) -
+                             test_amplitude),
+            0, eps);
+    };
+
+    for (const auto& pauli_string :
+        {"", "Z 1", "Z 0 Z 3 Z 4", "X 2", "Y 0", "X 0 Y 1 Z 2",
+            "Z 4 Y 3 X 2 Y 1", "Y 0 Y 1 Y 2 X 3 Z 4"}) {
+        check(PauliOperator(pauli_string, CPPCTYPE(0.5, -1.5)));
+    }
+    PauliOperator pauli("X 0 Y 1 Z 2", 2.0);
+    pauli *= PauliOperator("Y 0 Y 2 X 4", 1.0);
+    check(pauli);
+    pauli.add_single_Pauli(3, 2);
+    check(pauli);
+}
+
+TEST(PauliOperatorTest, ExpectationValueComputedByState) {
+    const UINT n = 4;
+    const double eps = 1e-5;
+    QuantumState state(n);
+    state.set_Haar_random_state();
+    QuantumStateCpuF32 state_f32(n);
+    state_f32.load(&state);
+    PauliOperator pauli("X 0 Y 2 Z 3", CPPCTYPE(0.5, -1.5));
+
+    ASSERT_FALSE(state.is_Pauli_expectation_computed_by_state());
+    ASSERT_THROW(state.get_Pauli_expectation_value(
+                     pauli.get_index_list(), pauli.get_pauli_id_list()),
+        NotImplementedException);
+    ASSERT_TRUE(state_f32.is_Pauli_expectation_computed_by_state());
+    const CPPCTYPE value = pauli.get_expectation_value(&state);
+    ASSERT_NEAR(std::abs(pauli.get_expectation_value(&state_f32) - value), 0,
+        eps);
+    ASSERT_NEAR(
+        std::abs(pauli.get_expectation_value_single_thread(&state_f32) - value),
+        0, eps);
+}
+
+TEST(PauliOperatorTest, PauliMasksAboveIndexRange) {
+    const UINT n = 101;
+    const double eps = 1e-10;
+    StabilizerState state(n);
+    QuantumCircuit circuit(n);
+    circuit.add_H_gate(70);
+    circuit.add_X_gate(100);
+    circuit.update_quantum_state(&state);
+
+    ITYPE bit_flip_mask, phase_flip_mask;
+    UINT global_phase_90rot_count, pivot_qubit_index;
+    PauliOperator pauli("Z 0 X 70 Z 100", 2.0);
+    ASSERT_FALSE(pauli.get_Pauli_masks(&bit_flip_mask, &phase_flip_mask,
+        &global_phase_90rot_count, &pivot_qubit_index));
+    ASSERT_NEAR(std::abs(pauli.get_expectation_value(&state) - (-2.)), 0, eps);
+    ASSERT_NEAR(
+        std::abs(pauli.get_expectation_value_single_thread(&state) - (-2.)),
+        0, eps);
+
+    // terms without masks are summed one by one
+    GeneralQuantumOperator op(n);
+    op.add_operator(&pauli);
+    op.add_operator(0.5, "Z 0 Z 1");
+    ASSERT_NEAR(std::abs(op.get_expectation_value(&state) - (-1.5)), 0, eps);
+
+    // the masks are rebuilt once the large indices cancel out
+    pauli *= PauliOperator("X 70 Z 100", 1.0);
+    ASSERT_TRUE(pauli.get_Pauli_masks(&bit_flip_mask, &phase_flip_mask,
+        &global_phase_90rot_count, &pivot_qubit_index));
+    ASSERT_EQ(bit_flip_mask, 0ULL);
+    ASSERT_EQ(phase_flip_mask, 1ULL);
+    ASSERT_NEAR(std::abs(pauli.get_expectation_value(&state) - 2.), 0, eps);
+}
+
 struct PauliTestParam {
     std::string test_name;
     PauliOperator op1;
@@ -2,6 +2,7 @@
 
 #include <cppsim/state.hpp>
 #include <cppsim/utility.hpp>
+#include <thread>
 
 #include "../util/util.hpp"
 
@@ -80,6 +81,99 @@ TEST(StateTest, SamplingSuperpositionState) {
     ASSERT_GE(pass_count, test_count - 1);
 }
 
+TEST(StateTest, SamplingAliasTable) {
+    const UINT n = 10;
+    const UINT nshot = 1024;
+    QuantumState state(n);
+    state.set_alias_sampling(true);
+    state.set_computational_basis(100);
+    for (auto value : state.sampling(nshot)) ASSERT_EQ(value, 100U);
+    // the cached table is discarded when the state is modified
+    state.set_computational_basis(5);
+    for (auto value : state.sampling(nshot)) ASSERT_EQ(value, 5U);
+}
+
+TEST(StateTest, LoadSharedStateFromThreads) {
+    const UINT n = 10;
+    const UINT thread_count = 8;
+    QuantumState state(n);
+    state.set_alias_sampling(true);
+    state.set_computational_basis(100);
+    state.sampling(16);
+
+    // the threads read the shared state, which clears its alias table
+    const QuantumState* shared_state = &state;
+    std::vector<double> overlap_list(thread_count);
+    std::vector<std::thread> thread_list;
+    for (UINT thread_index = 0; thread_index < thread_count; ++thread_index) {
+        thread_list.emplace_back([&, thread_index]() {
+            QuantumState buffer(n);
+            for (UINT rep = 0; rep < 100; ++rep) buffer.load(shared_state);
+            overlap_list[thread_index] =
+                abs(state::inner_product(&buffer, shared_state));
+        });
+    }
+    for (auto& thread : thread_list) thread.join();
+    for (double overlap : overlap_list) ASSERT_NEAR(overlap, 1., eps);
+    for (auto value : state.sampling(16)) ASSERT_EQ(value, 100U);
+}
+
+TEST(StateTest, SamplingDistribution) {
+    const UINT n = 14;
+    const UINT nshot = 100000;
+    QuantumState state(n);
+    state.set_Haar_random_state(0);
+    // probability 1/2 on the basis states below dim/4
+    for (ITYPE i = 0; i < state.dim; ++i) {
+        state.data_cpp()[i] = (i < state.dim / 4) ? sqrt(2. / state.dim)
+                                                  : sqrt(2. / 3 / state.dim);
+    }
+    for (bool use_alias_table : {false, true}) {
+        state.set_alias_sampling(use_alias_table);
+        auto res = state.sampling(nshot, 1);
+        ASSERT_EQ(res.size(), nshot);
+        UINT count = 0;
+        for (auto value : res) {
+            ASSERT_LT(value, state.dim);
+            if (value < state.dim / 4) ++count;
+        }
+        ASSERT_NEAR((double)count / nshot, 0.5, 0.01);
+        // samples are not sorted
+        ASSERT_FALSE(std::is_sorted(res.begin(), res.end()));
+    }
+}
+
+TEST(StateTest, SamplingTargetQubits) {
+    const UINT n = 10;
+    const UINT nshot = 1024;
+    QuantumState state(n);
+    state.set_computational_basis(0b0001001001);
+    std::vector<UINT> target_list = {6, 0, 4};
+    for (auto value : state.sampling(nshot, target_list)) {
+        ASSERT_EQ(value, 0b011U);
+    }
+
+    state.set_Haar_random_state(0);
+    auto distribution = state.get_marginal_distribution(target_list);
+    ASSERT_EQ(distribution.size(), 8U);
+    for (ITYPE outcome = 0; outcome < distribution.size(); ++outcome) {
+        std::vector<UINT> measured_values(n, 2);
+        for (UINT i = 0; i < target_list.size(); ++i) {
+            measured_values[target_list[i]] = (outcome >> i) & 1;
+        }
+        ASSERT_NEAR(distribution[outcome],
+            state.get_marginal_probability(measured_values), eps);
+    }
+    auto res = state.sampling(nshot, target_list, 0);
+    ASSERT_EQ(res, state.sampling(nshot, target_list, 0));
+    for (auto value : res) ASSERT_LT(value, 8U);
+
+    ASSERT_THROW(state.sampling(nshot, std::vector<UINT>{0, n}),
+        QubitIndexOutOfRangeException);
+    ASSERT_THROW(state.sampling(nshot, std::vector<UINT>{1, 1}),
+        DuplicatedQubitIndexException);
+}
+
 TEST(StateTest, SetState) {
     const UINT n = 10;
     QuantumState state(n);
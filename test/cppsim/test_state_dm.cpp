@@ -58,6 +58,22 @@ TEST(DensityMatrixTest, Sampling) {
     state.set_computational_basis(10);
     auto res2 = state.sampling(1024);
 }
+TEST(DensityMatrixTest, SamplingTargetQubits) {
+    const UINT n = 5;
+    QuantumState state(n);
+    state.set_Haar_random_state(0);
+    DensityMatrix dm(n);
+    dm.load(&state);
+    std::vector<UINT> target_list = {3, 1};
+    auto distribution = dm.get_marginal_distribution(target_list);
+    auto expected = state.get_marginal_distribution(target_list);
+    for (ITYPE outcome = 0; outcome < distribution.size(); ++outcome) {
+        ASSERT_NEAR(distribution[outcome], expected[outcome], eps);
+    }
+    dm.set_computational_basis(0b01010);
+    for (auto value : dm.sampling(100, target_list)) ASSERT_EQ(value, 0b11U);
+}
+
 TEST(DensityMatrixTest, Probabilistic) {
     DensityMatrix state_noI(2);
     DensityMatrix state_yesI(2);
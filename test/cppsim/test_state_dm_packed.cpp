@@ -0,0 +1,130 @@
+#include <gtest/gtest.h>
+
+#include <cppsim/circuit.hpp>
+#include <cppsim/exception.hpp>
+#include <cppsim/gate_factory.hpp>
+#include <cppsim/gate_merge.hpp>
+#include <cppsim/observable.hpp>
+#include <cppsim/state.hpp>
+#include <cppsim/state_dm.hpp>
+#include <cppsim/state_dm_packed.hpp>
+#include <cppsim/utility.hpp>
+
+#include "../util/util.hpp"
+
+static void assert_same_density_matrix(
+    const PackedDensityMatrix& packed, const DensityMatrix& dm) {
+    CPPCTYPE* unpacked = packed.duplicate_data_cpp();
+    for (ITYPE i = 0; i < dm.dim * dm.dim; ++i) {
+        ASSERT_NEAR(abs(unpacked[i] - dm.data_cpp()[i]), 0., eps);
+    }
+    free(unpacked);
+}
+
+TEST(PackedDensityMatrixTest, GenerateAndLoad) {
+    const UINT n = 4;
+    PackedDensityMatrix packed(n);
+    DensityMatrix dm(n);
+    assert_same_density_matrix(packed, dm);
+    packed.set_computational_basis(5);
+    dm.set_computational_basis(5);
+    assert_same_density_matrix(packed, dm);
+
+    QuantumState state(n);
+    state.set_Haar_random_state(1);
+    packed.load(&state);
+    dm.load(&state);
+    assert_same_density_matrix(packed, dm);
+    ASSERT_NEAR(packed.get_squared_norm(), 1., eps);
+
+    DensityMatrix mixture(n);
+    mixture.set_Haar_random_state(2);
+    mixture.multiply_coef(0.5);
+    mixture.add_state_with_coef(0.5, &dm);
+    packed.load(&mixture);
+    assert_same_density_matrix(packed, mixture);
+    dm.load(&packed);
+    assert_same_density_matrix(packed, dm);
+
+    PackedDensityMatrix* copied = packed.copy();
+    assert_same_density_matrix(*copied, dm);
+    QuantumStateBase* restored = state::from_ptree(packed.to_ptree());
+    assert_same_density_matrix(
+        *dynamic_cast<PackedDensityMatrix*>(restored), dm);
+    delete copied;
+    delete restored;
+
+    ASSERT_THROW(packed.data_cpp(), NotImplementedException);
+    ASSERT_THROW(
+        packed.multiply_coef(CPPCTYPE(0., 1.)), NonHermitianException);
+    ASSERT_THROW(
+        packed.add_state(&state), InoperatableQuantumStateTypeException);
+}
+
+TEST(PackedDensityMatrixTest, CompareWithDensityMatrix) {
+    const UINT n = 5, depth = 4;
+    Random random;
+    random.set_seed(3);
+    for (UINT repeat = 0; repeat < 5; ++repeat) {
+        QuantumCircuit circuit(n);
+        for (UINT d = 0; d < depth; ++d) {
+            for (UINT i = 0; i < n; ++i) {
+                const UINT j = (i + 1 + random.int32() % (n - 1)) % n;
+                const UINT k = (j + 1 + random.int32() % (n - 1)) % n;
+                switch (random.int32() % 8) {
+                    case 0: circuit.add_H_gate(i); break;
+                    case 1: circuit.add_RX_gate(i, random.uniform()); break;
+                    case 2: circuit.add_CNOT_gate(i, j); break;
+                    case 3: circuit.add_random_unitary_gate({i, j}); break;
+                    case 4: {
+                        if (k == i) break;
+                        auto gate = gate::to_matrix_gate(gate::RY(i, 0.3));
+                        gate->add_control_qubit(j, 1);
+                        gate->add_control_qubit(k, 0);
+                        circuit.add_gate(gate);
+                        break;
+                    }
+                    case 5:
+                        circuit.add_gate(gate::DepolarizingNoise(i, 0.1));
+                        break;
+                    case 6:
+                        circuit.add_gate(gate::AmplitudeDampingNoise(i, 0.2));
+                        break;
+                    default: circuit.add_gate(gate::Measurement(i, i)); break;
+                }
+            }
+        }
+        PackedDensityMatrix packed(n);
+        DensityMatrix dm(n);
+        packed.set_Haar_random_state(repeat);
+        dm.set_Haar_random_state(repeat);
+        circuit.update_quantum_state(&packed);
+        circuit.update_quantum_state(&dm);
+        assert_same_density_matrix(packed, dm);
+
+        ASSERT_NEAR(packed.get_squared_norm(), dm.get_squared_norm(), eps);
+        ASSERT_NEAR(packed.get_entropy(), dm.get_entropy(), eps);
+        for (UINT i = 0; i < n; ++i) {
+            ASSERT_NEAR(packed.get_zero_probability(i),
+                dm.get_zero_probability(i), eps);
+        }
+        std::vector<UINT> measured_values(n);
+        for (UINT i = 0; i < n; ++i) measured_values[i] = random.int32() % 3;
+        ASSERT_NEAR(packed.get_marginal_probability(measured_values),
+            dm.get_marginal_probability(measured_values), eps);
+
+        Observable observable(n);
+        observable.add_random_operator(10, random.int32());
+        ASSERT_NEAR(abs(observable.get_expectation_value(&packed) -
+                        observable.get_expectation_value(&dm)),
+            0., eps);
+
+        std::vector<UINT> traced = {1, 3};
+        PackedDensityMatrix* packed_reduced =
+            state::partial_trace(&packed, traced);
+        DensityMatrix* reduced = state::partial_trace(&dm, traced);
+        assert_same_density_matrix(*packed_reduced, *reduced);
+        delete packed_reduced;
+        delete reduced;
+    }
+}
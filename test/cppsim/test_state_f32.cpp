@@ -0,0 +1,150 @@
+#include <gtest/gtest.h>
+
+#include <cppsim/circuit.hpp>
+#include <cppsim/gate_factory.hpp>
+#include <cppsim/gate_matrix.hpp>
+#include <cppsim/observable.hpp>
+#include <cppsim/state.hpp>
+#include <cppsim/state_dm.hpp>
+#include <cppsim/state_f32.hpp>
+#include <cppsim/utility.hpp>
+
+#include "../util/util.hpp"
+
+// tolerance of single-precision states compared with double-precision ones
+static const double eps_f32 = 1e-5;
+
+static void assert_state_near(
+    const QuantumStateCpuF32& state_f32, const QuantumState& state) {
+    CPPCTYPE* converted = state_f32.duplicate_data_cpp();
+    for (ITYPE i = 0; i < state.dim; ++i) {
+        ASSERT_NEAR(converted[i].real(), state.data_cpp()[i].real(), eps_f32);
+        ASSERT_NEAR(converted[i].imag(), state.data_cpp()[i].imag(), eps_f32);
+    }
+    free(converted);
+}
+
+TEST(StateF32Test, ConvertFromAndToDouble) {
+    const UINT n = 8;
+    QuantumState state(n);
+    state.set_Haar_random_state(0);
+    state.set_classical_value(0, 1);
+
+    QuantumStateCpuF32* state_f32 = state::to_single_precision(&state);
+    ASSERT_EQ(state_f32->get_classical_value(0), 1U);
+    assert_state_near(*state_f32, state);
+    ASSERT_NEAR(state_f32->get_squared_norm(), 1., eps_f32);
+    ASSERT_NEAR(state_f32->get_entropy(), state.get_entropy(), eps_f32);
+    ASSERT_NEAR(state_f32->get_zero_probability(3),
+        state.get_zero_probability(3), eps_f32);
+
+    QuantumState* state_converted = state_f32->to_double_precision();
+    ASSERT_EQ(state_converted->get_classical_value(0), 1U);
+    for (ITYPE i = 0; i < state.dim; ++i) {
+        ASSERT_NEAR(
+            abs(state_converted->data_cpp()[i] - state.data_cpp()[i]), 0,
+            eps_f32);
+    }
+    ASSERT_THROW(state_f32->data_c(), NotImplementedException);
+
+    QuantumStateCpuF32* state_copy = state_f32->copy();
+    ASSERT_NEAR(
+        abs(state::inner_product(state_copy, state_f32) - 1.), 0, eps_f32);
+    delete state_copy;
+    delete state_converted;
+    delete state_f32;
+}
+
+TEST(StateF32Test, SamplingMatchesDouble) {
+    const UINT n = 8;
+    const UINT nshot = 1024;
+    QuantumState state(n);
+    state.set_Haar_random_state(1);
+    QuantumStateCpuF32* state_f32 = state::to_single_precision(&state);
+
+    // the same random numbers are assigned to the same basis indices except
+    // near the boundaries shifted by the rounding of single precision
+    auto result = state.sampling(nshot, 2);
+    auto result_f32 = state_f32->sampling(nshot, 2);
+    UINT mismatch_count = 0;
+    for (UINT i = 0; i < nshot; ++i) {
+        ASSERT_LT(result_f32[i], state.dim);
+        if (result_f32[i] != result[i]) ++mismatch_count;
+    }
+    ASSERT_LE(mismatch_count, 2U);
+    delete state_f32;
+}
+
+TEST(StateF32Test, CircuitMatchesDouble) {
+    const UINT n = 6;
+    QuantumState state(n);
+    state.set_Haar_random_state(1);
+    QuantumStateCpuF32 state_f32(n);
+    state_f32.load(&state);
+
+    Random random;
+    random.set_seed(2);
+    QuantumCircuit circuit(n);
+    for (UINT rep = 0; rep < 3; ++rep) {
+        for (UINT i = 0; i < n; ++i) {
+            circuit.add_H_gate(i);
+            circuit.add_T_gate(i);
+            circuit.add_RX_gate(i, random.uniform() * 3.);
+            circuit.add_RZ_gate(i, random.uniform() * 3.);
+        }
+        circuit.add_X_gate(0);
+        circuit.add_Y_gate(1);
+        circuit.add_Z_gate(2);
+        circuit.add_S_gate(3);
+        circuit.add_Sdag_gate(4);
+        circuit.add_Tdag_gate(5);
+        circuit.add_CNOT_gate(0, 3);
+        circuit.add_CZ_gate(4, 1);
+        circuit.add_SWAP_gate(2, 5);
+        circuit.add_gate(gate::Pauli({0, 2, 5}, {1, 2, 3}));
+        circuit.add_gate(
+            gate::PauliRotation({1, 3, 4}, {3, 1, 2}, random.uniform()));
+        circuit.add_gate(gate::RandomUnitary({2, 4}));
+        auto controlled = gate::RandomUnitary({1, 5});
+        controlled->add_control_qubit(3, 0);
+        circuit.add_gate(controlled);
+        circuit.add_gate(gate::DiagonalMatrix(
+            {0, 4}, get_eigen_diagonal_matrix_random_multi_qubit_unitary(2)));
+    }
+
+    circuit.update_quantum_state(&state);
+    circuit.update_quantum_state(&state_f32);
+    assert_state_near(state_f32, state);
+    ASSERT_NEAR(state_f32.get_squared_norm(), 1., eps_f32);
+
+    Observable observable(n);
+    observable.add_random_operator(10, 3);
+    CPPCTYPE value = observable.get_expectation_value(&state);
+    CPPCTYPE value_f32 = observable.get_expectation_value(&state_f32);
+    ASSERT_NEAR(value_f32.real(), value.real(), eps_f32);
+    ASSERT_NEAR(value_f32.imag(), value.imag(), eps_f32);
+
+    // unsupported gates are rejected before any gate is applied
+    QuantumCircuit measurement_circuit(n);
+    measurement_circuit.add_H_gate(0);
+    measurement_circuit.add_gate(gate::Measurement(0, 0));
+    ASSERT_FALSE(state_f32.is_supported_gate(measurement_circuit.gate_list[1]));
+    ASSERT_THROW(measurement_circuit.update_quantum_state(&state_f32),
+        NotImplementedException);
+    assert_state_near(state_f32, state);
+}
+
+TEST(StateF32Test, PtreeRoundTrip) {
+    const UINT n = 4;
+    QuantumStateCpuF32 state_f32(n);
+    state_f32.set_Haar_random_state(3);
+    state_f32.set_classical_value(0, 1);
+
+    QuantumStateBase* restored = state::from_ptree(state_f32.to_ptree());
+    auto restored_f32 = dynamic_cast<QuantumStateCpuF32*>(restored);
+    ASSERT_NE(restored_f32, nullptr);
+    ASSERT_EQ(restored_f32->get_classical_value(0), 1U);
+    ASSERT_NEAR(
+        abs(state::inner_product(restored_f32, &state_f32) - 1.), 0, eps_f32);
+    delete restored;
+}
@@ -0,0 +1,207 @@
+#include <gtest/gtest.h>
+
+#include <cppsim/circuit.hpp>
+#include <cppsim/exception.hpp>
+#include <cppsim/gate_factory.hpp>
+#include <cppsim/gate_merge.hpp>
+#include <cppsim/observable.hpp>
+#include <cppsim/pauli_operator.hpp>
+#include <cppsim/state.hpp>
+#include <cppsim/state_dm.hpp>
+#include <cppsim/state_mps.hpp>
+#include <cppsim/utility.hpp>
+
+#include "../util/util.hpp"
+
+static QuantumCircuit* get_random_circuit(UINT n, UINT depth, Random& random) {
+    QuantumCircuit* circuit = new QuantumCircuit(n);
+    for (UINT d = 0; d < depth; ++d) {
+        for (UINT i = 0; i < n; ++i) {
+            const UINT j = (i + 1 + random.int32() % (n - 1)) % n;
+            const UINT k = (j + 1 + random.int32() % (n - 1)) % n;
+            switch (random.int32() % 9) {
+                case 0: circuit->add_H_gate(i); break;
+                case 1: circuit->add_T_gate(i); break;
+                case 2: circuit->add_RX_gate(i, random.uniform()); break;
+                case 3: circuit->add_RY_gate(i, random.uniform()); break;
+                case 4: circuit->add_CNOT_gate(i, j); break;
+                case 5: circuit->add_CZ_gate(i, j); break;
+                case 6: circuit->add_random_unitary_gate({i, j}); break;
+                case 7: {
+                    if (k == i) break;
+                    auto gate = gate::to_matrix_gate(gate::H(i));
+                    gate->add_control_qubit(j, 1);
+                    gate->add_control_qubit(k, 0);
+                    circuit->add_gate(gate);
+                    break;
+                }
+                default: circuit->add_SWAP_gate(i, j); break;
+            }
+        }
+    }
+    return circuit;
+}
+
+TEST(MatrixProductStateTest, CompareWithStateVector) {
+    const UINT n = 6, depth = 6;
+    Random random;
+    random.set_seed(1);
+    for (UINT repeat = 0; repeat < 10; ++repeat) {
+        QuantumCircuit* circuit = get_random_circuit(n, depth, random);
+        QuantumState state(n);
+        MatrixProductState mps(n);
+        const ITYPE basis = random.int32() % (1ULL << n);
+        state.set_computational_basis(basis);
+        mps.set_computational_basis(basis);
+        circuit->update_quantum_state(&state);
+        circuit->update_quantum_state(&mps);
+
+        ASSERT_NEAR(mps.get_truncation_error(), 0., eps);
+        ASSERT_NEAR(mps.get_squared_norm(), 1., eps);
+        CPPCTYPE* amplitudes = mps.duplicate_data_cpp();
+        for (ITYPE i = 0; i < state.dim; ++i) {
+            ASSERT_NEAR(abs(amplitudes[i] - state.data_cpp()[i]), 0., eps);
+        }
+        free(amplitudes);
+
+        for (UINT i = 0; i < n; ++i) {
+            ASSERT_NEAR(mps.get_zero_probability(i),
+                state.get_zero_probability(i), eps);
+        }
+        std::vector<UINT> measured_values(n);
+        for (UINT i = 0; i < n; ++i) measured_values[i] = random.int32() % 3;
+        ASSERT_NEAR(mps.get_marginal_probability(measured_values),
+            state.get_marginal_probability(measured_values), eps);
+
+        Observable observable(n);
+        observable.add_random_operator(10, random.int32());
+        ASSERT_NEAR(abs(observable.get_expectation_value(&mps) -
+                        observable.get_expectation_value(&state)),
+            0., eps);
+        delete circuit;
+    }
+}
+
+TEST(MatrixProductStateTest, LoadStateVector) {
+    const UINT n = 7;
+    QuantumState state(n);
+    state.set_Haar_random_state(2);
+    MatrixProductState mps(n);
+    mps.load(&state);
+    ASSERT_NEAR(mps.get_truncation_error(), 0., eps);
+    CPPCTYPE* amplitudes = mps.duplicate_data_cpp();
+    for (ITYPE i = 0; i < state.dim; ++i) {
+        ASSERT_NEAR(abs(amplitudes[i] - state.data_cpp()[i]), 0., eps);
+    }
+    free(amplitudes);
+
+    // a bond dimension of 2 cannot hold a random state
+    MatrixProductState truncated_mps(n, 2);
+    truncated_mps.load(&state);
+    for (UINT bond_dimension : truncated_mps.get_bond_dimension_list()) {
+        ASSERT_LE(bond_dimension, 2U);
+    }
+    ASSERT_GT(truncated_mps.get_truncation_error(), 0.);
+    ASSERT_NEAR(truncated_mps.get_squared_norm(), 1., eps);
+}
+
+TEST(MatrixProductStateTest, LoadToStateVector) {
+    const UINT n = 5;
+    QuantumState state(n);
+    state.set_Haar_random_state(4);
+    MatrixProductState mps(n);
+    mps.load(&state);
+
+    // the other states read the contracted state vector of mps
+    QuantumState loaded_state(n);
+    loaded_state.load(&mps);
+    DensityMatrix loaded_density_matrix(n);
+    loaded_density_matrix.load(&mps);
+    for (ITYPE i = 0; i < state.dim; ++i) {
+        ASSERT_NEAR(
+            abs(loaded_state.data_cpp()[i] - state.data_cpp()[i]), 0., eps);
+        for (ITYPE j = 0; j < state.dim; ++j) {
+            const CPPCTYPE expected =
+                state.data_cpp()[i] * conj(state.data_cpp()[j]);
+            ASSERT_NEAR(
+                abs(loaded_density_matrix.data_cpp()[i * state.dim + j] -
+                    expected),
+                0., eps);
+        }
+    }
+}
+
+TEST(MatrixProductStateTest, TruncateRandomCircuit) {
+    const UINT n = 10, depth = 10;
+    Random random;
+    random.set_seed(3);
+    QuantumCircuit* circuit = get_random_circuit(n, depth, random);
+    QuantumState state(n);
+    MatrixProductState mps(n, 4);
+    state.set_zero_state();
+    circuit->update_quantum_state(&state);
+    circuit->update_quantum_state(&mps);
+
+    for (UINT bond_dimension : mps.get_bond_dimension_list()) {
+        ASSERT_LE(bond_dimension, 4U);
+    }
+    const double truncation_error = mps.get_truncation_error();
+    ASSERT_GT(truncation_error, 0.);
+    ASSERT_NEAR(mps.get_squared_norm(), 1., eps);
+    CPPCTYPE* amplitudes = mps.duplicate_data_cpp();
+    CPPCTYPE overlap = 0.;
+    for (ITYPE i = 0; i < state.dim; ++i) {
+        overlap += std::conj(state.data_cpp()[i]) * amplitudes[i];
+    }
+    free(amplitudes);
+    const double fidelity = std::norm(overlap);
+    ASSERT_LE(fidelity, 1. + eps);
+    ASSERT_GT(fidelity, 0.);
+    delete circuit;
+}
+
+TEST(MatrixProductStateTest, InvalidTruncationParameter) {
+    MatrixProductState mps(4);
+    ASSERT_THROW(
+        mps.set_max_bond_dimension(0), InvalidTruncationParameterException);
+    ASSERT_THROW(mps.set_truncation_threshold(-1.),
+        InvalidTruncationParameterException);
+}
+
+TEST(MatrixProductStateTest, LargeGHZState) {
+    const UINT n = 100;
+    QuantumCircuit circuit(n);
+    circuit.add_H_gate(0);
+    for (UINT i = 0; i + 1 < n; ++i) circuit.add_CNOT_gate(i, i + 1);
+    circuit.add_CZ_gate(0, n - 1);
+    MatrixProductState mps(n);
+    circuit.update_quantum_state(&mps);
+    for (UINT bond_dimension : mps.get_bond_dimension_list()) {
+        ASSERT_EQ(bond_dimension, 2U);
+    }
+    ASSERT_NEAR(mps.get_truncation_error(), 0., eps);
+
+    PauliOperator zz("Z 0 Z " + std::to_string(n - 1));
+    ASSERT_NEAR(zz.get_expectation_value(&mps).real(), 1., eps);
+    std::vector<UINT> index_list(n), x_list(n, 1);
+    for (UINT i = 0; i < n; ++i) index_list[i] = i;
+    PauliOperator all_x(index_list, x_list);
+    ASSERT_NEAR(all_x.get_expectation_value(&mps).real(), -1., eps);
+    ASSERT_NEAR(mps.get_zero_probability(n / 2), 0.5, eps);
+    ASSERT_THROW(mps.sampling(10), InvalidQubitCountException);
+
+    const UINT m = 60;
+    MatrixProductState small_mps(m);
+    QuantumCircuit small_circuit(m);
+    small_circuit.add_H_gate(0);
+    for (UINT i = 0; i + 1 < m; ++i) small_circuit.add_CNOT_gate(i, i + 1);
+    small_circuit.update_quantum_state(&small_mps);
+    const ITYPE all_one = (1ULL << m) - 1;
+    UINT one_count = 0;
+    for (ITYPE sample : small_mps.sampling(1000, 4)) {
+        ASSERT_TRUE(sample == 0 || sample == all_one);
+        if (sample == all_one) ++one_count;
+    }
+    ASSERT_GT(one_count, 400U);
+    ASSERT_LT(one_count, 600U);
+}
@@ -0,0 +1,130 @@
+#include <gtest/gtest.h>
+
+#include <cppsim/circuit.hpp>
+#include <cppsim/exception.hpp>
+#include <cppsim/gate_factory.hpp>
+#include <cppsim/pauli_operator.hpp>
+#include <cppsim/state.hpp>
+#include <cppsim/state_stabilizer.hpp>
+#include <cppsim/utility.hpp>
+
+#include "../util/util.hpp"
+
+static QuantumCircuit* get_random_Clifford_circuit(
+    UINT n, UINT depth, Random& random) {
+    QuantumCircuit* circuit = new QuantumCircuit(n);
+    for (UINT d = 0; d < depth; ++d) {
+        for (UINT i = 0; i < n; ++i) {
+            const UINT j = (i + 1 + random.int32() % (n - 1)) % n;
+            switch (random.int32() % 13) {
+                case 0: circuit->add_H_gate(i); break;
+                case 1: circuit->add_S_gate(i); break;
+                case 2: circuit->add_Sdag_gate(i); break;
+                case 3: circuit->add_X_gate(i); break;
+                case 4: circuit->add_Y_gate(i); break;
+                case 5: circuit->add_Z_gate(i); break;
+                case 6: circuit->add_sqrtX_gate(i); break;
+                case 7: circuit->add_sqrtXdag_gate(i); break;
+                case 8: circuit->add_sqrtY_gate(i); break;
+                case 9: circuit->add_sqrtYdag_gate(i); break;
+                case 10: circuit->add_CNOT_gate(i, j); break;
+                case 11: circuit->add_CZ_gate(i, j); break;
+                default: circuit->add_SWAP_gate(i, j); break;
+            }
+        }
+    }
+    return circuit;
+}
+
+TEST(StabilizerStateTest, CompareWithStateVector) {
+    const UINT n = 5, depth = 10;
+    Random random;
+    random.set_seed(1);
+    for (UINT repeat = 0; repeat < 20; ++repeat) {
+        QuantumCircuit* circuit = get_random_Clifford_circuit(n, depth, random);
+        QuantumState state(n);
+        StabilizerState stabilizer_state(n);
+        const ITYPE basis = random.int32() % (1ULL << n);
+        state.set_computational_basis(basis);
+        stabilizer_state.set_computational_basis(basis);
+        circuit->update_quantum_state(&state);
+        circuit->update_quantum_state(&stabilizer_state);
+
+        for (UINT i = 0; i < n; ++i) {
+            ASSERT_NEAR(stabilizer_state.get_zero_probability(i),
+                state.get_zero_probability(i), eps);
+        }
+        std::vector<UINT> measured_values(n);
+        for (UINT i = 0; i < n; ++i) measured_values[i] = random.int32() % 3;
+        ASSERT_NEAR(stabilizer_state.get_marginal_probability(measured_values),
+            state.get_marginal_probability(measured_values), eps);
+        ASSERT_NEAR(stabilizer_state.get_entropy(), state.get_entropy(), 1e-6);
+
+        for (UINT k = 0; k < 10; ++k) {
+            std::vector<UINT> index_list, pauli_id_list;
+            for (UINT i = 0; i < n; ++i) {
+                index_list.push_back(i);
+                pauli_id_list.push_back(random.int32() % 4);
+            }
+            PauliOperator pauli(index_list, pauli_id_list, 2.);
+            ASSERT_NEAR(pauli.get_expectation_value(&stabilizer_state).real(),
+                pauli.get_expectation_value(&state).real(), eps);
+        }
+        delete circuit;
+    }
+}
+
+TEST(StabilizerStateTest, LargeGHZState) {
+    const UINT n = 2000;
+    QuantumCircuit circuit(n);
+    circuit.add_H_gate(0);
+    for (UINT i = 0; i + 1 < n; ++i) circuit.add_CNOT_gate(i, i + 1);
+    StabilizerState state(n);
+    ASSERT_FALSE(state.is_state_vector());
+    ASSERT_EQ(state.dim, 0ULL);
+    circuit.update_quantum_state(&state);
+
+    ASSERT_NEAR(state.get_zero_probability(n - 1), 0.5, 1e-10);
+    std::vector<UINT> index_list, x_list(n, 1);
+    for (UINT i = 0; i < n; ++i) index_list.push_back(i);
+    PauliOperator all_X(index_list, x_list);
+    ASSERT_NEAR(all_X.get_expectation_value(&state).real(), 1., 1e-10);
+    PauliOperator z_pair(
+        std::vector<UINT>{0, n - 1}, std::vector<UINT>{3, 3});
+    ASSERT_NEAR(z_pair.get_expectation_value(&state).real(), 1., 1e-10);
+    PauliOperator single_z(std::vector<UINT>{n / 2}, std::vector<UINT>{3});
+    ASSERT_NEAR(single_z.get_expectation_value(&state).real(), 0., 1e-10);
+
+    const UINT outcome = state.measure(n / 2);
+    for (UINT i = 0; i < n; i += 97) {
+        ASSERT_NEAR(state.get_zero_probability(i), outcome ? 0. : 1., 1e-10);
+    }
+    ASSERT_THROW(state.sampling(1), InvalidQubitCountException);
+}
+
+TEST(StabilizerStateTest, SamplingGHZState) {
+    const UINT n = 10;
+    QuantumCircuit circuit(n);
+    circuit.add_H_gate(0);
+    for (UINT i = 0; i + 1 < n; ++i) circuit.add_CNOT_gate(i, i + 1);
+    StabilizerState state(n);
+    circuit.update_quantum_state(&state);
+    std::vector<ITYPE> result = state.sampling(1000, 0);
+    UINT count = 0;
+    for (ITYPE sample : result) {
+        ASSERT_TRUE(sample == 0 || sample == (1ULL << n) - 1);
+        if (sample == 0) ++count;
+    }
+    ASSERT_GT(count, 400);
+    ASSERT_LT(count, 600);
+    // sampling does not change the state
+    ASSERT_NEAR(state.get_zero_probability(0), 0.5, 1e-10);
+}
+
+TEST(StabilizerStateTest, RejectNonCliffordGate) {
+    QuantumCircuit circuit(2);
+    circuit.add_T_gate(0);
+    StabilizerState state(2);
+    ASSERT_THROW(
+        circuit.update_quantum_state(&state), NotImplementedException);
+}
@@ -0,0 +1,86 @@
+#include <gtest/gtest.h>
+
+#include <cppsim/circuit.hpp>
+#include <cppsim/exception.hpp>
+#include <cppsim/gate_factory.hpp>
+#include <cppsim/observable.hpp>
+#include <cppsim/state.hpp>
+#include <cppsim/state_dm.hpp>
+#include <cppsim/trajectory_ensemble.hpp>
+
+#include "../util/util.hpp"
+
+static QuantumCircuit* create_noisy_circuit(UINT n) {
+    QuantumCircuit* circuit = new QuantumCircuit(n);
+    for (UINT i = 0; i < n; ++i) {
+        circuit->add_H_gate(i);
+        circuit->add_RY_gate(i, 0.3 * (i + 1));
+    }
+    for (UINT i = 0; i + 1 < n; ++i) {
+        circuit->add_CNOT_gate(i, i + 1);
+        circuit->add_gate(gate::DepolarizingNoise(i, 0.1));
+        circuit->add_gate(gate::AmplitudeDampingNoise(i + 1, 0.2));
+    }
+    for (UINT i = 0; i < n; ++i) {
+        circuit->add_gate(gate::BitFlipNoise(i, 0.05));
+        circuit->add_RX_gate(i, 0.7);
+    }
+    return circuit;
+}
+
+TEST(TrajectoryEnsembleTest, CompareWithDensityMatrix) {
+    const UINT n = 4;
+    QuantumCircuit* circuit = create_noisy_circuit(n);
+    Observable observable(n);
+    observable.add_operator(1.0, "Z 0 Z 1");
+    observable.add_operator(0.5, "X 2");
+    observable.add_operator(-0.8, "Z 3");
+
+    DensityMatrix dm(n);
+    dm.set_zero_state();
+    circuit->update_quantum_state(&dm);
+    const double exact = observable.get_expectation_value(&dm).real();
+
+    TrajectoryEnsemble ensemble(circuit);
+    ensemble.set_seed(1);
+    const auto result = ensemble.estimate(&observable, 4000);
+    ASSERT_EQ(result.trajectory_count, 4000U);
+    ASSERT_GT(result.standard_error, 0.);
+    ASSERT_LT(std::abs(result.mean - exact), 5 * result.standard_error);
+
+    // the same seed gives the same estimate
+    ensemble.set_seed(1);
+    const auto repeated = ensemble.estimate(&observable, 4000);
+    ASSERT_NEAR(repeated.mean, result.mean, eps);
+    delete circuit;
+}
+
+TEST(TrajectoryEnsembleTest, StopAtTargetStandardError) {
+    const UINT n = 3;
+    QuantumCircuit* circuit = create_noisy_circuit(n);
+    Observable observable(n);
+    observable.add_operator(1.0, "Z 0 Z 2");
+
+    QuantumState initial_state(n);
+    initial_state.set_computational_basis(5);
+    DensityMatrix dm(n);
+    dm.load(&initial_state);
+    circuit->update_quantum_state(&dm);
+    const double exact = observable.get_expectation_value(&dm).real();
+
+    TrajectoryEnsemble ensemble(circuit, &initial_state);
+    ensemble.set_seed(2);
+    const double target = 0.02;
+    const UINT batch_size = 50;
+    const auto result =
+        ensemble.estimate(&observable, 1000000, target, batch_size);
+    ASSERT_LE(result.standard_error, target);
+    ASSERT_LT(result.trajectory_count, 1000000U);
+    ASSERT_EQ(result.trajectory_count % batch_size, 0U);
+    ASSERT_LT(std::abs(result.mean - exact), 5 * target);
+
+    Observable invalid_observable(n + 1);
+    ASSERT_THROW(ensemble.estimate(&invalid_observable, 10),
+        InvalidQubitCountException);
+    delete circuit;
+}
@@ -1,7 +1,11 @@
 #include <gtest/gtest.h>
 
+#include <thread>
+#include <vector>
+
 #include <csim/init_ops.hpp>
 #include <csim/memory_ops.hpp>
+#include <csim/stat_ops.hpp>
 #include <csim/utility.hpp>
 
 #include "../util/util.hpp"
@@ -43,3 +47,129 @@ TEST(MemoryOperationTest, LargeMemory) {
     initialize_quantum_state(ptr, dim);
     release_quantum_state(ptr);
 }
+
+TEST(MemoryOperationTest, AllocatorPolicy) {
+    const UINT n = 16;
+    const ITYPE dim = 1ULL << n;
+    const UINT default_alignment = get_quantum_state_alignment();
+    const UINT default_huge_page_policy = get_quantum_state_huge_page_policy();
+    const UINT default_numa_policy = get_quantum_state_numa_policy();
+
+    for (UINT alignment : {64, 4096}) {
+        for (UINT huge_page_policy = HUGE_PAGE_NONE;
+             huge_page_policy <= HUGE_PAGE_EXPLICIT; ++huge_page_policy) {
+            for (UINT numa_policy = NUMA_POLICY_NONE;
+                 numa_policy <= NUMA_POLICY_FIRST_TOUCH; ++numa_policy) {
+                set_quantum_state_allocator(
+                    alignment, huge_page_policy, numa_policy);
+                ASSERT_EQ(get_quantum_state_alignment(), alignment);
+                ASSERT_EQ(get_quantum_state_huge_page_policy(),
+                    huge_page_policy);
+                ASSERT_EQ(get_quantum_state_numa_policy(), numa_policy);
+
+                auto ptr = allocate_quantum_state(dim);
+                ASSERT_EQ((uintptr_t)ptr % alignment, 0U);
+                initialize_Haar_random_state_with_seed(ptr, dim, 0);
+                ASSERT_NEAR(state_norm_squared(ptr, dim), 1., eps);
+                release_quantum_state(ptr);
+            }
+        }
+    }
+
+    // invalid alignment falls back to the default of 64 bytes
+    set_quantum_state_allocator(48, HUGE_PAGE_NONE, NUMA_POLICY_NONE);
+    ASSERT_EQ(get_quantum_state_alignment(), 64U);
+
+    set_quantum_state_allocator(
+        default_alignment, default_huge_page_policy, default_numa_policy);
+}
+
+TEST(MemoryOperationTest, StateMemoryPool) {
+    const UINT n = 10;
+    const ITYPE dim = 1ULL << n;
+    const size_t size = sizeof(CTYPE) * dim;
+    const size_t default_capacity = get_state_memory_pool_capacity();
+
+    set_state_memory_pool_capacity(4 * size);
+    clear_state_memory_pool();
+    reset_state_memory_pool_statistics();
+
+    // a released buffer is reused by the next allocation of the same size
+    auto ptr = allocate_quantum_state(dim);
+    release_quantum_state(ptr);
+    auto statistics = get_state_memory_pool_statistics();
+    ASSERT_EQ(statistics.cached_count, 1U);
+    ASSERT_EQ(statistics.cached_bytes, size);
+    auto reused = allocate_quantum_state(dim);
+    ASSERT_EQ(reused, ptr);
+    auto other = allocate_quantum_state(dim / 2);
+    statistics = get_state_memory_pool_statistics();
+    ASSERT_EQ(statistics.allocation_count, 3U);
+    ASSERT_EQ(statistics.reuse_count, 1U);
+    ASSERT_EQ(statistics.cached_count, 0U);
+    release_quantum_state(reused);
+    release_quantum_state(other);
+
+    // the cached buffers never exceed the capacity
+    std::vector<CTYPE*> ptr_list;
+    for (UINT i = 0; i < 6; ++i) {
+        ptr_list.push_back(allocate_quantum_state(dim));
+    }
+    for (auto p : ptr_list) release_quantum_state(p);
+    statistics = get_state_memory_pool_statistics();
+    ASSERT_LE(statistics.cached_bytes, 4 * size);
+    ASSERT_EQ(statistics.release_count, 9U);
+
+    // allocations from several threads
+    reset_state_memory_pool_statistics();
+    std::vector<std::thread> thread_list;
+    for (UINT thread_index = 0; thread_index < 4; ++thread_index) {
+        thread_list.emplace_back([=]() {
+            for (UINT rep = 0; rep < 50; ++rep) {
+                auto state = allocate_quantum_state(dim >> (rep % 2));
+                initialize_quantum_state(state, dim >> (rep % 2));
+                release_quantum_state(state);
+            }
+        });
+    }
+    for (auto& thread : thread_list) thread.join();
+    statistics = get_state_memory_pool_statistics();
+    ASSERT_EQ(statistics.allocation_count, 200U);
+    ASSERT_EQ(statistics.release_count, 200U);
+    ASSERT_GT(statistics.reuse_count, 0U);
+
+    // a buffer allocated before the policy changes is not cached, and the
+    // policy is changed while the other threads allocate
+    clear_state_memory_pool();
+    const UINT alignment = get_quantum_state_alignment();
+    const UINT huge_page_policy = get_quantum_state_huge_page_policy();
+    const UINT numa_policy = get_quantum_state_numa_policy();
+    auto old_ptr = allocate_quantum_state(dim);
+    thread_list.clear();
+    for (UINT thread_index = 0; thread_index < 4; ++thread_index) {
+        thread_list.emplace_back([=]() {
+            for (UINT rep = 0; rep < 50; ++rep) {
+                if (thread_index == 0 && rep % 10 == 0) {
+                    set_quantum_state_allocator(
+                        (rep % 20 == 0) ? 4096 : alignment, huge_page_policy,
+                        numa_policy);
+                }
+                auto state = allocate_quantum_state(dim);
+                initialize_quantum_state(state, dim);
+                release_quantum_state(state);
+            }
+        });
+    }
+    for (auto& thread : thread_list) thread.join();
+    set_quantum_state_allocator(alignment, huge_page_policy, numa_policy);
+    release_quantum_state(old_ptr);
+    ASSERT_EQ(get_state_memory_pool_statistics().cached_count, 0U);
+
+    // capacity 0 disables the pool
+    set_state_memory_pool_capacity(0);
+    ASSERT_EQ(get_state_memory_pool_statistics().cached_count, 0U);
+    release_quantum_state(allocate_quantum_state(dim));
+    ASSERT_EQ(get_state_memory_pool_statistics().cached_count, 0U);
+
+    set_state_memory_pool_capacity(default_capacity);
+}
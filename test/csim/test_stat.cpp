@@ -1,9 +1,12 @@
 #include <gtest/gtest.h>
 
 #include <Eigen/Core>
+#include <algorithm>
 #include <csim/init_ops.hpp>
 #include <csim/memory_ops.hpp>
 #include <csim/stat_ops.hpp>
+#include <csim/update_ops.hpp>
+#include <csim/utility.hpp>
 
 #include "../util/util.hpp"
 
@@ -93,6 +96,53 @@ TEST(StatOperationTest, MarginalProbTest) {
 }
 
 // entropy
+TEST(StatOperationTest, MarginalDistributionTest) {
+    const UINT n = 12;
+    const ITYPE dim = 1ULL << n;
+    const UINT target_count = 3;
+
+    CTYPE* state = allocate_quantum_state(dim);
+    initialize_Haar_random_state_with_seed(state, dim, 0);
+    for (UINT rep = 0; rep < 10; ++rep) {
+        std::vector<UINT> target_list;
+        while (target_list.size() < target_count) {
+            UINT target = rand_int(n);
+            if (std::find(target_list.begin(), target_list.end(), target) ==
+                target_list.end()) {
+                target_list.push_back(target);
+            }
+        }
+        std::vector<double> distribution(1ULL << target_count);
+        marginal_distribution(target_list.data(), target_count,
+            distribution.data(), state, dim);
+
+        // the tables of the threads are summed in a fixed order
+        std::vector<double> repeated_distribution(distribution.size());
+        marginal_distribution(target_list.data(), target_count,
+            repeated_distribution.data(), state, dim);
+        ASSERT_EQ(repeated_distribution, distribution);
+
+        // compare with the marginal probability of each outcome
+        std::vector<UINT> sorted_target_list = target_list;
+        std::sort(sorted_target_list.begin(), sorted_target_list.end());
+        for (ITYPE outcome = 0; outcome < distribution.size(); ++outcome) {
+            std::vector<UINT> measured_value_list(target_count);
+            for (UINT i = 0; i < target_count; ++i) {
+                UINT position = (UINT)(std::find(target_list.begin(),
+                                           target_list.end(),
+                                           sorted_target_list[i]) -
+                                       target_list.begin());
+                measured_value_list[i] = (outcome >> position) & 1;
+            }
+            ASSERT_NEAR(distribution[outcome],
+                marginal_prob(sorted_target_list.data(),
+                    measured_value_list.data(), target_count, state, dim),
+                eps);
+        }
+    }
+    release_quantum_state(state);
+}
+
 TEST(StatOperationTest, EntropyTest) {
     const UINT n = 6;
     const ITYPE dim = 1ULL << n;
@@ -675,3 +725,151 @@ TEST(StatOperationTest, MultiQubitTransitionAmplitudeZopPartialTest) {
     release_quantum_state(state_ket);
     release_quantum_state(state_bra);
 }
+
+TEST(StatOperationTest, PauliOperatorGroupExpectationValueTest) {
+    const UINT term_count = 8;
+
+    for (UINT n : {4, 12}) {
+        const ITYPE dim = 1ULL << n;
+        CTYPE* state = allocate_quantum_state(dim);
+        initialize_Haar_random_state(state, dim);
+        // the first group has no bit flip, i.e. the terms are diagonal
+        for (UINT bit_flip_pattern : {0U, 0b1011U}) {
+            std::vector<ITYPE> phase_flip_mask_list(term_count);
+            std::vector<UINT> global_phase_90rot_count_list(term_count);
+            std::vector<CTYPE> coef_list(term_count);
+            ITYPE bit_flip_mask = 0;
+            UINT pivot_qubit_index = 0;
+            CTYPE test_value = 0.;
+            for (UINT term = 0; term < term_count; ++term) {
+                std::vector<UINT> index_list, pauli_list;
+                for (UINT i = 0; i < n; ++i) {
+                    // X or Y on the flipped qubits, I or Z on the others
+                    const bool is_flipped = (bit_flip_pattern >> (i % 4)) & 1;
+                    const UINT pauli = is_flipped ? 1 + rand_int(2)
+                                                  : 3 * rand_int(2);
+                    if (pauli == 0) continue;
+                    index_list.push_back(i);
+                    pauli_list.push_back(pauli);
+                }
+                get_Pauli_masks_partial_list(index_list.data(),
+                    pauli_list.data(), (UINT)index_list.size(),
+                    &bit_flip_mask, &phase_flip_mask_list[term],
+                    &global_phase_90rot_count_list[term], &pivot_qubit_index);
+                coef_list[term] = CTYPE(rand_real(), rand_real());
+                test_value +=
+                    coef_list[term] *
+                    expectation_value_multi_qubit_Pauli_operator_partial_list(
+                        index_list.data(), pauli_list.data(),
+                        (UINT)index_list.size(), state, dim);
+            }
+            const CTYPE value = expectation_value_Pauli_operator_group(
+                bit_flip_mask, pivot_qubit_index, phase_flip_mask_list.data(),
+                global_phase_90rot_count_list.data(), coef_list.data(),
+                term_count, state, dim);
+            const CTYPE value_single_thread =
+                expectation_value_Pauli_operator_group_single_thread(
+                    bit_flip_mask, pivot_qubit_index,
+                    phase_flip_mask_list.data(),
+                    global_phase_90rot_count_list.data(), coef_list.data(),
+                    term_count, state, dim);
+            ASSERT_NEAR(_creal(value), _creal(test_value), eps);
+            ASSERT_NEAR(_cimag(value), _cimag(test_value), eps);
+            ASSERT_NEAR(_creal(value_single_thread), _creal(test_value), eps);
+            ASSERT_NEAR(_cimag(value_single_thread), _cimag(test_value), eps);
+        }
+        release_quantum_state(state);
+    }
+}
+
+TEST(StatOperationTest, KrausOperatorProbabilitiesTest) {
+    const UINT n = 8;
+    const ITYPE dim = 1ULL << n;
+    const UINT matrix_count = 3;
+    const std::vector<UINT> target_list = {5, 1};
+    const ITYPE matrix_dim = 1ULL << target_list.size();
+
+    CTYPE* state = allocate_quantum_state(dim);
+    CTYPE* buffer = allocate_quantum_state(dim);
+    initialize_Haar_random_state(state, dim);
+    std::vector<CTYPE> matrix_list(matrix_count * matrix_dim * matrix_dim);
+    for (auto& value : matrix_list) value = CTYPE(rand_real(), rand_real());
+
+    std::vector<double> probability_list(matrix_count);
+    const double norm = Kraus_operator_probabilities(target_list.data(),
+        (UINT)target_list.size(), matrix_list.data(), matrix_count,
+        probability_list.data(), state, dim);
+    ASSERT_NEAR(norm, state_norm_squared(state, dim), eps);
+    for (UINT i = 0; i < matrix_count; ++i) {
+        std::copy(state, state + dim, buffer);
+        multi_qubit_dense_matrix_gate(target_list.data(),
+            (UINT)target_list.size(),
+            matrix_list.data() + i * matrix_dim * matrix_dim, buffer, dim);
+        ASSERT_NEAR(probability_list[i], state_norm_squared(buffer, dim), eps);
+    }
+    release_quantum_state(state);
+    release_quantum_state(buffer);
+}
+
+TEST(StatOperationTest, SamplingSortedTest) {
+    const UINT n = 14;
+    const ITYPE dim = 1ULL << n;
+    const UINT sampling_count = 1000;
+
+    CTYPE* state = allocate_quantum_state(dim);
+    initialize_Haar_random_state_with_seed(state, dim, 0);
+    // leave some basis states with zero probability
+    for (ITYPE i = 0; i < dim; i += 3) state[i] = 0.;
+    const double norm = state_norm_squared(state, dim);
+    std::vector<double> cumulative(dim + 1, 0.);
+    for (ITYPE i = 0; i < dim; ++i) {
+        cumulative[i + 1] = cumulative[i] + std::norm(state[i]) / norm;
+    }
+
+    std::vector<double> random_list(sampling_count);
+    for (UINT i = 0; i < sampling_count; ++i) random_list[i] = rand_real();
+    std::sort(random_list.begin(), random_list.end());
+    std::vector<ITYPE> result(sampling_count);
+    state_sampling_sorted(
+        random_list.data(), sampling_count, result.data(), state, dim);
+    for (UINT i = 0; i < sampling_count; ++i) {
+        ASSERT_LT(result[i], dim);
+        ASSERT_NE(result[i] % 3, 0U);
+        ASSERT_LE(cumulative[result[i]], random_list[i] + eps);
+        ASSERT_GE(cumulative[result[i] + 1], random_list[i] - eps);
+    }
+    release_quantum_state(state);
+}
+
+TEST(StatOperationTest, SamplingAliasTableTest) {
+    const UINT n = 14;
+    const ITYPE dim = 1ULL << n;
+
+    CTYPE* state = allocate_quantum_state(dim);
+    initialize_Haar_random_state_with_seed(state, dim, 1);
+    for (ITYPE i = 0; i < dim; i += 5) state[i] = 0.;
+    const double norm = state_norm_squared(state, dim);
+
+    std::vector<double> threshold_list(dim);
+    std::vector<ITYPE> alias_list(dim);
+    state_sampling_alias_table(
+        threshold_list.data(), alias_list.data(), state, dim);
+
+    // the probability restored from the alias table
+    std::vector<double> restored(dim, 0.);
+    for (ITYPE i = 0; i < dim; ++i) {
+        ASSERT_LT(alias_list[i], dim);
+        if (alias_list[i] == i) {
+            restored[i] += 1.;
+        } else {
+            ASSERT_GE(threshold_list[i], 0.);
+            ASSERT_LT(threshold_list[i], 1.);
+            restored[i] += threshold_list[i];
+            restored[alias_list[i]] += 1. - threshold_list[i];
+        }
+    }
+    for (ITYPE i = 0; i < dim; ++i) {
+        ASSERT_NEAR(restored[i] / dim, std::norm(state[i]) / norm, eps);
+    }
+    release_quantum_state(state);
+}
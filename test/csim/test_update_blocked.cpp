@@ -0,0 +1,110 @@
+#include <gtest/gtest.h>
+
+#include <Eigen/Core>
+#include <csim/init_ops.hpp>
+#include <csim/memory_ops.hpp>
+#include <csim/update_ops.hpp>
+#include <vector>
+
+#include "../util/util.hpp"
+
+TEST(UpdateTest, BlockedDenseMatrixTest) {
+    const UINT n = 8;
+    const ITYPE dim = 1ULL << n;
+    const UINT block_qubit_count = 4;
+    const UINT gate_count = 20;
+
+    auto state = allocate_quantum_state(dim);
+    auto test_state = allocate_quantum_state(dim);
+    initialize_Haar_random_state(state, dim);
+    memcpy(test_state, state, sizeof(CTYPE) * dim);
+
+    std::vector<UINT> control_count_list, control_list, value_list;
+    std::vector<UINT> target_count_list, target_list;
+    std::vector<CTYPE> matrix_list;
+    for (UINT gate_index = 0; gate_index < gate_count; ++gate_index) {
+        // one or two target qubits with at most one control qubit, all of
+        // which are smaller than block_qubit_count
+        UINT target_count = 1 + rand_int(2);
+        UINT control_count = rand_int(2);
+        std::vector<UINT> qubits;
+        while (qubits.size() < target_count + control_count) {
+            UINT index = rand_int(block_qubit_count);
+            if (std::find(qubits.begin(), qubits.end(), index) ==
+                qubits.end())
+                qubits.push_back(index);
+        }
+        std::vector<UINT> targets(
+            qubits.begin(), qubits.begin() + target_count);
+        std::vector<UINT> controls(
+            qubits.begin() + target_count, qubits.end());
+        std::vector<UINT> values;
+        for (UINT i = 0; i < control_count; ++i)
+            values.push_back(rand_int(2));
+
+        Eigen::Matrix<std::complex<double>, Eigen::Dynamic, Eigen::Dynamic,
+            Eigen::RowMajor>
+            U = get_eigen_matrix_random_single_qubit_unitary();
+        if (target_count == 2) {
+            U = kronecker_product(
+                get_eigen_matrix_random_single_qubit_unitary(),
+                get_eigen_matrix_random_single_qubit_unitary());
+        }
+        multi_qubit_control_multi_qubit_dense_matrix_gate(controls.data(),
+            values.data(), control_count, targets.data(), target_count,
+            (CTYPE*)U.data(), test_state, dim);
+
+        control_count_list.push_back(control_count);
+        control_list.insert(
+            control_list.end(), controls.begin(), controls.end());
+        value_list.insert(value_list.end(), values.begin(), values.end());
+        target_count_list.push_back(target_count);
+        target_list.insert(target_list.end(), targets.begin(), targets.end());
+        matrix_list.insert(matrix_list.end(), (CTYPE*)U.data(),
+            (CTYPE*)U.data() + U.size());
+    }
+
+    multi_gate_blocked_dense_matrix_gate(gate_count,
+        control_count_list.data(), control_list.data(), value_list.data(),
+        target_count_list.data(), target_list.data(), matrix_list.data(),
+        block_qubit_count, state, dim);
+
+    for (ITYPE i = 0; i < dim; ++i) {
+        ASSERT_NEAR(_creal(state[i]), _creal(test_state[i]), eps);
+        ASSERT_NEAR(_cimag(state[i]), _cimag(test_state[i]), eps);
+    }
+    release_quantum_state(state);
+    release_quantum_state(test_state);
+}
+
+TEST(UpdateTest, BlockedGateWithoutTarget) {
+    const UINT n = 6;
+    const ITYPE dim = 1ULL << n;
+    const UINT block_qubit_count = 4;
+
+    auto state = allocate_quantum_state(dim);
+    auto test_state = allocate_quantum_state(dim);
+    initialize_Haar_random_state(state, dim);
+    memcpy(test_state, state, sizeof(CTYPE) * dim);
+
+    // an identity on qubit 1, and a phase on the amplitudes whose qubit 2
+    // is 1 and qubit 0 is 0, which has no target qubit
+    const CTYPE phase = 1.i;
+    std::vector<UINT> control_count_list{0, 2}, control_list{2, 0},
+        value_list{1, 0}, target_count_list{1, 0}, target_list{1};
+    std::vector<CTYPE> matrix_list{1., 0., 0., 1., phase};
+    multi_gate_blocked_dense_matrix_gate(2, control_count_list.data(),
+        control_list.data(), value_list.data(), target_count_list.data(),
+        target_list.data(), matrix_list.data(), block_qubit_count, state,
+        dim);
+
+    for (ITYPE i = 0; i < dim; ++i) {
+        const CTYPE expected =
+            (((i >> 2) & 1) == 1 && (i & 1) == 0) ? phase * test_state[i]
+                                                  : test_state[i];
+        ASSERT_NEAR(_creal(state[i]), _creal(expected), eps);
+        ASSERT_NEAR(_cimag(state[i]), _cimag(expected), eps);
+    }
+    release_quantum_state(state);
+    release_quantum_state(test_state);
+}
@@ -359,3 +359,27 @@ TEST(UpdateTest, SWAPGate) {
         get_eigen_matrix_full_qubit_SWAP);
 #endif
 }
+
+TEST(UpdateTest, MultiSWAPGate) {
+    const UINT n = 8;
+    const ITYPE dim = 1ULL << n;
+    const std::vector<UINT> list_0 = {7, 0, 3};
+    const std::vector<UINT> list_1 = {1, 5, 6};
+
+    auto state = allocate_quantum_state(dim);
+    auto test_state = allocate_quantum_state(dim);
+    initialize_Haar_random_state_with_seed(state, dim, 0);
+    memcpy(test_state, state, sizeof(CTYPE) * dim);
+
+    multi_SWAP_gate(list_0.data(), list_1.data(), (UINT)list_0.size(), state,
+        dim);
+    for (UINT i = 0; i < list_0.size(); ++i) {
+        SWAP_gate(list_0[i], list_1[i], test_state, dim);
+    }
+    for (ITYPE i = 0; i < dim; ++i) {
+        ASSERT_NEAR(_creal(state[i]), _creal(test_state[i]), eps);
+        ASSERT_NEAR(_cimag(state[i]), _cimag(test_state[i]), eps);
+    }
+    release_quantum_state(state);
+    release_quantum_state(test_state);
+}
@@ -0,0 +1,209 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+
+#include <csim/init_ops.hpp>
+#include <csim/memory_ops.hpp>
+#include <csim/memory_ops_template.hpp>
+#include <csim/stat_ops.hpp>
+#include <csim/stat_ops_template.hpp>
+#include <csim/update_ops.hpp>
+#include <csim/update_ops_template.hpp>
+
+#include "../util/util.hpp"
+
+// tolerance of single-precision kernels compared with double-precision ones
+static const double eps_f32 = 1e-5;
+
+static void assert_state_near(
+    const std::complex<float>* state_f32, const CTYPE* state, ITYPE dim) {
+    for (ITYPE i = 0; i < dim; ++i) {
+        ASSERT_NEAR(state_f32[i].real(), state[i].real(), eps_f32);
+        ASSERT_NEAR(state_f32[i].imag(), state[i].imag(), eps_f32);
+    }
+}
+
+TEST(UpdateTemplateTest, NamedGateFloat) {
+    const UINT n = 6;
+    const ITYPE dim = 1ULL << n;
+
+    CTYPE* state = allocate_quantum_state(dim);
+    std::complex<float>* state_f32 = allocate_quantum_state<float>(dim);
+    initialize_Haar_random_state_with_seed(state, dim, 0);
+    convert_quantum_state(state, state_f32, dim);
+
+    using SingleFunc = void (*)(UINT, CTYPE*, ITYPE);
+    using SingleFuncF32 = void (*)(UINT, std::complex<float>*, ITYPE);
+    std::vector<std::pair<SingleFunc, SingleFuncF32>> single_funcs = {
+        {X_gate, X_gate<float>}, {Y_gate, Y_gate<float>},
+        {Z_gate, Z_gate<float>}, {H_gate, H_gate<float>},
+        {S_gate, S_gate<float>}, {Sdag_gate, Sdag_gate<float>},
+        {T_gate, T_gate<float>}, {Tdag_gate, Tdag_gate<float>}};
+    using DoubleFunc = void (*)(UINT, UINT, CTYPE*, ITYPE);
+    using DoubleFuncF32 = void (*)(UINT, UINT, std::complex<float>*, ITYPE);
+    std::vector<std::pair<DoubleFunc, DoubleFuncF32>> double_funcs = {
+        {CNOT_gate, CNOT_gate<float>}, {CZ_gate, CZ_gate<float>},
+        {SWAP_gate, SWAP_gate<float>}};
+
+    for (UINT rep = 0; rep < 20; ++rep) {
+        for (const auto& func : single_funcs) {
+            UINT target = rand_int(n);
+            func.first(target, state, dim);
+            func.second(target, state_f32, dim);
+            assert_state_near(state_f32, state, dim);
+        }
+        for (const auto& func : double_funcs) {
+            UINT target = rand_int(n);
+            UINT control = (target + 1 + rand_int(n - 1)) % n;
+            func.first(control, target, state, dim);
+            func.second(control, target, state_f32, dim);
+            assert_state_near(state_f32, state, dim);
+        }
+    }
+    release_quantum_state(state);
+    release_quantum_state(state_f32);
+}
+
+TEST(UpdateTemplateTest, MatrixGateFloat) {
+    const UINT n = 6;
+    const ITYPE dim = 1ULL << n;
+
+    CTYPE* state = allocate_quantum_state(dim);
+    std::complex<float>* state_f32 = allocate_quantum_state<float>(dim);
+    initialize_Haar_random_state_with_seed(state, dim, 1);
+    convert_quantum_state(state, state_f32, dim);
+
+    for (UINT rep = 0; rep < 10; ++rep) {
+        // single-qubit dense and diagonal matrices
+        UINT target = rand_int(n);
+        Eigen::MatrixXcd single =
+            get_eigen_matrix_random_single_qubit_unitary();
+        CTYPE matrix[4];
+        std::complex<float> matrix_f32[4];
+        for (UINT i = 0; i < 4; ++i) {
+            matrix[i] = single(i / 2, i % 2);
+            matrix_f32[i] = std::complex<float>(matrix[i]);
+        }
+        single_qubit_dense_matrix_gate(target, matrix, state, dim);
+        single_qubit_dense_matrix_gate(target, matrix_f32, state_f32, dim);
+        assert_state_near(state_f32, state, dim);
+
+        CTYPE diagonal[2] = {matrix[0] / std::abs(matrix[0]),
+            matrix[3] / std::abs(matrix[3])};
+        std::complex<float> diagonal_f32[2] = {
+            std::complex<float>(diagonal[0]), std::complex<float>(diagonal[1])};
+        single_qubit_diagonal_matrix_gate(target, diagonal, state, dim);
+        single_qubit_diagonal_matrix_gate(
+            target, diagonal_f32, state_f32, dim);
+        assert_state_near(state_f32, state, dim);
+
+        // two-target dense and diagonal matrices with one control qubit
+        std::vector<UINT> index_list = {0, 1, 2, 3, 4, 5};
+        std::shuffle(
+            index_list.begin(), index_list.end(), std::mt19937(rand()));
+        UINT targets[2] = {index_list[0], index_list[1]};
+        UINT controls[1] = {index_list[2]};
+        UINT control_values[1] = {rand_int(2)};
+        Eigen::MatrixXcd dense =
+            kronecker_product(get_eigen_matrix_random_single_qubit_unitary(),
+                get_eigen_matrix_random_single_qubit_unitary());
+        std::vector<CTYPE> dense_element(16);
+        std::vector<std::complex<float>> dense_element_f32(16);
+        std::vector<CTYPE> diagonal_element(4);
+        std::vector<std::complex<float>> diagonal_element_f32(4);
+        for (UINT y = 0; y < 4; ++y) {
+            for (UINT x = 0; x < 4; ++x) {
+                dense_element[y * 4 + x] = dense(y, x);
+                dense_element_f32[y * 4 + x] = std::complex<float>(dense(y, x));
+            }
+            diagonal_element[y] = dense(y, y) / std::abs(dense(y, y));
+            diagonal_element_f32[y] = std::complex<float>(diagonal_element[y]);
+        }
+        multi_qubit_control_multi_qubit_dense_matrix_gate(controls,
+            control_values, 1, targets, 2, dense_element.data(), state, dim);
+        multi_qubit_control_multi_qubit_dense_matrix_gate(controls,
+            control_values, 1, targets, 2, dense_element_f32.data(), state_f32,
+            dim);
+        assert_state_near(state_f32, state, dim);
+        multi_qubit_control_multi_qubit_diagonal_matrix_gate(controls,
+            control_values, 1, targets, 2, diagonal_element.data(), state, dim);
+        multi_qubit_control_multi_qubit_diagonal_matrix_gate(controls,
+            control_values, 1, targets, 2, diagonal_element_f32.data(),
+            state_f32, dim);
+        assert_state_near(state_f32, state, dim);
+    }
+    release_quantum_state(state);
+    release_quantum_state(state_f32);
+}
+
+TEST(UpdateTemplateTest, PauliGateAndStatFloat) {
+    const UINT n = 6;
+    const ITYPE dim = 1ULL << n;
+
+    CTYPE* state = allocate_quantum_state(dim);
+    std::complex<float>* state_f32 = allocate_quantum_state<float>(dim);
+    initialize_Haar_random_state_with_seed(state, dim, 2);
+    convert_quantum_state(state, state_f32, dim);
+
+    for (UINT rep = 0; rep < 10; ++rep) {
+        std::vector<UINT> target_list, pauli_list;
+        for (UINT i = 0; i < n; ++i) {
+            if (rand_int(2)) continue;
+            target_list.push_back(i);
+            pauli_list.push_back(rand_int(4));
+        }
+        const UINT count = (UINT)target_list.size();
+        const double angle = rand_real() * 2 * M_PI;
+        multi_qubit_Pauli_gate_partial_list(
+            target_list.data(), pauli_list.data(), count, state, dim);
+        multi_qubit_Pauli_gate_partial_list(
+            target_list.data(), pauli_list.data(), count, state_f32, dim);
+        assert_state_near(state_f32, state, dim);
+        multi_qubit_Pauli_rotation_gate_partial_list(
+            target_list.data(), pauli_list.data(), count, angle, state, dim);
+        multi_qubit_Pauli_rotation_gate_partial_list(target_list.data(),
+            pauli_list.data(), count, angle, state_f32, dim);
+        assert_state_near(state_f32, state, dim);
+
+        ASSERT_NEAR(expectation_value_multi_qubit_Pauli_operator_partial_list(
+                        target_list.data(), pauli_list.data(), count,
+                        state_f32, dim),
+            expectation_value_multi_qubit_Pauli_operator_partial_list(
+                target_list.data(), pauli_list.data(), count, state, dim),
+            eps_f32);
+        ASSERT_NEAR(
+            expectation_value_multi_qubit_Pauli_operator_partial_list_single_thread(
+                target_list.data(), pauli_list.data(), count, state_f32, dim),
+            expectation_value_multi_qubit_Pauli_operator_partial_list(
+                target_list.data(), pauli_list.data(), count, state, dim),
+            eps_f32);
+    }
+
+    ASSERT_NEAR(
+        state_norm_squared(state_f32, dim), state_norm_squared(state, dim),
+        eps_f32);
+    ASSERT_NEAR(measurement_distribution_entropy(state_f32, dim),
+        measurement_distribution_entropy(state, dim), eps_f32);
+    for (UINT target = 0; target < n; ++target) {
+        ASSERT_NEAR(M0_prob(target, state_f32, dim),
+            M0_prob(target, state, dim), eps_f32);
+    }
+    UINT sorted_target_list[2] = {1, 4};
+    UINT measured_value_list[2] = {1, 0};
+    ASSERT_NEAR(marginal_prob(sorted_target_list, measured_value_list, 2,
+                    state_f32, dim),
+        marginal_prob(sorted_target_list, measured_value_list, 2, state, dim),
+        eps_f32);
+    CTYPE inner = state_inner_product(state_f32, state_f32, dim);
+    ASSERT_NEAR(inner.real(), state_inner_product(state, state, dim).real(),
+        eps_f32);
+
+    // conversion back to double precision keeps the amplitudes
+    CTYPE* state_converted = allocate_quantum_state(dim);
+    convert_quantum_state(state_f32, state_converted, dim);
+    assert_state_near(state_f32, state_converted, dim);
+    release_quantum_state(state_converted);
+    release_quantum_state(state);
+    release_quantum_state(state_f32);
+}
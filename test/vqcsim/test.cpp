@@ -26,6 +26,22 @@ public:
     };
 };
 
+// a user-defined gate which has no generator kernel
+class ClsParametricUserRXGate
+    : public QuantumGate_SingleParameterOneQubitRotation {
+public:
+    ClsParametricUserRXGate(UINT target_qubit_index, double angle)
+        : QuantumGate_SingleParameterOneQubitRotation(angle) {
+        this->_name = "ParametricUserRX";
+        this->_update_func = RX_gate;
+        this->_target_qubit_list.push_back(TargetQubitInfo(target_qubit_index));
+    }
+    virtual void set_matrix(ComplexMatrix& matrix) const override {}
+    virtual QuantumGate_SingleParameter* copy() const override {
+        return new ClsParametricUserRXGate(*this);
+    };
+};
+
 TEST(ParametricGate, NullUpdateFunc) {
     ClsParametricNullUpdateGate gate(0, 0.);
     QuantumState state(1);
@@ -264,6 +280,50 @@ TEST(EnergyMinimization, MultiQubit) {
     delete emp;
 }
 
+TEST(EnergyMinimization, AdjointDifferentiation) {
+    const UINT n = 4;
+    Random random;
+    ParametricQuantumCircuit circuit(n);
+    for (UINT depth = 0; depth < 3; ++depth) {
+        for (UINT i = 0; i < n; ++i) {
+            circuit.add_parametric_RY_gate(i, 0.);
+            circuit.add_H_gate(i);
+            circuit.add_parametric_RZ_gate(i, 0.);
+        }
+        for (UINT i = 0; i + 1 < n; ++i) circuit.add_CNOT_gate(i, i + 1);
+        circuit.add_parametric_multi_Pauli_rotation_gate({0, 3}, {1, 2}, 0.);
+    }
+    const UINT parameter_count = circuit.get_parameter_count();
+    std::vector<double> parameter;
+    for (UINT i = 0; i < parameter_count; ++i) {
+        parameter.push_back(random.uniform() * 6.);
+    }
+
+    Observable* observable = new Observable(n);
+    observable->add_operator(1.0, "Z 0 X 1");
+    observable->add_operator(-0.5, "Y 2 Y 3");
+    observable->add_operator(0.3, "X 3");
+    EnergyMinimizationProblem instance(observable);
+    ParametricQuantumCircuitSimulator sim(&circuit);
+
+    std::vector<double> expected(parameter_count);
+    GradientByHalfPi half_pi;
+    const double expected_loss =
+        half_pi.compute_gradient(&sim, &instance, parameter, &expected);
+
+    // with and without the checkpoints
+    for (size_t budget : {(size_t)1 << 30, (size_t)0}) {
+        std::vector<double> gradient(parameter_count);
+        GradientByAdjoint adjoint(budget);
+        const double loss =
+            adjoint.compute_gradient(&sim, &instance, parameter, &gradient);
+        ASSERT_NEAR(loss, expected_loss, eps);
+        for (UINT i = 0; i < parameter_count; ++i) {
+            ASSERT_NEAR(gradient[i], expected[i], eps);
+        }
+    }
+}
+
 TEST(ParametricGate, DuplicateIndex) {
     auto gate1 = gate::ParametricPauliRotation(
         {0, 1, 2, 3, 4, 5, 6}, {0, 0, 0, 0, 0, 0, 0}, 0.0);
@@ -287,6 +347,58 @@ TEST(ParametricGate, DuplicateIndex) {
         DuplicatedQubitIndexException);
 }
 
+TEST(ParametricGate, GeneratorAndDerivative) {
+    const UINT n = 3;
+    const double angle = 0.7, delta = 1e-4;
+    std::vector<QuantumGate_SingleParameter*> gate_list = {
+        gate::ParametricRX(0, angle), gate::ParametricRY(1, angle),
+        gate::ParametricRZ(2, angle),
+        gate::ParametricPauliRotation({0, 2, 1}, {1, 2, 3}, angle),
+        new ClsParametricUserRXGate(1, angle)};
+    QuantumState state(n), expected(n), derivative(n), shifted(n);
+    for (auto gate : gate_list) {
+        state.set_Haar_random_state();
+
+        // derivative by finite difference
+        expected.load(&state);
+        gate->set_parameter_value(angle + delta);
+        gate->update_quantum_state(&expected);
+        shifted.load(&state);
+        gate->set_parameter_value(angle - delta);
+        gate->update_quantum_state(&shifted);
+        gate->set_parameter_value(angle);
+        expected.add_state_with_coef(-1., &shifted);
+        expected.multiply_coef(0.5 / delta);
+
+        derivative.load(&state);
+        gate->apply_derivative(&derivative);
+        ASSERT_EQ(gate->get_parameter_value(), angle);
+        for (ITYPE i = 0; i < state.dim; ++i) {
+            ASSERT_NEAR(abs(derivative.data_cpp()[i] - expected.data_cpp()[i]),
+                0, 1e-6);
+        }
+
+        // the derivative is i G U / 2
+        derivative.load(&state);
+        gate->update_quantum_state(&derivative);
+        gate->apply_generator(&derivative);
+        derivative.multiply_coef(CPPCTYPE(0, 0.5));
+        for (ITYPE i = 0; i < state.dim; ++i) {
+            ASSERT_NEAR(abs(derivative.data_cpp()[i] - expected.data_cpp()[i]),
+                0, 1e-6);
+        }
+
+        shifted.load(&state);
+        gate->update_quantum_state(&shifted);
+        gate->apply_inverse(&shifted);
+        ASSERT_NEAR(abs(state::inner_product(&state, &shifted)), 1., eps);
+
+        DensityMatrix dm(n);
+        ASSERT_THROW(gate->apply_generator(&dm), NotImplementedException);
+        delete gate;
+    }
+}
+
 TEST(ParametricQuantumCircuitSimulator, Basic) {
     UINT n = 3;
     Observable observable(n);
@@ -390,6 +502,224 @@ TEST(GradCalculator, BasicCheck) {
     }
 }
 
+TEST(GradCalculator, AdjointEnergyAndGrad) {
+    const UINT n = 4;
+    Random rnd;
+    Observable observable(n);
+    observable.add_operator(0.7, "X 0 Z 2");
+    observable.add_operator(-1.1, "Y 1 Y 3");
+    observable.add_operator(0.4, "Z 3");
+
+    ParametricQuantumCircuit circuit(n);
+    for (UINT depth = 0; depth < 2; ++depth) {
+        for (UINT i = 0; i < n; ++i) {
+            circuit.add_parametric_RX_gate(i, rnd.uniform());
+            circuit.add_parametric_RY_gate(i, rnd.uniform());
+            circuit.add_gate(gate::H(i));
+            circuit.add_parametric_RZ_gate(i, rnd.uniform());
+        }
+        for (UINT i = 0; i + 1 < n; ++i) {
+            circuit.add_CNOT_gate(i, i + 1);
+        }
+        circuit.add_parametric_multi_Pauli_rotation_gate(
+            {0, 2, 3}, {1, 2, 3}, rnd.uniform());
+        circuit.add_gate(gate::RandomUnitary({1, 3}));
+    }
+    const UINT parameter_count = circuit.get_parameter_count();
+    std::vector<double> theta;
+    for (UINT i = 0; i < parameter_count; ++i) {
+        theta.push_back(circuit.get_parameter(i));
+    }
+
+    GradCalculator grad_calculator;
+    auto energy_and_grad =
+        grad_calculator.calculate_energy_and_grad(circuit, observable);
+    // the parameters of the circuit are restored
+    for (UINT i = 0; i < parameter_count; ++i) {
+        ASSERT_EQ(circuit.get_parameter(i), theta[i]);
+    }
+
+    QuantumState state(n);
+    state.set_zero_state();
+    circuit.update_quantum_state(&state);
+    ASSERT_NEAR(energy_and_grad.first,
+        observable.get_expectation_value(&state).real(), eps);
+
+    const double delta = 0.001;
+    for (UINT i = 0; i < parameter_count; ++i) {
+        double expectation_value[2];
+        for (UINT sign = 0; sign < 2; ++sign) {
+            circuit.set_parameter(i, theta[i] + (sign == 0 ? delta : -delta));
+            state.set_zero_state();
+            circuit.update_quantum_state(&state);
+            expectation_value[sign] =
+                observable.get_expectation_value(&state).real();
+        }
+        circuit.set_parameter(i, theta[i]);
+        ASSERT_NEAR(energy_and_grad.second[i],
+            (expectation_value[0] - expectation_value[1]) / (2 * delta), 1e-6);
+    }
+
+    // gates without their inverses fall back to the parameter shift rule
+    circuit.add_gate(gate::Measurement(0, 0));
+    ASSERT_THROW(grad_calculator.calculate_energy_and_grad(circuit, observable),
+        NotImplementedException);
+    ASSERT_EQ(grad_calculator.calculate_grad(circuit, observable).size(),
+        parameter_count);
+}
+
+TEST(GradCalculator, NonUnitaryMatrixGate) {
+    const UINT n = 2;
+    Observable observable(n);
+    observable.add_operator(0.6, "Z 0 X 1");
+    observable.add_operator(-0.8, "Y 0");
+
+    ParametricQuantumCircuit circuit(n);
+    circuit.add_H_gate(0);
+    circuit.add_parametric_RX_gate(0, 0.3);
+    ComplexMatrix matrix(2, 2);
+    matrix << 1., 0.2, 0., 0.5;
+    circuit.add_gate(gate::DenseMatrix(0, matrix));
+    circuit.add_CNOT_gate(0, 1);
+    circuit.add_parametric_RY_gate(1, -0.7);
+    circuit.add_parametric_RZ_gate(0, 1.1);
+    const UINT parameter_count = circuit.get_parameter_count();
+    std::vector<double> theta;
+    for (UINT i = 0; i < parameter_count; ++i) {
+        theta.push_back(circuit.get_parameter(i));
+    }
+
+    // the conjugate transpose is not the inverse of the matrix
+    GradCalculator grad_calculator;
+    ASSERT_THROW(grad_calculator.calculate_energy_and_grad(circuit, observable),
+        NotImplementedException);
+    auto grad = grad_calculator.calculate_grad(circuit, observable);
+    ASSERT_EQ(grad.size(), parameter_count);
+
+    QuantumState state(n);
+    const double delta = 0.001;
+    for (UINT i = 0; i < parameter_count; ++i) {
+        double expectation_value[2];
+        for (UINT sign = 0; sign < 2; ++sign) {
+            circuit.set_parameter(i, theta[i] + (sign == 0 ? delta : -delta));
+            state.set_zero_state();
+            circuit.update_quantum_state(&state);
+            expectation_value[sign] =
+                observable.get_expectation_value(&state).real();
+        }
+        circuit.set_parameter(i, theta[i]);
+        ASSERT_NEAR(grad[i].real(),
+            (expectation_value[0] - expectation_value[1]) / (2 * delta), 1e-6);
+    }
+}
+
+TEST(CausalConeSimulator, SharedConesAndParameterUpdate) {
+    const UINT n = 6;
+    Random rnd;
+    ParametricQuantumCircuit circuit(n);
+    for (UINT i = 0; i < n; ++i) {
+        circuit.add_H_gate(i);
+        circuit.add_parametric_RY_gate(i, rnd.uniform());
+    }
+    for (UINT i = 0; i + 1 < n; i += 2) {
+        circuit.add_parametric_RX_gate(i + 1, rnd.uniform());
+        circuit.add_CNOT_gate(i, i + 1);
+    }
+    Observable observable(n);
+    observable.add_operator(0.3, "Z 0");
+    observable.add_operator(-0.7, "Z 0 Z 1");
+    observable.add_operator(1.1, "X 1");
+    observable.add_operator(0.5, "Z 2 Z 4");
+    observable.add_operator(0.9, "Y 5");
+
+    auto direct_expectation_value = [&]() {
+        QuantumState state(n);
+        state.set_zero_state();
+        circuit.update_quantum_state(&state);
+        return observable.get_expectation_value(&state);
+    };
+
+    CausalConeSimulator cone(circuit, observable);
+    cone.build();
+    // the terms share the cones {0, 1}, {2, 3} and {4, 5}
+    UINT component_count = 0;
+    for (auto& circuits : cone.get_circuit_list()) {
+        component_count += (UINT)circuits.size();
+    }
+    ASSERT_EQ(component_count, 6U);
+    ASSERT_EQ(cone.get_cone_count(), 3U);
+    ASSERT_NEAR(cone.get_expectation_value().real(),
+        direct_expectation_value().real(), eps);
+
+    // parameters are updated without building the cones again
+    for (UINT p = 0; p < circuit.get_parameter_count(); ++p) {
+        const double value = rnd.uniform() * 5.0;
+        circuit.set_parameter(p, value);
+        cone.set_parameter(p, value);
+    }
+    ASSERT_EQ(cone.get_cone_count(), 3U);
+    ASSERT_NEAR(cone.get_expectation_value().real(),
+        direct_expectation_value().real(), eps);
+    ASSERT_THROW(cone.set_parameter(circuit.get_parameter_count(), 0.),
+        ParameterIndexOutOfRangeException);
+}
+
+TEST(ParametricCircuit, EvaluateBatch) {
+    const UINT n = 5, batch_size = 37;
+    Random rnd;
+    Observable observable(n);
+    observable.add_operator(0.3, "Z 0 X 3");
+    observable.add_operator(-0.9, "Y 2 Z 4");
+    observable.add_operator(1.2, "Z 1");
+
+    ParametricQuantumCircuit circuit(n);
+    for (UINT i = 0; i < n; ++i) circuit.add_H_gate(i);
+    circuit.add_CNOT_gate(0, 1);
+    circuit.add_gate(gate::RandomUnitary({2, 4}));
+    for (UINT i = 0; i < n; ++i) {
+        circuit.add_parametric_RY_gate(i, 0.);
+        circuit.add_CNOT_gate(i, (i + 1) % n);
+        circuit.add_parametric_RZ_gate(i, 0.);
+    }
+    circuit.add_parametric_multi_Pauli_rotation_gate({0, 1, 4}, {1, 1, 2}, 0.);
+    // the last parameter belongs to a gate before the other parametric gates
+    circuit.add_parametric_gate(gate::ParametricRX(3, 0.), n + 2);
+    const UINT parameter_count = circuit.get_parameter_count();
+    for (UINT p = 0; p < parameter_count; ++p) {
+        circuit.set_parameter(p, 0.25);
+    }
+
+    std::vector<std::vector<double>> theta_matrix(batch_size);
+    for (auto& theta : theta_matrix) {
+        for (UINT p = 0; p < parameter_count; ++p) {
+            theta.push_back(rnd.uniform() * 6.);
+        }
+    }
+    auto result = circuit.evaluate_batch(theta_matrix, observable);
+    ASSERT_EQ(result.size(), batch_size);
+    // the parameters of the circuit are not changed
+    for (UINT p = 0; p < parameter_count; ++p) {
+        ASSERT_EQ(circuit.get_parameter(p), 0.25);
+    }
+
+    QuantumState state(n);
+    for (UINT i = 0; i < batch_size; ++i) {
+        for (UINT p = 0; p < parameter_count; ++p) {
+            circuit.set_parameter(p, theta_matrix[i][p]);
+        }
+        state.set_zero_state();
+        circuit.update_quantum_state(&state);
+        ASSERT_NEAR(
+            result[i], observable.get_expectation_value(&state).real(), eps);
+    }
+
+    ASSERT_EQ(circuit.evaluate_batch({}, observable).size(), 0U);
+    ASSERT_THROW(circuit.evaluate_batch({{0.1}}, observable),
+        ParameterIndexOutOfRangeException);
+    ASSERT_THROW(circuit.evaluate_batch(theta_matrix, Observable(n + 1)),
+        InvalidQubitCountException);
+}
+
 TEST(ParametricCircuit, ParametricMergeCircuits) {
     ParametricQuantumCircuit base_circuit(3), circuit_for_merge(3),
         expected_circuit(3);